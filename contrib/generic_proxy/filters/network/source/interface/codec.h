@@ -80,8 +80,9 @@ using MessageCreatorPtr = std::unique_ptr<MessageCreator>;
  */
 class ProtocolOptions {
 public:
-  ProtocolOptions(bool bind_upstream_connection)
-      : bind_upstream_connection_(bind_upstream_connection) {}
+  ProtocolOptions(bool bind_upstream_connection, bool multiplex_upstream_connection = false)
+      : bind_upstream_connection_(bind_upstream_connection),
+        multiplex_upstream_connection_(multiplex_upstream_connection) {}
   ProtocolOptions() = default;
 
   /**
@@ -110,8 +111,26 @@ public:
    */
   bool bindUpstreamConnection() const { return bind_upstream_connection_; }
 
+  /**
+   * @return true if the requests of all downstream connections may be multiplexed on upstream
+   * connections shared by the worker, false otherwise.
+   *
+   * By default, an upstream connection is used by one request at a time. If this option is true,
+   * the router keeps one upstream connection per upstream host and worker and sends the requests
+   * of all downstream connections to the host on it, without waiting for the previous responses.
+   * Every request gets a stream id that is unique on the upstream connection and the downstream
+   * stream id is restored on its response. So the following requirements must be met:
+   * 1. The codec must support updating the stream id of requests and responses. See
+   *    Request::setStreamId() and Response::setStreamId().
+   * 2. The response must carry the stream id of its request.
+   *
+   * This option is ignored if bindUpstreamConnection() is true.
+   */
+  bool multiplexUpstreamConnection() const { return multiplex_upstream_connection_; }
+
 private:
   bool bind_upstream_connection_{false};
+  bool multiplex_upstream_connection_{false};
 };
 
 /**
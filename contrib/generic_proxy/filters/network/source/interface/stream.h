@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/pure.h"
 #include "envoy/tracing/trace_context.h"
 
@@ -80,6 +81,26 @@ public:
  */
 class Request : public Tracing::TraceContext {
 public:
+  /**
+   * Get the raw frame that the request was decoded from. Codecs may keep the frame to let the
+   * generic proxy forward the request by moving the buffer slices of the frame instead of
+   * encoding the request again. The frame must be dropped by the codec once the request is
+   * modified, and is drained when it is forwarded.
+   *
+   * @return the raw frame or nullptr if the codec doesn't keep it.
+   */
+  virtual Buffer::Instance* rawFrame() { return nullptr; }
+
+  /**
+   * Update the stream id of the request, in the raw frame too if it is kept. This is required to
+   * multiplex the requests of different downstream connections on the same upstream connection.
+   * See ProtocolOptions::multiplexUpstreamConnection().
+   *
+   * @param stream_id supplies the new stream id.
+   * @return false if the codec doesn't support updating the stream id.
+   */
+  virtual bool setStreamId(uint64_t) { return false; }
+
   // Used for matcher.
   static constexpr absl::string_view name() { return "generic_proxy"; }
 };
@@ -106,6 +127,22 @@ public:
    * @return generic response status.
    */
   virtual Status status() const PURE;
+
+  /**
+   * Get the raw frame that the response was decoded from. See Request::rawFrame().
+   *
+   * @return the raw frame or nullptr if the codec doesn't keep it.
+   */
+  virtual Buffer::Instance* rawFrame() { return nullptr; }
+
+  /**
+   * Update the stream id of the response, in the raw frame too if it is kept. See
+   * Request::setStreamId().
+   *
+   * @param stream_id supplies the new stream id.
+   * @return false if the codec doesn't support updating the stream id.
+   */
+  virtual bool setStreamId(uint64_t) { return false; }
 };
 
 using ResponsePtr = std::unique_ptr<Response>;
@@ -363,6 +363,12 @@ void Filter::writeToConnection(Buffer::Instance& data) {
 }
 
 void Filter::sendReplyDownstream(Response& response, ResponseEncoderCallback& callback) {
+  // Forward the raw frame of the response as is if the codec keeps it.
+  if (Buffer::Instance* raw_frame = response.rawFrame();
+      raw_frame != nullptr && raw_frame->length() > 0) {
+    callback.onEncodingSuccess(*raw_frame);
+    return;
+  }
   response_encoder_->encode(response, callback);
 }
 
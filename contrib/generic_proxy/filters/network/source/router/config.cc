@@ -11,8 +11,16 @@ namespace Router {
 FilterFactoryCb
 RouterFactory::createFilterFactoryFromProto(const Protobuf::Message&, const std::string&,
                                             Server::Configuration::FactoryContext& context) {
-  return [&context](FilterChainFactoryCallbacks& callbacks) {
-    callbacks.addDecoderFilter(std::make_shared<RouterFilter>(context));
+  // The upstream connections that are shared when the codec enables the upstream connection
+  // multiplexing.
+  SharedUpstreamManagersSlotSharedPtr shared_upstream_managers =
+      SharedUpstreamManagersSlot::makeUnique(context.threadLocal());
+  shared_upstream_managers->set([](Envoy::Event::Dispatcher& dispatcher) {
+    return std::make_shared<SharedUpstreamManagers>(dispatcher);
+  });
+
+  return [&context, shared_upstream_managers](FilterChainFactoryCallbacks& callbacks) {
+    callbacks.addDecoderFilter(std::make_shared<RouterFilter>(context, shared_upstream_managers));
   };
 }
 
@@ -46,10 +46,222 @@ void UpstreamManagerImpl::onPoolFailureImpl(ConnectionPool::PoolFailureReason re
 
 void UpstreamManagerImpl::setResponseCallback() { response_decoder_->setDecoderCallback(parent_); }
 
+SharedUpstreamManagerImpl::SharedUpstreamManagerImpl(SharedUpstreamManagers& parent,
+                                                     Upstream::TcpPoolData&& tcp_pool_data,
+                                                     ResponseDecoderPtr&& response_decoder)
+    : UpstreamConnection(std::move(tcp_pool_data), std::move(response_decoder)), parent_(parent),
+      pool_(tcp_pool_data_.pool()) {
+  response_decoder_->setDecoderCallback(*this);
+}
+
+uint64_t SharedUpstreamManagerImpl::newStreamId() {
+  while (registered_upstream_callbacks_.contains(next_stream_id_) ||
+         registered_response_callbacks_.contains(next_stream_id_)) {
+    next_stream_id_++;
+  }
+  return next_stream_id_++;
+}
+
+void SharedUpstreamManagerImpl::registerUpstreamCallback(uint64_t stream_id,
+                                                         UpstreamBindingCallback& cb) {
+  // Connection is already ready and use it directly.
+  if (owned_conn_data_ != nullptr) {
+    cb.onBindSuccess(owned_conn_data_->connection(), upstream_host_);
+    return;
+  }
+
+  ASSERT(!registered_upstream_callbacks_.contains(stream_id));
+  registered_upstream_callbacks_[stream_id] = &cb;
+
+  // The upstream connection is created when the first request is registered. This may call
+  // onPoolSuccessImpl()/onPoolFailureImpl() directly.
+  if (tcp_pool_handle_ == nullptr) {
+    newConnection();
+  }
+}
+
+void SharedUpstreamManagerImpl::unregisterUpstreamCallback(uint64_t stream_id) {
+  registered_upstream_callbacks_.erase(stream_id);
+  removeIfIdle();
+}
+
+void SharedUpstreamManagerImpl::registerResponseCallback(uint64_t stream_id,
+                                                         PendingResponseCallback& cb) {
+  ASSERT(!registered_response_callbacks_.contains(stream_id));
+  registered_response_callbacks_[stream_id] = &cb;
+}
+
+void SharedUpstreamManagerImpl::unregisterResponseCallback(uint64_t stream_id) {
+  // The request is reset before its response arrives. The response may still be sent by the
+  // upstream later, so the connection can not be reused by other requests of the pool.
+  if (registered_response_callbacks_.erase(stream_id) > 0) {
+    has_abandoned_responses_ = true;
+  }
+  removeIfIdle();
+}
+
+void SharedUpstreamManagerImpl::removeIfIdle() {
+  if (!registered_upstream_callbacks_.empty() || !registered_response_callbacks_.empty()) {
+    return;
+  }
+
+  // Remove the idle connection so that its host is not kept alive by the registry after the host
+  // is removed from the cluster. The connection is released to the connection pool if it is
+  // clean, so the following requests can reuse it.
+  ENVOY_LOG(debug, "generic proxy shared upstream: no pending requests, remove the connection");
+  parent_.remove(*this, draining_ || has_abandoned_responses_);
+}
+
+void SharedUpstreamManagerImpl::onEventImpl(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::Connected ||
+      event == Network::ConnectionEvent::ConnectedZeroRtt) {
+    return;
+  }
+
+  ENVOY_LOG(debug, "generic proxy shared upstream: connection closed");
+  ASSERT(registered_upstream_callbacks_.empty());
+
+  // Remove this connection first to ensure new requests will not be sent to it.
+  parent_.remove(*this);
+
+  while (!registered_response_callbacks_.empty()) {
+    auto it = registered_response_callbacks_.begin();
+    auto* cb = it->second;
+    registered_response_callbacks_.erase(it);
+
+    cb->onConnectionClose(event);
+  }
+}
+
+void SharedUpstreamManagerImpl::onPoolSuccessImpl() {
+  ASSERT(registered_response_callbacks_.empty());
+
+  while (!registered_upstream_callbacks_.empty()) {
+    auto it = registered_upstream_callbacks_.begin();
+    auto* cb = it->second;
+    registered_upstream_callbacks_.erase(it);
+
+    cb->onBindSuccess(owned_conn_data_->connection(), upstream_host_);
+  }
+}
+
+void SharedUpstreamManagerImpl::onPoolFailureImpl(ConnectionPool::PoolFailureReason reason,
+                                                  absl::string_view transport_failure_reason) {
+  ASSERT(registered_response_callbacks_.empty());
+
+  // Remove this connection first to ensure the following requests will create a new connection.
+  parent_.remove(*this);
+
+  while (!registered_upstream_callbacks_.empty()) {
+    auto it = registered_upstream_callbacks_.begin();
+    auto* cb = it->second;
+    registered_upstream_callbacks_.erase(it);
+
+    cb->onBindFailure(reason, transport_failure_reason, upstream_host_);
+  }
+}
+
+void SharedUpstreamManagerImpl::onDecodingSuccess(ResponsePtr response, ExtendedOptions options) {
+  const uint64_t stream_id = options.streamId().value_or(0);
+
+  auto it = registered_response_callbacks_.find(stream_id);
+  if (it == registered_response_callbacks_.end()) {
+    // This is expected for the late responses of the reset requests.
+    ENVOY_LOG_EVERY_POW_2(warn, "generic proxy shared upstream: stream_id {} not found",
+                          stream_id);
+    return;
+  }
+
+  auto* cb = it->second;
+  registered_response_callbacks_.erase(it);
+
+  // The upstream asks to close the connection. Keep it for the pending requests only.
+  if (options.drainClose()) {
+    draining_ = true;
+    parent_.drain(*this);
+  }
+
+  cb->onDecodingSuccess(std::move(response), options);
+
+  removeIfIdle();
+}
+
+void SharedUpstreamManagerImpl::onDecodingFailure() {
+  ASSERT(registered_upstream_callbacks_.empty());
+
+  ENVOY_LOG(error, "generic proxy shared upstream: decoding failure");
+
+  // The stream ids of the following responses can not be trusted anymore. Close the connection
+  // and reset all pending requests.
+  parent_.remove(*this);
+
+  while (!registered_response_callbacks_.empty()) {
+    auto it = registered_response_callbacks_.begin();
+    auto* cb = it->second;
+    registered_response_callbacks_.erase(it);
+
+    cb->onDecodingFailure();
+  }
+}
+
+void SharedUpstreamManagerImpl::writeToConnection(Buffer::Instance& buffer) {
+  if (is_cleaned_up_) {
+    return;
+  }
+
+  if (owned_conn_data_ != nullptr) {
+    ASSERT(owned_conn_data_->connection().state() == Network::Connection::State::Open);
+    owned_conn_data_->connection().write(buffer, false);
+  }
+}
+
+SharedUpstreamManagerImpl&
+SharedUpstreamManagers::getOrCreate(Upstream::TcpPoolData&& tcp_pool_data,
+                                    const CodecFactory& codec_factory) {
+  auto& manager = active_managers_[&tcp_pool_data.pool()];
+  if (manager == nullptr) {
+    manager = std::make_unique<SharedUpstreamManagerImpl>(*this, std::move(tcp_pool_data),
+                                                          codec_factory.responseDecoder());
+  }
+  return *manager;
+}
+
+void SharedUpstreamManagers::drain(SharedUpstreamManagerImpl& manager) {
+  auto it = active_managers_.find(&manager.pool_);
+  if (it == active_managers_.end() || it->second.get() != &manager) {
+    return;
+  }
+  draining_managers_[&manager] = std::move(it->second);
+  active_managers_.erase(it);
+}
+
+void SharedUpstreamManagers::remove(SharedUpstreamManagerImpl& manager, bool close_connection) {
+  std::unique_ptr<SharedUpstreamManagerImpl> removed;
+
+  if (auto active = active_managers_.find(&manager.pool_);
+      active != active_managers_.end() && active->second.get() == &manager) {
+    removed = std::move(active->second);
+    active_managers_.erase(active);
+  } else if (auto draining = draining_managers_.find(&manager);
+             draining != draining_managers_.end()) {
+    removed = std::move(draining->second);
+    draining_managers_.erase(draining);
+  }
+
+  // The manager is already removed.
+  if (removed == nullptr) {
+    return;
+  }
+
+  removed->cleanUp(close_connection);
+  dispatcher_.deferredDelete(std::move(removed));
+}
+
 UpstreamRequest::UpstreamRequest(RouterFilter& parent,
-                                 absl::optional<Upstream::TcpPoolData> tcp_pool_data)
+                                 absl::optional<Upstream::TcpPoolData> tcp_pool_data,
+                                 SharedUpstreamManagerImpl* shared_upstream_manager)
     : parent_(parent), decoder_callbacks_(*parent_.callbacks_),
-      tcp_pool_data_(std::move(tcp_pool_data)),
+      tcp_pool_data_(std::move(tcp_pool_data)), shared_upstream_manager_(shared_upstream_manager),
       stream_info_(parent.context_.mainThreadDispatcher().timeSource(), nullptr) {
 
   // Set the upstream info for the stream info.
@@ -61,7 +273,10 @@ UpstreamRequest::UpstreamRequest(RouterFilter& parent,
   // Set request options.
   auto options = decoder_callbacks_.requestOptions();
   ASSERT(options.has_value());
-  stream_id_ = options->streamId().value_or(0);
+  downstream_stream_id_ = options->streamId();
+  stream_id_ = downstream_stream_id_.value_or(0);
+  upstream_stream_id_ =
+      shared_upstream_manager_ != nullptr ? shared_upstream_manager_->newStreamId() : stream_id_;
   wait_response_ = options->waitResponse();
 
   // Set tracing config.
@@ -74,13 +289,21 @@ UpstreamRequest::UpstreamRequest(RouterFilter& parent,
   }
 }
 
+OptRef<UpstreamManager> UpstreamRequest::upstreamConnManager() {
+  if (shared_upstream_manager_ != nullptr) {
+    return {*shared_upstream_manager_};
+  }
+  return decoder_callbacks_.boundUpstreamConn();
+}
+
 void UpstreamRequest::startStream() {
   if (!tcp_pool_data_.has_value()) {
     // Iff the upstream connection binding is enabled, the upstream connection should be
-    // managed by the generic proxy directly. Then register the upstream callbacks to the
-    // generic proxy and wait for the bound upstream connection.
-    ASSERT(decoder_callbacks_.boundUpstreamConn().has_value());
-    decoder_callbacks_.boundUpstreamConn()->registerUpstreamCallback(stream_id_, *this);
+    // managed by the generic proxy directly. Iff the upstream connection multiplexing is
+    // enabled, the upstream connection is shared by the worker. Then register the upstream
+    // callbacks to the upstream manager and wait for the upstream connection.
+    ASSERT(upstreamConnManager().has_value());
+    upstreamConnManager()->registerUpstreamCallback(upstream_stream_id_, *this);
     return;
   }
 
@@ -106,12 +329,13 @@ void UpstreamRequest::resetStream(StreamResetReason reason) {
     decoder_callbacks_.dispatcher().deferredDelete(std::move(upstream_manager_));
     upstream_manager_ = nullptr;
   } else {
-    // If the upstream connection is not managed by the generic proxy, we should unregister
-    // the related callbacks from the generic proxy.
-    ASSERT(decoder_callbacks_.boundUpstreamConn().has_value());
-    decoder_callbacks_.boundUpstreamConn()->unregisterUpstreamCallback(stream_id_);
-    decoder_callbacks_.boundUpstreamConn()->unregisterResponseCallback(stream_id_);
+    // If the upstream connection is not managed by the upstream request self, we should
+    // unregister the related callbacks from the upstream manager.
+    ASSERT(upstreamConnManager().has_value());
+    upstreamConnManager()->unregisterUpstreamCallback(upstream_stream_id_);
+    upstreamConnManager()->unregisterResponseCallback(upstream_stream_id_);
   }
+  releaseRequestResource();
 
   if (span_ != nullptr) {
     span_->setTag(Tracing::Tags::get().Error, Tracing::Tags::get().True);
@@ -143,12 +367,24 @@ void UpstreamRequest::clearStream(bool close_connection) {
     upstream_manager_->cleanUp(close_connection);
     decoder_callbacks_.dispatcher().deferredDelete(std::move(upstream_manager_));
     upstream_manager_ = nullptr;
+  } else if (shared_upstream_manager_ != nullptr) {
+    // The response callback is already removed if the response is received. This lets the shared
+    // upstream connection be removed if it is idle.
+    shared_upstream_manager_->unregisterResponseCallback(upstream_stream_id_);
   }
+  releaseRequestResource();
 
   // Remove this stream form the parent's list because this upstream request is complete.
   deferredDelete();
 }
 
+void UpstreamRequest::releaseRequestResource() {
+  if (request_resource_acquired_) {
+    request_resource_acquired_ = false;
+    parent_.cluster_->resourceManager(Upstream::ResourcePriority::Default).requests().dec();
+  }
+}
+
 void UpstreamRequest::deferredDelete() {
   if (inserted()) {
     // Remove this stream from the parent's list of upstream requests and delete it at
@@ -161,6 +397,11 @@ void UpstreamRequest::onEncodingSuccess(Buffer::Instance& buffer) {
   ENVOY_LOG(debug, "upstream request encoding success");
   encodeBufferToUpstream(buffer);
 
+  if (shared_upstream_manager_ != nullptr) {
+    // Restore the downstream stream id of the request in case of a local reply.
+    parent_.request_->setStreamId(stream_id_);
+  }
+
   // Need not to wait for the upstream response and complete directly.
   if (!wait_response_) {
     clearStream(false);
@@ -169,12 +410,11 @@ void UpstreamRequest::onEncodingSuccess(Buffer::Instance& buffer) {
   }
 
   // If the upstream connection manager is null, it means the upstream
-  // connection is managed by the generic proxy directly. Register the
-  // response callback to the generic proxy and wait for the upstream
-  // response.
+  // connection is bound or shared. Register the response callback to the
+  // upstream manager and wait for the upstream response.
   if (upstream_manager_ == nullptr) {
-    ASSERT(decoder_callbacks_.boundUpstreamConn().has_value());
-    decoder_callbacks_.boundUpstreamConn()->registerResponseCallback(stream_id_, *this);
+    ASSERT(upstreamConnManager().has_value());
+    upstreamConnManager()->registerResponseCallback(upstream_stream_id_, *this);
   } else {
     upstream_manager_->setResponseCallback();
   }
@@ -198,7 +438,9 @@ void UpstreamRequest::onBindFailure(ConnectionPool::PoolFailureReason reason, ab
 void UpstreamRequest::onBindSuccess(Network::ClientConnection& conn,
                                     Upstream::HostDescriptionConstSharedPtr host) {
   ENVOY_LOG(debug, "upstream request: {} tcp connection has ready",
-            upstream_manager_ != nullptr ? "owned" : "bound");
+            upstream_manager_ != nullptr
+                ? "owned"
+                : (shared_upstream_manager_ != nullptr ? "shared" : "bound"));
 
   onUpstreamHostSelected(std::move(host));
   upstream_conn_ = &conn;
@@ -207,10 +449,47 @@ void UpstreamRequest::onBindSuccess(Network::ClientConnection& conn,
     span_->injectContext(*parent_.request_, upstream_host_);
   }
 
+  if (shared_upstream_manager_ != nullptr) {
+    // The requests on the shared upstream connection are not limited by the connection pool, so
+    // apply the max requests limit of the cluster before sending the request.
+    auto& requests =
+        parent_.cluster_->resourceManager(Upstream::ResourcePriority::Default).requests();
+    if (!requests.canCreate()) {
+      ENVOY_LOG(debug, "upstream request: max requests overflow of shared upstream connection");
+      parent_.cluster_->trafficStats()->upstream_rq_pending_overflow_.inc();
+      resetStream(StreamResetReason::Overflow);
+      return;
+    }
+    requests.inc();
+    request_resource_acquired_ = true;
+
+    if (!parent_.request_->setStreamId(upstream_stream_id_)) {
+      ENVOY_LOG(error, "upstream request: codec doesn't support updating the stream id");
+      resetStream(StreamResetReason::ProtocolError);
+      return;
+    }
+  }
+
+  // Forward the raw frame of the request as is if the codec keeps it.
+  if (Buffer::Instance* raw_frame = parent_.request_->rawFrame();
+      raw_frame != nullptr && raw_frame->length() > 0) {
+    onEncodingSuccess(*raw_frame);
+    return;
+  }
+
   parent_.request_encoder_->encode(*parent_.request_, *this);
 }
 
 void UpstreamRequest::onDecodingSuccess(ResponsePtr response, ExtendedOptions options) {
+  if (shared_upstream_manager_ != nullptr) {
+    // Restore the downstream stream id of the response. The drain close of the shared upstream
+    // connection is handled by the shared upstream manager and is not propagated to the
+    // downstream connection.
+    response->setStreamId(stream_id_);
+    options = ExtendedOptions(downstream_stream_id_, options.waitResponse(), false,
+                              options.isHeartbeat());
+  }
+
   clearStream(options.drainClose());
   parent_.onUpstreamResponse(std::move(response), options);
 }
@@ -371,6 +650,20 @@ void RouterFilter::kickOffNewUpstreamRequest() {
     return;
   }
 
+  if (protocol_options_.multiplexUpstreamConnection() && shared_upstream_managers_ != nullptr) {
+    // Upstream connection multiplexing is enabled. Send the request on the upstream connection
+    // to the selected host that is shared by all downstream connections of the worker.
+    auto& shared_upstream_manager = (*shared_upstream_managers_)
+                                        ->getOrCreate(std::move(pool_data.value()),
+                                                      callbacks_->downstreamCodec());
+    auto upstream_request =
+        std::make_unique<UpstreamRequest>(*this, absl::nullopt, &shared_upstream_manager);
+    auto raw_upstream_request = upstream_request.get();
+    LinkedList::moveIntoList(std::move(upstream_request), upstream_requests_);
+    raw_upstream_request->startStream();
+    return;
+  }
+
   // Normal upstream request.
   auto upstream_request = std::make_unique<UpstreamRequest>(*this, std::move(pool_data.value()));
   auto raw_upstream_request = upstream_request.get();
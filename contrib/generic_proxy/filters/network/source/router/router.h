@@ -2,12 +2,15 @@
 
 #include "envoy/network/connection.h"
 #include "envoy/server/factory_context.h"
+#include "envoy/thread_local/thread_local.h"
+#include "envoy/thread_local/thread_local_object.h"
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/linked_object.h"
 #include "source/common/stream_info/stream_info_impl.h"
 #include "source/common/upstream/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "contrib/generic_proxy/filters/network/source/interface/codec.h"
 #include "contrib/generic_proxy/filters/network/source/interface/filter.h"
 #include "contrib/generic_proxy/filters/network/source/interface/stream.h"
@@ -57,6 +60,109 @@ public:
   UpstreamRequest& parent_;
 };
 
+class SharedUpstreamManagers;
+
+/**
+ * Upstream connection that is shared by the requests of all downstream connections of a worker.
+ * The requests are multiplexed on the connection: every request is sent with a stream id that is
+ * unique on the connection and the responses are matched to the requests by the stream id.
+ */
+class SharedUpstreamManagerImpl : public UpstreamConnection,
+                                  public UpstreamManager,
+                                  public ResponseDecoderCallback {
+public:
+  SharedUpstreamManagerImpl(SharedUpstreamManagers& parent, Upstream::TcpPoolData&& tcp_pool_data,
+                            ResponseDecoderPtr&& response_decoder);
+
+  /**
+   * @return a stream id that is not used by any pending request on this connection.
+   */
+  uint64_t newStreamId();
+
+  // UpstreamConnection
+  void onEventImpl(Network::ConnectionEvent event) override;
+  void onPoolSuccessImpl() override;
+  void onPoolFailureImpl(ConnectionPool::PoolFailureReason reason,
+                         absl::string_view transport_failure_reason) override;
+
+  // ResponseDecoderCallback
+  void onDecodingSuccess(ResponsePtr response, ExtendedOptions options) override;
+  void onDecodingFailure() override;
+  void writeToConnection(Buffer::Instance& buffer) override;
+
+  // UpstreamManager
+  void registerUpstreamCallback(uint64_t stream_id, UpstreamBindingCallback& cb) override;
+  void unregisterUpstreamCallback(uint64_t stream_id) override;
+  void registerResponseCallback(uint64_t stream_id, PendingResponseCallback& cb) override;
+  void unregisterResponseCallback(uint64_t stream_id) override;
+
+  // Remove the connection from the registry if there is no pending request on it.
+  void removeIfIdle();
+
+  SharedUpstreamManagers& parent_;
+  // The connection pool which the connection is taken from, which is also its key in the
+  // SharedUpstreamManagers.
+  const Tcp::ConnectionPool::Instance& pool_;
+
+  // Stream ids are allocated in increasing order, so a late response to a reset request is not
+  // matched to a new request.
+  uint64_t next_stream_id_{};
+  bool draining_{};
+  // Whether a request was reset while waiting for its response.
+  bool has_abandoned_responses_{};
+
+  absl::flat_hash_map<uint64_t, PendingResponseCallback*> registered_response_callbacks_;
+  absl::flat_hash_map<uint64_t, UpstreamBindingCallback*> registered_upstream_callbacks_;
+};
+
+/**
+ * Per worker registry of the shared upstream connections, one per connection pool. The cluster
+ * manager creates a pool per upstream host and per set of socket options and transport socket
+ * options, so requests only share a connection if they would have been given connections from
+ * the same pool. A connection is removed once it has no pending requests, so the registry doesn't
+ * keep removed hosts or idle connections alive.
+ */
+class SharedUpstreamManagers : public ThreadLocal::ThreadLocalObject {
+public:
+  SharedUpstreamManagers(Envoy::Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+  /**
+   * Get the shared upstream connection of the connection pool, or create it if there is none. The
+   * connection is established when the first request is registered.
+   * @param tcp_pool_data supplies the connection pool of the selected host.
+   * @param codec_factory supplies the codec factory to create the response decoder.
+   */
+  SharedUpstreamManagerImpl& getOrCreate(Upstream::TcpPoolData&& tcp_pool_data,
+                                         const CodecFactory& codec_factory);
+
+  /**
+   * Stop handing out the connection to new requests. The connection is kept for the pending
+   * requests until it is removed.
+   */
+  void drain(SharedUpstreamManagerImpl& manager);
+
+  /**
+   * Clean up the connection and delete it at the next event loop iteration. This is safe to call
+   * multiple times.
+   * @param close_connection supplies whether to close the upstream connection or to release it
+   * to the connection pool.
+   */
+  void remove(SharedUpstreamManagerImpl& manager, bool close_connection = true);
+
+  size_t sizeForTest() const { return active_managers_.size() + draining_managers_.size(); }
+
+private:
+  Envoy::Event::Dispatcher& dispatcher_;
+
+  absl::flat_hash_map<const Tcp::ConnectionPool::Instance*,
+                      std::unique_ptr<SharedUpstreamManagerImpl>>
+      active_managers_;
+  absl::flat_hash_map<const SharedUpstreamManagerImpl*, std::unique_ptr<SharedUpstreamManagerImpl>>
+      draining_managers_;
+};
+using SharedUpstreamManagersSlot = ThreadLocal::TypedSlot<SharedUpstreamManagers>;
+using SharedUpstreamManagersSlotSharedPtr = std::shared_ptr<SharedUpstreamManagersSlot>;
+
 class UpstreamRequest : public UpstreamBindingCallback,
                         public LinkedObject<UpstreamRequest>,
                         public Envoy::Event::DeferredDeletable,
@@ -64,7 +170,8 @@ class UpstreamRequest : public UpstreamBindingCallback,
                         public PendingResponseCallback,
                         Logger::Loggable<Envoy::Logger::Id::filter> {
 public:
-  UpstreamRequest(RouterFilter& parent, absl::optional<Upstream::TcpPoolData> tcp_data);
+  UpstreamRequest(RouterFilter& parent, absl::optional<Upstream::TcpPoolData> tcp_data,
+                  SharedUpstreamManagerImpl* shared_upstream_manager = nullptr);
 
   void startStream();
   void resetStream(StreamResetReason reason);
@@ -72,6 +179,8 @@ public:
 
   // Called when the stream has been reset or completed.
   void deferredDelete();
+  // Release the request of the cluster's max requests limit if it is held by this request.
+  void releaseRequestResource();
 
   // UpstreamBindingCallback
   void onBindFailure(ConnectionPool::PoolFailureReason reason,
@@ -92,16 +201,28 @@ public:
   void onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host);
   void encodeBufferToUpstream(Buffer::Instance& buffer);
 
+  // The upstream manager of the bound or shared upstream connection if the upstream connection
+  // isn't owned by this request.
+  OptRef<UpstreamManager> upstreamConnManager();
+
   bool stream_reset_{};
 
   RouterFilter& parent_;
   DecoderFilterCallback& decoder_callbacks_;
 
+  absl::optional<uint64_t> downstream_stream_id_;
   uint64_t stream_id_{};
+  // The stream id used on the upstream connection. This differs from the downstream stream id
+  // only if the upstream connection is shared.
+  uint64_t upstream_stream_id_{};
   bool wait_response_{};
 
   absl::optional<Upstream::TcpPoolData> tcp_pool_data_;
   std::unique_ptr<UpstreamManagerImpl> upstream_manager_;
+  SharedUpstreamManagerImpl* shared_upstream_manager_{};
+  // Whether this request counts against the max requests limit of the cluster. This is only
+  // the case for the requests on a shared upstream connection.
+  bool request_resource_acquired_{};
 
   Network::ClientConnection* upstream_conn_{};
   Upstream::HostDescriptionConstSharedPtr upstream_host_;
@@ -121,7 +242,9 @@ class RouterFilter : public DecoderFilter,
                      public Upstream::LoadBalancerContextBase,
                      Logger::Loggable<Envoy::Logger::Id::filter> {
 public:
-  RouterFilter(Server::Configuration::FactoryContext& context) : context_(context) {}
+  RouterFilter(Server::Configuration::FactoryContext& context,
+               SharedUpstreamManagersSlotSharedPtr shared_upstream_managers = nullptr)
+      : shared_upstream_managers_(std::move(shared_upstream_managers)), context_(context) {}
 
   // DecoderFilter
   void onDestroy() override;
@@ -166,6 +289,8 @@ private:
   DecoderFilterCallback* callbacks_{};
   ProtocolOptions protocol_options_;
 
+  SharedUpstreamManagersSlotSharedPtr shared_upstream_managers_;
+
   Server::Configuration::FactoryContext& context_;
 };
 
@@ -8,11 +8,15 @@ namespace NetworkFilters {
 namespace GenericProxy {
 
 RequestDecoderPtr FakeStreamCodecFactory::requestDecoder() const {
-  return std::make_unique<FakeRequestDecoder>();
+  auto decoder = std::make_unique<FakeRequestDecoder>();
+  decoder->keep_raw_frame_ = keep_raw_frame_;
+  return decoder;
 }
 
 ResponseDecoderPtr FakeStreamCodecFactory::responseDecoder() const {
-  return std::make_unique<FakeResponseDecoder>();
+  auto decoder = std::make_unique<FakeResponseDecoder>();
+  decoder->keep_raw_frame_ = keep_raw_frame_;
+  return decoder;
 }
 RequestEncoderPtr FakeStreamCodecFactory::requestEncoder() const {
   return std::make_unique<FakeRequestEncoder>();
@@ -26,6 +26,8 @@ public:
     return absl::make_optional<absl::string_view>(iter->second);
   }
   void setByKey(absl::string_view key, absl::string_view val) override {
+    // The raw frame is out of date once the stream is modified.
+    raw_frame_.drain(raw_frame_.length());
     data_[key] = std::string(val);
   }
   void setByReferenceKey(absl::string_view key, absl::string_view val) override {
@@ -33,7 +35,15 @@ public:
   }
   void setByReference(absl::string_view key, absl::string_view val) override { setByKey(key, val); }
 
+  Buffer::Instance* rawFrame() override { return raw_frame_.length() > 0 ? &raw_frame_ : nullptr; }
+  bool setStreamId(uint64_t stream_id) override {
+    setByKey("stream_id", absl::StrCat(stream_id));
+    return true;
+  }
+
   absl::flat_hash_map<std::string, std::string> data_;
+  // The raw frame is only kept if the decoder is configured to keep it.
+  Buffer::OwnedImpl raw_frame_;
 };
 
 /**
@@ -74,7 +84,13 @@ public:
     bool parseRequestBody() {
       std::string body(message_size_.value(), 0);
       buffer_.copyOut(0, message_size_.value(), body.data());
-      buffer_.drain(message_size_.value());
+      Buffer::OwnedImpl raw_frame;
+      if (keep_raw_frame_) {
+        raw_frame.writeBEInt<uint32_t>(message_size_.value());
+        raw_frame.move(buffer_, message_size_.value());
+      } else {
+        buffer_.drain(message_size_.value());
+      }
       message_size_.reset();
 
       std::vector<absl::string_view> result = absl::StrSplit(body, '|');
@@ -101,6 +117,7 @@ public:
         wait_response = it->second == "true";
       }
       ExtendedOptions request_options{stream_id, wait_response, false, false};
+      request->raw_frame_.move(raw_frame);
 
       callback_->onDecodingSuccess(std::move(request), request_options);
       return true;
@@ -134,6 +151,7 @@ public:
     absl::optional<uint32_t> message_size_;
     Buffer::OwnedImpl buffer_;
     RequestDecoderCallback* callback_{};
+    bool keep_raw_frame_{};
   };
 
   class FakeResponseDecoder : public ResponseDecoder {
@@ -145,7 +163,14 @@ public:
 
       std::string body(message_size_.value(), 0);
       buffer_.copyOut(0, message_size_.value(), body.data());
-      buffer_.drain(message_size_.value());
+      Buffer::OwnedImpl raw_frame;
+      if (keep_raw_frame_) {
+        raw_frame.writeBEInt<uint32_t>(message_size_.value() + 4);
+        raw_frame.writeBEInt<int32_t>(status_code);
+        raw_frame.move(buffer_, message_size_.value());
+      } else {
+        buffer_.drain(message_size_.value());
+      }
       message_size_.reset();
 
       std::vector<absl::string_view> result = absl::StrSplit(body, '|');
@@ -171,6 +196,7 @@ public:
         close_connection = it->second == "true";
       }
       ExtendedOptions response_options{stream_id, false, close_connection, false};
+      response->raw_frame_.move(raw_frame);
 
       callback_->onDecodingSuccess(std::move(response), response_options);
       return true;
@@ -210,6 +236,7 @@ public:
     absl::optional<uint32_t> message_size_;
     Buffer::OwnedImpl buffer_;
     ResponseDecoderCallback* callback_{};
+    bool keep_raw_frame_{};
   };
 
   class FakeRequestEncoder : public RequestEncoder {
@@ -275,6 +302,8 @@ public:
   ProtocolOptions protocolOptions() const override;
 
   ProtocolOptions protocol_options_;
+  // Whether the decoders keep the raw frames of the decoded requests and responses.
+  bool keep_raw_frame_{};
 };
 
 class FakeStreamCodecFactoryConfig : public CodecFactoryConfig {
@@ -0,0 +1,98 @@
+// Measures the cost of forwarding decoded requests upstream, either by moving the raw frames kept
+// by the decoder or by encoding the requests again.
+
+#include "source/common/buffer/buffer_impl.h"
+
+#include "benchmark/benchmark.h"
+#include "contrib/generic_proxy/filters/network/test/fake_codec.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace GenericProxy {
+namespace {
+
+constexpr uint32_t NumFrames = 100;
+
+// Forwards every decoded request to the upstream buffer, as the router does when the upstream
+// connection is ready.
+class ForwardingCallback : public RequestDecoderCallback, public RequestEncoderCallback {
+public:
+  ForwardingCallback(Buffer::Instance& upstream) : upstream_(upstream) {}
+
+  // RequestDecoderCallback
+  void onDecodingSuccess(RequestPtr request, ExtendedOptions) override {
+    if (Buffer::Instance* raw_frame = request->rawFrame(); raw_frame != nullptr) {
+      upstream_.move(*raw_frame);
+      return;
+    }
+    encoder_.encode(*request, *this);
+  }
+  void onDecodingFailure() override { RELEASE_ASSERT(false, "unexpected decoding failure"); }
+  void writeToConnection(Buffer::Instance&) override {}
+
+  // RequestEncoderCallback
+  void onEncodingSuccess(Buffer::Instance& buffer) override { upstream_.move(buffer); }
+
+private:
+  Buffer::Instance& upstream_;
+  FakeStreamCodecFactory::FakeRequestEncoder encoder_;
+};
+
+// Encodes NumFrames requests with a body of the given size.
+void makeFrames(uint32_t body_size, Buffer::Instance& frames) {
+  struct EncoderCallback : public RequestEncoderCallback {
+    EncoderCallback(Buffer::Instance& frames) : frames_(frames) {}
+    void onEncodingSuccess(Buffer::Instance& buffer) override { frames_.move(buffer); }
+    Buffer::Instance& frames_;
+  };
+
+  EncoderCallback callback(frames);
+  FakeStreamCodecFactory::FakeRequestEncoder encoder;
+  for (uint32_t i = 0; i < NumFrames; i++) {
+    FakeStreamCodecFactory::FakeRequest request;
+    request.protocol_ = "fake_protocol";
+    request.host_ = "service_name_0";
+    request.path_ = "/path_or_method";
+    request.method_ = "method";
+    request.data_["stream_id"] = absl::StrCat(i);
+    request.data_["body"] = std::string(body_size, 'a');
+    encoder.encode(request, callback);
+  }
+}
+
+void forwardFrames(benchmark::State& state, bool keep_raw_frame) {
+  FakeStreamCodecFactory factory;
+  factory.keep_raw_frame_ = keep_raw_frame;
+  Buffer::OwnedImpl frames;
+  makeFrames(state.range(0), frames);
+
+  Buffer::OwnedImpl downstream;
+  Buffer::OwnedImpl upstream;
+  ForwardingCallback callback(upstream);
+  auto decoder = factory.requestDecoder();
+  decoder->setDecoderCallback(callback);
+  for (auto _ : state) { // NOLINT
+    // Copying the frames into the downstream buffer stands for the read from the downstream
+    // socket, which copies them too.
+    downstream.add(frames);
+    decoder->decode(downstream);
+    RELEASE_ASSERT(upstream.length() == frames.length(), "");
+    upstream.drain(upstream.length());
+  }
+  state.SetItemsProcessed(state.iterations() * NumFrames);
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ForwardEncodedFrames(benchmark::State& state) { forwardFrames(state, false); }
+BENCHMARK(BM_ForwardEncodedFrames)->Arg(64)->Arg(4096)->Arg(65536);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ForwardRawFrames(benchmark::State& state) { forwardFrames(state, true); }
+BENCHMARK(BM_ForwardRawFrames)->Arg(64)->Arg(4096)->Arg(65536);
+
+} // namespace
+} // namespace GenericProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -289,6 +289,37 @@ TEST_F(FilterTest, SendReplyDownstream) {
   filter_->sendReplyDownstream(*response, encoder_callback);
 }
 
+TEST_F(FilterTest, SendReplyDownstreamWithRawFrame) {
+  initializeFilter();
+
+  NiceMock<MockResponseEncoderCallback> encoder_callback;
+
+  auto response = std::make_unique<FakeStreamCodecFactory::FakeResponse>();
+  response->raw_frame_.add("raw_frame");
+
+  // The raw frame is forwarded as is and the response is not encoded again.
+  EXPECT_CALL(*encoder_, encode(_, _)).Times(0);
+  EXPECT_CALL(encoder_callback, onEncodingSuccess(BufferStringEqual("raw_frame")));
+
+  filter_->sendReplyDownstream(*response, encoder_callback);
+}
+
+TEST_F(FilterTest, SendReplyDownstreamWithModifiedRawFrame) {
+  initializeFilter();
+
+  NiceMock<MockResponseEncoderCallback> encoder_callback;
+
+  auto response = std::make_unique<FakeStreamCodecFactory::FakeResponse>();
+  response->raw_frame_.add("raw_frame");
+  // The raw frame is dropped once the response is modified.
+  response->setByKey("key", "value");
+  EXPECT_EQ(nullptr, response->rawFrame());
+
+  EXPECT_CALL(*encoder_, encode(_, _));
+
+  filter_->sendReplyDownstream(*response, encoder_callback);
+}
+
 TEST_F(FilterTest, GetConnection) {
   initializeFilter();
 
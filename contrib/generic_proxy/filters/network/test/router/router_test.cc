@@ -1,6 +1,7 @@
 #include "source/common/tracing/common_values.h"
 
 #include "test/mocks/server/factory_context.h"
+#include "test/mocks/tcp/mocks.h"
 #include "test/test_common/registry.h"
 #include "test/test_common/utility.h"
 
@@ -707,6 +708,329 @@ TEST_P(RouterFilterTest, UpstreamRequestPoolReadyAndResponseDecodingFailure) {
   notifyDecodingFailure();
 }
 
+class RouterFilterFakeCodecTest : public testing::Test {
+public:
+  struct DownstreamStream {
+    NiceMock<MockDecoderFilterCallback> callbacks_;
+    std::shared_ptr<RouterFilter> filter_;
+    FakeStreamCodecFactory::FakeRequest request_;
+  };
+
+  RouterFilterFakeCodecTest() {
+    shared_upstream_managers_ =
+        SharedUpstreamManagersSlot::makeUnique(factory_context_.thread_local_);
+    shared_upstream_managers_->set([](Envoy::Event::Dispatcher& dispatcher) {
+      return std::make_shared<SharedUpstreamManagers>(dispatcher);
+    });
+
+    factory_context_.cluster_manager_.initializeThreadLocalClusters({cluster_name_});
+    ON_CALL(mock_route_entry_, clusterName()).WillByDefault(ReturnRef(cluster_name_));
+  }
+
+  std::unique_ptr<DownstreamStream> newStream(uint64_t stream_id) {
+    auto stream = std::make_unique<DownstreamStream>();
+    ON_CALL(stream->callbacks_, dispatcher()).WillByDefault(ReturnRef(dispatcher_));
+    ON_CALL(stream->callbacks_, activeSpan()).WillByDefault(ReturnRef(active_span_));
+    ON_CALL(stream->callbacks_, downstreamCodec()).WillByDefault(ReturnRef(codec_factory_));
+    ON_CALL(stream->callbacks_, streamInfo()).WillByDefault(ReturnRef(stream_info_));
+    ON_CALL(stream->callbacks_, routeEntry()).WillByDefault(Return(&mock_route_entry_));
+    ON_CALL(stream->callbacks_, requestOptions())
+        .WillByDefault(Return(ExtendedOptions{stream_id, true, false, false}));
+
+    stream->request_.protocol_ = "fake_protocol";
+    stream->request_.data_["stream_id"] = absl::StrCat(stream_id);
+
+    stream->filter_ = std::make_shared<RouterFilter>(factory_context_, shared_upstream_managers_);
+    stream->filter_->setDecoderFilterCallbacks(stream->callbacks_);
+    return stream;
+  }
+
+  void encodeResponse(uint64_t stream_id, Buffer::Instance& buffer, bool close_connection = false) {
+    struct EncoderCallback : public ResponseEncoderCallback {
+      EncoderCallback(Buffer::Instance& buffer) : buffer_(buffer) {}
+      void onEncodingSuccess(Buffer::Instance& encoded) override { buffer_.move(encoded); }
+      Buffer::Instance& buffer_;
+    };
+
+    FakeStreamCodecFactory::FakeResponse response;
+    response.protocol_ = "fake_protocol";
+    response.data_["stream_id"] = absl::StrCat(stream_id);
+    if (close_connection) {
+      response.data_["close_connection"] = "true";
+    }
+    EncoderCallback callback(buffer);
+    FakeStreamCodecFactory::FakeResponseEncoder().encode(response, callback);
+  }
+
+  // Destroyed last because it is used by the upstream connections until they are destroyed.
+  NiceMock<Network::MockClientConnection> mock_upstream_connection_;
+
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context_;
+  NiceMock<Envoy::Event::MockDispatcher> dispatcher_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  NiceMock<Tracing::MockSpan> active_span_;
+  NiceMock<MockRouteEntry> mock_route_entry_;
+  const std::string cluster_name_{"cluster_0"};
+
+  FakeStreamCodecFactory codec_factory_;
+  SharedUpstreamManagersSlotSharedPtr shared_upstream_managers_;
+};
+
+TEST_F(RouterFilterFakeCodecTest, ForwardRawFrameOfRequest) {
+  auto stream = newStream(1);
+  stream->request_.raw_frame_.add("raw_frame");
+
+  auto& tcp_conn_pool = factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_;
+  EXPECT_CALL(tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream->filter_->onStreamDecoded(stream->request_));
+
+  // The raw frame is forwarded as is without encoding the request again.
+  EXPECT_CALL(mock_upstream_connection_, write(BufferStringEqual("raw_frame"), false));
+  tcp_conn_pool.poolReady(mock_upstream_connection_);
+}
+
+TEST_F(RouterFilterFakeCodecTest, MultiplexRequestsOfDifferentDownstreamConnections) {
+  codec_factory_.protocol_options_ = ProtocolOptions{false, true};
+
+  // Requests from different downstream connections with the same stream id.
+  auto stream_0 = newStream(1);
+  auto stream_1 = newStream(1);
+
+  // Only one upstream connection is created for both requests.
+  auto& tcp_conn_pool = factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_;
+  EXPECT_CALL(tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_0->filter_->onStreamDecoded(stream_0->request_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_1->filter_->onStreamDecoded(stream_1->request_));
+  EXPECT_EQ(1, (*shared_upstream_managers_)->sizeForTest());
+
+  auto* upstream_request_0 = stream_0->filter_->upstreamRequestsForTest().front().get();
+  auto* upstream_request_1 = stream_1->filter_->upstreamRequestsForTest().front().get();
+  auto* shared_upstream_manager = upstream_request_0->shared_upstream_manager_;
+  ASSERT_NE(nullptr, shared_upstream_manager);
+  EXPECT_EQ(shared_upstream_manager, upstream_request_1->shared_upstream_manager_);
+
+  // The requests are sent with different stream ids on the shared upstream connection.
+  EXPECT_EQ(0, upstream_request_0->upstream_stream_id_);
+  EXPECT_EQ(1, upstream_request_1->upstream_stream_id_);
+
+  std::vector<std::string> upstream_frames;
+  EXPECT_CALL(mock_upstream_connection_, write(_, false))
+      .Times(2)
+      .WillRepeatedly(Invoke([&upstream_frames](Buffer::Instance& buffer, bool) {
+        upstream_frames.push_back(buffer.toString());
+        buffer.drain(buffer.length());
+      }));
+  tcp_conn_pool.poolReady(mock_upstream_connection_);
+  EXPECT_THAT(upstream_frames, testing::UnorderedElementsAre(testing::HasSubstr("stream_id:0;"),
+                                                             testing::HasSubstr("stream_id:1;")));
+
+  // The downstream stream ids of the requests are restored.
+  EXPECT_EQ("1", stream_0->request_.getByKey("stream_id").value());
+  EXPECT_EQ("1", stream_1->request_.getByKey("stream_id").value());
+
+  // The responses are matched to the requests by the upstream stream ids and get the downstream
+  // stream ids back.
+  EXPECT_CALL(stream_1->callbacks_, upstreamResponse(_, _))
+      .WillOnce(Invoke([](ResponsePtr response, ExtendedOptions options) {
+        EXPECT_EQ(1, options.streamId().value());
+        EXPECT_EQ("1", response->getByKey("stream_id").value());
+      }));
+  Buffer::OwnedImpl response_1;
+  encodeResponse(1, response_1);
+  shared_upstream_manager->onUpstreamData(response_1, false);
+
+  EXPECT_CALL(stream_0->callbacks_, upstreamResponse(_, _))
+      .WillOnce(Invoke([](ResponsePtr response, ExtendedOptions options) {
+        EXPECT_EQ(1, options.streamId().value());
+        EXPECT_EQ("1", response->getByKey("stream_id").value());
+      }));
+  // The idle shared upstream connection is removed and released to the connection pool.
+  EXPECT_CALL(mock_upstream_connection_, close(_)).Times(0);
+  Buffer::OwnedImpl response_0;
+  encodeResponse(0, response_0);
+  shared_upstream_manager->onUpstreamData(response_0, false);
+  EXPECT_EQ(0, (*shared_upstream_managers_)->sizeForTest());
+}
+
+TEST_F(RouterFilterFakeCodecTest, SharedUpstreamConnectionCanceledIfNoPendingRequest) {
+  codec_factory_.protocol_options_ = ProtocolOptions{false, true};
+
+  auto stream_0 = newStream(1);
+
+  auto& tcp_conn_pool = factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_;
+  EXPECT_CALL(tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_0->filter_->onStreamDecoded(stream_0->request_));
+  EXPECT_EQ(1, (*shared_upstream_managers_)->sizeForTest());
+
+  // The only request is reset before the upstream connection is ready.
+  EXPECT_CALL(tcp_conn_pool.handles_.back(), cancel(_));
+  stream_0->filter_->onDestroy();
+  EXPECT_EQ(0, (*shared_upstream_managers_)->sizeForTest());
+}
+
+TEST_F(RouterFilterFakeCodecTest, SharedUpstreamConnectionClosedIfResponseAbandoned) {
+  codec_factory_.protocol_options_ = ProtocolOptions{false, true};
+
+  auto stream_0 = newStream(1);
+  auto stream_1 = newStream(2);
+
+  auto& tcp_conn_pool = factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_;
+  EXPECT_CALL(tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_0->filter_->onStreamDecoded(stream_0->request_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_1->filter_->onStreamDecoded(stream_1->request_));
+  auto* shared_upstream_manager =
+      stream_0->filter_->upstreamRequestsForTest().front()->shared_upstream_manager_;
+
+  EXPECT_CALL(mock_upstream_connection_, write(_, false)).Times(2);
+  tcp_conn_pool.poolReady(mock_upstream_connection_);
+
+  // The first request is reset while waiting for its response.
+  stream_0->filter_->onDestroy();
+  EXPECT_EQ(1, (*shared_upstream_managers_)->sizeForTest());
+
+  // The connection may still receive the response of the reset request, so it is closed rather
+  // than released to the connection pool once it is idle.
+  EXPECT_CALL(stream_1->callbacks_, upstreamResponse(_, _));
+  EXPECT_CALL(mock_upstream_connection_, close(Network::ConnectionCloseType::FlushWrite));
+  Buffer::OwnedImpl response_1;
+  encodeResponse(1, response_1);
+  shared_upstream_manager->onUpstreamData(response_1, false);
+  EXPECT_EQ(0, (*shared_upstream_managers_)->sizeForTest());
+}
+
+TEST_F(RouterFilterFakeCodecTest, SharedUpstreamConnectionMaxRequestsOverflow) {
+  codec_factory_.protocol_options_ = ProtocolOptions{false, true};
+  auto& cluster_info = factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_;
+  cluster_info->resetResourceManager(1024, 1024, 1, 3, 1024);
+  auto& requests = cluster_info->resourceManager(Upstream::ResourcePriority::Default).requests();
+
+  auto stream_0 = newStream(1);
+
+  auto& tcp_conn_pool = factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_;
+  EXPECT_CALL(tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_0->filter_->onStreamDecoded(stream_0->request_));
+  auto* shared_upstream_manager =
+      stream_0->filter_->upstreamRequestsForTest().front()->shared_upstream_manager_;
+
+  EXPECT_CALL(mock_upstream_connection_, write(_, false));
+  tcp_conn_pool.poolReady(mock_upstream_connection_);
+  EXPECT_EQ(1, requests.count());
+
+  // The second request exceeds the max requests of the cluster and is not sent.
+  auto stream_1 = newStream(2);
+  EXPECT_CALL(mock_upstream_connection_, write(_, false)).Times(0);
+  EXPECT_CALL(stream_1->callbacks_, sendLocalReply(_, _))
+      .WillOnce(Invoke([](Status status, ResponseUpdateFunction&&) {
+        EXPECT_EQ("overflow", status.message());
+      }));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_1->filter_->onStreamDecoded(stream_1->request_));
+  EXPECT_EQ(1, cluster_info->trafficStats()->upstream_rq_pending_overflow_.value());
+  EXPECT_EQ(1, requests.count());
+
+  // The request is released from the limit once its response is received.
+  EXPECT_CALL(stream_0->callbacks_, upstreamResponse(_, _));
+  Buffer::OwnedImpl response_0;
+  encodeResponse(0, response_0);
+  shared_upstream_manager->onUpstreamData(response_0, false);
+  EXPECT_EQ(0, requests.count());
+}
+
+// Requests given different connection pools of the same host, e.g. for different socket options,
+// don't share an upstream connection.
+TEST_F(RouterFilterFakeCodecTest, SharedUpstreamConnectionPerConnectionPool) {
+  codec_factory_.protocol_options_ = ProtocolOptions{false, true};
+
+  auto stream_0 = newStream(1);
+  auto stream_1 = newStream(2);
+
+  auto& thread_local_cluster = factory_context_.cluster_manager_.thread_local_cluster_;
+  auto& tcp_conn_pool = thread_local_cluster.tcp_conn_pool_;
+  NiceMock<Tcp::ConnectionPool::MockInstance> other_tcp_conn_pool;
+  ON_CALL(other_tcp_conn_pool, host()).WillByDefault(Return(tcp_conn_pool.host_));
+
+  EXPECT_CALL(tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_0->filter_->onStreamDecoded(stream_0->request_));
+  EXPECT_CALL(thread_local_cluster, tcpConnPool(_, _))
+      .WillOnce(Return(Upstream::TcpPoolData([]() {}, &other_tcp_conn_pool)));
+  EXPECT_CALL(other_tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_1->filter_->onStreamDecoded(stream_1->request_));
+
+  EXPECT_EQ(2, (*shared_upstream_managers_)->sizeForTest());
+  EXPECT_NE(stream_0->filter_->upstreamRequestsForTest().front()->shared_upstream_manager_,
+            stream_1->filter_->upstreamRequestsForTest().front()->shared_upstream_manager_);
+}
+
+TEST_F(RouterFilterFakeCodecTest, SharedUpstreamConnectionClosed) {
+  codec_factory_.protocol_options_ = ProtocolOptions{false, true};
+
+  auto stream_0 = newStream(1);
+
+  auto& tcp_conn_pool = factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_;
+  EXPECT_CALL(tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_0->filter_->onStreamDecoded(stream_0->request_));
+  auto* shared_upstream_manager =
+      stream_0->filter_->upstreamRequestsForTest().front()->shared_upstream_manager_;
+
+  EXPECT_CALL(mock_upstream_connection_, write(_, false));
+  tcp_conn_pool.poolReady(mock_upstream_connection_);
+
+  // The pending request is reset and the connection is removed.
+  EXPECT_CALL(stream_0->callbacks_, sendLocalReply(_, _))
+      .WillOnce(Invoke([](Status status, ResponseUpdateFunction&&) {
+        EXPECT_EQ("connection_termination", status.message());
+      }));
+  shared_upstream_manager->onEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_EQ(0, (*shared_upstream_managers_)->sizeForTest());
+
+  // The following request creates a new upstream connection.
+  auto stream_1 = newStream(2);
+  EXPECT_CALL(tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_1->filter_->onStreamDecoded(stream_1->request_));
+  EXPECT_EQ(1, (*shared_upstream_managers_)->sizeForTest());
+  EXPECT_NE(shared_upstream_manager,
+            stream_1->filter_->upstreamRequestsForTest().front()->shared_upstream_manager_);
+}
+
+TEST_F(RouterFilterFakeCodecTest, SharedUpstreamConnectionDrainClose) {
+  codec_factory_.protocol_options_ = ProtocolOptions{false, true};
+
+  auto stream_0 = newStream(1);
+  auto stream_1 = newStream(2);
+
+  auto& tcp_conn_pool = factory_context_.cluster_manager_.thread_local_cluster_.tcp_conn_pool_;
+  EXPECT_CALL(tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_0->filter_->onStreamDecoded(stream_0->request_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_1->filter_->onStreamDecoded(stream_1->request_));
+  auto* shared_upstream_manager =
+      stream_0->filter_->upstreamRequestsForTest().front()->shared_upstream_manager_;
+
+  EXPECT_CALL(mock_upstream_connection_, write(_, false)).Times(2);
+  tcp_conn_pool.poolReady(mock_upstream_connection_);
+
+  // The drain close of the upstream connection is not propagated to the downstream connection.
+  EXPECT_CALL(stream_0->callbacks_, upstreamResponse(_, _))
+      .WillOnce(Invoke([](ResponsePtr, ExtendedOptions options) {
+        EXPECT_FALSE(options.drainClose());
+      }));
+  Buffer::OwnedImpl response_0;
+  encodeResponse(0, response_0, true);
+  shared_upstream_manager->onUpstreamData(response_0, false);
+
+  // The draining connection is not used by new requests but is kept for the pending request.
+  auto stream_2 = newStream(3);
+  EXPECT_CALL(tcp_conn_pool, newConnection(_));
+  EXPECT_EQ(FilterStatus::StopIteration, stream_2->filter_->onStreamDecoded(stream_2->request_));
+  EXPECT_EQ(2, (*shared_upstream_managers_)->sizeForTest());
+
+  // The draining connection is closed after the last pending response.
+  EXPECT_CALL(stream_1->callbacks_, upstreamResponse(_, _));
+  EXPECT_CALL(mock_upstream_connection_, close(Network::ConnectionCloseType::FlushWrite));
+  Buffer::OwnedImpl response_1;
+  encodeResponse(1, response_1);
+  shared_upstream_manager->onUpstreamData(response_1, false);
+  EXPECT_EQ(1, (*shared_upstream_managers_)->sizeForTest());
+}
+
 } // namespace
 } // namespace Router
 } // namespace GenericProxy
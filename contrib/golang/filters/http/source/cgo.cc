@@ -114,6 +114,15 @@ CAPIStatus envoyGoFilterHttpRemoveHeader(void* r, void* key) {
   });
 }
 
+CAPIStatus envoyGoFilterHttpSetHeaders(void* r, void* strs, void* actions, int num) {
+  return envoyGoFilterHandlerWrapper(
+      r, [strs, actions, num](std::shared_ptr<Filter>& filter) -> CAPIStatus {
+        auto goStrs = reinterpret_cast<GoString*>(strs);
+        auto goActions = reinterpret_cast<uint8_t*>(actions);
+        return filter->setHeaders(goStrs, goActions, num);
+      });
+}
+
 CAPIStatus envoyGoFilterHttpGetBuffer(void* r, unsigned long long int buffer_ptr, void* data) {
   return envoyGoFilterHandlerWrapper(
       r, [buffer_ptr, data](std::shared_ptr<Filter>& filter) -> CAPIStatus {
@@ -28,6 +28,7 @@ typedef enum { // NOLINT(modernize-use-using)
 typedef enum { // NOLINT(modernize-use-using)
   HeaderSet,
   HeaderAdd,
+  HeaderRemove,
 } headerAction;
 
 // The return value of C Api that invoking from Go.
@@ -49,6 +50,9 @@ CAPIStatus envoyGoFilterHttpGetHeader(void* r, void* key, void* value);
 CAPIStatus envoyGoFilterHttpCopyHeaders(void* r, void* strs, void* buf);
 CAPIStatus envoyGoFilterHttpSetHeaderHelper(void* r, void* key, void* value, headerAction action);
 CAPIStatus envoyGoFilterHttpRemoveHeader(void* r, void* key);
+// Apply a batch of header mutations with one cgo call, strs is the key and value pairs of the
+// mutations, and actions is the headerAction of each mutation.
+CAPIStatus envoyGoFilterHttpSetHeaders(void* r, void* strs, void* actions, int num);
 
 CAPIStatus envoyGoFilterHttpGetBuffer(void* r, unsigned long long int buffer, void* value);
 CAPIStatus envoyGoFilterHttpSetBufferHelper(void* r, unsigned long long int buffer, void* data,
@@ -31,6 +31,9 @@ type HttpCAPI interface {
 	HttpCopyHeaders(r unsafe.Pointer, num uint64, bytes uint64) map[string][]string
 	HttpSetHeader(r unsafe.Pointer, key *string, value *string, add bool)
 	HttpRemoveHeader(r unsafe.Pointer, key *string)
+	// Apply a batch of header mutations with one cgo call, strs contains the key and value pairs of the mutations,
+	// actions contains the HeaderAction of each mutation.
+	HttpSetHeaders(r unsafe.Pointer, strs []string, actions []HeaderAction)
 
 	HttpGetBuffer(r unsafe.Pointer, bufferPtr uint64, value *string, length uint64)
 	HttpSetBufferHelper(r unsafe.Pointer, bufferPtr uint64, value string, action BufferAction)
@@ -148,6 +148,15 @@ const (
 	PrependBuffer BufferAction = 2
 )
 
+// HeaderAction is the action of a header mutation, the values are the same as headerAction in api.h.
+type HeaderAction uint8
+
+const (
+	SetHeader    HeaderAction = 0
+	AddHeader    HeaderAction = 1
+	RemoveHeader HeaderAction = 2
+)
+
 type DataBufferBase interface {
 	// Write appends the contents of p to the buffer, growing the buffer as
 	// needed. The return value n is the length of p; err is always nil. If the
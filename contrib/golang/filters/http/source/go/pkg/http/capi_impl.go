@@ -143,6 +143,15 @@ func (c *httpCApiImpl) HttpRemoveHeader(r unsafe.Pointer, key *string) {
 	handleCApiStatus(res)
 }
 
+func (c *httpCApiImpl) HttpSetHeaders(r unsafe.Pointer, strs []string, actions []api.HeaderAction) {
+	if len(actions) == 0 {
+		return
+	}
+	// api.HeaderAction is one byte, the same as the uint8_t actions in the Envoy side.
+	res := C.envoyGoFilterHttpSetHeaders(r, unsafe.Pointer(&strs[0]), unsafe.Pointer(&actions[0]), C.int(len(actions)))
+	handleCApiStatus(res)
+}
+
 func (c *httpCApiImpl) HttpGetBuffer(r unsafe.Pointer, bufferPtr uint64, value *string, length uint64) {
 	buf := make([]byte, length)
 	bHeader := (*reflect.SliceHeader)(unsafe.Pointer(&buf))
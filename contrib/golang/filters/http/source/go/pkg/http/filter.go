@@ -60,6 +60,28 @@ type httpRequest struct {
 	req        *C.httpRequest
 	httpFilter api.StreamFilter
 	pInfo      panicInfo
+	// Header mutations that are not applied in the Envoy side yet, they are applied by one cgo call
+	// in flushHeaderMutations, instead of one cgo call per mutation.
+	headerMutationStrs    []string
+	headerMutationActions []api.HeaderAction
+}
+
+func (r *httpRequest) addHeaderMutation(key, value string, action api.HeaderAction) {
+	r.headerMutationStrs = append(r.headerMutationStrs, key, value)
+	r.headerMutationActions = append(r.headerMutationActions, action)
+}
+
+// flushHeaderMutations applies the pending header mutations in the Envoy side. It should be invoked
+// before leaving Go, i.e. before returning a non-Running status, Continue and SendLocalReply, and
+// before reading the headers from the Envoy side.
+func (r *httpRequest) flushHeaderMutations() {
+	if len(r.headerMutationActions) == 0 {
+		return
+	}
+	strs, actions := r.headerMutationStrs, r.headerMutationActions
+	// Reset first, the mutations won't be applied again if it panics.
+	r.headerMutationStrs, r.headerMutationActions = nil, nil
+	cAPI.HttpSetHeaders(unsafe.Pointer(r.req), strs, actions)
 }
 
 func (r *httpRequest) pluginName() string {
@@ -102,10 +124,12 @@ func (r *httpRequest) Continue(status api.StatusType) {
 		fmt.Printf("warning: LocalReply status is useless after sendLocalReply, ignoring")
 		return
 	}
+	r.flushHeaderMutations()
 	cAPI.HttpContinue(unsafe.Pointer(r.req), uint64(status))
 }
 
 func (r *httpRequest) SendLocalReply(responseCode int, bodyText string, headers map[string]string, grpcStatus int64, details string) {
+	r.flushHeaderMutations()
 	cAPI.HttpSendLocalReply(unsafe.Pointer(r.req), responseCode, bodyText, headers, grpcStatus, details)
 }
 
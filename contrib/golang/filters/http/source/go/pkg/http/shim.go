@@ -171,6 +171,10 @@ func envoyGoFilterOnHttpHeader(r *C.httpRequest, endStream, headerNum, headerByt
 		}
 		status = f.EncodeTrailers(header)
 	}
+	// Otherwise, the header mutations are applied by Continue in the goroutine.
+	if status != api.Running {
+		req.flushHeaderMutations()
+	}
 	return uint64(status)
 }
 
@@ -200,6 +204,11 @@ func envoyGoFilterOnHttpData(r *C.httpRequest, endStream, buffer, length uint64)
 	} else {
 		status = f.EncodeData(buf, endStream == 1)
 	}
+	// The headers may be still modifiable while processing the data, if the headers are not
+	// continued yet.
+	if status != api.Running {
+		req.flushHeaderMutations()
+	}
 	return uint64(status)
 }
 
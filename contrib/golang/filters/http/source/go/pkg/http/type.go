@@ -56,6 +56,8 @@ func (h *requestOrResponseHeaderMapImpl) initHeaders() {
 }
 
 func (h *requestOrResponseHeaderMapImpl) GetRaw(key string) string {
+	// Apply the pending mutations first, since the value is read from the Envoy side.
+	h.request.flushHeaderMutations()
 	var value string
 	cAPI.HttpGetHeader(unsafe.Pointer(h.request.req), &key, &value)
 	return value
@@ -87,7 +89,7 @@ func (h *requestOrResponseHeaderMapImpl) Set(key, value string) {
 	if h.headers != nil {
 		h.headers[key] = []string{value}
 	}
-	cAPI.HttpSetHeader(unsafe.Pointer(h.request.req), &key, &value, false)
+	h.request.addHeaderMutation(key, value, api.SetHeader)
 }
 
 func (h *requestOrResponseHeaderMapImpl) Add(key, value string) {
@@ -99,7 +101,7 @@ func (h *requestOrResponseHeaderMapImpl) Add(key, value string) {
 			h.headers[key] = []string{value}
 		}
 	}
-	cAPI.HttpSetHeader(unsafe.Pointer(h.request.req), &key, &value, true)
+	h.request.addHeaderMutation(key, value, api.AddHeader)
 }
 
 func (h *requestOrResponseHeaderMapImpl) Del(key string) {
@@ -108,7 +110,7 @@ func (h *requestOrResponseHeaderMapImpl) Del(key string) {
 	// Otherwise, we may get outdated values in a following Get call.
 	h.initHeaders()
 	delete(h.headers, key)
-	cAPI.HttpRemoveHeader(unsafe.Pointer(h.request.req), &key)
+	h.request.addHeaderMutation(key, "", api.RemoveHeader)
 }
 
 func (h *requestOrResponseHeaderMapImpl) Range(f func(key, value string) bool) {
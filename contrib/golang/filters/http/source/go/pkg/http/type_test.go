@@ -0,0 +1,161 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package http
+
+import (
+	"testing"
+	"unsafe"
+
+	"github.com/envoyproxy/envoy/contrib/golang/filters/http/source/go/pkg/api"
+)
+
+// countingCAPI counts the C API calls, which cross the cgo boundary in Envoy.
+type countingCAPI struct {
+	api.HttpCAPI
+	calls   int
+	strs    []string
+	actions []api.HeaderAction
+}
+
+func (c *countingCAPI) HttpCopyHeaders(r unsafe.Pointer, num uint64, bytes uint64) map[string][]string {
+	c.calls++
+	return map[string][]string{
+		":method":    {"GET"},
+		":path":      {"/"},
+		":authority": {"example.com"},
+	}
+}
+
+func (c *countingCAPI) HttpSetHeader(r unsafe.Pointer, key *string, value *string, add bool) {
+	c.calls++
+}
+
+func (c *countingCAPI) HttpRemoveHeader(r unsafe.Pointer, key *string) {
+	c.calls++
+}
+
+func (c *countingCAPI) HttpSetHeaders(r unsafe.Pointer, strs []string, actions []api.HeaderAction) {
+	c.calls++
+	c.strs = append(c.strs, strs...)
+	c.actions = append(c.actions, actions...)
+}
+
+func newRequestHeaderMap(req *httpRequest) *requestHeaderMapImpl {
+	return &requestHeaderMapImpl{
+		requestOrResponseHeaderMapImpl{
+			headerMapImpl{
+				request:     req,
+				headerNum:   3,
+				headerBytes: 40,
+			},
+		},
+	}
+}
+
+func TestHeaderMutationsAreBatched(t *testing.T) {
+	capi := &countingCAPI{}
+	SetHttpCAPI(capi)
+	defer SetHttpCAPI(&httpCApiImpl{})
+
+	req := &httpRequest{}
+	header := newRequestHeaderMap(req)
+	header.Set("x-set", "foo")
+	header.Add("x-add", "bar")
+	header.Del(":authority")
+
+	// The mutations take effect in Go immediately.
+	if v, _ := header.Get("x-set"); v != "foo" {
+		t.Fatalf("unexpected x-set: %s", v)
+	}
+	if _, ok := header.Get(":authority"); ok {
+		t.Fatalf("unexpected :authority")
+	}
+	// Only the headers are copied.
+	if capi.calls != 1 {
+		t.Fatalf("unexpected C API calls: %d", capi.calls)
+	}
+
+	req.flushHeaderMutations()
+	if capi.calls != 2 {
+		t.Fatalf("unexpected C API calls: %d", capi.calls)
+	}
+	expectedStrs := []string{"x-set", "foo", "x-add", "bar", ":authority", ""}
+	expectedActions := []api.HeaderAction{api.SetHeader, api.AddHeader, api.RemoveHeader}
+	if len(capi.strs) != len(expectedStrs) || len(capi.actions) != len(expectedActions) {
+		t.Fatalf("unexpected mutations: %v %v", capi.strs, capi.actions)
+	}
+	for i := range expectedStrs {
+		if capi.strs[i] != expectedStrs[i] {
+			t.Fatalf("unexpected mutations: %v", capi.strs)
+		}
+	}
+	for i := range expectedActions {
+		if capi.actions[i] != expectedActions[i] {
+			t.Fatalf("unexpected mutations: %v", capi.actions)
+		}
+	}
+
+	// Nothing to apply.
+	req.flushHeaderMutations()
+	if capi.calls != 2 {
+		t.Fatalf("unexpected C API calls: %d", capi.calls)
+	}
+}
+
+var mutatedHeaders = []string{"x-request-id", "x-user", "x-tenant", "x-region", "x-version", "x-trace", "x-debug", "x-canary"}
+
+// BenchmarkHeaderMutations reports the C API calls per request of a header-heavy filter.
+func BenchmarkHeaderMutations(b *testing.B) {
+	capi := &countingCAPI{}
+	SetHttpCAPI(capi)
+	defer SetHttpCAPI(&httpCApiImpl{})
+
+	for i := 0; i < b.N; i++ {
+		req := &httpRequest{}
+		header := newRequestHeaderMap(req)
+		for _, key := range mutatedHeaders {
+			header.Set(key, "value")
+		}
+		header.Del(":authority")
+		req.flushHeaderMutations()
+	}
+	b.ReportMetric(float64(capi.calls)/float64(b.N), "cgo-calls/op")
+}
+
+// BenchmarkHeaderMutationsUnbatched applies the same mutations with one C API call per mutation,
+// as the header map did before batching.
+func BenchmarkHeaderMutationsUnbatched(b *testing.B) {
+	capi := &countingCAPI{}
+	SetHttpCAPI(capi)
+	defer SetHttpCAPI(&httpCApiImpl{})
+
+	for i := 0; i < b.N; i++ {
+		req := &httpRequest{}
+		header := newRequestHeaderMap(req)
+		header.initHeaders()
+		for _, key := range mutatedHeaders {
+			key, value := key, "value"
+			header.headers[key] = []string{value}
+			cAPI.HttpSetHeader(unsafe.Pointer(req.req), &key, &value, false)
+		}
+		key := ":authority"
+		delete(header.headers, key)
+		cAPI.HttpRemoveHeader(unsafe.Pointer(req.req), &key)
+	}
+	b.ReportMetric(float64(capi.calls)/float64(b.N), "cgo-calls/op")
+}
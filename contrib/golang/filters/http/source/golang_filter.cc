@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "envoy/http/codes.h"
@@ -640,6 +641,30 @@ CAPIStatus Filter::copyHeaders(GoString* go_strs, char* go_buf) {
   return CAPIStatus::CAPIOK;
 }
 
+namespace {
+
+void applyHeaderMutation(Http::HeaderMap& headers, absl::string_view key, absl::string_view value,
+                         headerAction act) {
+  switch (act) {
+  case HeaderAdd:
+    headers.addCopy(Http::LowerCaseString(key), value);
+    break;
+
+  case HeaderSet:
+    headers.setCopy(Http::LowerCaseString(key), value);
+    break;
+
+  case HeaderRemove:
+    headers.remove(Http::LowerCaseString(key));
+    break;
+
+  default:
+    RELEASE_ASSERT(false, absl::StrCat("unknown header action: ", act));
+  }
+}
+
+} // namespace
+
 // It won't take affect immidiately while it's invoked from a Go thread, instead, it will post a
 // callback to run in the envoy worker thread.
 CAPIStatus Filter::setHeader(absl::string_view key, absl::string_view value, headerAction act) {
@@ -660,19 +685,7 @@ CAPIStatus Filter::setHeader(absl::string_view key, absl::string_view value, hea
 
   if (state.isThreadSafe()) {
     // it's safe to write header in the safe thread.
-    switch (act) {
-    case HeaderAdd:
-      headers_->addCopy(Http::LowerCaseString(key), value);
-      break;
-
-    case HeaderSet:
-      headers_->setCopy(Http::LowerCaseString(key), value);
-      break;
-
-    default:
-      RELEASE_ASSERT(false, absl::StrCat("unknown header action: ", act));
-    }
-
+    applyHeaderMutation(*headers_, key, value, act);
     onHeadersModified();
   } else {
     // should deep copy the string_view before post to dipatcher callback.
@@ -686,19 +699,7 @@ CAPIStatus Filter::setHeader(absl::string_view key, absl::string_view value, hea
     state.getDispatcher().post([this, weak_ptr, key_str, value_str, act] {
       Thread::LockGuard lock(mutex_);
       if (!weak_ptr.expired() && !has_destroyed_) {
-        switch (act) {
-        case HeaderAdd:
-          headers_->addCopy(Http::LowerCaseString(key_str), value_str);
-          break;
-
-        case HeaderSet:
-          headers_->setCopy(Http::LowerCaseString(key_str), value_str);
-          break;
-
-        default:
-          RELEASE_ASSERT(false, absl::StrCat("unknown header action: ", act));
-        }
-
+        applyHeaderMutation(*headers_, key_str, value_str, act);
         onHeadersModified();
       } else {
         ENVOY_LOG(debug, "golang filter has gone or destroyed in setHeader");
@@ -751,6 +752,60 @@ CAPIStatus Filter::removeHeader(absl::string_view key) {
   return CAPIStatus::CAPIOK;
 }
 
+// Apply a batch of header mutations that is collected in Go, to save the cgo calls of setting
+// the headers one by one. Like setHeader, it won't take affect immidiately while it's invoked from
+// a Go thread.
+CAPIStatus Filter::setHeaders(GoString* go_strs, uint8_t* go_actions, int num) {
+  Thread::LockGuard lock(mutex_);
+  if (has_destroyed_) {
+    ENVOY_LOG(debug, "golang filter has been destroyed");
+    return CAPIStatus::CAPIFilterIsDestroy;
+  }
+  auto& state = getProcessorState();
+  if (!state.isProcessingInGo()) {
+    ENVOY_LOG(debug, "golang filter is not processing Go");
+    return CAPIStatus::CAPINotInGo;
+  }
+  if (headers_ == nullptr) {
+    ENVOY_LOG(debug, "invoking cgo api at invalid phase: {}", __func__);
+    return CAPIStatus::CAPIInvalidPhase;
+  }
+
+  if (state.isThreadSafe()) {
+    // it's safe to write header in the safe thread.
+    for (int i = 0; i < num; i++) {
+      applyHeaderMutation(*headers_, absl::string_view(go_strs[2 * i].p, go_strs[2 * i].n),
+                          absl::string_view(go_strs[2 * i + 1].p, go_strs[2 * i + 1].n),
+                          static_cast<headerAction>(go_actions[i]));
+    }
+    onHeadersModified();
+  } else {
+    // should deep copy the strings before post to dipatcher callback.
+    std::vector<std::tuple<std::string, std::string, headerAction>> mutations;
+    mutations.reserve(num);
+    for (int i = 0; i < num; i++) {
+      mutations.emplace_back(std::string(go_strs[2 * i].p, go_strs[2 * i].n),
+                             std::string(go_strs[2 * i + 1].p, go_strs[2 * i + 1].n),
+                             static_cast<headerAction>(go_actions[i]));
+    }
+
+    auto weak_ptr = weak_from_this();
+    // dispatch one callback to apply all the mutations in the envoy safe thread.
+    state.getDispatcher().post([this, weak_ptr, mutations = std::move(mutations)] {
+      Thread::LockGuard lock(mutex_);
+      if (!weak_ptr.expired() && !has_destroyed_) {
+        for (const auto& [key, value, act] : mutations) {
+          applyHeaderMutation(*headers_, key, value, act);
+        }
+        onHeadersModified();
+      } else {
+        ENVOY_LOG(debug, "golang filter has gone or destroyed in setHeaders");
+      }
+    });
+  }
+  return CAPIStatus::CAPIOK;
+}
+
 CAPIStatus Filter::copyBuffer(Buffer::Instance* buffer, char* data) {
   Thread::LockGuard lock(mutex_);
   if (has_destroyed_) {
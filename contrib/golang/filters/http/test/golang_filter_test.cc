@@ -22,6 +22,7 @@
 #include "test/test_common/utility.h"
 
 #include "absl/strings/str_format.h"
+#include "contrib/golang/common/dso/test/mocks.h"
 #include "contrib/golang/filters/http/source/golang_filter.h"
 #include "gmock/gmock.h"
 
@@ -29,6 +30,7 @@ using testing::_;
 using testing::AtLeast;
 using testing::InSequence;
 using testing::Invoke;
+using testing::Return;
 
 namespace Envoy {
 namespace Extensions {
@@ -175,6 +177,66 @@ TEST_F(GolangHttpFilterTest, SetHeaderAtWrongStage) {
   EXPECT_EQ(CAPINotInGo, filter_->setHeader("foo", "bar", HeaderSet));
 }
 
+// setHeaders at wrong stage
+TEST_F(GolangHttpFilterTest, SetHeadersAtWrongStage) {
+  InSequence s;
+  setup(PASSTHROUGH, genSoPath(PASSTHROUGH), PASSTHROUGH);
+
+  GoString strs[2] = {{"foo", 3}, {"bar", 3}};
+  uint8_t actions[1] = {HeaderSet};
+  EXPECT_EQ(CAPINotInGo, filter_->setHeaders(strs, actions, 1));
+}
+
+// setHeaders applies a batch of mixed header mutations in order
+TEST_F(GolangHttpFilterTest, SetHeadersInGo) {
+  auto dso_lib = std::make_shared<NiceMock<Dso::MockHttpFilterDsoImpl>>();
+  // hard code the return config_id to 1 since the default 0 is invalid.
+  ON_CALL(*dso_lib, envoyGoFilterNewHttpPluginConfig(_, _)).WillByDefault(Return(1));
+  ON_CALL(*dso_lib, envoyGoFilterOnHttpDestroy(_, _))
+      .WillByDefault(Invoke([](httpRequest* p0, int) -> void {
+        // delete the filter->req_, make LeakSanitizer happy.
+        delete reinterpret_cast<httpRequestInternal*>(p0);
+      }));
+
+  const auto yaml = R"EOF(
+    library_id: test
+    library_path: test
+    plugin_name: test
+    )EOF";
+  envoy::extensions::filters::http::golang::v3alpha::Config proto_config;
+  TestUtility::loadFromYaml(yaml, proto_config);
+  config_ = std::make_shared<FilterConfig>(proto_config, dso_lib, "", context_);
+  filter_ = std::make_unique<TestFilter>(config_, dso_lib);
+  filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+
+  EXPECT_CALL(*dso_lib, envoyGoFilterOnHttpHeader(_, _, _, _))
+      .WillOnce(Invoke([this](httpRequest*, GoUint64, GoUint64, GoUint64) -> GoUint64 {
+        GoString strs[10] = {{"x-set", 5},     {"new", 3}, {"x-add", 5},     {"b", 1},
+                             {"x-remove", 8},  {"", 0},    {"x-created", 9}, {"c", 1},
+                             {"x-created", 9}, {"d", 1}};
+        uint8_t actions[5] = {HeaderSet, HeaderAdd, HeaderRemove, HeaderSet, HeaderAdd};
+        EXPECT_CALL(decoder_callbacks_.downstream_callbacks_, clearRouteCache());
+        EXPECT_EQ(CAPIOK, filter_->setHeaders(strs, actions, 5));
+        return static_cast<GoUint64>(GolangStatus::Continue);
+      }));
+
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":path", "/"}, {"x-set", "old"}, {"x-add", "a"}, {"x-remove", "foo"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+
+  EXPECT_EQ("new", request_headers.get_("x-set"));
+  auto added = request_headers.get(Http::LowerCaseString("x-add"));
+  ASSERT_EQ(2, added.size());
+  EXPECT_EQ("a", added[0]->value().getStringView());
+  EXPECT_EQ("b", added[1]->value().getStringView());
+  EXPECT_FALSE(request_headers.has("x-remove"));
+  auto created = request_headers.get(Http::LowerCaseString("x-created"));
+  ASSERT_EQ(2, created.size());
+  EXPECT_EQ("c", created[0]->value().getStringView());
+  EXPECT_EQ("d", created[1]->value().getStringView());
+}
+
 } // namespace
 } // namespace Golang
 } // namespace HttpFilters
@@ -18,10 +18,12 @@ Network::FilterFactoryCb KafkaConfigFactory::createFilterFactoryFromProtoTyped(
   ASSERT(!proto_config.stat_prefix().empty());
 
   const std::string& stat_prefix = proto_config.stat_prefix();
+  const bool header_only_parsing = proto_config.header_only_parsing();
 
-  return [&context, stat_prefix](Network::FilterManager& filter_manager) -> void {
-    Network::FilterSharedPtr filter =
-        std::make_shared<KafkaBrokerFilter>(context.scope(), context.timeSource(), stat_prefix);
+  return [&context, stat_prefix,
+          header_only_parsing](Network::FilterManager& filter_manager) -> void {
+    Network::FilterSharedPtr filter = std::make_shared<KafkaBrokerFilter>(
+        context.scope(), context.timeSource(), stat_prefix, header_only_parsing);
     filter_manager.addFilter(filter);
   };
 }
@@ -18,37 +18,59 @@ void Forwarder::onFailedParse(RequestParseFailureSharedPtr parse_failure) {
 
 // Nothing fancy here, proper metrics registration is left to Rich...MetricsImpl constructors.
 KafkaMetricsFacadeImpl::KafkaMetricsFacadeImpl(Stats::Scope& scope, TimeSource& time_source,
-                                               const std::string& stat_prefix)
+                                               const std::string& stat_prefix,
+                                               const bool header_only_parsing)
     : KafkaMetricsFacadeImpl{time_source,
                              std::make_shared<RichRequestMetricsImpl>(scope, stat_prefix),
-                             std::make_shared<RichResponseMetricsImpl>(scope, stat_prefix)} {};
+                             std::make_shared<RichResponseMetricsImpl>(scope, stat_prefix),
+                             header_only_parsing} {};
 
 KafkaMetricsFacadeImpl::KafkaMetricsFacadeImpl(TimeSource& time_source,
                                                RichRequestMetricsSharedPtr request_metrics,
-                                               RichResponseMetricsSharedPtr response_metrics)
-    : time_source_{time_source}, request_metrics_{request_metrics}, response_metrics_{
-                                                                        response_metrics} {};
+                                               RichResponseMetricsSharedPtr response_metrics,
+                                               const bool header_only_parsing)
+    : time_source_{time_source}, header_only_parsing_{header_only_parsing},
+      request_metrics_{request_metrics}, response_metrics_{response_metrics} {};
 
 // When request is successfully parsed, increase type count and store its arrival timestamp.
 void KafkaMetricsFacadeImpl::onMessage(AbstractRequestSharedPtr request) {
-  const RequestHeader& header = request->request_header_;
+  onRequestHeader(request->request_header_);
+}
+
+// With header-only parsing, every request ends up as a parse failure carrying the header.
+void KafkaMetricsFacadeImpl::onFailedParse(RequestParseFailureSharedPtr parse_failure) {
+  if (header_only_parsing_) {
+    onRequestHeader(parse_failure->request_header_);
+  } else {
+    request_metrics_->onUnknownRequest();
+  }
+}
+
+void KafkaMetricsFacadeImpl::onRequestHeader(const RequestHeader& header) {
   request_metrics_->onRequest(header.api_key_);
 
   const MonotonicTime request_arrival_ts = time_source_.monotonicTime();
   request_arrivals_[header.correlation_id_] = request_arrival_ts;
 }
 
-void KafkaMetricsFacadeImpl::onFailedParse(RequestParseFailureSharedPtr) {
-  request_metrics_->onUnknownRequest();
-}
-
 void KafkaMetricsFacadeImpl::onRequestException() { request_metrics_->onBrokenRequest(); }
 
 // When response is successfully parsed, compute processing time using its correlation id and
 // stored request arrival timestamp, then update metrics with the result.
 void KafkaMetricsFacadeImpl::onMessage(AbstractResponseSharedPtr response) {
-  const ResponseMetadata& metadata = response->metadata_;
+  onResponseMetadata(response->metadata_);
+}
 
+// With header-only parsing, every response ends up as a parse failure carrying the metadata.
+void KafkaMetricsFacadeImpl::onFailedParse(ResponseMetadataSharedPtr parse_failure) {
+  if (header_only_parsing_) {
+    onResponseMetadata(*parse_failure);
+  } else {
+    response_metrics_->onUnknownResponse();
+  }
+}
+
+void KafkaMetricsFacadeImpl::onResponseMetadata(const ResponseMetadata& metadata) {
   const MonotonicTime response_arrival_ts = time_source_.monotonicTime();
   const MonotonicTime request_arrival_ts = request_arrivals_[metadata.correlation_id_];
   request_arrivals_.erase(metadata.correlation_id_);
@@ -59,10 +81,6 @@ void KafkaMetricsFacadeImpl::onMessage(AbstractResponseSharedPtr response) {
   response_metrics_->onResponse(metadata.api_key_, ms.count());
 }
 
-void KafkaMetricsFacadeImpl::onFailedParse(ResponseMetadataSharedPtr) {
-  response_metrics_->onUnknownResponse();
-}
-
 void KafkaMetricsFacadeImpl::onResponseException() { response_metrics_->onBrokenResponse(); }
 
 absl::flat_hash_map<int32_t, MonotonicTime>& KafkaMetricsFacadeImpl::getRequestArrivalsForTest() {
@@ -70,14 +88,25 @@ absl::flat_hash_map<int32_t, MonotonicTime>& KafkaMetricsFacadeImpl::getRequestA
 }
 
 KafkaBrokerFilter::KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source,
-                                     const std::string& stat_prefix)
-    : KafkaBrokerFilter{
-          std::make_shared<KafkaMetricsFacadeImpl>(scope, time_source, stat_prefix)} {};
-
-KafkaBrokerFilter::KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics)
-    : metrics_{metrics}, response_decoder_{new ResponseDecoder({metrics})},
-      request_decoder_{
-          new RequestDecoder({std::make_shared<Forwarder>(*response_decoder_), metrics})} {};
+                                     const std::string& stat_prefix,
+                                     const bool header_only_parsing)
+    : KafkaBrokerFilter{std::make_shared<KafkaMetricsFacadeImpl>(scope, time_source, stat_prefix,
+                                                                 header_only_parsing),
+                        header_only_parsing ? HeaderOnlyRequestParserResolver::getInstance()
+                                            : RequestParserResolver::getDefaultInstance(),
+                        header_only_parsing ? HeaderOnlyResponseParserResolver::getInstance()
+                                            : ResponseParserResolver::getDefaultInstance()} {};
+
+KafkaBrokerFilter::KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics,
+                                     const RequestParserResolver& request_parser_resolver,
+                                     const ResponseParserResolver& response_parser_resolver)
+    : metrics_{metrics},
+      response_decoder_{new ResponseDecoder(ResponseInitialParserFactory::getDefaultInstance(),
+                                            response_parser_resolver, {metrics})},
+      request_decoder_{new RequestDecoder(InitialParserFactory::getDefaultInstance(),
+                                          request_parser_resolver,
+                                          {std::make_shared<Forwarder>(*response_decoder_),
+                                           metrics})} {};
 
 KafkaBrokerFilter::KafkaBrokerFilter(KafkaMetricsFacadeSharedPtr metrics,
                                      ResponseDecoderSharedPtr response_decoder,
@@ -71,6 +71,8 @@ using KafkaMetricsFacadeSharedPtr = std::shared_ptr<KafkaMetricsFacade>;
  * Metrics facade implementation that actually uses rich request/response metrics.
  * Keeps requests' arrival timestamps (by correlation id) and uses them calculate response
  * processing time.
+ * With header-only parsing, messages are never deserialized, so failed parses carry the headers of
+ * messages of any type and are accounted for in the same way as successfully parsed messages.
  */
 class KafkaMetricsFacadeImpl : public KafkaMetricsFacade {
 public:
@@ -79,13 +81,13 @@ public:
    * compute processing durations.
    */
   KafkaMetricsFacadeImpl(Stats::Scope& scope, TimeSource& time_source,
-                         const std::string& stat_prefix);
+                         const std::string& stat_prefix, bool header_only_parsing);
 
   /**
    * Visible for testing.
    */
   KafkaMetricsFacadeImpl(TimeSource& time_source, RichRequestMetricsSharedPtr request_metrics,
-                         RichResponseMetricsSharedPtr response_metrics);
+                         RichResponseMetricsSharedPtr response_metrics, bool header_only_parsing);
 
   // RequestCallback
   void onMessage(AbstractRequestSharedPtr request) override;
@@ -102,7 +104,11 @@ public:
   absl::flat_hash_map<int32_t, MonotonicTime>& getRequestArrivalsForTest();
 
 private:
+  void onRequestHeader(const RequestHeader& header);
+  void onResponseMetadata(const ResponseMetadata& metadata);
+
   TimeSource& time_source_;
+  const bool header_only_parsing_;
   absl::flat_hash_map<int32_t, MonotonicTime> request_arrivals_;
   RichRequestMetricsSharedPtr request_metrics_;
   RichResponseMetricsSharedPtr response_metrics_;
@@ -136,9 +142,11 @@ public:
   /**
    * Main constructor.
    * Creates decoders that eventually update prefixed metrics stored in scope, using time source for
-   * duration calculation.
+   * duration calculation. If header_only_parsing is set, decoders only parse message headers and
+   * skip over message payloads.
    */
-  KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source, const std::string& stat_prefix);
+  KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source, const std::string& stat_prefix,
+                    bool header_only_parsing);
 
   /**
    * Visible for testing.
@@ -160,9 +168,11 @@ public:
 private:
   /**
    * Helper delegate constructor.
-   * Passes metrics facade as argument to decoders.
+   * Passes metrics facade as argument to decoders, that use given parser resolvers.
    */
-  KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics);
+  KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics,
+                    const RequestParserResolver& request_parser_resolver,
+                    const ResponseParserResolver& response_parser_resolver);
 
   const KafkaMetricsFacadeSharedPtr metrics_;
   const ResponseDecoderSharedPtr response_decoder_;
@@ -176,6 +176,21 @@ public:
   }
 };
 
+/**
+ * Request parser resolver that never deserializes request-specific data. Every request is consumed
+ * by a sentinel parser, what means that only the request header is captured and the rest of the
+ * message is skipped without copying it.
+ */
+class HeaderOnlyRequestParserResolver : public RequestParserResolver {
+public:
+  RequestParserSharedPtr createParser(int16_t, int16_t,
+                                      RequestContextSharedPtr context) const override {
+    return std::make_shared<SentinelParser>(context);
+  }
+
+  static const HeaderOnlyRequestParserResolver& getInstance();
+};
+
 /**
  * Request parser uses a single deserializer to construct a request object.
  * This parser is responsible for consuming request-specific data (e.g. topic names) and always
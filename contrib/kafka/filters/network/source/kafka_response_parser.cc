@@ -11,6 +11,10 @@ const ResponseParserResolver& ResponseParserResolver::getDefaultInstance() {
   CONSTRUCT_ON_FIRST_USE(ResponseParserResolver);
 }
 
+const HeaderOnlyResponseParserResolver& HeaderOnlyResponseParserResolver::getInstance() {
+  CONSTRUCT_ON_FIRST_USE(HeaderOnlyResponseParserResolver);
+}
+
 ResponseParseResponse ResponseHeaderParser::parse(absl::string_view& data) {
   length_deserializer_.feed(data);
   if (!length_deserializer_.ready()) {
@@ -151,6 +151,20 @@ public:
   }
 };
 
+/**
+ * Response parser resolver that never deserializes response-specific data. Every response is
+ * consumed by a sentinel parser, what means that only the response header is captured and the
+ * rest of the message is skipped without copying it.
+ */
+class HeaderOnlyResponseParserResolver : public ResponseParserResolver {
+public:
+  ResponseParserSharedPtr createParser(ResponseContextSharedPtr context) const override {
+    return std::make_shared<SentinelResponseParser>(context);
+  }
+
+  static const HeaderOnlyResponseParserResolver& getInstance();
+};
+
 /**
  * Response parser uses a single deserializer to construct a response object.
  * This parser is responsible for consuming response-specific data (e.g. topic names) and always
@@ -0,0 +1,66 @@
+/**
+ * Benchmarks measuring how fast Kafka broker filter processes requests carrying large record
+ * batches, with full and header-only parsing.
+ */
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/test_common/test_time.h"
+
+#include "benchmark/benchmark.h"
+#include "contrib/kafka/filters/network/source/broker/filter.h"
+#include "contrib/kafka/filters/network/source/external/requests.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Broker {
+
+// Creates a buffer with 16 Produce requests, each of them carrying a single record batch of given
+// size.
+static Buffer::OwnedImpl makeProduceRequests(const uint32_t record_batch_size) {
+  Buffer::OwnedImpl result;
+  RequestEncoder encoder{result};
+  const std::vector<unsigned char> record_batch(record_batch_size, 'a');
+  for (int32_t correlation_id = 0; correlation_id < 16; ++correlation_id) {
+    const RequestHeader header = {0, 0, correlation_id, "client-id"};
+    const PartitionProduceData partition_data = {0, record_batch};
+    const TopicProduceData topic_data = {"topic", {partition_data}};
+    const ProduceRequest data = {0, 0, {topic_data}};
+    encoder.encode(Request<ProduceRequest>{header, data});
+  }
+  return result;
+}
+
+static void processProduceRequests(const bool header_only_parsing, benchmark::State& state) {
+  Stats::IsolatedStoreImpl store;
+  Event::TestRealTimeSystem time_source;
+  KafkaBrokerFilter filter{*store.rootScope(), time_source, "prefix", header_only_parsing};
+
+  Buffer::OwnedImpl requests = makeProduceRequests(state.range(0));
+  for (auto _ : state) { // NOLINT
+    // The filter does not modify the data, so the same requests can be fed again.
+    filter.onData(requests, false);
+  }
+  state.SetBytesProcessed(state.iterations() * requests.length());
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ProduceRequestsFullParsing(benchmark::State& state) {
+  processProduceRequests(false, state);
+}
+BENCHMARK(BM_ProduceRequestsFullParsing)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_ProduceRequestsHeaderOnlyParsing(benchmark::State& state) {
+  processProduceRequests(true, state);
+}
+BENCHMARK(BM_ProduceRequestsHeaderOnlyParsing)->Arg(1024)->Arg(64 * 1024)->Arg(1024 * 1024);
+
+} // namespace Broker
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
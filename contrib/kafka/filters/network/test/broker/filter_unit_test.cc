@@ -208,7 +208,7 @@ protected:
       std::make_shared<MockRichRequestMetrics>();
   std::shared_ptr<MockRichResponseMetrics> response_metrics_ =
       std::make_shared<MockRichResponseMetrics>();
-  KafkaMetricsFacadeImpl testee_{time_source_, request_metrics_, response_metrics_};
+  KafkaMetricsFacadeImpl testee_{time_source_, request_metrics_, response_metrics_, false};
 };
 
 TEST_F(KafkaMetricsFacadeImplUnitTest, ShouldRegisterRequest) {
@@ -277,6 +277,59 @@ TEST_F(KafkaMetricsFacadeImplUnitTest, ShouldRegisterUnknownResponse) {
   // then - response_metrics_ is updated.
 }
 
+class HeaderOnlyKafkaMetricsFacadeImplUnitTest : public testing::Test {
+protected:
+  MockTimeSource time_source_;
+  std::shared_ptr<MockRichRequestMetrics> request_metrics_ =
+      std::make_shared<MockRichRequestMetrics>();
+  std::shared_ptr<MockRichResponseMetrics> response_metrics_ =
+      std::make_shared<MockRichResponseMetrics>();
+  KafkaMetricsFacadeImpl testee_{time_source_, request_metrics_, response_metrics_, true};
+};
+
+TEST_F(HeaderOnlyKafkaMetricsFacadeImplUnitTest, ShouldRegisterRequestFromHeader) {
+  // given
+  const int16_t api_key = 42;
+  const int32_t correlation_id = 1234;
+  RequestHeader header = {api_key, 0, correlation_id, ""};
+  RequestParseFailureSharedPtr request = std::make_shared<RequestParseFailure>(header);
+
+  EXPECT_CALL(*request_metrics_, onRequest(api_key));
+
+  MonotonicTime time_point{Event::TimeSystem::Milliseconds(1234)};
+  EXPECT_CALL(time_source_, monotonicTime()).WillOnce(Return(time_point));
+
+  // when
+  testee_.onFailedParse(request);
+
+  // then
+  const auto& request_arrivals = testee_.getRequestArrivalsForTest();
+  ASSERT_EQ(request_arrivals.at(correlation_id), time_point);
+}
+
+TEST_F(HeaderOnlyKafkaMetricsFacadeImplUnitTest, ShouldRegisterResponseFromMetadata) {
+  // given
+  const int16_t api_key = 42;
+  const int32_t correlation_id = 1234;
+  ResponseMetadataSharedPtr response =
+      std::make_shared<ResponseMetadata>(api_key, 0, correlation_id);
+
+  MonotonicTime request_time_point{Event::TimeSystem::Milliseconds(1234)};
+  testee_.getRequestArrivalsForTest()[correlation_id] = request_time_point;
+
+  MonotonicTime response_time_point{Event::TimeSystem::Milliseconds(2345)};
+
+  EXPECT_CALL(*response_metrics_, onResponse(api_key, 1111));
+  EXPECT_CALL(time_source_, monotonicTime()).WillOnce(Return(response_time_point));
+
+  // when
+  testee_.onFailedParse(response);
+
+  // then
+  const auto& request_arrivals = testee_.getRequestArrivalsForTest();
+  ASSERT_EQ(request_arrivals.find(correlation_id), request_arrivals.end());
+}
+
 } // namespace Broker
 } // namespace Kafka
 } // namespace NetworkFilters
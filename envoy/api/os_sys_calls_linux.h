@@ -20,6 +20,23 @@ public:
    * @see sched_getaffinity (man 2 sched_getaffinity)
    */
   virtual SysCallIntResult sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask) PURE;
+
+  /**
+   * @see pipe2 (man 2 pipe2)
+   */
+  virtual SysCallIntResult pipe2(int pipefd[2], int flags) PURE;
+
+  /**
+   * Moves up to len bytes between fd_in and fd_out, one of which must be a pipe, without copying
+   * them to user space. Offsets are not supported.
+   * @see splice (man 2 splice)
+   */
+  virtual SysCallSizeResult splice(int fd_in, int fd_out, size_t len, unsigned int flags) PURE;
+
+  /**
+   * @see fcntl (man 2 fcntl), for the commands which take an int argument, e.g. F_SETPIPE_SZ.
+   */
+  virtual SysCallIntResult fcntl(int fd, int cmd, int arg) PURE;
 };
 
 using LinuxOsSysCallsPtr = std::unique_ptr<LinuxOsSysCalls>;
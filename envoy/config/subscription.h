@@ -65,6 +65,14 @@ public:
    * @return optional ref<envoy::config::core::v3::Metadata> of a resource.
    */
   virtual const OptRef<const envoy::config::core::v3::Metadata> metadata() const PURE;
+
+  /**
+   * @return absl::optional<uint64_t> a hash of the serialized resource payload as received from
+   *         the config source, if the resource was decoded from one. Resources with different
+   *         hashes were received with different payloads. As hashes may collide, resources with
+   *         the same hash must still be compared before being treated as identical.
+   */
+  virtual absl::optional<uint64_t> wireHash() const PURE;
 };
 
 using DecodedResourcePtr = std::unique_ptr<DecodedResource>;
@@ -37,7 +37,14 @@ namespace Event {
 /**
  * All dispatcher stats. @see stats_macros.h
  */
-#define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+#define ALL_DISPATCHER_STATS(COUNTER, GAUGE, HISTOGRAM)                                            \
+  COUNTER(deferred_delete_time_us)                                                                 \
+  COUNTER(file_event_time_us)                                                                      \
+  COUNTER(post_time_us)                                                                            \
+  COUNTER(schedulable_callback_time_us)                                                            \
+  COUNTER(timer_time_us)                                                                           \
+  GAUGE(utilization_percent, NeverImport)                                                          \
+  HISTOGRAM(callbacks_per_loop, Unspecified)                                                       \
   HISTOGRAM(loop_duration_us, Microseconds)                                                        \
   HISTOGRAM(poll_delay_us, Microseconds)
 
@@ -45,7 +52,7 @@ namespace Event {
  * Struct definition for all dispatcher stats. @see stats_macros.h
  */
 struct DispatcherStats {
-  ALL_DISPATCHER_STATS(GENERATE_HISTOGRAM_STRUCT)
+  ALL_DISPATCHER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 using DispatcherStatsPtr = std::unique_ptr<DispatcherStats>;
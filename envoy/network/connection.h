@@ -6,6 +6,7 @@
 #include <string>
 
 #include "envoy/buffer/buffer.h"
+#include "envoy/common/optref.h"
 #include "envoy/common/pure.h"
 #include "envoy/common/scope_tracker.h"
 #include "envoy/event/deferred_deletable.h"
@@ -367,6 +368,37 @@ public:
    * return value is cwnd(in packets) times the connection's MSS.
    */
   virtual absl::optional<uint64_t> congestionWindowInBytes() const PURE;
+
+  /**
+   * The result of rawIoHandle().
+   */
+  struct RawIoHandle {
+    enum class Status {
+      // Bytes can bypass the connection through io_handle_.
+      Available,
+      // Bytes can't bypass the connection yet, because it is still connecting or bytes are still
+      // buffered in it. This may change once the buffered bytes have been written.
+      NotYet,
+      // Bytes can never bypass the connection, e.g. because of its transport socket or because it
+      // is closed or half closed.
+      Never,
+    };
+
+    Status status_{Status::Never};
+    // The io handle of the connection's socket. Only set if status_ is Available.
+    OptRef<IoHandle> io_handle_;
+  };
+
+  /**
+   * Gives access to the socket of the connection for moving bytes without going through the
+   * connection's buffers, e.g. with splice(2). This is only possible if the connection is open, its
+   * transport socket passes bytes through unmodified (i.e. it is a raw buffer socket), no bytes
+   * are buffered in the connection in either direction and neither direction has been half closed.
+   * The caller must read disable the connection while it moves bytes itself.
+   * @return the io handle of the connection's socket, or whether bytes may bypass the connection
+   * later.
+   */
+  virtual RawIoHandle rawIoHandle() PURE;
 };
 
 using ConnectionPtr = std::unique_ptr<Connection>;
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "envoy/common/pure.h"
 #include "envoy/event/dispatcher.h"
@@ -31,6 +32,14 @@ public:
     bool enable_reuse_port_default_;
   };
 
+  struct HostHealthFromParent {
+    std::string cluster_name_;
+    std::string address_;
+    bool failed_active_health_check_{};
+    bool degraded_active_health_check_{};
+    bool failed_outlier_check_{};
+  };
+
   virtual ~HotRestart() = default;
 
   /**
@@ -79,6 +88,15 @@ public:
    */
   virtual ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot& stats_store) PURE;
 
+  /**
+   * Retrieve the health of the upstream hosts of our parent process, so that the same hosts of
+   * the new process can start out with the active health checking and outlier detection state the
+   * parent last saw.
+   * @return the health of every host of the parent, or an empty vector if there is no parent or
+   *         the parent doesn't support the request.
+   */
+  virtual std::vector<HostHealthFromParent> parentHostHealth() PURE;
+
   /**
    * Shutdown the half of our hot restarter that acts as a parent.
    */
@@ -144,6 +144,12 @@ public:
    * to secure mode. Implemented only by start_tls transport socket.
    */
   virtual bool startUpstreamSecureTransport() PURE;
+
+  /**
+   * @return the upstream connection if this upstream proxies bytes over a TCP connection of its
+   *         own, or nullopt if the bytes are encapsulated, e.g. in an HTTP stream.
+   */
+  virtual OptRef<Network::Connection> connection() PURE;
 };
 
 using GenericConnPoolPtr = std::unique_ptr<GenericConnPool>;
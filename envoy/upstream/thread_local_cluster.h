@@ -64,6 +64,13 @@ public:
 
   Upstream::HostDescriptionConstSharedPtr host() const { return pool_->host(); }
 
+  /**
+   * @return the connection pool, which tells apart the pools of a host created for different
+   *         socket options or transport socket options. Connections must still be requested
+   *         through newConnection().
+   */
+  const Tcp::ConnectionPool::Instance& pool() const { return *pool_; }
+
 private:
   friend class TcpPoolDataPeer;
   OnNewConnectionFn on_new_connection_;
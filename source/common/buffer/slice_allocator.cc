@@ -0,0 +1,212 @@
+#include "source/common/buffer/slice_allocator.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+#include "source/common/runtime/runtime_features.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+// A magazine holds about this many bytes, so that small size classes cache more storage than large
+// ones, but never less than MinMagazineSlots pieces of storage.
+constexpr uint64_t MagazineBytes = 128 * 1024;
+constexpr uint64_t MinMagazineSlots = 2;
+
+using Magazine = std::vector<uint8_t*>;
+
+uint32_t sizeClass(uint64_t size) {
+  return static_cast<uint32_t>(size / SliceAllocator::PageSize) - 1;
+}
+
+uint64_t classSize(uint32_t size_class) {
+  return (static_cast<uint64_t>(size_class) + 1) * SliceAllocator::PageSize;
+}
+
+uint64_t magazineSlots(uint32_t size_class) {
+  return std::max(MinMagazineSlots, MagazineBytes / classSize(size_class));
+}
+
+void freeMagazine(Magazine& magazine) {
+  for (uint8_t* storage : magazine) {
+    delete[] storage;
+  }
+  magazine.clear();
+}
+
+// Full magazines shared by all threads.
+class Depot {
+public:
+  // Takes the storage of a magazine, or frees it if the depot is full.
+  void put(uint32_t size_class, Magazine&& magazine) {
+    const uint64_t bytes = magazine.size() * classSize(size_class);
+    {
+      absl::MutexLock lock(&mutex_);
+      if (bytes_ + bytes <= SliceAllocator::MaxDepotCachedBytes) {
+        bytes_ += bytes;
+        magazines_[size_class].push_back(std::move(magazine));
+        available_[size_class].store(magazines_[size_class].size(), std::memory_order_relaxed);
+        return;
+      }
+    }
+    freeMagazine(magazine);
+  }
+
+  // Refills an empty magazine, if the depot has storage of the size class.
+  bool take(uint32_t size_class, Magazine& magazine) {
+    ASSERT(magazine.empty());
+    // Avoid the lock while the depot has nothing to give, e.g. while all threads are still growing
+    // their working sets.
+    if (available_[size_class].load(std::memory_order_relaxed) == 0) {
+      return false;
+    }
+    absl::MutexLock lock(&mutex_);
+    std::vector<Magazine>& magazines = magazines_[size_class];
+    if (magazines.empty()) {
+      return false;
+    }
+    magazine.swap(magazines.back());
+    magazines.pop_back();
+    available_[size_class].store(magazines.size(), std::memory_order_relaxed);
+    bytes_ -= magazine.size() * classSize(size_class);
+    return true;
+  }
+
+  uint64_t bytes() {
+    absl::MutexLock lock(&mutex_);
+    return bytes_;
+  }
+
+  void release() {
+    absl::MutexLock lock(&mutex_);
+    for (uint32_t size_class = 0; size_class < SliceAllocator::NumSizeClasses; ++size_class) {
+      for (Magazine& magazine : magazines_[size_class]) {
+        freeMagazine(magazine);
+      }
+      magazines_[size_class].clear();
+      available_[size_class].store(0, std::memory_order_relaxed);
+    }
+    bytes_ = 0;
+  }
+
+private:
+  absl::Mutex mutex_;
+  std::array<std::vector<Magazine>, SliceAllocator::NumSizeClasses> magazines_
+      ABSL_GUARDED_BY(mutex_);
+  std::array<std::atomic<uint64_t>, SliceAllocator::NumSizeClasses> available_{};
+  uint64_t bytes_ ABSL_GUARDED_BY(mutex_){};
+};
+
+// The depot is never destroyed, as threads return their magazines to it when they exit.
+Depot& depot() { MUTABLE_CONSTRUCT_ON_FIRST_USE(Depot); }
+
+// Set once the cache of the thread is destroyed, so that slices destroyed later while the thread
+// exits bypass it.
+thread_local bool thread_cache_destroyed = false;
+
+class ThreadCache {
+public:
+  ~ThreadCache() {
+    thread_cache_destroyed = true;
+    for (uint32_t size_class = 0; size_class < SliceAllocator::NumSizeClasses; ++size_class) {
+      if (!magazines_[size_class].empty()) {
+        depot().put(size_class, std::move(magazines_[size_class]));
+      }
+    }
+  }
+
+  uint8_t* allocate(uint32_t size_class) {
+    Magazine& magazine = magazines_[size_class];
+    if (magazine.empty()) {
+      if (!depot().take(size_class, magazine)) {
+        return new uint8_t[classSize(size_class)];
+      }
+      bytes_ += magazine.size() * classSize(size_class);
+    }
+    uint8_t* storage = magazine.back();
+    magazine.pop_back();
+    bytes_ -= classSize(size_class);
+    return storage;
+  }
+
+  void free(uint32_t size_class, uint8_t* storage) {
+    Magazine& magazine = magazines_[size_class];
+    const uint64_t slots = magazineSlots(size_class);
+    if (magazine.size() >= slots) {
+      bytes_ -= magazine.size() * classSize(size_class);
+      depot().put(size_class, std::move(magazine));
+      magazine.clear();
+      magazine.reserve(slots);
+    }
+    if (bytes_ + classSize(size_class) > SliceAllocator::MaxThreadCachedBytes) {
+      delete[] storage;
+      return;
+    }
+    magazine.push_back(storage);
+    bytes_ += classSize(size_class);
+  }
+
+  uint64_t bytes() const { return bytes_; }
+
+  void release() {
+    for (Magazine& magazine : magazines_) {
+      freeMagazine(magazine);
+    }
+    bytes_ = 0;
+  }
+
+private:
+  std::array<Magazine, SliceAllocator::NumSizeClasses> magazines_;
+  // The bytes cached by all of the magazines.
+  uint64_t bytes_{};
+};
+
+ThreadCache& threadCache() {
+  static thread_local ThreadCache cache;
+  return cache;
+}
+
+bool cached(uint64_t size) {
+  return size != 0 && size <= SliceAllocator::MaxCachedSize && !thread_cache_destroyed &&
+         Runtime::runtimeFeatureEnabled("envoy.reloadable_features.buffer_slice_magazines");
+}
+
+} // namespace
+
+uint8_t* SliceAllocator::allocate(uint64_t size) {
+  ASSERT(size % PageSize == 0);
+  if (!cached(size)) {
+    return new uint8_t[size];
+  }
+  return threadCache().allocate(sizeClass(size));
+}
+
+void SliceAllocator::free(uint8_t* storage, uint64_t size) {
+  ASSERT(size % PageSize == 0);
+  // Storage allocated while caching was disabled may be cached, and the other way around, as all
+  // storage of a size class is allocated with the same size.
+  if (!cached(size)) {
+    delete[] storage;
+    return;
+  }
+  threadCache().free(sizeClass(size), storage);
+}
+
+uint64_t SliceAllocator::threadCachedBytesForTest() { return threadCache().bytes(); }
+
+uint64_t SliceAllocator::depotCachedBytesForTest() { return depot().bytes(); }
+
+void SliceAllocator::releaseCachedForTest() {
+  threadCache().release();
+  depot().release();
+}
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * Allocates the backing storage of buffer slices. Slice sizes are multiples of a page, and every
+ * page multiple up to MaxCachedSize is its own size class. Freed storage of a size class is kept in
+ * a thread local magazine and handed out again by the next allocation of the same size class on
+ * that thread, so workers mostly reuse storage instead of going through malloc and free.
+ *
+ * Storage is cached by the thread freeing it, wherever it was allocated. When a magazine is full,
+ * it is moved to a process wide depot, from which threads with an empty magazine for that size
+ * class refill. This is how storage freed on one thread returns to the threads allocating it.
+ *
+ * The cached storage isn't charged to any buffer memory account, so it is bounded instead: freeing
+ * storage never grows the cache of a thread beyond MaxThreadCachedBytes, nor the depot beyond
+ * MaxDepotCachedBytes, and storage beyond the bounds is freed. Refilling from the depot may exceed
+ * the thread bound by one magazine, at most 128KiB, until the storage is allocated again.
+ *
+ * Caching is disabled unless envoy.reloadable_features.buffer_slice_magazines is enabled. Empty
+ * storage, storage larger than MaxCachedSize and all storage while caching is disabled are
+ * allocated and freed directly.
+ */
+class SliceAllocator {
+public:
+  static constexpr uint64_t PageSize = 4096;
+  static constexpr uint64_t MaxCachedSize = 64 * 1024;
+  static constexpr uint32_t NumSizeClasses = MaxCachedSize / PageSize;
+  static constexpr uint64_t MaxThreadCachedBytes = 1024 * 1024;
+  static constexpr uint64_t MaxDepotCachedBytes = 4 * 1024 * 1024;
+
+  /**
+   * @param size supplies the size of the storage. Must be a multiple of PageSize.
+   * @return storage of the given size.
+   */
+  static uint8_t* allocate(uint64_t size);
+
+  /**
+   * Frees storage returned by allocate().
+   * @param storage supplies the storage to free.
+   * @param size supplies the size the storage was allocated with.
+   */
+  static void free(uint8_t* storage, uint64_t size);
+
+  /**
+   * @return the number of bytes cached by the magazines of the calling thread.
+   */
+  static uint64_t threadCachedBytesForTest();
+
+  /**
+   * @return the number of bytes cached in the depot.
+   */
+  static uint64_t depotCachedBytesForTest();
+
+  /**
+   * Frees all storage cached by the calling thread and by the depot.
+   */
+  static void releaseCachedForTest();
+};
+
+} // namespace Buffer
+} // namespace Envoy
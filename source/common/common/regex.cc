@@ -10,9 +10,68 @@
 #include "source/common/common/fmt.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+
 namespace Envoy {
 namespace Regex {
 
+namespace {
+
+// Returns the string matched by a regex made of literal characters only, or absl::nullopt if the
+// regex contains any operator. Only punctuation may be escaped, as escaped letters and digits
+// denote character classes and other operators.
+absl::optional<std::string> parseLiteral(absl::string_view regex) {
+  std::string literal;
+  literal.reserve(regex.size());
+  for (size_t i = 0; i < regex.size(); ++i) {
+    char c = regex[i];
+    if (c == '\\') {
+      if (++i == regex.size() || !absl::ascii_ispunct(regex[i])) {
+        return absl::nullopt;
+      }
+      c = regex[i];
+    } else if (absl::string_view(".[]{}()*+?^$|").find(c) != absl::string_view::npos) {
+      return absl::nullopt;
+    }
+    literal.push_back(c);
+  }
+  return literal;
+}
+
+// Returns whether the last character of the regex is preceded by an odd number of backslashes.
+bool lastCharacterEscaped(absl::string_view regex) {
+  size_t backslashes = 0;
+  while (backslashes + 1 < regex.size() && regex[regex.size() - 2 - backslashes] == '\\') {
+    ++backslashes;
+  }
+  return backslashes % 2 == 1;
+}
+
+// Strips a leading '^' and a trailing '$', which are redundant as the whole value is matched.
+absl::string_view stripAnchors(absl::string_view regex) {
+  if (absl::StartsWith(regex, "^")) {
+    regex.remove_prefix(1);
+  }
+  if (absl::EndsWith(regex, "$") && !lastCharacterEscaped(regex)) {
+    regex.remove_suffix(1);
+  }
+  return regex;
+}
+
+// Returns whether ".*" matches the whole value. Values containing non-ASCII characters are
+// reported as not matching, as RE2 only matches valid UTF-8 with ".".
+bool isAsciiWithoutNewlines(absl::string_view value) {
+  for (const char c : value) {
+    if (c == '\n' || static_cast<unsigned char>(c) >= 0x80) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
 CompiledGoogleReMatcher::CompiledGoogleReMatcher(const std::string& regex,
                                                  bool do_program_size_check)
     : regex_(regex, re2::RE2::Quiet) {
@@ -20,6 +79,10 @@ CompiledGoogleReMatcher::CompiledGoogleReMatcher(const std::string& regex,
     throw EnvoyException(regex_.error());
   }
 
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.regex_literal_fast_path")) {
+    analyzeLiterals(regex);
+  }
+
   if (do_program_size_check && Runtime::isRuntimeInitialized()) {
     const uint32_t regex_program_size = static_cast<uint32_t>(regex_.ProgramSize());
     const uint32_t max_program_size_error_level =
@@ -59,6 +122,89 @@ CompiledGoogleReMatcher::CompiledGoogleReMatcher(
   }
 }
 
+void CompiledGoogleReMatcher::analyzeLiterals(absl::string_view regex) {
+  regex = stripAnchors(regex);
+
+  // An alternation of literals, optionally wrapped in a group.
+  if (absl::StrContains(regex, '|')) {
+    if (absl::EndsWith(regex, ")") && !lastCharacterEscaped(regex)) {
+      if (absl::StartsWith(regex, "(?:")) {
+        regex = regex.substr(3, regex.size() - 4);
+      } else if (absl::StartsWith(regex, "(")) {
+        regex = regex.substr(1, regex.size() - 2);
+      }
+    }
+    absl::flat_hash_set<std::string> literals;
+    size_t start = 0;
+    for (size_t i = 0; i <= regex.size(); ++i) {
+      if (i < regex.size() && regex[i] == '\\') {
+        ++i;
+      } else if (i == regex.size() || regex[i] == '|') {
+        absl::optional<std::string> literal = parseLiteral(regex.substr(start, i - start));
+        if (!literal.has_value()) {
+          return;
+        }
+        literals.insert(std::move(literal.value()));
+        start = i + 1;
+      }
+    }
+    literals_ = std::move(literals);
+    literal_match_type_ = LiteralMatchType::ExactSet;
+    return;
+  }
+
+  // A literal, optionally preceded and followed by ".*".
+  const bool leading_wildcard = absl::StartsWith(regex, ".*");
+  if (leading_wildcard) {
+    regex.remove_prefix(2);
+  }
+  const bool trailing_wildcard =
+      absl::EndsWith(regex, ".*") && !lastCharacterEscaped(regex.substr(0, regex.size() - 1));
+  if (trailing_wildcard) {
+    regex.remove_suffix(2);
+  }
+  absl::optional<std::string> literal = parseLiteral(regex);
+  if (!literal.has_value()) {
+    return;
+  }
+  literal_ = std::move(literal.value());
+  if (leading_wildcard && trailing_wildcard) {
+    literal_match_type_ = LiteralMatchType::Contains;
+  } else if (leading_wildcard) {
+    literal_match_type_ = LiteralMatchType::Suffix;
+  } else if (trailing_wildcard) {
+    literal_match_type_ = LiteralMatchType::Prefix;
+  } else {
+    literal_match_type_ = LiteralMatchType::Exact;
+  }
+}
+
+bool CompiledGoogleReMatcher::literalMatch(absl::string_view value) const {
+  switch (literal_match_type_) {
+  case LiteralMatchType::Exact:
+    return value == literal_;
+  case LiteralMatchType::ExactSet:
+    return literals_.contains(value);
+  case LiteralMatchType::Prefix:
+  case LiteralMatchType::Suffix:
+  case LiteralMatchType::Contains:
+    // Values which ".*" may not match are left to RE2.
+    if (!isAsciiWithoutNewlines(value)) {
+      return re2::RE2::FullMatch(re2::StringPiece(value.data(), value.size()), regex_);
+    }
+    if (literal_match_type_ == LiteralMatchType::Prefix) {
+      return absl::StartsWith(value, literal_);
+    }
+    if (literal_match_type_ == LiteralMatchType::Suffix) {
+      return absl::EndsWith(value, literal_);
+    }
+    return absl::StrContains(value, literal_);
+  case LiteralMatchType::None:
+    break;
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
 CompiledMatcherPtr GoogleReEngine::matcher(const std::string& regex) const {
   return std::make_unique<CompiledGoogleReMatcher>(regex, true);
 }
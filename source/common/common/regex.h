@@ -12,6 +12,7 @@
 #include "source/common/singleton/threadsafe_singleton.h"
 #include "source/common/stats/symbol_table.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "re2/re2.h"
 #include "xds/type/matcher/v3/regex.pb.h"
 
@@ -29,6 +30,9 @@ public:
 
   // CompiledMatcher
   bool match(absl::string_view value) const override {
+    if (literal_match_type_ != LiteralMatchType::None) {
+      return literalMatch(value);
+    }
     return re2::RE2::FullMatch(re2::StringPiece(value.data(), value.size()), regex_);
   }
 
@@ -41,7 +45,17 @@ public:
   }
 
 private:
+  // Regexes which only compare the value with literals are matched without running RE2. A literal
+  // may be surrounded by ``.*``, as in prefix, suffix and substring matches.
+  enum class LiteralMatchType { None, Exact, Prefix, Suffix, Contains, ExactSet };
+
+  void analyzeLiterals(absl::string_view regex);
+  bool literalMatch(absl::string_view value) const;
+
   const re2::RE2 regex_;
+  LiteralMatchType literal_match_type_{LiteralMatchType::None};
+  std::string literal_;
+  absl::flat_hash_set<std::string> literals_;
 };
 
 class GoogleReEngine : public Engine {
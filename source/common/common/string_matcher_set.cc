@@ -0,0 +1,164 @@
+#include "source/common/common/string_matcher_set.h"
+
+#include <queue>
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Matchers {
+namespace {
+
+constexpr uint32_t NoTransition = UINT32_MAX;
+
+} // namespace
+
+StringMatcherSet::StringMatcherSet(const std::vector<Pattern>& patterns) {
+  std::vector<const Pattern*> case_sensitive_patterns;
+  std::vector<const Pattern*> case_insensitive_patterns;
+  for (const Pattern& pattern : patterns) {
+    if (pattern.value_.empty()) {
+      if (pattern.type_ == MatchType::Exact) {
+        matches_empty_ = true;
+      } else {
+        matches_everything_ = true;
+      }
+    } else if (pattern.ignore_case_) {
+      case_insensitive_patterns.push_back(&pattern);
+    } else {
+      case_sensitive_patterns.push_back(&pattern);
+    }
+  }
+  if (!case_sensitive_patterns.empty()) {
+    automatons_.emplace_back(case_sensitive_patterns, false);
+  }
+  if (!case_insensitive_patterns.empty()) {
+    automatons_.emplace_back(case_insensitive_patterns, true);
+  }
+}
+
+bool StringMatcherSet::matchAny(absl::string_view value) const {
+  if (matches_everything_ || (matches_empty_ && value.empty())) {
+    return true;
+  }
+  for (const Automaton& automaton : automatons_) {
+    if (automaton.matchAny(value)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+StringMatcherSet::Automaton::Automaton(const std::vector<const Pattern*>& patterns,
+                                       bool ignore_case) {
+  const auto normalize = [ignore_case](char c) {
+    return static_cast<uint8_t>(ignore_case ? absl::ascii_tolower(c) : c);
+  };
+
+  // Assign a class to every byte used by the patterns. With ignore_case, upper case bytes share
+  // the class of their lower case counterpart, so that values don't need to be lower cased.
+  std::array<bool, 256> used{};
+  for (const Pattern* pattern : patterns) {
+    for (const char c : pattern->value_) {
+      used[normalize(c)] = true;
+    }
+  }
+  std::array<uint16_t, 256> normalized_classes{};
+  for (size_t byte = 0; byte < used.size(); ++byte) {
+    if (used[byte]) {
+      normalized_classes[byte] = num_classes_++;
+    }
+  }
+  for (size_t byte = 0; byte < byte_classes_.size(); ++byte) {
+    byte_classes_[byte] = normalized_classes[normalize(static_cast<char>(byte))];
+  }
+
+  // Build the trie of the patterns. Missing transitions are filled in below.
+  const auto add_state = [this]() {
+    transitions_.resize(transitions_.size() + num_classes_, NoTransition);
+    accepting_.push_back(false);
+    outputs_.emplace_back();
+    return static_cast<uint32_t>(accepting_.size() - 1);
+  };
+  add_state();
+  for (const Pattern* pattern : patterns) {
+    uint32_t state = 0;
+    for (const char c : pattern->value_) {
+      uint32_t& next = transitions_[state * num_classes_ + byte_classes_[static_cast<uint8_t>(c)]];
+      if (next == NoTransition) {
+        // add_state() may reallocate the table that next points to.
+        const uint32_t new_state = add_state();
+        transitions_[state * num_classes_ + byte_classes_[static_cast<uint8_t>(c)]] = new_state;
+        state = new_state;
+      } else {
+        state = next;
+      }
+    }
+    if (pattern->type_ == MatchType::Contains) {
+      accepting_[state] = true;
+    } else {
+      outputs_[state].push_back({pattern->type_, static_cast<uint32_t>(pattern->value_.size())});
+    }
+  }
+
+  // Visit the states breadth first to compute their failure states, i.e. the states of the
+  // longest proper suffixes of their paths which are also in the trie. Each missing transition is
+  // replaced by the transition of the failure state, and each state inherits the outputs of its
+  // failure state, which turns the trie into a deterministic automaton.
+  std::vector<uint32_t> failure(accepting_.size(), 0);
+  std::queue<uint32_t> states;
+  states.push(0);
+  while (!states.empty()) {
+    const uint32_t state = states.front();
+    states.pop();
+    for (uint32_t byte_class = 0; byte_class < num_classes_; ++byte_class) {
+      uint32_t& next = transitions_[state * num_classes_ + byte_class];
+      const uint32_t failure_next =
+          state == 0 ? 0 : transitions_[failure[state] * num_classes_ + byte_class];
+      if (next == NoTransition) {
+        next = failure_next;
+        continue;
+      }
+      failure[next] = failure_next;
+      accepting_[next] = accepting_[next] || accepting_[failure_next];
+      outputs_[next].insert(outputs_[next].end(), outputs_[failure_next].begin(),
+                            outputs_[failure_next].end());
+      states.push(next);
+    }
+  }
+}
+
+bool StringMatcherSet::Automaton::matchAny(absl::string_view value) const {
+  uint32_t state = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    state = transition(state, value[i]);
+    if (accepting_[state]) {
+      return true;
+    }
+    const size_t end = i + 1;
+    for (const Output& output : outputs_[state]) {
+      switch (output.type_) {
+      case MatchType::Exact:
+        if (output.length_ == end && end == value.size()) {
+          return true;
+        }
+        break;
+      case MatchType::Prefix:
+        if (output.length_ == end) {
+          return true;
+        }
+        break;
+      case MatchType::Suffix:
+        if (end == value.size()) {
+          return true;
+        }
+        break;
+      case MatchType::Contains:
+        break;
+      }
+    }
+  }
+  return false;
+}
+
+} // namespace Matchers
+} // namespace Envoy
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Matchers {
+
+/**
+ * A set of exact, prefix, suffix and contains string matchers which are evaluated together against
+ * a value by scanning it once, instead of once per matcher. The patterns are compiled into
+ * Aho-Corasick automatons, one for case sensitive patterns and one for case insensitive ones.
+ *
+ * This is meant for configurations where many string matchers apply to the same input and are
+ * combined with a logical OR, e.g. lists of header values allowed by RBAC policies.
+ */
+class StringMatcherSet {
+public:
+  enum class MatchType { Exact, Prefix, Suffix, Contains };
+
+  struct Pattern {
+    MatchType type_;
+    std::string value_;
+    bool ignore_case_;
+  };
+
+  /**
+   * @return the pattern matching the same values as a StringMatcher proto, or absl::nullopt if the
+   *         matcher can't be part of a StringMatcherSet, e.g. because it is a regex.
+   */
+  template <class StringMatcherType>
+  static absl::optional<Pattern> toPattern(const StringMatcherType& matcher) {
+    switch (matcher.match_pattern_case()) {
+    case StringMatcherType::MatchPatternCase::kExact:
+      return Pattern{MatchType::Exact, matcher.exact(), matcher.ignore_case()};
+    case StringMatcherType::MatchPatternCase::kPrefix:
+      return Pattern{MatchType::Prefix, matcher.prefix(), matcher.ignore_case()};
+    case StringMatcherType::MatchPatternCase::kSuffix:
+      return Pattern{MatchType::Suffix, matcher.suffix(), matcher.ignore_case()};
+    case StringMatcherType::MatchPatternCase::kContains:
+      return Pattern{MatchType::Contains, matcher.contains(), matcher.ignore_case()};
+    default:
+      return absl::nullopt;
+    }
+  }
+
+  explicit StringMatcherSet(const std::vector<Pattern>& patterns);
+
+  /**
+   * @return whether any of the patterns matches the value.
+   */
+  bool matchAny(absl::string_view value) const;
+
+private:
+  class Automaton {
+  public:
+    Automaton(const std::vector<const Pattern*>& patterns, bool ignore_case);
+
+    bool matchAny(absl::string_view value) const;
+
+  private:
+    // A pattern which ends in a state, and whose position in the value must be checked.
+    struct Output {
+      MatchType type_;
+      uint32_t length_;
+    };
+
+    uint32_t transition(uint32_t state, char c) const {
+      return transitions_[state * num_classes_ + byte_classes_[static_cast<uint8_t>(c)]];
+    }
+
+    // Bytes are mapped to classes of bytes which no pattern tells apart, which keeps the
+    // transition table small. Class 0 holds the bytes which don't appear in any pattern.
+    std::array<uint16_t, 256> byte_classes_{};
+    uint32_t num_classes_{1};
+    // Transitions of the state machine, num_classes_ per state. State 0 is the initial state.
+    std::vector<uint32_t> transitions_;
+    // Whether a contains pattern ends in each state, in which case the value matches.
+    std::vector<bool> accepting_;
+    // The exact, prefix and suffix patterns ending in each state.
+    std::vector<std::vector<Output>> outputs_;
+  };
+
+  // Set if an empty contains, prefix or suffix pattern matches every value.
+  bool matches_everything_{};
+  // Set if an empty exact pattern matches empty values.
+  bool matches_empty_{};
+  std::vector<Automaton> automatons_;
+};
+
+} // namespace Matchers
+} // namespace Envoy
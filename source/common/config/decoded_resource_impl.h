@@ -4,6 +4,7 @@
 #include "envoy/config/subscription.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
+#include "source/common/common/hash.h"
 #include "source/common/protobuf/utility.h"
 
 #include "xds/core/v3/collection_entry.pb.h"
@@ -27,9 +28,11 @@ using DecodedResourceImplPtr = std::unique_ptr<DecodedResourceImpl>;
 
 class DecodedResourceImpl : public DecodedResource {
 public:
+  // If set, wire_hash is computeWireHash(resource), which is then not computed again.
   static DecodedResourceImplPtr fromResource(OpaqueResourceDecoder& resource_decoder,
                                              const ProtobufWkt::Any& resource,
-                                             const std::string& version) {
+                                             const std::string& version,
+                                             absl::optional<uint64_t> wire_hash = absl::nullopt) {
     if (resource.Is<envoy::service::discovery::v3::Resource>()) {
       envoy::service::discovery::v3::Resource r;
       MessageUtil::unpackTo(resource, r);
@@ -41,7 +44,7 @@ public:
 
     return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
         resource_decoder, absl::nullopt, Protobuf::RepeatedPtrField<std::string>(), resource, true,
-        version, absl::nullopt, absl::nullopt));
+        version, absl::nullopt, absl::nullopt, wire_hash));
   }
 
   static DecodedResourceImplPtr
@@ -67,7 +70,14 @@ public:
   DecodedResourceImpl(ProtobufTypes::MessagePtr resource, const std::string& name,
                       const std::vector<std::string>& aliases, const std::string& version)
       : resource_(std::move(resource)), has_resource_(true), name_(name), aliases_(aliases),
-        version_(version), ttl_(absl::nullopt), metadata_(absl::nullopt) {}
+        version_(version), ttl_(absl::nullopt), metadata_(absl::nullopt),
+        wire_hash_(absl::nullopt) {}
+  // Shares the decoded message of an already decoded resource, at a new version. This is used to
+  // skip decoding resources which a later update carries unchanged.
+  DecodedResourceImpl(const DecodedResourceImpl& resource, const std::string& version)
+      : resource_(resource.resource_), has_resource_(resource.has_resource_),
+        name_(resource.name_), aliases_(resource.aliases_), version_(version),
+        ttl_(resource.ttl_), metadata_(resource.metadata_), wire_hash_(resource.wire_hash_) {}
 
   // Config::DecodedResource
   const std::string& name() const override { return name_; }
@@ -79,19 +89,33 @@ public:
   const OptRef<const envoy::config::core::v3::Metadata> metadata() const override {
     return metadata_;
   }
+  absl::optional<uint64_t> wireHash() const override { return wire_hash_; }
+
+  /**
+   * @return the hash of a serialized resource, as returned by wireHash() for a resource decoded
+   *         from it, unless it is wrapped in a Resource.
+   */
+  static uint64_t computeWireHash(const ProtobufWkt::Any& resource) {
+    return HashUtil::xxHash64(resource.value(), HashUtil::xxHash64(resource.type_url()));
+  }
 
 private:
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder, absl::optional<std::string> name,
                       const Protobuf::RepeatedPtrField<std::string>& aliases,
                       const ProtobufWkt::Any& resource, bool has_resource,
                       const std::string& version, absl::optional<std::chrono::milliseconds> ttl,
-                      const OptRef<const envoy::config::core::v3::Metadata> metadata)
+                      const OptRef<const envoy::config::core::v3::Metadata> metadata,
+                      absl::optional<uint64_t> wire_hash = absl::nullopt)
       : resource_(resource_decoder.decodeResource(resource)), has_resource_(has_resource),
         name_(name ? *name : resource_decoder.resourceName(*resource_)),
         aliases_(repeatedPtrFieldToVector(aliases)), version_(version), ttl_(ttl),
-        metadata_(metadata) {}
+        metadata_(metadata),
+        wire_hash_(!has_resource ? absl::nullopt
+                   : wire_hash   ? wire_hash
+                                 : absl::make_optional(computeWireHash(resource))) {}
 
-  const ProtobufTypes::MessagePtr resource_;
+  // Shared between the copies of a resource reused across updates, and never modified.
+  const std::shared_ptr<const Protobuf::Message> resource_;
   const bool has_resource_;
   const std::string name_;
   const std::vector<std::string> aliases_;
@@ -102,6 +126,8 @@ private:
   // This is the metadata info under the Resource wrapper.
   // It is intended to be consumed in the xds_config_tracker extension.
   const OptRef<const envoy::config::core::v3::Metadata> metadata_;
+  // Hash of the serialized resource this was decoded from, if any.
+  const absl::optional<uint64_t> wire_hash_;
 };
 
 struct DecodedResourcesWrapper {
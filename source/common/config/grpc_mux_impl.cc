@@ -7,6 +7,7 @@
 #include "source/common/config/xds_source_id.h"
 #include "source/common/memory/utils.h"
 #include "source/common/protobuf/protobuf.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "absl/container/btree_map.h"
 #include "absl/container/node_hash_set.h"
@@ -291,6 +292,10 @@ void GrpcMuxImpl::onDiscoveryResponse(
   TRY_ASSERT_MAIN_THREAD {
     std::vector<DecodedResourcePtr> resources;
     OpaqueResourceDecoder& resource_decoder = *api_state.watches_.front()->resource_decoder_;
+    const bool reuse_decoded_resources =
+        Runtime::runtimeFeatureEnabled("envoy.reloadable_features.xds_reuse_unchanged_resources");
+    // Replaces api_state.decoded_resources_ once the update is accepted.
+    absl::flat_hash_map<uint64_t, ReusableResource> decoded_resources;
 
     for (const auto& resource : message->resources()) {
       // TODO(snowp): Check the underlying type when the resource is a Resource.
@@ -301,8 +306,26 @@ void GrpcMuxImpl::onDiscoveryResponse(
                         resource.type_url(), type_url, message->DebugString()));
       }
 
-      auto decoded_resource =
-          DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info());
+      DecodedResourceImplPtr decoded_resource;
+      if (reuse_decoded_resources) {
+        const uint64_t hash = DecodedResourceImpl::computeWireHash(resource);
+        auto it = api_state.decoded_resources_.find(hash);
+        if (it != api_state.decoded_resources_.end() &&
+            it->second.serialized_resource_.type_url() == resource.type_url() &&
+            it->second.serialized_resource_.value() == resource.value()) {
+          decoded_resource = std::make_unique<DecodedResourceImpl>(
+              *it->second.decoded_resource_, message->version_info());
+        } else {
+          decoded_resource = DecodedResourceImpl::fromResource(
+              resource_decoder, resource, message->version_info(), hash);
+        }
+        decoded_resources.emplace(
+            hash, ReusableResource{resource, std::make_unique<DecodedResourceImpl>(
+                                                 *decoded_resource, message->version_info())});
+      } else {
+        decoded_resource =
+            DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info());
+      }
 
       if (!isHeartbeatResource(type_url, *decoded_resource)) {
         resources.emplace_back(std::move(decoded_resource));
@@ -311,6 +334,9 @@ void GrpcMuxImpl::onDiscoveryResponse(
 
     processDiscoveryResources(resources, api_state, type_url, message->version_info(),
                               /*call_delegate=*/true);
+    if (reuse_decoded_resources) {
+      api_state.decoded_resources_ = std::move(decoded_resources);
+    }
 
     // Processing point when resources are successfully ingested.
     if (xds_config_tracker_.has_value()) {
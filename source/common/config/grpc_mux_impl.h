@@ -20,12 +20,14 @@
 #include "source/common/common/utility.h"
 #include "source/common/config/api_version.h"
 #include "source/common/config/custom_config_validators.h"
+#include "source/common/config/decoded_resource_impl.h"
 #include "source/common/config/grpc_stream.h"
 #include "source/common/config/ttl.h"
 #include "source/common/config/utility.h"
 #include "source/common/config/xds_context_params.h"
 #include "source/common/config/xds_resource.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "xds/core/v3/resource_name.pb.h"
 
@@ -160,6 +162,13 @@ private:
     WatchList::iterator iter_;
   };
 
+  // A resource of the most recently accepted update of an API, as received and decoded.
+  struct ReusableResource {
+    // Compared to the resources of later updates, as their hashes may collide.
+    ProtobufWkt::Any serialized_resource_;
+    DecodedResourceImplPtr decoded_resource_;
+  };
+
   // Per muxed API state.
   struct ApiState {
     ApiState(Event::Dispatcher& dispatcher,
@@ -184,6 +193,11 @@ private:
     // The identifier for the server that sent the most recent response, or
     // empty if there is none.
     std::string control_plane_identifier_{};
+    // Resources of the most recently accepted update, keyed by the
+    // DecodedResourceImpl::computeWireHash() of their serialized form. Control planes commonly
+    // resend every resource of a type on each update, so resources that are unchanged are reused
+    // instead of being decoded and validated again.
+    absl::flat_hash_map<uint64_t, ReusableResource> decoded_resources_;
   };
 
   bool isHeartbeatResource(const std::string& type_url, const DecodedResource& resource) {
@@ -107,8 +107,11 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope,
   post([this, &scope, effective_prefix] {
     stats_prefix_ = effective_prefix + "dispatcher";
     stats_ = std::make_unique<DispatcherStats>(
-        DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
-    base_scheduler_.initializeStats(stats_.get());
+        DispatcherStats{ALL_DISPATCHER_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix_ + "."),
+                                             POOL_GAUGE_PREFIX(scope, stats_prefix_ + "."),
+                                             POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
+    instrumentation_ = std::make_unique<DispatcherInstrumentation>(name_, *stats_, time_source_);
+    base_scheduler_.initializeStats(stats_.get(), instrumentation_.get());
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_.debugString());
   });
 }
@@ -134,6 +137,8 @@ void DispatcherImpl::clearDeferredDeleteList() {
 
   touchWatchdog();
   deferred_deleting_ = true;
+  DispatcherInstrumentation::ScopedCallback scoped_callback(instrumentation_.get(),
+                                                            CallbackType::DeferredDelete);
 
   // Calling clear() on the vector does not specify which order destructors run in. We want to
   // destroy in FIFO order so just do it manually. This required 2 passes over the vector which is
@@ -179,8 +184,10 @@ FileEventPtr DispatcherImpl::createFileEvent(os_fd_t fd, FileReadyCb cb, FileTri
   ASSERT(isThreadSafe());
   return FileEventPtr{new FileEventImpl(
       *this, fd,
-      [this, cb](uint32_t events) {
+      [this, cb, source = &cb.target_type()](uint32_t events) {
         touchWatchdog();
+        DispatcherInstrumentation::ScopedCallback scoped_callback(instrumentation_.get(),
+                                                                  CallbackType::FileEvent, source);
         cb(events);
       },
       trigger, events)};
@@ -227,16 +234,20 @@ TimerPtr DispatcherImpl::createScaledTimer(ScaledTimerMinimum minimum, TimerCb c
 
 Event::SchedulableCallbackPtr DispatcherImpl::createSchedulableCallback(std::function<void()> cb) {
   ASSERT(isThreadSafe());
-  return base_scheduler_.createSchedulableCallback([this, cb]() {
+  return base_scheduler_.createSchedulableCallback([this, cb, source = &cb.target_type()]() {
     touchWatchdog();
+    DispatcherInstrumentation::ScopedCallback scoped_callback(
+        instrumentation_.get(), CallbackType::SchedulableCallback, source);
     cb();
   });
 }
 
 TimerPtr DispatcherImpl::createTimerInternal(TimerCb cb) {
   return scheduler_->createTimer(
-      [this, cb]() {
+      [this, cb, source = &cb.target_type()]() {
         touchWatchdog();
+        DispatcherInstrumentation::ScopedCallback scoped_callback(instrumentation_.get(),
+                                                                  CallbackType::Timer, source);
         cb();
       },
       *this);
@@ -376,7 +387,11 @@ void DispatcherImpl::runPostCallbacks() {
     // executing a long list of callbacks.
     touchWatchdog();
     // Run the callback.
-    callbacks.front()();
+    {
+      DispatcherInstrumentation::ScopedCallback scoped_callback(instrumentation_.get(),
+                                                                CallbackType::Post);
+      callbacks.front()();
+    }
     // Pop the front so that the destructor of the callback that just executed runs before the next
     // callback executes.
     callbacks.pop_front();
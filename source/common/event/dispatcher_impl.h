@@ -16,6 +16,7 @@
 
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
+#include "source/common/event/dispatcher_instrumentation.h"
 #include "source/common/event/libevent.h"
 #include "source/common/event/libevent_scheduler.h"
 #include "source/common/signal/fatal_error_handler.h"
@@ -153,6 +154,8 @@ private:
   Filesystem::Instance& file_system_;
   std::string stats_prefix_;
   DispatcherStatsPtr stats_;
+  // Set together with stats_, and only accessed on the thread of the dispatcher.
+  DispatcherInstrumentationPtr instrumentation_;
   Thread::ThreadId run_tid_;
   Buffer::WatermarkFactorySharedPtr buffer_factory_;
   LibeventScheduler base_scheduler_;
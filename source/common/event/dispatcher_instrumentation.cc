@@ -0,0 +1,153 @@
+#include "source/common/event/dispatcher_instrumentation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/macros.h"
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+
+#include <cstdlib>
+#endif
+
+namespace Envoy {
+namespace Event {
+
+namespace {
+
+// All live instrumented dispatchers, for the admin endpoint.
+ABSL_CONST_INIT absl::Mutex registry_mutex(absl::kConstInit);
+
+std::list<const DispatcherInstrumentation*>& registry() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(std::list<const DispatcherInstrumentation*>);
+}
+
+} // namespace
+
+DispatcherInstrumentation::DispatcherInstrumentation(const std::string& name,
+                                                     DispatcherStats& stats,
+                                                     TimeSource& time_source)
+    : name_(name), stats_(stats), time_source_(time_source),
+      time_counters_{&stats.file_event_time_us_, &stats.timer_time_us_,
+                     &stats.schedulable_callback_time_us_, &stats.post_time_us_,
+                     &stats.deferred_delete_time_us_} {
+  slowest_callbacks_.reserve(MaxSlowCallbacks + 1);
+  {
+    absl::MutexLock lock(&mutex_);
+    published_.name_ = name_;
+  }
+  absl::MutexLock lock(&registry_mutex);
+  registry().push_back(this);
+}
+
+DispatcherInstrumentation::~DispatcherInstrumentation() {
+  absl::MutexLock lock(&registry_mutex);
+  registry().remove(this);
+}
+
+void DispatcherInstrumentation::onCallback(CallbackType type, const std::type_info* source,
+                                           MonotonicTime start) {
+  const auto duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(time_source_.monotonicTime() - start);
+  const size_t index = static_cast<size_t>(type);
+  ++callback_times_[index].count_;
+  callback_times_[index].total_time_ += duration;
+  unpublished_times_[index] += duration;
+  ++callbacks_this_loop_;
+
+  // Most callbacks are faster than the slowest ones seen so far, and only cost this comparison.
+  if (slowest_callbacks_.size() == MaxSlowCallbacks &&
+      duration <= slowest_callbacks_.back().duration_) {
+    return;
+  }
+  const auto position = std::upper_bound(
+      slowest_callbacks_.begin(), slowest_callbacks_.end(), duration,
+      [](std::chrono::microseconds d, const SlowCallback& slow) { return d > slow.duration_; });
+  slowest_callbacks_.insert(position, SlowCallback{type, source, duration});
+  if (slowest_callbacks_.size() > MaxSlowCallbacks) {
+    slowest_callbacks_.pop_back();
+  }
+}
+
+void DispatcherInstrumentation::onLoopBusy(std::chrono::microseconds busy) {
+  stats_.callbacks_per_loop_.recordValue(callbacks_this_loop_);
+  callbacks_this_loop_ = 0;
+  busy_ += busy;
+  if (busy_ + idle_ >= PublishInterval) {
+    publish();
+  }
+}
+
+void DispatcherInstrumentation::onLoopIdle(std::chrono::microseconds idle) { idle_ += idle; }
+
+void DispatcherInstrumentation::publish() {
+  const double utilization = static_cast<double>(busy_.count()) / (busy_ + idle_).count();
+  busy_ = idle_ = std::chrono::microseconds::zero();
+
+  stats_.utilization_percent_.set(std::lround(utilization * 100));
+  for (size_t i = 0; i < NumCallbackTypes; ++i) {
+    time_counters_[i]->add(unpublished_times_[i].count());
+    unpublished_times_[i] = std::chrono::microseconds::zero();
+  }
+
+  absl::MutexLock lock(&mutex_);
+  published_.utilization_ = utilization;
+  published_.callback_times_ = callback_times_;
+  published_.slowest_callbacks_.swap(slowest_callbacks_);
+  slowest_callbacks_.clear();
+  slowest_callbacks_.reserve(MaxSlowCallbacks + 1);
+}
+
+DispatcherInstrumentation::Snapshot DispatcherInstrumentation::snapshot() const {
+  absl::MutexLock lock(&mutex_);
+  return published_;
+}
+
+std::vector<DispatcherInstrumentation::Snapshot> DispatcherInstrumentation::snapshotAll() {
+  std::vector<Snapshot> snapshots;
+  absl::MutexLock lock(&registry_mutex);
+  for (const DispatcherInstrumentation* instrumentation : registry()) {
+    snapshots.push_back(instrumentation->snapshot());
+  }
+  std::sort(snapshots.begin(), snapshots.end(),
+            [](const Snapshot& a, const Snapshot& b) { return a.name_ < b.name_; });
+  return snapshots;
+}
+
+absl::string_view DispatcherInstrumentation::callbackTypeName(CallbackType type) {
+  switch (type) {
+  case CallbackType::FileEvent:
+    return "file_event";
+  case CallbackType::Timer:
+    return "timer";
+  case CallbackType::SchedulableCallback:
+    return "schedulable_callback";
+  case CallbackType::Post:
+    return "post";
+  case CallbackType::DeferredDelete:
+    return "deferred_delete";
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+std::string DispatcherInstrumentation::sourceName(const std::type_info* source) {
+  if (source == nullptr) {
+    return "";
+  }
+#if defined(__GNUC__)
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(source->name(), nullptr, nullptr, &status);
+  if (status == 0 && demangled != nullptr) {
+    std::string name(demangled);
+    ::free(demangled);
+    return name;
+  }
+#endif
+  return source->name();
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/stats/stats.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * The types of callbacks the event loop of a dispatcher runs.
+ */
+enum class CallbackType {
+  FileEvent,
+  Timer,
+  SchedulableCallback,
+  Post,
+  DeferredDelete,
+};
+
+inline constexpr size_t NumCallbackTypes = 5;
+
+/**
+ * Instruments the event loop of a dispatcher with dispatcher stats enabled. It keeps track of the
+ * share of time the loop spends running callbacks rather than polling, the time spent per callback
+ * type, and the slowest callbacks of each PublishInterval.
+ *
+ * Everything is accumulated in plain members on the thread of the dispatcher, and only published
+ * to the stats and to snapshot() once per PublishInterval of loop time, so that timing a callback
+ * costs two clock reads. All methods except snapshot() and snapshotAll() must be called on the
+ * thread of the dispatcher.
+ */
+class DispatcherInstrumentation {
+public:
+  static constexpr size_t MaxSlowCallbacks = 10;
+  static constexpr std::chrono::microseconds PublishInterval = std::chrono::seconds(1);
+
+  struct CallbackTime {
+    uint64_t count_{};
+    std::chrono::microseconds total_time_{};
+  };
+
+  struct SlowCallback {
+    CallbackType type_;
+    // The type of the function object of the callback, or nullptr if it isn't known.
+    const std::type_info* source_;
+    std::chrono::microseconds duration_;
+  };
+
+  struct Snapshot {
+    std::string name_;
+    double utilization_{};
+    std::array<CallbackTime, NumCallbackTypes> callback_times_{};
+    // The slowest callbacks of the last PublishInterval, slowest first.
+    std::vector<SlowCallback> slowest_callbacks_;
+  };
+
+  /**
+   * Times a callback while in scope. A callback which runs within another timed callback, e.g. a
+   * deferred delete list cleared from a timer, is accounted to the outer callback only, so that no
+   * time is counted twice. Does nothing if instrumentation is nullptr.
+   */
+  class ScopedCallback {
+  public:
+    ScopedCallback(DispatcherInstrumentation* instrumentation, CallbackType type,
+                   const std::type_info* source = nullptr)
+        : instrumentation_(instrumentation), type_(type), source_(source) {
+      if (instrumentation_ != nullptr && instrumentation_->depth_++ == 0) {
+        start_ = instrumentation_->time_source_.monotonicTime();
+      }
+    }
+
+    ~ScopedCallback() {
+      if (instrumentation_ != nullptr && --instrumentation_->depth_ == 0) {
+        instrumentation_->onCallback(type_, source_, start_);
+      }
+    }
+
+  private:
+    DispatcherInstrumentation* const instrumentation_;
+    const CallbackType type_;
+    const std::type_info* const source_;
+    MonotonicTime start_;
+  };
+
+  DispatcherInstrumentation(const std::string& name, DispatcherStats& stats,
+                            TimeSource& time_source);
+  ~DispatcherInstrumentation();
+
+  /**
+   * Called once per loop iteration, right before polling.
+   * @param busy supplies the time spent since polling returned in the previous iteration.
+   */
+  void onLoopBusy(std::chrono::microseconds busy);
+
+  /**
+   * Called once per loop iteration, right after polling.
+   * @param idle supplies the time spent polling.
+   */
+  void onLoopIdle(std::chrono::microseconds idle);
+
+  /**
+   * @return the values published last. Thread safe.
+   */
+  Snapshot snapshot() const;
+
+  /**
+   * @return the values published last by all live instrumented dispatchers. Thread safe.
+   */
+  static std::vector<Snapshot> snapshotAll();
+
+  /**
+   * @return the name of a callback type as used in stats, e.g. "file_event".
+   */
+  static absl::string_view callbackTypeName(CallbackType type);
+
+  /**
+   * @return the readable name of the source of a callback, or an empty string if it isn't known.
+   */
+  static std::string sourceName(const std::type_info* source);
+
+private:
+  void onCallback(CallbackType type, const std::type_info* source, MonotonicTime start);
+  void publish();
+
+  const std::string name_;
+  DispatcherStats& stats_;
+  TimeSource& time_source_;
+  // Indexed by CallbackType.
+  const std::array<Stats::Counter*, NumCallbackTypes> time_counters_;
+
+  uint32_t depth_{};
+  uint64_t callbacks_this_loop_{};
+  std::chrono::microseconds busy_{};
+  std::chrono::microseconds idle_{};
+  std::array<CallbackTime, NumCallbackTypes> callback_times_{};
+  std::array<std::chrono::microseconds, NumCallbackTypes> unpublished_times_{};
+  // The slowest callbacks since the last publish(), so that a slow callback at startup doesn't
+  // hide the slow callbacks which follow.
+  std::vector<SlowCallback> slowest_callbacks_;
+
+  mutable absl::Mutex mutex_;
+  Snapshot published_ ABSL_GUARDED_BY(mutex_);
+};
+
+using DispatcherInstrumentationPtr = std::unique_ptr<DispatcherInstrumentation>;
+
+} // namespace Event
+} // namespace Envoy
@@ -1,5 +1,7 @@
 #include "source/common/event/libevent_scheduler.h"
 
+#include <chrono>
+
 #include "source/common/common/assert.h"
 #include "source/common/event/schedulable_cb_impl.h"
 #include "source/common/event/timer_impl.h"
@@ -10,8 +12,10 @@ namespace Envoy {
 namespace Event {
 
 namespace {
+uint64_t toMicroseconds(const timeval& tv) { return tv.tv_sec * 1000000 + tv.tv_usec; }
+
 void recordTimeval(Stats::Histogram& histogram, const timeval& tv) {
-  histogram.recordValue(tv.tv_sec * 1000000 + tv.tv_usec);
+  histogram.recordValue(toMicroseconds(tv));
 }
 } // namespace
 
@@ -70,8 +74,10 @@ void LibeventScheduler::registerOnPrepareCallback(OnPrepareCallback&& callback)
   evwatch_prepare_new(libevent_.get(), &onPrepareForCallback, this);
 }
 
-void LibeventScheduler::initializeStats(DispatcherStats* stats) {
+void LibeventScheduler::initializeStats(DispatcherStats* stats,
+                                        DispatcherInstrumentation* instrumentation) {
   stats_ = stats;
+  instrumentation_ = instrumentation;
   // These are thread safe.
   evwatch_prepare_new(libevent_.get(), &onPrepareForStats, this);
   evwatch_check_new(libevent_.get(), &onCheckForStats, this);
@@ -101,6 +107,7 @@ void LibeventScheduler::onPrepareForStats(evwatch*, const evwatch_prepare_cb_inf
     timeval delta;
     evutil_timersub(&self->prepare_time_, &self->check_time_, &delta);
     recordTimeval(self->stats_->loop_duration_us_, delta);
+    self->instrumentation_->onLoopBusy(std::chrono::microseconds(toMicroseconds(delta)));
   }
 }
 
@@ -112,9 +119,11 @@ void LibeventScheduler::onCheckForStats(evwatch*, const evwatch_check_cb_info*,
   // from above to compute the actual polling duration, and store it for the next iteration of the
   // event loop to compute the loop duration.
   evutil_gettimeofday(&self->check_time_, nullptr);
+  timeval delta;
+  evutil_timersub(&self->check_time_, &self->prepare_time_, &delta);
+  self->instrumentation_->onLoopIdle(std::chrono::microseconds(toMicroseconds(delta)));
   if (self->timeout_set_) {
-    timeval delta, delay;
-    evutil_timersub(&self->check_time_, &self->prepare_time_, &delta);
+    timeval delay;
     evutil_timersub(&delta, &self->timeout_, &delay);
 
     // Delay can be negative, meaning polling completed early. This happens in normal operation,
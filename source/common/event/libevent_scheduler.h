@@ -6,6 +6,7 @@
 #include "envoy/event/schedulable_cb.h"
 #include "envoy/event/timer.h"
 
+#include "source/common/event/dispatcher_instrumentation.h"
 #include "source/common/event/libevent.h"
 
 #include "event2/event.h"
@@ -96,8 +97,10 @@ public:
   /**
    * Start writing stats once thread-local storage is ready to receive them (see
    * ThreadLocalStoreImpl::initializeThreading).
+   * @param stats supplies the stats to write to.
+   * @param instrumentation supplies the instrumentation to report busy and idle loop time to.
    */
-  void initializeStats(DispatcherStats* stats);
+  void initializeStats(DispatcherStats* stats, DispatcherInstrumentation* instrumentation);
 
 private:
   static void onPrepareForCallback(evwatch*, const evwatch_prepare_cb_info* info, void* arg);
@@ -116,6 +119,7 @@ private:
 
   Libevent::BasePtr libevent_;
   DispatcherStats* stats_{}; // stats owned by the containing DispatcherImpl
+  DispatcherInstrumentation* instrumentation_{}; // owned by the containing DispatcherImpl
   bool timeout_set_{};       // whether there is a poll timeout in the current event loop iteration
   timeval timeout_{};        // the poll timeout for the current event loop iteration, if available
   timeval prepare_time_{};   // timestamp immediately before polling
@@ -2,9 +2,11 @@
 
 #include <algorithm>
 #include <climits>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <iterator>
 #include <memory>
 #include <regex>
 #include <string>
@@ -28,6 +30,7 @@
 #include "source/common/runtime/runtime_features.h"
 #include "source/common/stream_info/utility.h"
 
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/str_split.h"
@@ -52,6 +55,166 @@ void truncate(std::string& str, absl::optional<uint32_t> max_length) {
   str = str.substr(0, max_length.value());
 }
 
+// Returns whether the protobuf JSON printer escapes the non-ASCII code point, which it does for
+// the C1 controls and for the format characters listed in its escaping tables.
+bool protobufEscapesCodePoint(uint32_t code_point) {
+  return (code_point >= 0x80 && code_point <= 0x9f) || code_point == 0xad ||
+         (code_point >= 0x600 && code_point <= 0x603) || code_point == 0x6dd ||
+         code_point == 0x70f || (code_point >= 0x17b4 && code_point <= 0x17b5) ||
+         (code_point >= 0x200b && code_point <= 0x200f) ||
+         (code_point >= 0x2028 && code_point <= 0x202e) ||
+         (code_point >= 0x2060 && code_point <= 0x2064) ||
+         (code_point >= 0x206a && code_point <= 0x206f) || code_point == 0xfeff ||
+         (code_point >= 0xfff9 && code_point <= 0xfffb) ||
+         (code_point >= 0x1d173 && code_point <= 0x1d17a) || code_point == 0xe0001 ||
+         (code_point >= 0xe0020 && code_point <= 0xe007f);
+}
+
+void appendJsonUnicodeEscape(uint32_t code_point, std::string& output) {
+  if (code_point > 0xffff) {
+    code_point -= 0x10000;
+    fmt::format_to(std::back_inserter(output), "\\u{:04x}\\u{:04x}", 0xd800 + (code_point >> 10),
+                   0xdc00 + (code_point & 0x3ff));
+  } else {
+    fmt::format_to(std::back_inserter(output), "\\u{:04x}", code_point);
+  }
+}
+
+// Appends str to output as a JSON string, escaped the same way as by the protobuf JSON printer.
+// Bytes which aren't part of a valid UTF-8 sequence can't be represented in JSON, and are
+// replaced with '!', as done by MessageUtil::sanitizeUtf8String().
+void appendJsonString(absl::string_view str, std::string& output) {
+  std::string coerced;
+  if (!google::protobuf::internal::IsStructurallyValidUTF8(str.data(), str.size())) {
+    coerced.resize(str.size());
+    str = absl::string_view(
+        google::protobuf::internal::UTF8CoerceToStructurallyValid(
+            google::protobuf::StringPiece(str.data(), str.size()), coerced.data(), '!'),
+        str.size());
+  }
+
+  output.push_back('"');
+  for (size_t i = 0; i < str.size(); ++i) {
+    const uint8_t c = static_cast<uint8_t>(str[i]);
+    if (c >= 0x80) {
+      // The string is valid UTF-8 here, so the lead byte gives the length of the sequence.
+      const size_t length = c >= 0xf0 ? 4 : (c >= 0xe0 ? 3 : 2);
+      uint32_t code_point = c & (0x7f >> length);
+      for (size_t j = 1; j < length; ++j) {
+        code_point = (code_point << 6) | (static_cast<uint8_t>(str[i + j]) & 0x3f);
+      }
+      if (protobufEscapesCodePoint(code_point)) {
+        appendJsonUnicodeEscape(code_point, output);
+      } else {
+        output.append(str.data() + i, length);
+      }
+      i += length - 1;
+      continue;
+    }
+    switch (c) {
+    case '"':
+      output.append("\\\"");
+      break;
+    case '\\':
+      output.append("\\\\");
+      break;
+    case '\b':
+      output.append("\\b");
+      break;
+    case '\f':
+      output.append("\\f");
+      break;
+    case '\n':
+      output.append("\\n");
+      break;
+    case '\r':
+      output.append("\\r");
+      break;
+    case '\t':
+      output.append("\\t");
+      break;
+    default:
+      // The protobuf JSON printer also escapes '<' and '>', so that the output can be embedded
+      // in HTML.
+      if (c < 0x20 || c == '<' || c == '>' || c == 0x7f) {
+        appendJsonUnicodeEscape(c, output);
+      } else {
+        output.push_back(c);
+      }
+    }
+  }
+  output.push_back('"');
+}
+
+// Appends number to output the way the protobuf JSON printer does, with the shortest of 15 or 17
+// significant digits which reads back as the same number.
+void appendJsonNumber(double number, std::string& output) {
+  char buffer[32];
+  int length = absl::SNPrintF(buffer, sizeof(buffer), "%.15g", number);
+  double parsed;
+  if (!absl::SimpleAtod(absl::string_view(buffer, length), &parsed) || parsed != number) {
+    length = absl::SNPrintF(buffer, sizeof(buffer), "%.17g", number);
+  }
+  output.append(buffer, length);
+}
+
+// Appends the JSON serialization of value to output. The output is equivalent to that of the
+// protobuf JSON printer, except that invalid UTF-8 is replaced instead of failing the conversion.
+void appendJsonValue(const ProtobufWkt::Value& value, std::string& output) {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::KIND_NOT_SET:
+  case ProtobufWkt::Value::kNullValue:
+    output.append("null");
+    return;
+  case ProtobufWkt::Value::kNumberValue: {
+    const double number = value.number_value();
+    if (std::isnan(number)) {
+      output.append("\"NaN\"");
+    } else if (std::isinf(number)) {
+      output.append(number > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+    } else {
+      appendJsonNumber(number, output);
+    }
+    return;
+  }
+  case ProtobufWkt::Value::kStringValue:
+    appendJsonString(value.string_value(), output);
+    return;
+  case ProtobufWkt::Value::kBoolValue:
+    output.append(value.bool_value() ? "true" : "false");
+    return;
+  case ProtobufWkt::Value::kStructValue: {
+    output.push_back('{');
+    bool first = true;
+    for (const auto& field : value.struct_value().fields()) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendJsonString(field.first, output);
+      output.push_back(':');
+      appendJsonValue(field.second, output);
+    }
+    output.push_back('}');
+    return;
+  }
+  case ProtobufWkt::Value::kListValue: {
+    output.push_back('[');
+    bool first = true;
+    for (const auto& element : value.list_value().values()) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendJsonValue(element, output);
+    }
+    output.push_back(']');
+    return;
+  }
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
 // Matches newline pattern in a system time format string (e.g. start time)
 const std::regex& getSystemTimeFormatNewlinePattern() {
   CONSTRUCT_ON_FIRST_USE(std::regex, "%[-_0^#]*[1-9]*(E|O)?n");
@@ -134,9 +297,10 @@ std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
   log_line.reserve(256);
 
   for (const FormatterProviderPtr& provider : providers_) {
-    const auto bit = provider->format(request_headers, response_headers, response_trailers,
-                                      stream_info, local_reply_body);
-    log_line += bit.value_or(empty_value_string_);
+    if (!provider->formatTo(request_headers, response_headers, response_trailers, stream_info,
+                            local_reply_body, log_line)) {
+      log_line += empty_value_string_;
+    }
   }
 
   return log_line;
@@ -147,6 +311,16 @@ std::string JsonFormatterImpl::format(const Http::RequestHeaderMap& request_head
                                       const Http::ResponseTrailerMap& response_trailers,
                                       const StreamInfo::StreamInfo& stream_info,
                                       absl::string_view local_reply_body) const {
+  if (Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.json_access_log_direct_serialization")) {
+    std::string log_line;
+    log_line.reserve(256);
+    struct_formatter_.formatJson(request_headers, response_headers, response_trailers, stream_info,
+                                 local_reply_body, log_line);
+    log_line.push_back('\n');
+    return log_line;
+  }
+
   const ProtobufWkt::Struct output_struct = struct_formatter_.format(
       request_headers, response_headers, response_trailers, stream_info, local_reply_body);
 
@@ -264,9 +438,10 @@ ProtobufWkt::Value StructFormatter::providersCallback(
   // Multiple providers forces string output.
   std::string str;
   for (const auto& provider : providers) {
-    const auto bit = provider->format(request_headers, response_headers, response_trailers,
-                                      stream_info, local_reply_body);
-    str += bit.value_or(empty_value_);
+    if (!provider->formatTo(request_headers, response_headers, response_trailers, stream_info,
+                            local_reply_body, str)) {
+      str += empty_value_;
+    }
   }
   return ValueUtil::stringValue(str);
 }
@@ -323,6 +498,120 @@ ProtobufWkt::Struct StructFormatter::format(const Http::RequestHeaderMap& reques
   return structFormatMapCallback(struct_output_format_, visitor).struct_value();
 }
 
+bool StructFormatter::jsonCallback(const StructFormatValue& value,
+                                   const JsonFormatContext& context) const {
+  if (const auto* providers = absl::get_if<const std::vector<FormatterProviderPtr>>(&value)) {
+    return providersJsonCallback(*providers, context);
+  }
+  if (const auto* format_map = absl::get_if<const StructFormatMapWrapper>(&value)) {
+    return structFormatMapJsonCallback(*format_map, context);
+  }
+  return structFormatListJsonCallback(absl::get<const StructFormatListWrapper>(value), context);
+}
+
+bool StructFormatter::providersJsonCallback(const std::vector<FormatterProviderPtr>& providers,
+                                            const JsonFormatContext& context) const {
+  ASSERT(!providers.empty());
+  if (providers.size() == 1 && preserve_types_) {
+    const ProtobufWkt::Value value = providers.front()->formatValue(
+        context.request_headers_, context.response_headers_, context.response_trailers_,
+        context.stream_info_, context.local_reply_body_);
+    if (omit_empty_values_ && value.kind_case() == ProtobufWkt::Value::kNullValue) {
+      return false;
+    }
+    appendJsonValue(value, context.output_);
+    return true;
+  }
+
+  std::string& value_buffer = context.value_buffer_;
+  value_buffer.clear();
+  if (providers.size() == 1) {
+    if (!providers.front()->formatTo(context.request_headers_, context.response_headers_,
+                                     context.response_trailers_, context.stream_info_,
+                                     context.local_reply_body_, value_buffer)) {
+      if (omit_empty_values_) {
+        return false;
+      }
+      value_buffer = DefaultUnspecifiedValueString;
+    }
+  } else {
+    // Multiple providers forces string output.
+    for (const auto& provider : providers) {
+      if (!provider->formatTo(context.request_headers_, context.response_headers_,
+                              context.response_trailers_, context.stream_info_,
+                              context.local_reply_body_, value_buffer)) {
+        value_buffer += empty_value_;
+      }
+    }
+  }
+  appendJsonString(value_buffer, context.output_);
+  return true;
+}
+
+bool StructFormatter::structFormatMapJsonCallback(
+    const StructFormatter::StructFormatMapWrapper& format_map,
+    const JsonFormatContext& context) const {
+  std::string& output = context.output_;
+  const size_t start = output.size();
+  output.push_back('{');
+  bool empty = true;
+  for (const auto& pair : *format_map.value_) {
+    const size_t field_start = output.size();
+    if (!empty) {
+      output.push_back(',');
+    }
+    appendJsonString(pair.first, output);
+    output.push_back(':');
+    if (!jsonCallback(pair.second, context)) {
+      output.resize(field_start);
+      continue;
+    }
+    empty = false;
+  }
+  if (omit_empty_values_ && empty) {
+    output.resize(start);
+    return false;
+  }
+  output.push_back('}');
+  return true;
+}
+
+bool StructFormatter::structFormatListJsonCallback(
+    const StructFormatter::StructFormatListWrapper& format_list,
+    const JsonFormatContext& context) const {
+  std::string& output = context.output_;
+  output.push_back('[');
+  bool empty = true;
+  for (const auto& val : *format_list.value_) {
+    const size_t element_start = output.size();
+    if (!empty) {
+      output.push_back(',');
+    }
+    if (!jsonCallback(val, context)) {
+      output.resize(element_start);
+      continue;
+    }
+    empty = false;
+  }
+  output.push_back(']');
+  return true;
+}
+
+void StructFormatter::formatJson(const Http::RequestHeaderMap& request_headers,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const Http::ResponseTrailerMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 absl::string_view local_reply_body, std::string& output) const {
+  std::string value_buffer;
+  const JsonFormatContext context{request_headers, response_headers, response_trailers,
+                                  stream_info,     local_reply_body, value_buffer,
+                                  output};
+  // An omitted top level structure is output as an empty one, as done by format().
+  if (!structFormatMapJsonCallback(struct_output_format_, context)) {
+    output.append("{}");
+  }
+}
+
 void SubstitutionFormatParser::parseSubcommandHeaders(const std::string& subcommand,
                                                       std::string& main_header,
                                                       std::string& alternative_header) {
@@ -1623,6 +1912,13 @@ absl::optional<std::string> PlainStringFormatter::format(const Http::RequestHead
   return str_.string_value();
 }
 
+bool PlainStringFormatter::formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                                    const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                                    absl::string_view, std::string& output) const {
+  output.append(str_.string_value());
+  return true;
+}
+
 ProtobufWkt::Value PlainStringFormatter::formatValue(const Http::RequestHeaderMap&,
                                                      const Http::ResponseHeaderMap&,
                                                      const Http::ResponseTrailerMap&,
@@ -1657,6 +1953,16 @@ LocalReplyBodyFormatter::format(const Http::RequestHeaderMap&, const Http::Respo
   return std::string(local_reply_body);
 }
 
+bool LocalReplyBodyFormatter::formatTo(const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap&,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&,
+                                       absl::string_view local_reply_body,
+                                       std::string& output) const {
+  output.append(local_reply_body.data(), local_reply_body.size());
+  return true;
+}
+
 ProtobufWkt::Value LocalReplyBodyFormatter::formatValue(const Http::RequestHeaderMap&,
                                                         const Http::ResponseHeaderMap&,
                                                         const Http::ResponseTrailerMap&,
@@ -1693,6 +1999,20 @@ absl::optional<std::string> HeaderFormatter::format(const Http::HeaderMap& heade
   return val;
 }
 
+bool HeaderFormatter::formatTo(const Http::HeaderMap& headers, std::string& output) const {
+  const Http::HeaderEntry* header = findHeader(headers);
+  if (!header) {
+    return false;
+  }
+
+  absl::string_view val = header->value().getStringView();
+  if (max_length_) {
+    val = val.substr(0, max_length_.value());
+  }
+  output.append(val.data(), val.size());
+  return true;
+}
+
 ProtobufWkt::Value HeaderFormatter::formatValue(const Http::HeaderMap& headers) const {
   const Http::HeaderEntry* header = findHeader(headers);
   if (!header) {
@@ -1715,6 +2035,14 @@ absl::optional<std::string> ResponseHeaderFormatter::format(
   return HeaderFormatter::format(response_headers);
 }
 
+bool ResponseHeaderFormatter::formatTo(const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap& response_headers,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&, absl::string_view,
+                                       std::string& output) const {
+  return HeaderFormatter::formatTo(response_headers, output);
+}
+
 ProtobufWkt::Value ResponseHeaderFormatter::formatValue(
     const Http::RequestHeaderMap&, const Http::ResponseHeaderMap& response_headers,
     const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view) const {
@@ -1733,6 +2061,14 @@ RequestHeaderFormatter::format(const Http::RequestHeaderMap& request_headers,
   return HeaderFormatter::format(request_headers);
 }
 
+bool RequestHeaderFormatter::formatTo(const Http::RequestHeaderMap& request_headers,
+                                      const Http::ResponseHeaderMap&,
+                                      const Http::ResponseTrailerMap&,
+                                      const StreamInfo::StreamInfo&, absl::string_view,
+                                      std::string& output) const {
+  return HeaderFormatter::formatTo(request_headers, output);
+}
+
 ProtobufWkt::Value
 RequestHeaderFormatter::formatValue(const Http::RequestHeaderMap& request_headers,
                                     const Http::ResponseHeaderMap&, const Http::ResponseTrailerMap&,
@@ -1752,6 +2088,14 @@ ResponseTrailerFormatter::format(const Http::RequestHeaderMap&, const Http::Resp
   return HeaderFormatter::format(response_trailers);
 }
 
+bool ResponseTrailerFormatter::formatTo(const Http::RequestHeaderMap&,
+                                        const Http::ResponseHeaderMap&,
+                                        const Http::ResponseTrailerMap& response_trailers,
+                                        const StreamInfo::StreamInfo&, absl::string_view,
+                                        std::string& output) const {
+  return HeaderFormatter::formatTo(response_trailers, output);
+}
+
 ProtobufWkt::Value
 ResponseTrailerFormatter::formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                       const Http::ResponseTrailerMap& response_trailers,
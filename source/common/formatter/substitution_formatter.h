@@ -177,6 +177,16 @@ public:
                              const StreamInfo::StreamInfo& stream_info,
                              absl::string_view local_reply_body) const;
 
+  /**
+   * Appends to output the JSON serialization of the structure returned by format(), without
+   * building the intermediate Struct.
+   */
+  void formatJson(const Http::RequestHeaderMap& request_headers,
+                  const Http::ResponseHeaderMap& response_headers,
+                  const Http::ResponseTrailerMap& response_trailers,
+                  const StreamInfo::StreamInfo& stream_info, absl::string_view local_reply_body,
+                  std::string& output) const;
+
 private:
   struct StructFormatMapWrapper;
   struct StructFormatListWrapper;
@@ -202,6 +212,18 @@ private:
       const std::function<ProtobufWkt::Value(const StructFormatter::StructFormatMapWrapper&)>,
       const std::function<ProtobufWkt::Value(const StructFormatter::StructFormatListWrapper&)>>;
 
+  // The arguments of a formatJson() call, passed down while walking the format map.
+  struct JsonFormatContext {
+    const Http::RequestHeaderMap& request_headers_;
+    const Http::ResponseHeaderMap& response_headers_;
+    const Http::ResponseTrailerMap& response_trailers_;
+    const StreamInfo::StreamInfo& stream_info_;
+    const absl::string_view local_reply_body_;
+    // Used to build string values before they are escaped into output_.
+    std::string& value_buffer_;
+    std::string& output_;
+  };
+
   // Methods for building the format map.
   class FormatBuilder {
   public:
@@ -232,6 +254,18 @@ private:
   structFormatListCallback(const StructFormatter::StructFormatListWrapper& format_list,
                            const StructFormatMapVisitor& visitor) const;
 
+  // Methods for doing the formatting straight to JSON. Each appends the JSON serialization of a
+  // value to the output, or returns false without appending anything if the value is omitted.
+  // They are dispatched to directly rather than through a visitor of std::functions, so that
+  // nothing has to be built for each line.
+  bool jsonCallback(const StructFormatValue& value, const JsonFormatContext& context) const;
+  bool providersJsonCallback(const std::vector<FormatterProviderPtr>& providers,
+                             const JsonFormatContext& context) const;
+  bool structFormatMapJsonCallback(const StructFormatter::StructFormatMapWrapper& format_map,
+                                   const JsonFormatContext& context) const;
+  bool structFormatListJsonCallback(const StructFormatter::StructFormatListWrapper& format_list,
+                                    const JsonFormatContext& context) const;
+
   const bool omit_empty_values_;
   const bool preserve_types_;
   const std::string empty_value_;
@@ -273,6 +307,9 @@ public:
   absl::optional<std::string> format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                      absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
@@ -311,6 +348,9 @@ public:
   absl::optional<std::string> format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                      absl::string_view local_reply_body) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                absl::string_view local_reply_body, std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view local_reply_body) const override;
@@ -323,6 +363,7 @@ public:
 
 protected:
   absl::optional<std::string> format(const Http::HeaderMap& headers) const;
+  bool formatTo(const Http::HeaderMap& headers, std::string& output) const;
   ProtobufWkt::Value formatValue(const Http::HeaderMap& headers) const;
 
 private:
@@ -373,6 +414,9 @@ public:
                                      const Http::ResponseHeaderMap&,
                                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                      absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap& request_headers, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
@@ -391,6 +435,9 @@ public:
                                      const Http::ResponseHeaderMap& response_headers,
                                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                      absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&, absl::string_view,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
@@ -409,6 +456,9 @@ public:
                                      const Http::ResponseTrailerMap& response_trailers,
                                      const StreamInfo::StreamInfo&,
                                      absl::string_view) const override;
+  bool formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap& response_trailers, const StreamInfo::StreamInfo&,
+                absl::string_view, std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
                                  absl::string_view) const override;
@@ -12,6 +12,7 @@
 #include "envoy/network/connection.h"
 
 #include "source/common/common/assert.h"
+#include "source/common/common/byte_order.h"
 #include "source/common/common/cleanup.h"
 #include "source/common/common/dump_state_utils.h"
 #include "source/common/common/enum_to_int.h"
@@ -29,6 +30,7 @@
 
 #include "absl/cleanup/cleanup.h"
 #include "absl/container/fixed_array.h"
+#include "absl/types/variant.h"
 #include "quiche/http2/adapter/callback_visitor.h"
 #include "quiche/http2/adapter/nghttp2_adapter.h"
 #include "quiche/http2/adapter/oghttp2_adapter.h"
@@ -243,6 +245,21 @@ ConnectionImpl::StreamImpl::buildHeaders(const HeaderMap& headers) {
   return out;
 }
 
+void ConnectionImpl::StreamImpl::trackHeaderList(
+    const std::vector<http2::adapter::Header>& headers) {
+  if (parent_.hpack_encoding_tracker_ == nullptr) {
+    return;
+  }
+  const auto size = [](const http2::adapter::HeaderRep& rep) -> uint64_t {
+    return absl::visit([](const auto& str) -> uint64_t { return str.size(); }, rep);
+  };
+  uint64_t bytes = 0;
+  for (const auto& [name, value] : headers) {
+    bytes += size(name) + size(value);
+  }
+  pending_hpack_header_list_bytes_.push_back(bytes);
+}
+
 void ConnectionImpl::ServerStreamImpl::encode1xxHeaders(const ResponseHeaderMap& headers) {
   ASSERT(HeaderUtility::isSpecial1xx(headers));
   encodeHeaders(headers, false);
@@ -615,6 +632,7 @@ void ConnectionImpl::StreamImpl::submitTrailers(const HeaderMap& trailers) {
   }
 
   std::vector<http2::adapter::Header> final_headers = buildHeaders(trailers);
+  trackHeaderList(final_headers);
   parent_.adapter_->SubmitTrailer(stream_id_, final_headers);
 }
 
@@ -660,15 +678,18 @@ bool ConnectionImpl::StreamDataFrameSource::Send(absl::string_view frame_header,
 
 void ConnectionImpl::ClientStreamImpl::submitHeaders(const HeaderMap& headers, bool end_stream) {
   ASSERT(stream_id_ == -1);
+  std::vector<http2::adapter::Header> final_headers = buildHeaders(headers);
+  trackHeaderList(final_headers);
   stream_id_ = parent_.adapter_->SubmitRequest(
-      buildHeaders(headers), end_stream ? nullptr : std::make_unique<StreamDataFrameSource>(*this),
-      base());
+      final_headers, end_stream ? nullptr : std::make_unique<StreamDataFrameSource>(*this), base());
   ASSERT(stream_id_ > 0);
 }
 
 void ConnectionImpl::ServerStreamImpl::submitHeaders(const HeaderMap& headers, bool end_stream) {
   ASSERT(stream_id_ != -1);
-  parent_.adapter_->SubmitResponse(stream_id_, buildHeaders(headers),
+  std::vector<http2::adapter::Header> final_headers = buildHeaders(headers);
+  trackHeaderList(final_headers);
+  parent_.adapter_->SubmitResponse(stream_id_, final_headers,
                                    end_stream ? nullptr
                                               : std::make_unique<StreamDataFrameSource>(*this));
 }
@@ -855,6 +876,9 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
     // This call schedules the initial interval, with jitter.
     onKeepaliveResponse();
   }
+  if (http2_options.has_window_autotuning()) {
+    window_autotuner_ = std::make_unique<WindowAutotuner>(http2_options);
+  }
 }
 
 ConnectionImpl::~ConnectionImpl() {
@@ -908,6 +932,54 @@ void ConnectionImpl::onKeepaliveResponseTimeout() {
                     StreamInfo::LocalCloseReasons::get().Http2PingTimeout);
 }
 
+void ConnectionImpl::onWindowAutotuningDataReceived(size_t length) {
+  const MonotonicTime now = connection_.dispatcher().timeSource().monotonicTime();
+  if (!window_autotuner_->onDataReceived(length, now)) {
+    return;
+  }
+  const uint64_t payload = random_.random();
+  ENVOY_CONN_LOG(trace, "Sending window autotuning PING {}", connection_, payload);
+  // This is called while dispatching, so the PING is sent with the frames generated by dispatch().
+  adapter_->SubmitPing(payload);
+  window_autotuner_->onPingSent(payload, now);
+}
+
+bool ConnectionImpl::onWindowAutotuningPingAck(uint64_t payload) {
+  const uint32_t stream_window = window_autotuner_->streamWindow();
+  const uint32_t connection_window = window_autotuner_->connectionWindow();
+  if (!window_autotuner_->onPingAck(payload,
+                                    connection_.dispatcher().timeSource().monotonicTime())) {
+    return false;
+  }
+  ENVOY_CONN_LOG(trace, "window autotuning sample of {} bytes in {}us", connection_,
+                 window_autotuner_->lastSample(), window_autotuner_->lastRoundTripTime().count());
+
+  const uint32_t new_stream_window = window_autotuner_->streamWindow();
+  if (new_stream_window != stream_window) {
+    ENVOY_CONN_LOG(debug, "autotuning stream-level window size from {} to {}", connection_,
+                   stream_window, new_stream_window);
+    // The peer applies the new initial window size to its open streams as well as new ones. Only
+    // the receive window grows: the per-stream buffer limits, and so the send and receive buffer
+    // watermarks of streams, stay at the configured initial stream window size.
+    adapter_->SubmitSettings({{http2::adapter::INITIAL_WINDOW_SIZE, new_stream_window}});
+    if (new_stream_window > stream_window) {
+      stats_.stream_window_grown_.inc();
+    } else {
+      stats_.stream_window_shrunk_.inc();
+    }
+  }
+
+  const uint32_t new_connection_window = window_autotuner_->connectionWindow();
+  if (new_connection_window != connection_window) {
+    ASSERT(new_connection_window > connection_window);
+    ENVOY_CONN_LOG(debug, "autotuning connection-level window size from {} to {}", connection_,
+                   connection_window, new_connection_window);
+    adapter_->SubmitWindowUpdate(0, new_connection_window - connection_window);
+    stats_.connection_window_grown_.inc();
+  }
+  return true;
+}
+
 bool ConnectionImpl::slowContainsStreamId(int32_t stream_id) const {
   for (const auto& stream : active_streams_) {
     if (stream->stream_id_ == stream_id) {
@@ -1069,6 +1141,11 @@ Status ConnectionImpl::onFrameReceived(const nghttp2_frame* frame) {
     safeMemcpy(&data, &(frame->ping.opaque_data));
     ENVOY_CONN_LOG(trace, "recv PING ACK {}", connection_, data);
 
+    // The opaque data is the PING payload in network byte order.
+    if (window_autotuner_ != nullptr &&
+        onWindowAutotuningPingAck(fromEndianness<ByteOrder::BigEndian>(data))) {
+      return okStatus();
+    }
     onKeepaliveResponse();
     return okStatus();
   }
@@ -1085,6 +1162,9 @@ Status ConnectionImpl::onFrameReceived(const nghttp2_frame* frame) {
   if (frame->hd.type == NGHTTP2_DATA) {
     RETURN_IF_ERROR(trackInboundFrames(frame->hd.stream_id, frame->hd.length, frame->hd.type,
                                        frame->hd.flags, frame->data.padlen));
+    if (window_autotuner_ != nullptr) {
+      onWindowAutotuningDataReceived(frame->hd.length);
+    }
   }
 
   // Only raise GOAWAY once, since we don't currently expose stream information. Shutdown
@@ -1183,6 +1263,10 @@ int ConnectionImpl::onFrameSend(int32_t stream_id, size_t length, uint8_t type,
     if (type == NGHTTP2_HEADERS || type == NGHTTP2_CONTINUATION) {
       stream->bytes_meter_->addHeaderBytesSent(length + H2_FRAME_HEADER_SIZE);
     }
+    if (type == NGHTTP2_HEADERS && !stream->pending_hpack_header_list_bytes_.empty()) {
+      hpack_encoding_tracker_->onHeaderListSent(stream->pending_hpack_header_list_bytes_.front());
+      stream->pending_hpack_header_list_bytes_.pop_front();
+    }
   }
   switch (type) {
   case NGHTTP2_GOAWAY: {
@@ -1304,6 +1388,10 @@ void ConnectionImpl::addOutboundFrameFragment(Buffer::OwnedImpl& output, const u
 
 ssize_t ConnectionImpl::onSend(const uint8_t* data, size_t length) {
   ENVOY_CONN_LOG(trace, "send data: bytes={}", connection_, length);
+  if (hpack_encoding_tracker_ != nullptr) {
+    hpack_encoding_tracker_->onBytesSent(
+        absl::string_view(reinterpret_cast<const char*>(data), length));
+  }
   Buffer::OwnedImpl buffer;
   addOutboundFrameFragment(buffer, data, length);
 
@@ -1816,6 +1904,9 @@ void ConnectionImpl::dumpState(std::ostream& os, int indent_level) const {
      << DUMP_MEMBER(allow_metadata_) << DUMP_MEMBER(stream_error_on_invalid_http_messaging_)
      << DUMP_MEMBER(is_outbound_flood_monitored_control_frame_) << DUMP_MEMBER(dispatching_)
      << DUMP_MEMBER(raised_goaway_) << DUMP_MEMBER(pending_deferred_reset_streams_.size()) << '\n';
+  if (hpack_encoding_tracker_ != nullptr) {
+    hpack_encoding_tracker_->dumpState(os, indent_level + 2);
+  }
 
   // Dump the protocol constraints
   DUMP_DETAILS(&protocol_constraints_);
@@ -1943,6 +2034,9 @@ ClientConnectionImpl::ClientConnectionImpl(
   }
   http2_session_factory.init(base(), http2_options);
   allow_metadata_ = http2_options.allow_metadata();
+  if (http2_options.track_hpack_encoding()) {
+    hpack_encoding_tracker_ = std::make_unique<HpackEncodingTracker>(stats_, /*is_client=*/true);
+  }
   idle_session_requires_ping_interval_ = std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(
       http2_options.connection_keepalive(), connection_idle_interval, 0));
 }
@@ -2053,6 +2147,9 @@ ServerConnectionImpl::ServerConnectionImpl(
   }
   sendSettings(http2_options, false);
   allow_metadata_ = http2_options.allow_metadata();
+  if (http2_options.track_hpack_encoding()) {
+    hpack_encoding_tracker_ = std::make_unique<HpackEncodingTracker>(stats_, /*is_client=*/false);
+  }
 }
 
 Status ServerConnectionImpl::onBeginHeaders(const nghttp2_frame* frame) {
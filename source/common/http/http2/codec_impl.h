@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <list>
 #include <memory>
@@ -26,9 +27,11 @@
 #include "source/common/http/codec_helper.h"
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/http2/codec_stats.h"
+#include "source/common/http/http2/hpack_encoding_tracker.h"
 #include "source/common/http/http2/metadata_decoder.h"
 #include "source/common/http/http2/metadata_encoder.h"
 #include "source/common/http/http2/protocol_constraints.h"
+#include "source/common/http/http2/window_autotuner.h"
 #include "source/common/http/status.h"
 #include "source/common/http/utility.h"
 
@@ -220,6 +223,9 @@ protected:
     void resetStreamWorker(StreamResetReason reason);
     static void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers);
     static std::vector<http2::adapter::Header> buildHeaders(const HeaderMap& headers);
+    // Records the size of a header list submitted to the codec library, to count it with the HPACK
+    // encoding stats once its HEADERS frame is sent.
+    void trackHeaderList(const std::vector<http2::adapter::Header>& headers);
     void saveHeader(HeaderString&& name, HeaderString&& value);
     void encodeHeadersBase(const HeaderMap& headers, bool end_stream);
     virtual void submitHeaders(const HeaderMap& headers, bool end_stream) PURE;
@@ -327,9 +333,10 @@ protected:
 
     Buffer::BufferMemoryAccountSharedPtr buffer_memory_account_;
     // Note that in current implementation the watermark callbacks of the pending_recv_data_ are
-    // never called. The watermark value is set to the size of the stream window. As a result this
-    // watermark can never overflow because the peer can never send more bytes than the stream
-    // window without triggering protocol error. This buffer is drained after each DATA frame was
+    // never called unless window autotuning grew the stream window. The watermark value is set to
+    // the initial size of the stream window. Otherwise this watermark can never overflow because
+    // the peer can never send more bytes than the stream window without triggering protocol error.
+    // This buffer is drained after each DATA frame was
     // dispatched through the filter chain unless
     // envoy.reloadable_features.defer_processing_backedup_streams is enabled,
     // in which case this buffer may accumulate data.
@@ -344,6 +351,9 @@ protected:
     // to determine whether we should continue processing that data.
     absl::optional<StreamResetReason> reset_reason_;
     HeaderString cookies_;
+    // The bytes of the names and values of the header lists submitted and not sent yet, in order,
+    // if HPACK encoding is tracked. Those of a stream reset before sending them are not counted.
+    std::deque<uint64_t> pending_hpack_header_list_bytes_;
     bool local_end_stream_sent_ : 1;
     bool remote_end_stream_ : 1;
     bool remote_rst_ : 1;
@@ -706,6 +716,11 @@ private:
                                     uint32_t padding_length) PURE;
   void onKeepaliveResponse();
   void onKeepaliveResponseTimeout();
+  // Sends a PING to start a window autotuning sample, if one is due.
+  void onWindowAutotuningDataReceived(size_t length);
+  // Applies the windows of a completed window autotuning sample. Returns false if `payload` is not
+  // that of the sample's PING.
+  bool onWindowAutotuningPingAck(uint64_t payload);
   bool slowContainsStreamId(int32_t stream_id) const;
   virtual StreamResetReason getMessagingErrorResetReason() const PURE;
 
@@ -726,6 +741,10 @@ private:
   std::chrono::milliseconds keepalive_interval_;
   std::chrono::milliseconds keepalive_timeout_;
   uint32_t keepalive_interval_jitter_percent_;
+  // Only set if window autotuning is configured.
+  std::unique_ptr<WindowAutotuner> window_autotuner_;
+  // Only set if tracking of HPACK encoding is configured.
+  std::unique_ptr<HpackEncodingTracker> hpack_encoding_tracker_;
 };
 
 /**
@@ -31,6 +31,14 @@ namespace Http2 {
   COUNTER(tx_flush_timeout)                                                                        \
   COUNTER(tx_reset)                                                                                \
   COUNTER(keepalive_timeout)                                                                       \
+  COUNTER(stream_window_grown)                                                                     \
+  COUNTER(stream_window_shrunk)                                                                    \
+  COUNTER(connection_window_grown)                                                                 \
+  COUNTER(tx_hpack_fields)                                                                         \
+  COUNTER(tx_hpack_dynamic_table_hits)                                                             \
+  COUNTER(tx_hpack_static_table_hits)                                                              \
+  COUNTER(tx_hpack_uncompressed_bytes)                                                             \
+  COUNTER(tx_hpack_encoded_bytes)                                                                  \
   GAUGE(streams_active, Accumulate)                                                                \
   GAUGE(pending_send_bytes, Accumulate)                                                            \
   GAUGE(deferred_stream_close, Accumulate)
@@ -0,0 +1,199 @@
+#include "source/common/http/http2/hpack_encoding_tracker.h"
+
+#include <algorithm>
+
+#include "source/common/common/dump_state_utils.h"
+
+#include "nghttp2/nghttp2.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+namespace {
+
+constexpr size_t FrameHeaderSize = 9;
+constexpr size_t PriorityFieldsSize = 5;
+
+// Decodes an integer with a prefix of `prefix_bits` bits (RFC 7541, section 5.1) from the start of
+// `input`, and removes it. Returns false if it is truncated or doesn't fit 64 bits.
+bool decodeInteger(absl::string_view& input, uint8_t prefix_bits, uint64_t& value) {
+  if (input.empty()) {
+    return false;
+  }
+  const uint8_t max_prefix_value = (1 << prefix_bits) - 1;
+  value = static_cast<uint8_t>(input[0]) & max_prefix_value;
+  input.remove_prefix(1);
+  if (value < max_prefix_value) {
+    return true;
+  }
+  for (uint32_t shift = 0; shift <= 56; shift += 7) {
+    if (input.empty()) {
+      return false;
+    }
+    const uint8_t byte = input[0];
+    input.remove_prefix(1);
+    value += static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Removes a string literal (RFC 7541, section 5.2) from the start of `input`.
+bool skipString(absl::string_view& input) {
+  uint64_t length;
+  if (!decodeInteger(input, 7, length) || length > input.size()) {
+    return false;
+  }
+  input.remove_prefix(length);
+  return true;
+}
+
+} // namespace
+
+HpackEncodingTracker::HpackEncodingTracker(CodecStats& stats, bool is_client)
+    : stats_(stats), preface_bytes_to_skip_(is_client ? ClientPrefaceSize : 0) {}
+
+void HpackEncodingTracker::onHeaderListSent(uint64_t uncompressed_bytes) {
+  counts_.uncompressed_bytes_ += uncompressed_bytes;
+  stats_.tx_hpack_uncompressed_bytes_.add(uncompressed_bytes);
+}
+
+void HpackEncodingTracker::onBytesSent(absl::string_view data) {
+  if (preface_bytes_to_skip_ > 0) {
+    const size_t skipped = std::min<uint64_t>(preface_bytes_to_skip_, data.size());
+    data.remove_prefix(skipped);
+    preface_bytes_to_skip_ -= skipped;
+  }
+  while (!data.empty() && !failed_) {
+    if (frame_header_.size() < FrameHeaderSize) {
+      const size_t length = std::min(FrameHeaderSize - frame_header_.size(), data.size());
+      frame_header_.append(data.data(), length);
+      data.remove_prefix(length);
+      if (frame_header_.size() < FrameHeaderSize) {
+        return;
+      }
+      const auto* header = reinterpret_cast<const uint8_t*>(frame_header_.data());
+      frame_bytes_remaining_ = (header[0] << 16) | (header[1] << 8) | header[2];
+      frame_type_ = header[3];
+      frame_flags_ = header[4];
+    }
+
+    const bool is_header_block =
+        frame_type_ == NGHTTP2_HEADERS || frame_type_ == NGHTTP2_CONTINUATION;
+    const size_t length = std::min<uint64_t>(frame_bytes_remaining_, data.size());
+    if (is_header_block) {
+      frame_payload_.append(data.data(), length);
+    }
+    data.remove_prefix(length);
+    frame_bytes_remaining_ -= length;
+    if (frame_bytes_remaining_ == 0) {
+      if (is_header_block) {
+        onHeaderBlockFragment(frame_type_, frame_flags_, frame_payload_);
+        frame_payload_.clear();
+      }
+      frame_header_.clear();
+    }
+  }
+}
+
+void HpackEncodingTracker::onHeaderBlockFragment(uint8_t type, uint8_t flags,
+                                                 absl::string_view payload) {
+  if (type == NGHTTP2_HEADERS) {
+    size_t padding = 0;
+    if (flags & NGHTTP2_FLAG_PADDED) {
+      if (payload.empty()) {
+        failed_ = true;
+        return;
+      }
+      padding = static_cast<uint8_t>(payload[0]);
+      payload.remove_prefix(1);
+    }
+    if (flags & NGHTTP2_FLAG_PRIORITY) {
+      if (payload.size() < PriorityFieldsSize) {
+        failed_ = true;
+        return;
+      }
+      payload.remove_prefix(PriorityFieldsSize);
+    }
+    if (padding > payload.size() || !header_block_.empty()) {
+      failed_ = true;
+      return;
+    }
+    payload.remove_suffix(padding);
+  }
+
+  counts_.encoded_bytes_ += payload.size();
+  stats_.tx_hpack_encoded_bytes_.add(payload.size());
+  if (!(flags & NGHTTP2_FLAG_END_HEADERS)) {
+    header_block_.append(payload.data(), payload.size());
+    return;
+  }
+  if (header_block_.empty()) {
+    failed_ = !parseHeaderBlock(payload);
+  } else {
+    header_block_.append(payload.data(), payload.size());
+    failed_ = !parseHeaderBlock(header_block_);
+    header_block_.clear();
+  }
+}
+
+bool HpackEncodingTracker::parseHeaderBlock(absl::string_view block) {
+  uint64_t fields = 0;
+  uint64_t dynamic_table_hits = 0;
+  uint64_t static_table_hits = 0;
+  while (!block.empty()) {
+    const uint8_t first_byte = block[0];
+    uint64_t index;
+    if (first_byte & 0x80) {
+      // Indexed header field.
+      if (!decodeInteger(block, 7, index) || index == 0) {
+        return false;
+      }
+      fields++;
+      if (index > StaticTableSize) {
+        dynamic_table_hits++;
+      } else {
+        static_table_hits++;
+      }
+    } else if ((first_byte & 0xe0) == 0x20) {
+      // Dynamic table size update.
+      if (!decodeInteger(block, 5, index)) {
+        return false;
+      }
+    } else {
+      // Literal header field, either with incremental indexing or without. An index of zero means
+      // the name is a literal too.
+      if (!decodeInteger(block, (first_byte & 0x40) ? 6 : 4, index)) {
+        return false;
+      }
+      if ((index == 0 && !skipString(block)) || !skipString(block)) {
+        return false;
+      }
+      fields++;
+    }
+  }
+
+  counts_.header_blocks_++;
+  counts_.fields_ += fields;
+  counts_.dynamic_table_hits_ += dynamic_table_hits;
+  counts_.static_table_hits_ += static_table_hits;
+  stats_.tx_hpack_fields_.add(fields);
+  stats_.tx_hpack_dynamic_table_hits_.add(dynamic_table_hits);
+  stats_.tx_hpack_static_table_hits_.add(static_table_hits);
+  return true;
+}
+
+void HpackEncodingTracker::dumpState(std::ostream& os, int indent_level) const {
+  const char* spaces = spacesForLevel(indent_level);
+  os << spaces << "HpackEncodingTracker " << this << DUMP_MEMBER(counts_.header_blocks_)
+     << DUMP_MEMBER(counts_.fields_) << DUMP_MEMBER(counts_.dynamic_table_hits_)
+     << DUMP_MEMBER(counts_.static_table_hits_) << DUMP_MEMBER(counts_.uncompressed_bytes_)
+     << DUMP_MEMBER(counts_.encoded_bytes_) << DUMP_MEMBER(failed_) << '\n';
+}
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
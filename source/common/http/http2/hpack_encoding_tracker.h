@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "source/common/http/http2/codec_stats.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+// Measures how well the HPACK encoder of a connection compresses the header blocks it sends, by
+// parsing the header block fragments of the HEADERS and CONTINUATION frames written by the codec
+// library. The HPACK dynamic table is a per-connection cache of header fields: a field that is
+// found in it, typically because an earlier request or response on the connection had the same
+// field, is encoded as a single index.
+//
+// The counts of the connection are shown by dumpState(), and are also added to the codec stats,
+// where they are aggregated over connections:
+// - tx_hpack_fields: header fields sent.
+// - tx_hpack_dynamic_table_hits: fields encoded as an index into the dynamic table.
+// - tx_hpack_static_table_hits: fields encoded as an index into the static table.
+// - tx_hpack_uncompressed_bytes: bytes of the names and values of the header lists sent.
+// - tx_hpack_encoded_bytes: bytes of the encoded header blocks.
+// The dynamic table hit rate and the bytes saved by HPACK are derived from those stats.
+class HpackEncodingTracker {
+public:
+  // Size of the connection preface sent by clients ahead of their first frame.
+  static constexpr uint64_t ClientPrefaceSize = 24;
+  // Number of entries of the HPACK static table. Larger indexes are in the dynamic table.
+  static constexpr uint64_t StaticTableSize = 61;
+
+  struct Counts {
+    uint64_t header_blocks_{};
+    uint64_t fields_{};
+    uint64_t dynamic_table_hits_{};
+    uint64_t static_table_hits_{};
+    uint64_t uncompressed_bytes_{};
+    uint64_t encoded_bytes_{};
+  };
+
+  HpackEncodingTracker(CodecStats& stats, bool is_client);
+
+  // Counts the bytes of the names and values of a header list given to the codec library, once
+  // the HEADERS frame that carries it was sent.
+  void onHeaderListSent(uint64_t uncompressed_bytes);
+
+  // Parses the bytes the codec library writes to the connection, other than DATA frames. These are
+  // whole frames, other than the client connection preface, but a frame may be split over calls.
+  void onBytesSent(absl::string_view data);
+
+  const Counts& counts() const { return counts_; }
+
+  void dumpState(std::ostream& os, int indent_level) const;
+
+private:
+  void onHeaderBlockFragment(uint8_t type, uint8_t flags, absl::string_view payload);
+  // Returns false if the header block is malformed.
+  bool parseHeaderBlock(absl::string_view block);
+
+  CodecStats& stats_;
+  Counts counts_;
+  uint64_t preface_bytes_to_skip_;
+  // The header of the frame being parsed, until it is complete.
+  std::string frame_header_;
+  uint8_t frame_type_{};
+  uint8_t frame_flags_{};
+  uint32_t frame_bytes_remaining_{};
+  // The payload of the HEADERS or CONTINUATION frame being parsed.
+  std::string frame_payload_;
+  // The header block being sent, until its END_HEADERS flag.
+  std::string header_block_;
+  // Set if a malformed frame or header block was seen, after which parsing stops.
+  bool failed_{};
+};
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
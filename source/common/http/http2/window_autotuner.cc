@@ -0,0 +1,104 @@
+#include "source/common/http/http2/window_autotuner.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+namespace {
+
+// Without a configured maximum, windows grow to a multiple of their initial size, but no further
+// than an absolute cap so that peers can't make a connection buffer arbitrarily much.
+uint32_t defaultMaxWindow(uint32_t initial_window) {
+  return std::min<uint64_t>(
+      static_cast<uint64_t>(initial_window) * WindowAutotuner::DefaultMaxWindowSizeMultiplier,
+      WindowAutotuner::DefaultMaxWindowSize);
+}
+
+} // namespace
+
+WindowAutotuner::WindowAutotuner(
+    const envoy::config::core::v3::Http2ProtocolOptions& http2_options)
+    : WindowAutotuner(
+          http2_options.initial_stream_window_size().value(),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+              http2_options.window_autotuning(), max_stream_window_size,
+              defaultMaxWindow(http2_options.initial_stream_window_size().value())),
+          http2_options.initial_connection_window_size().value(),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+              http2_options.window_autotuning(), max_connection_window_size,
+              defaultMaxWindow(http2_options.initial_connection_window_size().value()))) {}
+
+WindowAutotuner::WindowAutotuner(uint32_t initial_stream_window, uint32_t max_stream_window,
+                                 uint32_t initial_connection_window,
+                                 uint32_t max_connection_window)
+    : min_stream_window_(initial_stream_window),
+      max_stream_window_(std::max(initial_stream_window, max_stream_window)),
+      max_connection_window_(std::max(initial_connection_window, max_connection_window)),
+      stream_window_(initial_stream_window), connection_window_(initial_connection_window) {}
+
+bool WindowAutotuner::onDataReceived(uint64_t bytes, MonotonicTime now) {
+  if (sampling_) {
+    sample_bytes_ += bytes;
+    return false;
+  }
+  return now >= next_sample_at_;
+}
+
+void WindowAutotuner::onPingSent(uint64_t payload, MonotonicTime now) {
+  ASSERT(!sampling_);
+  sampling_ = true;
+  ping_payload_ = payload;
+  ping_sent_at_ = now;
+  sample_bytes_ = 0;
+}
+
+bool WindowAutotuner::onPingAck(uint64_t payload, MonotonicTime now) {
+  if (!sampling_ || payload != ping_payload_) {
+    return false;
+  }
+  sampling_ = false;
+  last_sample_ = sample_bytes_;
+  last_rtt_ = std::chrono::duration_cast<std::chrono::microseconds>(now - ping_sent_at_);
+
+  const uint32_t old_stream_window = stream_window_;
+  const uint32_t old_connection_window = connection_window_;
+  stream_window_ = grownWindow(stream_window_, max_stream_window_, last_sample_);
+  connection_window_ = grownWindow(connection_window_, max_connection_window_, last_sample_);
+
+  if (last_sample_ < stream_window_ / 4) {
+    if (++samples_below_stream_window_ >= SamplesBeforeShrinking) {
+      stream_window_ = std::max(stream_window_ / 2, min_stream_window_);
+      samples_below_stream_window_ = 0;
+    }
+  } else {
+    samples_below_stream_window_ = 0;
+  }
+
+  if (stream_window_ > old_stream_window || connection_window_ > old_connection_window) {
+    // Keep sampling while the windows grow, to find the BDP quickly.
+    next_sample_delay_ = std::chrono::microseconds::zero();
+  } else {
+    next_sample_delay_ =
+        std::min<std::chrono::microseconds>(std::max(next_sample_delay_ * 2, last_rtt_),
+                                            MaxSampleInterval);
+  }
+  next_sample_at_ = now + next_sample_delay_;
+  return true;
+}
+
+uint32_t WindowAutotuner::grownWindow(uint32_t window, uint32_t max_window, uint64_t sample) {
+  // A sample of at least two thirds of the window means the peer was likely held back by it.
+  if (sample * 3 < static_cast<uint64_t>(window) * 2) {
+    return window;
+  }
+  return std::min<uint64_t>(std::max<uint64_t>(window, sample * 2), max_window);
+}
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
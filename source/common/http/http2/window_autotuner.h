@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/config/core/v3/protocol.pb.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+// Sizes the receive flow-control windows of a connection from its estimated bandwidth-delay
+// product (BDP), between the configured initial window sizes and the maximums of
+// `Http2ProtocolOptions.window_autotuning`.
+//
+// The BDP is sampled by sending a PING when DATA is received, and counting the DATA payload bytes
+// received until its ACK: that is how much the peer sent in one round trip. If a sample comes
+// close to the current window, the window is what limited the peer, so the window is grown to
+// twice the sample. The stream window is shrunk again, halving at a time, after several samples
+// in a row used less than a quarter of it. The connection window is only ever grown, since HTTP/2
+// has no way to take back credit already granted to the peer.
+//
+// Samples are taken back to back while the windows grow. Once a sample leaves them unchanged,
+// the next one waits for a round trip, and then twice as long each time, up to
+// MaxSampleInterval, so that a steady connection sees few PINGs.
+class WindowAutotuner {
+public:
+  // The size each window can be grown to when its maximum is not configured, as a multiple of its
+  // initial size, but no more than DefaultMaxWindowSize.
+  static constexpr uint32_t DefaultMaxWindowSizeMultiplier = 16;
+  static constexpr uint32_t DefaultMaxWindowSize = 16 * 1024 * 1024;
+  // The longest time between two samples of a connection that keeps receiving DATA.
+  static constexpr std::chrono::milliseconds MaxSampleInterval{1000};
+  // The number of consecutive samples below a quarter of the stream window that shrink it.
+  static constexpr uint32_t SamplesBeforeShrinking = 3;
+
+  explicit WindowAutotuner(const envoy::config::core::v3::Http2ProtocolOptions& http2_options);
+  WindowAutotuner(uint32_t initial_stream_window, uint32_t max_stream_window,
+                  uint32_t initial_connection_window, uint32_t max_connection_window);
+
+  // Counts the DATA payload bytes received from the peer.
+  // Returns true if a sample should be started by sending a PING, and calling onPingSent().
+  bool onDataReceived(uint64_t bytes, MonotonicTime now);
+
+  // Starts a sample, when the PING with the given payload has been submitted.
+  void onPingSent(uint64_t payload, MonotonicTime now);
+
+  // Completes the sample started by onPingSent() and updates the windows.
+  // Returns false, without doing anything, if `payload` is not that of the outstanding sample's
+  // PING, in which case the ACK is for another PING such as a keepalive.
+  bool onPingAck(uint64_t payload, MonotonicTime now);
+
+  uint32_t streamWindow() const { return stream_window_; }
+  uint32_t connectionWindow() const { return connection_window_; }
+  // The number of bytes received during the last round trip sampled.
+  uint64_t lastSample() const { return last_sample_; }
+  // The duration of the last round trip sampled.
+  std::chrono::microseconds lastRoundTripTime() const { return last_rtt_; }
+
+private:
+  static uint32_t grownWindow(uint32_t window, uint32_t max_window, uint64_t sample);
+
+  const uint32_t min_stream_window_;
+  const uint32_t max_stream_window_;
+  const uint32_t max_connection_window_;
+  uint32_t stream_window_;
+  uint32_t connection_window_;
+
+  bool sampling_{};
+  uint64_t ping_payload_{};
+  MonotonicTime ping_sent_at_{};
+  uint64_t sample_bytes_{};
+  uint64_t last_sample_{};
+  std::chrono::microseconds last_rtt_{};
+  uint32_t samples_below_stream_window_{};
+  MonotonicTime next_sample_at_{};
+  std::chrono::microseconds next_sample_delay_{};
+};
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
@@ -235,6 +235,21 @@ initializeAndValidateOptions(const envoy::config::core::v3::Http2ProtocolOptions
              OptionsLimits::MIN_INITIAL_CONNECTION_WINDOW_SIZE &&
          options_clone.initial_connection_window_size().value() <=
              OptionsLimits::MAX_INITIAL_CONNECTION_WINDOW_SIZE);
+  if (options_clone.has_window_autotuning()) {
+    const auto& autotuning = options_clone.window_autotuning();
+    if (autotuning.has_max_stream_window_size() &&
+        autotuning.max_stream_window_size().value() <
+            options_clone.initial_stream_window_size().value()) {
+      throw EnvoyException("window_autotuning.max_stream_window_size must not be smaller than "
+                           "initial_stream_window_size");
+    }
+    if (autotuning.has_max_connection_window_size() &&
+        autotuning.max_connection_window_size().value() <
+            options_clone.initial_connection_window_size().value()) {
+      throw EnvoyException("window_autotuning.max_connection_window_size must not be smaller than "
+                           "initial_connection_window_size");
+    }
+  }
   if (!options_clone.has_max_outbound_frames()) {
     options_clone.mutable_max_outbound_frames()->set_value(
         OptionsLimits::DEFAULT_MAX_OUTBOUND_FRAMES);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <sys/stat.h>
+
 #include "envoy/common/pure.h"
 
 #include "source/common/network/address_impl.h"
@@ -86,6 +88,50 @@ public:
    */
   virtual IoUringResult prepareClose(os_fd_t fd, void* user_data) PURE;
 
+  /**
+   * Prepares an openat system call and puts it into the submission queue.
+   * The path must stay valid until the call completes.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareOpenat(os_fd_t dir_fd, const char* path, int flags, mode_t mode,
+                                      void* user_data) PURE;
+
+  /**
+   * Prepares a statx system call and puts it into the submission queue.
+   * The path and the result buffer must stay valid until the call completes.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareStatx(os_fd_t dir_fd, const char* path, int flags, unsigned mask,
+                                     struct statx* statx_buf, void* user_data) PURE;
+
+  /**
+   * Prepares an unlinkat system call and puts it into the submission queue.
+   * The path must stay valid until the call completes.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareUnlinkat(os_fd_t dir_fd, const char* path, int flags,
+                                        void* user_data) PURE;
+
+  /**
+   * Prepares a linkat system call and puts it into the submission queue.
+   * The paths must stay valid until the call completes.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareLinkat(os_fd_t old_dir_fd, const char* old_path, os_fd_t new_dir_fd,
+                                      const char* new_path, int flags, void* user_data) PURE;
+
+  /**
+   * Prepares an operation doing nothing and puts it into the submission queue.
+   * Its completion can be used to run something on the thread handling completions.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareNop(void* user_data) PURE;
+
   /**
    * Submits the entries in the submission queue to the kernel using the
    * `io_uring_enter()` system call.
@@ -2,6 +2,8 @@
 
 #include <sys/eventfd.h>
 
+#include <algorithm>
+
 namespace Envoy {
 namespace Io {
 
@@ -17,6 +19,18 @@ bool isIoUringSupported() {
   return is_supported;
 }
 
+bool areIoUringOpcodesSupported(std::initializer_list<int> opcodes) {
+  struct io_uring_probe* probe = io_uring_get_probe();
+  if (probe == nullptr) {
+    return false;
+  }
+  const bool supported = std::all_of(opcodes.begin(), opcodes.end(), [probe](int opcode) {
+    return io_uring_opcode_supported(probe, opcode);
+  });
+  io_uring_free_probe(probe);
+  return supported;
+}
+
 IoUringFactoryImpl::IoUringFactoryImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
                                        ThreadLocal::SlotAllocator& tls)
     : io_uring_size_(io_uring_size), use_submission_queue_polling_(use_submission_queue_polling),
@@ -137,6 +151,66 @@ IoUringResult IoUringImpl::prepareClose(os_fd_t fd, void* user_data) {
   return IoUringResult::Ok;
 }
 
+IoUringResult IoUringImpl::prepareOpenat(os_fd_t dir_fd, const char* path, int flags, mode_t mode,
+                                         void* user_data) {
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_openat(sqe, dir_fd, path, flags, mode);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareStatx(os_fd_t dir_fd, const char* path, int flags, unsigned mask,
+                                        struct statx* statx_buf, void* user_data) {
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_statx(sqe, dir_fd, path, flags, mask, statx_buf);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareUnlinkat(os_fd_t dir_fd, const char* path, int flags,
+                                           void* user_data) {
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_unlinkat(sqe, dir_fd, path, flags);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareLinkat(os_fd_t old_dir_fd, const char* old_path,
+                                         os_fd_t new_dir_fd, const char* new_path, int flags,
+                                         void* user_data) {
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_linkat(sqe, old_dir_fd, old_path, new_dir_fd, new_path, flags);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareNop(void* user_data) {
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+  if (sqe == nullptr) {
+    return IoUringResult::Failed;
+  }
+
+  io_uring_prep_nop(sqe);
+  io_uring_sqe_set_data(sqe, user_data);
+  return IoUringResult::Ok;
+}
+
 IoUringResult IoUringImpl::submit() {
   int res = io_uring_submit(&ring_);
   RELEASE_ASSERT(res >= 0 || res == -EBUSY, "unable to submit io_uring queue entries");
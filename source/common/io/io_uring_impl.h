@@ -1,5 +1,7 @@
 #pragma once
 
+#include <initializer_list>
+
 #include "envoy/thread_local/thread_local.h"
 
 #include "source/common/io/io_uring.h"
@@ -11,6 +13,11 @@ namespace Io {
 
 bool isIoUringSupported();
 
+/**
+ * @return whether the kernel supports all of the given io_uring opcodes, e.g. IORING_OP_OPENAT.
+ */
+bool areIoUringOpcodesSupported(std::initializer_list<int> opcodes);
+
 class IoUringImpl : public IoUring, public ThreadLocal::ThreadLocalObject {
 public:
   IoUringImpl(uint32_t io_uring_size, bool use_submission_queue_polling);
@@ -29,6 +36,15 @@ public:
   IoUringResult prepareWritev(os_fd_t fd, const struct iovec* iovecs, unsigned nr_vecs,
                               off_t offset, void* user_data) override;
   IoUringResult prepareClose(os_fd_t fd, void* user_data) override;
+  IoUringResult prepareOpenat(os_fd_t dir_fd, const char* path, int flags, mode_t mode,
+                              void* user_data) override;
+  IoUringResult prepareStatx(os_fd_t dir_fd, const char* path, int flags, unsigned mask,
+                             struct statx* statx_buf, void* user_data) override;
+  IoUringResult prepareUnlinkat(os_fd_t dir_fd, const char* path, int flags,
+                                void* user_data) override;
+  IoUringResult prepareLinkat(os_fd_t old_dir_fd, const char* old_path, os_fd_t new_dir_fd,
+                              const char* new_path, int flags, void* user_data) override;
+  IoUringResult prepareNop(void* user_data) override;
   IoUringResult submit() override;
 
 private:
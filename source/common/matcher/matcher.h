@@ -17,6 +17,7 @@
 #include "source/common/matcher/prefix_map_matcher.h"
 #include "source/common/matcher/validation_visitor.h"
 #include "source/common/matcher/value_input_matcher.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
@@ -222,6 +223,80 @@ private:
       sub_matchers.emplace_back(createFieldMatcher<PredicateType>(predicate));
     }
 
+    return aggregateFieldMatcherFactoryCbs<MatcherT>(std::move(sub_matchers));
+  }
+
+  // Creates the matcher of OR-ed predicates. Single predicates using a string matcher on the same
+  // input are merged into one predicate matching a StringMatcherSet, so that the input is only
+  // extracted and scanned once for all of them.
+  template <class PredicateType, class FieldPredicateType>
+  FieldMatcherFactoryCb<DataType> createAnyFieldMatcherFactoryCb(
+      const Protobuf::RepeatedPtrField<FieldPredicateType>& predicates) {
+    if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.merge_or_string_matchers")) {
+      return createAggregateFieldMatcherFactoryCb<AnyFieldMatcher<DataType>, PredicateType>(
+          predicates);
+    }
+
+    // The indices of the predicates which can be merged, grouped by input.
+    std::vector<std::vector<int>> groups;
+    std::vector<absl::optional<size_t>> group_of_predicate(predicates.size());
+    std::vector<std::vector<Matchers::StringMatcherSet::Pattern>> group_patterns;
+    for (int i = 0; i < predicates.size(); ++i) {
+      if (predicates[i].match_type_case() != PredicateType::kSinglePredicate) {
+        continue;
+      }
+      const auto& single_predicate = predicates[i].single_predicate();
+      using SinglePredicateType = std::decay_t<decltype(single_predicate)>;
+      if (single_predicate.matcher_case() != SinglePredicateType::kValueMatch) {
+        continue;
+      }
+      auto pattern = Matchers::StringMatcherSet::toPattern(single_predicate.value_match());
+      if (!pattern.has_value()) {
+        continue;
+      }
+      size_t group = 0;
+      while (group < groups.size() &&
+             !Protobuf::util::MessageDifferencer::Equals(
+                 predicates[groups[group].front()].single_predicate().input(),
+                 single_predicate.input())) {
+        ++group;
+      }
+      if (group == groups.size()) {
+        groups.emplace_back();
+        group_patterns.emplace_back();
+      }
+      groups[group].push_back(i);
+      group_patterns[group].push_back(std::move(*pattern));
+      group_of_predicate[i] = group;
+    }
+
+    std::vector<FieldMatcherFactoryCb<DataType>> sub_matchers;
+    for (int i = 0; i < predicates.size(); ++i) {
+      if (!group_of_predicate[i].has_value() || groups[*group_of_predicate[i]].size() == 1) {
+        sub_matchers.emplace_back(createFieldMatcher<PredicateType>(predicates[i]));
+        continue;
+      }
+      // The merged predicate takes the place of the first predicate of its group. The inputs of
+      // the other predicates are still created, so that they are validated like any other input.
+      auto data_input =
+          match_input_factory_.createDataInput(predicates[i].single_predicate().input());
+      if (groups[*group_of_predicate[i]].front() != i) {
+        continue;
+      }
+      auto matcher_set = std::make_shared<const Matchers::StringMatcherSet>(
+          group_patterns[*group_of_predicate[i]]);
+      sub_matchers.emplace_back([data_input, matcher_set]() {
+        return std::make_unique<SingleFieldMatcher<DataType>>(
+            data_input(), std::make_unique<StringSetInputMatcher>(matcher_set));
+      });
+    }
+
+    return aggregateFieldMatcherFactoryCbs<AnyFieldMatcher<DataType>>(std::move(sub_matchers));
+  }
+
+  template <class MatcherT>
+  FieldMatcherFactoryCb<DataType>
+  aggregateFieldMatcherFactoryCbs(std::vector<FieldMatcherFactoryCb<DataType>> sub_matchers) {
     return [sub_matchers]() {
       std::vector<FieldMatcherPtr<DataType>> matchers;
       matchers.reserve(sub_matchers.size());
@@ -246,7 +321,7 @@ private:
       };
     }
     case (PredicateType::kOrMatcher):
-      return createAggregateFieldMatcherFactoryCb<AnyFieldMatcher<DataType>, PredicateType>(
+      return createAnyFieldMatcherFactoryCb<PredicateType>(
           field_predicate.or_matcher().predicate());
     case (PredicateType::kAndMatcher):
       return createAggregateFieldMatcherFactoryCb<AllFieldMatcher<DataType>, PredicateType>(
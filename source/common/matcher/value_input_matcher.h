@@ -3,6 +3,7 @@
 #include "envoy/matcher/matcher.h"
 
 #include "source/common/common/matchers.h"
+#include "source/common/common/string_matcher_set.h"
 
 namespace Envoy {
 namespace Matcher {
@@ -23,5 +24,26 @@ private:
   const Matchers::StringMatcherImpl<StringMatcherType> matcher_;
 };
 
+/**
+ * Matches an input against a set of string matchers, succeeding if any of them matches. This is
+ * used in place of OR-ed StringInputMatchers applied to the same input.
+ */
+class StringSetInputMatcher : public InputMatcher {
+public:
+  explicit StringSetInputMatcher(std::shared_ptr<const Matchers::StringMatcherSet> matcher_set)
+      : matcher_set_(std::move(matcher_set)) {}
+
+  bool match(absl::optional<absl::string_view> input) override {
+    if (!input) {
+      return false;
+    }
+
+    return matcher_set_->matchAny(*input);
+  }
+
+private:
+  const std::shared_ptr<const Matchers::StringMatcherSet> matcher_set_;
+};
+
 } // namespace Matcher
 } // namespace Envoy
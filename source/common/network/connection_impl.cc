@@ -18,6 +18,7 @@
 #include "source/common/common/enum_to_int.h"
 #include "source/common/common/scope_tracker.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
 #include "source/common/network/listen_socket_impl.h"
 #include "source/common/network/raw_buffer_socket.h"
 #include "source/common/network/utility.h"
@@ -798,6 +799,21 @@ absl::optional<uint64_t> ConnectionImpl::congestionWindowInBytes() const {
   return socket_->congestionWindowInBytes();
 }
 
+Connection::RawIoHandle ConnectionImpl::rawIoHandle() {
+  // Only the raw buffer socket passes bytes through unmodified. Wrapping transport sockets (e.g.
+  // tap or proxy protocol) need to see the bytes even if they forward them to a raw buffer socket.
+  // User space io handles (e.g. internal connections) have no file descriptor to move bytes from.
+  if (state() != State::Open || read_end_stream_ || write_end_stream_ ||
+      dynamic_cast<RawBufferSocket*>(transport_socket_.get()) == nullptr ||
+      dynamic_cast<IoSocketHandleImpl*>(&socket_->ioHandle()) == nullptr) {
+    return {RawIoHandle::Status::Never, {}};
+  }
+  if (connecting_ || read_buffer_->length() > 0 || write_buffer_->length() > 0) {
+    return {RawIoHandle::Status::NotYet, {}};
+  }
+  return {RawIoHandle::Status::Available, socket_->ioHandle()};
+}
+
 void ConnectionImpl::flushWriteBuffer() {
   if (state() == State::Open && write_buffer_->length() > 0) {
     onWriteReady();
@@ -291,6 +291,13 @@ absl::optional<uint64_t> MultiConnectionBaseImpl::congestionWindowInBytes() cons
   return connections_[0]->congestionWindowInBytes();
 }
 
+Connection::RawIoHandle MultiConnectionBaseImpl::rawIoHandle() {
+  if (!connect_finished_) {
+    return {RawIoHandle::Status::NotYet, {}};
+  }
+  return connections_[0]->rawIoHandle();
+}
+
 void MultiConnectionBaseImpl::addConnectionCallbacks(ConnectionCallbacks& cb) {
   if (connect_finished_) {
     connections_[0]->addConnectionCallbacks(cb);
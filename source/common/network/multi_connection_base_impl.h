@@ -98,6 +98,7 @@ public:
   absl::optional<std::chrono::milliseconds> lastRoundTripTime() const override;
   void configureInitialCongestionWindow(uint64_t, std::chrono::microseconds) override {}
   absl::optional<uint64_t> congestionWindowInBytes() const override;
+  RawIoHandle rawIoHandle() override;
 
   // Simple getters which always delegate to the first connection in connections_.
   bool isHalfCloseEnabled() const override;
@@ -167,6 +167,31 @@ protected:
 
   StreamInfo::BytesMeterSharedPtr& mutableBytesMeter() { return bytes_meter_; }
 
+  // Moves all the body bytes readable from the sequencer of |quic_stream| into |buffer|. Up to
+  // kMaxReadableRegions regions are copied into a single buffer reservation and consumed with one
+  // MarkConsumed() call, instead of adding and consuming every region separately. The sequencer
+  // recycles its blocks once they are consumed, so the data has to be copied out of them.
+  template <class QuicStreamType>
+  static void readBodyIntoBuffer(QuicStreamType& quic_stream, Buffer::Instance& buffer) {
+    iovec iovs[kMaxReadableRegions];
+    while (quic_stream.HasBytesToRead()) {
+      const int num_regions = quic_stream.GetReadableRegions(iovs, kMaxReadableRegions);
+      ASSERT(num_regions > 0);
+      uint64_t bytes_read = 0;
+      for (int i = 0; i < num_regions; ++i) {
+        bytes_read += iovs[i].iov_len;
+      }
+      Buffer::ReservationSingleSlice reservation = buffer.reserveSingleSlice(bytes_read);
+      uint8_t* dest = static_cast<uint8_t*>(reservation.slice().mem_);
+      for (int i = 0; i < num_regions; ++i) {
+        memcpy(dest, iovs[i].iov_base, iovs[i].iov_len); // NOLINT(safe-memcpy)
+        dest += iovs[i].iov_len;
+      }
+      reservation.commit(bytes_read);
+      quic_stream.MarkConsumed(bytes_read);
+    }
+  }
+
   // True once end of stream is propagated to Envoy. Envoy doesn't expect to be
   // notified more than once about end of stream. So once this is true, no need
   // to set it in the callback to Envoy stream any more.
@@ -191,6 +216,9 @@ protected:
   bool saw_regular_headers_{false};
 
 private:
+  // The maximum number of sequencer regions read at once by readBodyIntoBuffer().
+  static constexpr size_t kMaxReadableRegions = 16;
+
   // Keeps track of bytes buffered in the stream send buffer in QUICHE and reacts
   // upon crossing high and low watermarks.
   // Its high watermark is also the buffer limit of stream read/write filters in
@@ -1,5 +1,6 @@
 #include "source/common/stats/tag_producer_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -8,9 +9,73 @@
 #include "source/common/common/utility.h"
 #include "source/common/stats/tag_extractor_impl.h"
 
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+
 namespace Envoy {
 namespace Stats {
 
+namespace {
+
+// Returns whether RE2, matching bytes as Latin-1, matches at least every string that std::regex
+// matches for an ECMAScript regex, so that the regex can prefilter its std::regex extractor.
+// This is conservative: only ASCII regexes using escapes known to match at least as much in RE2
+// qualify. Constructs that RE2 doesn't support, such as lookaheads, make adding it to the set
+// fail instead.
+bool re2MatchesAtLeastStdRegex(absl::string_view regex) {
+  bool in_class = false;
+  for (size_t i = 0; i < regex.size(); ++i) {
+    const char c = regex[i];
+    if (!absl::ascii_isascii(c)) {
+      return false;
+    }
+    if (c == '\\') {
+      if (++i == regex.size()) {
+        return false;
+      }
+      // Escaped punctuation is a literal in both. RE2's \s doesn't match \v, so it is left out,
+      // and other letters and digits have different meanings, e.g. \p or back-references.
+      const char escaped = regex[i];
+      if (absl::ascii_isalnum(escaped) && !absl::StrContains("dDwWSbBtnrfv", escaped)) {
+        return false;
+      }
+      continue;
+    }
+    if (in_class) {
+      in_class = c != ']';
+    } else if (c == '[') {
+      // ECMAScript's [] and [^] match no character and any character, where RE2 takes the ']' as
+      // a member of the class.
+      if (absl::StartsWith(regex.substr(i + 1), "]") ||
+          absl::StartsWith(regex.substr(i + 1), "^]")) {
+        return false;
+      }
+      in_class = true;
+    }
+  }
+  return true;
+}
+
+// Matches a stat name against a regex set, leaving the indices of the regexes that matched sorted
+// in matches. Returns false if there is no set or matching it failed, e.g. because the DFA ran
+// out of memory, in which case all the extractors of the set must be evaluated.
+bool matchRegexSet(const re2::RE2::Set* set, absl::string_view stat_name,
+                   std::vector<int>& matches) {
+  matches.clear();
+  if (set == nullptr) {
+    return false;
+  }
+  re2::RE2::Set::ErrorInfo error_info;
+  if (!set->Match(re2::StringPiece(stat_name.data(), stat_name.size()), &matches, &error_info) &&
+      error_info.kind != re2::RE2::Set::kNoError) {
+    return false;
+  }
+  std::sort(matches.begin(), matches.end());
+  return true;
+}
+
+} // namespace
+
 TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v3::StatsConfig& config)
     : TagProducerImpl(config, {}) {}
 
@@ -38,21 +103,23 @@ TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v3::StatsConfig&
               "No regex specified for tag specifier and no default regex for name: '{}'", name));
         }
       } else {
-        addExtractor(TagExtractorImplBase::createTagExtractor(name, tag_specifier.regex()));
+        addRegexExtractor(name, tag_specifier.regex());
       }
     } else if (tag_specifier.tag_value_case() ==
                envoy::config::metrics::v3::TagSpecifier::TagValueCase::kFixedValue) {
       addExtractor(std::make_unique<TagExtractorFixedImpl>(name, tag_specifier.fixed_value()));
     }
   }
+
+  compileRegexSets();
 }
 
 int TagProducerImpl::addExtractorsMatching(absl::string_view name) {
   int num_found = 0;
   for (const auto& desc : Config::TagNames::get().descriptorVec()) {
     if (desc.name_ == name) {
-      addExtractor(TagExtractorImplBase::createTagExtractor(desc.name_, desc.regex_, desc.substr_,
-                                                            desc.negative_match_, desc.re_type_));
+      addRegexExtractor(desc.name_, desc.regex_, desc.substr_, desc.negative_match_,
+                        desc.re_type_);
       ++num_found;
     }
   }
@@ -76,16 +143,84 @@ void TagProducerImpl::addExtractor(TagExtractorPtr extractor) {
   const absl::string_view prefix = extractor->prefixToken();
   if (prefix.empty()) {
     tag_extractors_without_prefix_.emplace_back(std::move(extractor));
+    regex_set_entries_.emplace_back();
   } else {
     tag_extractor_prefix_map_[prefix].emplace_back(std::move(extractor));
   }
 }
 
+void TagProducerImpl::addRegexExtractor(absl::string_view name, absl::string_view regex,
+                                        absl::string_view substr, absl::string_view negative_match,
+                                        Regex::Type re_type) {
+  TagExtractorPtr extractor =
+      TagExtractorImplBase::createTagExtractor(name, regex, substr, negative_match, re_type);
+  const bool without_prefix = extractor->prefixToken().empty();
+  addExtractor(std::move(extractor));
+  if (!without_prefix) {
+    return;
+  }
+
+  // The RE2 extractors use the default options, so that the set matches as they do. ECMAScript
+  // regexes may match differently when compiled by RE2, so only those for which RE2 matches at
+  // least as much are prefiltered, and other std::regex extractors are evaluated for every name.
+  re2::RE2::Options options;
+  options.set_log_errors(false);
+  RegexSetId set_id;
+  if (re_type == Regex::Type::Re2) {
+    set_id = Re2Set;
+  } else if (re2MatchesAtLeastStdRegex(regex)) {
+    set_id = StdRegexSet;
+    options.set_encoding(re2::RE2::Options::EncodingLatin1);
+  } else {
+    return;
+  }
+
+  std::unique_ptr<re2::RE2::Set>& regex_set = regex_sets_[set_id];
+  if (regex_set == nullptr) {
+    regex_set = std::make_unique<re2::RE2::Set>(options, re2::RE2::UNANCHORED);
+  }
+  // Regexes failing to be added keep being evaluated for every stat name.
+  const int index = regex_set->Add(re2::StringPiece(regex.data(), regex.size()), nullptr);
+  if (index >= 0) {
+    regex_set_entries_.back() = {set_id, index};
+  }
+}
+
+void TagProducerImpl::compileRegexSets() {
+  for (std::unique_ptr<re2::RE2::Set>& regex_set : regex_sets_) {
+    if (regex_set != nullptr && !regex_set->Compile()) {
+      // Compilation only fails when running out of memory, in which case every extractor of the
+      // set is evaluated.
+      ENVOY_LOG_MISC(warn, "Unable to compile a tag extractor regex set");
+      regex_set.reset();
+    }
+  }
+}
+
 void TagProducerImpl::forEachExtractorMatching(
     absl::string_view stat_name, std::function<void(const TagExtractorPtr&)> f) const {
-  IntervalSetImpl<size_t> remove_characters;
-  for (const TagExtractorPtr& tag_extractor : tag_extractors_without_prefix_) {
-    f(tag_extractor);
+  // The indices of the regexes matched by each set, reused across stat names so that matching
+  // doesn't allocate once their capacity suffices.
+  static thread_local std::array<std::vector<int>, NumRegexSets> matches;
+  std::array<bool, NumRegexSets> usable;
+  for (size_t set_id = 0; set_id < NumRegexSets; ++set_id) {
+    usable[set_id] = matchRegexSet(regex_sets_[set_id].get(), stat_name, matches[set_id]);
+  }
+  // The next match to visit in each set. As the indices of a set increase along the extractors,
+  // the sorted matches are visited in order.
+  std::array<size_t, NumRegexSets> next_match{};
+  for (size_t i = 0; i < tag_extractors_without_prefix_.size(); ++i) {
+    const RegexSetEntry& entry = regex_set_entries_[i];
+    // If matching the set failed, the extractor is evaluated just as if it wasn't part of it.
+    if (entry.set_ >= 0 && usable[entry.set_]) {
+      const std::vector<int>& set_matches = matches[entry.set_];
+      size_t& next = next_match[entry.set_];
+      if (next == set_matches.size() || set_matches[next] != entry.index_) {
+        continue;
+      }
+      ++next;
+    }
+    f(tag_extractors_without_prefix_[i]);
   }
   const absl::string_view::size_type dot = stat_name.find('.');
   if (dot != std::string::npos) {
@@ -133,8 +268,8 @@ void TagProducerImpl::reserveResources(const envoy::config::metrics::v3::StatsCo
 void TagProducerImpl::addDefaultExtractors(const envoy::config::metrics::v3::StatsConfig& config) {
   if (!config.has_use_all_default_tags() || config.use_all_default_tags().value()) {
     for (const auto& desc : Config::TagNames::get().descriptorVec()) {
-      addExtractor(TagExtractorImplBase::createTagExtractor(desc.name_, desc.regex_, desc.substr_,
-                                                            desc.negative_match_, desc.re_type_));
+      addRegexExtractor(desc.name_, desc.regex_, desc.substr_, desc.negative_match_,
+                        desc.re_type_);
     }
     for (const auto& desc : Config::TagNames::get().tokenizedDescriptorVec()) {
       addExtractor(std::make_unique<TagExtractorTokensImpl>(desc.name_, desc.pattern_));
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -11,6 +12,7 @@
 #include "envoy/stats/tag_producer.h"
 
 #include "source/common/common/hash.h"
+#include "source/common/common/regex.h"
 #include "source/common/common/utility.h"
 #include "source/common/config/well_known_names.h"
 #include "source/common/protobuf/protobuf.h"
@@ -18,6 +20,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/strings/string_view.h"
+#include "re2/set.h"
 
 namespace Envoy {
 namespace Stats {
@@ -53,6 +56,26 @@ private:
    */
   void addExtractor(TagExtractorPtr extractor);
 
+  /**
+   * Creates and adds a regex-based TagExtractor. If its regex has no prefix token, it is also
+   * added to one of the regex sets used to prefilter such extractors in a single pass over the
+   * stat name, unless it is a std::regex which RE2 might not match where std::regex does.
+   * @param name absl::string_view the tag name.
+   * @param regex absl::string_view the regex.
+   * @param substr absl::string_view optional substring required to be present for a match.
+   * @param negative_match absl::string_view optional tag value which is not extracted.
+   * @param re_type Regex::Type the regular expression syntax used by the extractor.
+   */
+  void addRegexExtractor(absl::string_view name, absl::string_view regex,
+                         absl::string_view substr = "", absl::string_view negative_match = "",
+                         Regex::Type re_type = Regex::Type::StdRegex);
+
+  /**
+   * Compiles the regex sets built up by addRegexExtractor(). Must be called once all extractors
+   * have been added.
+   */
+  void compileRegexSets();
+
   /**
    * Adds all default extractors matching the specified tag name. In this model,
    * more than one TagExtractor can be used to generate a given tag. The default
@@ -82,7 +105,8 @@ private:
    * The possibly-matching-extractors list is computed by:
    *   1. Finding the first '.' separated token in stat_name.
    *   2. Collecting the TagExtractors whose regexes have that same prefix "^prefix\\."
-   *   3. Collecting also the TagExtractors whose regexes don't start with any prefix.
+   *   3. Collecting also the TagExtractors whose regexes don't start with any prefix,
+   *      skipping those whose regexes are in regex_sets_ but were not matched by them.
    * In the future, we may also do substring searches in some cases.
    * See DefaultTagRegexTester::produceTagsReverse in test/common/stats/stats_impl_test.cc.
    *
@@ -94,6 +118,25 @@ private:
 
   std::vector<TagExtractorPtr> tag_extractors_without_prefix_;
 
+  // The regexes of tag_extractors_without_prefix_, matched in a single pass over the stat name
+  // per set. As an extractor's own regex still has to be evaluated to capture the tag value, the
+  // sets are only used to skip the extractors that can't match, which is the common case. RE2
+  // extractors are in the Re2Set, compiled with their own options. std::regex extractors are in
+  // the StdRegexSet, which matches bytes as Latin-1 as std::regex does, if RE2 matches at least
+  // every string std::regex matches for their regexes. A set is null if it has no regexes.
+  enum RegexSetId { Re2Set, StdRegexSet, NumRegexSets };
+  std::array<std::unique_ptr<re2::RE2::Set>, NumRegexSets> regex_sets_;
+
+  // Where the regex of an entry of tag_extractors_without_prefix_ is in regex_sets_.
+  struct RegexSetEntry {
+    // The set holding the regex, or -1 if the extractor is always evaluated.
+    int set_{-1};
+    // The index of the regex in its set. Regexes are added to a set in the order of the
+    // extractors, so the indices increase along tag_extractors_without_prefix_.
+    int index_{-1};
+  };
+  std::vector<RegexSetEntry> regex_set_entries_;
+
   // Maps a prefix word extracted out of a regex to a vector of TagExtractors. Note that
   // the storage for the prefix string is owned by the TagExtractor, which, depending on
   // implementation, may need make a copy of the prefix.
@@ -0,0 +1,267 @@
+#include "source/common/tcp_proxy/splicer.h"
+
+#include <cerrno>
+
+#include "envoy/event/dispatcher.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/utility.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+
+#include "source/common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace TcpProxy {
+
+#if defined(__linux__)
+
+namespace {
+
+// Each splice moves at most the free space of the pipe, so a direction never holds more than the
+// pipe size. A pipe is 64KiB by default.
+constexpr uint64_t DefaultPipeSize = 64 * 1024;
+
+} // namespace
+
+Splicer::Splicer(Network::Connection& downstream, Network::Connection& upstream,
+                 Callbacks& callbacks)
+    : downstream_(downstream), upstream_(upstream), callbacks_(callbacks),
+      downstream_to_upstream_(downstream, upstream), upstream_to_downstream_(upstream, downstream) {
+}
+
+Splicer::CreateResult Splicer::create(Network::Connection& downstream,
+                                      Network::Connection& upstream, Callbacks& callbacks) {
+  using RawIoHandleStatus = Network::Connection::RawIoHandle::Status;
+  const Network::Connection::RawIoHandle downstream_handle = downstream.rawIoHandle();
+  const Network::Connection::RawIoHandle upstream_handle = upstream.rawIoHandle();
+  if (downstream_handle.status_ == RawIoHandleStatus::Never ||
+      upstream_handle.status_ == RawIoHandleStatus::Never) {
+    return {CreateStatus::Never, nullptr};
+  }
+  if (downstream_handle.status_ == RawIoHandleStatus::NotYet ||
+      upstream_handle.status_ == RawIoHandleStatus::NotYet) {
+    return {CreateStatus::RetryLater, nullptr};
+  }
+
+  std::unique_ptr<Splicer> splicer(new Splicer(downstream, upstream, callbacks));
+  if (!splicer->duplicateSockets(*downstream_handle.io_handle_, *upstream_handle.io_handle_) ||
+      !splicer->openPipe(splicer->downstream_to_upstream_) ||
+      !splicer->openPipe(splicer->upstream_to_downstream_)) {
+    return {CreateStatus::Failed, nullptr};
+  }
+
+  // From here on the connections must not read on their own, or the bytes they read would be
+  // reordered with the spliced bytes.
+  downstream.readDisable(true);
+  upstream.readDisable(true);
+
+  Event::Dispatcher& dispatcher = downstream.dispatcher();
+  Splicer* raw_splicer = splicer.get();
+  // The file events must use the same trigger as the connections' own file events on the same
+  // sockets. Both are always interested in all of read and write readiness, as progress on either
+  // socket may unblock either direction.
+  splicer->downstream_file_event_ = dispatcher.createFileEvent(
+      splicer->downstream_fd_, [raw_splicer](uint32_t) { raw_splicer->onFileEvent(); },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  splicer->upstream_file_event_ = dispatcher.createFileEvent(
+      splicer->upstream_fd_, [raw_splicer](uint32_t) { raw_splicer->onFileEvent(); },
+      Event::PlatformDefaultTriggerType, Event::FileReadyType::Read | Event::FileReadyType::Write);
+  ENVOY_CONN_LOG(debug, "splicing to upstream with pipes of {} and {} bytes", downstream,
+                 splicer->downstream_to_upstream_.pipe_size_,
+                 splicer->upstream_to_downstream_.pipe_size_);
+  return {CreateStatus::Started, std::move(splicer)};
+}
+
+Splicer::~Splicer() {
+  downstream_file_event_.reset();
+  upstream_file_event_.reset();
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  for (Direction* direction : {&downstream_to_upstream_, &upstream_to_downstream_}) {
+    for (int& fd : direction->pipe_fds_) {
+      if (fd != -1) {
+        os_sys_calls.close(fd);
+        fd = -1;
+      }
+    }
+  }
+  for (os_fd_t* fd : {&downstream_fd_, &upstream_fd_}) {
+    if (SOCKET_VALID(*fd)) {
+      os_sys_calls.close(*fd);
+      *fd = INVALID_SOCKET;
+    }
+  }
+}
+
+bool Splicer::duplicateSockets(Network::IoHandle& downstream_handle,
+                               Network::IoHandle& upstream_handle) {
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  for (auto [handle, fd] : {std::make_pair(&downstream_handle, &downstream_fd_),
+                            std::make_pair(&upstream_handle, &upstream_fd_)}) {
+    const Api::SysCallIntResult result =
+        os_sys_calls.fcntl(handle->fdDoNotUse(), F_DUPFD_CLOEXEC, 0);
+    if (result.return_value_ == -1) {
+      ENVOY_CONN_LOG(debug, "failed to duplicate socket for splicing: {}", downstream_,
+                     errorDetails(result.errno_));
+      return false;
+    }
+    *fd = result.return_value_;
+  }
+
+  downstream_to_upstream_.source_handle_ = &downstream_handle;
+  downstream_to_upstream_.source_fd_ = downstream_fd_;
+  downstream_to_upstream_.destination_fd_ = upstream_fd_;
+  upstream_to_downstream_.source_handle_ = &upstream_handle;
+  upstream_to_downstream_.source_fd_ = upstream_fd_;
+  upstream_to_downstream_.destination_fd_ = downstream_fd_;
+  return true;
+}
+
+bool Splicer::openPipe(Direction& direction) {
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  const Api::SysCallIntResult result =
+      os_sys_calls.pipe2(direction.pipe_fds_, O_NONBLOCK | O_CLOEXEC);
+  if (result.return_value_ != 0) {
+    ENVOY_CONN_LOG(debug, "failed to create splice pipe: {}", downstream_,
+                   errorDetails(result.errno_));
+    return false;
+  }
+
+  // Match the pipe to the buffer limit of the destination, which is where the bytes would be
+  // buffered otherwise. The kernel may refuse sizes above /proc/sys/fs/pipe-max-size for
+  // unprivileged processes, in which case the pipe keeps its size.
+  const uint32_t buffer_limit = direction.destination_.bufferLimit();
+  direction.pipe_size_ = DefaultPipeSize;
+  if (buffer_limit > 0) {
+    const Api::SysCallIntResult size_result =
+        os_sys_calls.fcntl(direction.pipe_fds_[1], F_SETPIPE_SZ, buffer_limit);
+    if (size_result.return_value_ > 0) {
+      direction.pipe_size_ = size_result.return_value_;
+    }
+  }
+  return true;
+}
+
+void Splicer::onFileEvent() {
+  uint64_t downstream_bytes = 0;
+  uint64_t upstream_bytes = 0;
+  bool ok = downstream_to_upstream_.done_ || transfer(downstream_to_upstream_, downstream_bytes);
+  ok = ok && (upstream_to_downstream_.done_ || transfer(upstream_to_downstream_, upstream_bytes));
+
+  if (downstream_bytes > 0) {
+    callbacks_.onDownstreamBytesSpliced(downstream_bytes);
+  }
+  if (upstream_bytes > 0) {
+    callbacks_.onUpstreamBytesSpliced(upstream_bytes);
+  }
+
+  if (!ok) {
+    abort();
+    return;
+  }
+  for (Direction* direction : {&downstream_to_upstream_, &upstream_to_downstream_}) {
+    if (!direction->done_ && direction->source_end_stream_ && direction->pipe_bytes_ == 0) {
+      finish(*direction);
+    }
+  }
+}
+
+bool Splicer::transfer(Direction& direction, uint64_t& bytes) {
+  auto& os_sys_calls = Api::LinuxOsSysCallsSingleton::get();
+  const os_fd_t source_fd = direction.source_fd_;
+  const os_fd_t destination_fd = direction.destination_fd_;
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    if (!direction.source_end_stream_ && direction.pipe_bytes_ < direction.pipe_size_) {
+      const Api::SysCallSizeResult result =
+          os_sys_calls.splice(source_fd, direction.pipe_fds_[1],
+                              direction.pipe_size_ - direction.pipe_bytes_,
+                              SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (result.return_value_ > 0) {
+        direction.pipe_bytes_ += result.return_value_;
+        progress = true;
+      } else if (result.return_value_ == 0) {
+        direction.source_end_stream_ = true;
+      } else if (result.errno_ != EAGAIN) {
+        ENVOY_CONN_LOG(debug, "splice read error: {}", direction.source_,
+                       errorDetails(result.errno_));
+        return false;
+      }
+    }
+
+    if (direction.pipe_bytes_ > 0) {
+      const Api::SysCallSizeResult result =
+          os_sys_calls.splice(direction.pipe_fds_[0], destination_fd, direction.pipe_bytes_,
+                              SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (result.return_value_ > 0) {
+        direction.pipe_bytes_ -= result.return_value_;
+        bytes += result.return_value_;
+        progress = true;
+      } else if (result.return_value_ < 0 && result.errno_ != EAGAIN) {
+        ENVOY_CONN_LOG(debug, "splice write error: {}", direction.destination_,
+                       errorDetails(result.errno_));
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void Splicer::finish(Direction& direction) {
+  ENVOY_CONN_LOG(debug, "end of stream reached while splicing", direction.source_);
+  direction.done_ = true;
+  // Stop listening for readiness before read enabling the source, so that its own file event sees
+  // the end of stream. The read is also activated explicitly, as the edge may have been consumed.
+  updateFileEvents();
+  handBack(direction);
+}
+
+void Splicer::abort() {
+  downstream_file_event_.reset();
+  upstream_file_event_.reset();
+  for (Direction* direction : {&downstream_to_upstream_, &upstream_to_downstream_}) {
+    if (!direction->done_) {
+      direction->done_ = true;
+      handBack(*direction);
+    }
+  }
+}
+
+void Splicer::handBack(Direction& direction) {
+  if (direction.source_.state() != Network::Connection::State::Open) {
+    return;
+  }
+  direction.source_.readDisable(false);
+  direction.source_handle_->activateFileEvents(Event::FileReadyType::Read);
+}
+
+void Splicer::updateFileEvents() {
+  const auto update = [](Event::FileEventPtr& file_event, const Direction& outgoing,
+                         const Direction& incoming) {
+    const uint32_t events = (outgoing.done_ ? 0 : Event::FileReadyType::Read) |
+                            (incoming.done_ ? 0 : Event::FileReadyType::Write);
+    if (events == 0) {
+      file_event.reset();
+    } else if (file_event != nullptr) {
+      file_event->setEnabled(events);
+    }
+  };
+  update(downstream_file_event_, downstream_to_upstream_, upstream_to_downstream_);
+  update(upstream_file_event_, upstream_to_downstream_, downstream_to_upstream_);
+}
+
+#else
+
+Splicer::CreateResult Splicer::create(Network::Connection&, Network::Connection&, Callbacks&) {
+  return {CreateStatus::Never, nullptr};
+}
+
+Splicer::~Splicer() = default;
+
+#endif
+
+} // namespace TcpProxy
+} // namespace Envoy
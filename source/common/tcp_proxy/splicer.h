@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/platform.h"
+#include "envoy/common/pure.h"
+#include "envoy/event/file_event.h"
+#include "envoy/network/connection.h"
+
+#include "source/common/common/logger.h"
+
+namespace Envoy {
+namespace TcpProxy {
+
+/**
+ * Moves bytes between a downstream and an upstream connection with splice(2), through one pipe per
+ * direction, so that the bytes are never copied to user space. The pipe of a direction holds at
+ * most as many bytes as the write buffer of its destination connection may, and the source is not
+ * read while the pipe is full, which gives the same back pressure as the connection watermarks.
+ *
+ * Both connections are read disabled while bytes are spliced. When the source of a direction
+ * reaches end of stream, its pipe is drained and the source is read enabled again, so that the
+ * connection reads the end of stream itself and the half close is proxied as usual. If splicing
+ * fails on either connection, both connections are handed back in the same way and the connections
+ * report the error. Bytes left in the pipes are dropped in that case.
+ *
+ * The splicer moves bytes between duplicates of the connections' sockets, so its sockets and file
+ * events stay valid if a connection closes its socket while the splicer is alive. The sockets are
+ * only fully closed once the splicer is destroyed too, so it must be destroyed when either
+ * connection is closed, before the connection's close event returns. It must not be destroyed by
+ * its callbacks.
+ */
+class Splicer : Logger::Loggable<Logger::Id::filter> {
+public:
+  class Callbacks {
+  public:
+    virtual ~Callbacks() = default;
+
+    /**
+     * Called when bytes were moved from the downstream to the upstream connection.
+     * @param bytes supplies the number of bytes moved.
+     */
+    virtual void onDownstreamBytesSpliced(uint64_t bytes) PURE;
+
+    /**
+     * Called when bytes were moved from the upstream to the downstream connection.
+     * @param bytes supplies the number of bytes moved.
+     */
+    virtual void onUpstreamBytesSpliced(uint64_t bytes) PURE;
+  };
+
+  enum class CreateStatus {
+    // Splicing started.
+    Started,
+    // Either connection can't be bypassed yet, e.g. because bytes are still buffered in it.
+    // Splicing may start once the connections have written them.
+    RetryLater,
+    // Splicing is not supported on this platform, or either connection can never be bypassed, e.g.
+    // because it uses TLS. @see Network::Connection::rawIoHandle().
+    Never,
+    // The sockets could not be duplicated or the pipes could not be created.
+    Failed,
+  };
+
+  struct CreateResult {
+    CreateStatus status_;
+    // The splicer. Only set if status_ is Started.
+    std::unique_ptr<Splicer> splicer_;
+  };
+
+  /**
+   * Starts splicing bytes between two connections. The connections are left untouched unless
+   * splicing started.
+   * @return the splicer if splicing started, or why it didn't.
+   */
+  static CreateResult create(Network::Connection& downstream, Network::Connection& upstream,
+                             Callbacks& callbacks);
+
+  ~Splicer();
+
+  /**
+   * @return whether bytes are still spliced in at least one direction.
+   */
+  bool active() const { return !downstream_to_upstream_.done_ || !upstream_to_downstream_.done_; }
+
+private:
+  // The bytes flowing from the source to the destination connection.
+  struct Direction {
+    Direction(Network::Connection& source, Network::Connection& destination)
+        : source_(source), destination_(destination) {}
+
+    Network::Connection& source_;
+    Network::Connection& destination_;
+    // The io handle of the source connection, which gets the rest of the stream handed back.
+    Network::IoHandle* source_handle_{};
+    // The duplicates of the sockets that the bytes are spliced from and to.
+    os_fd_t source_fd_{INVALID_SOCKET};
+    os_fd_t destination_fd_{INVALID_SOCKET};
+    // The read and the write end of the pipe.
+    int pipe_fds_[2]{-1, -1};
+    uint64_t pipe_size_{};
+    uint64_t pipe_bytes_{};
+    bool source_end_stream_{};
+    bool done_{};
+  };
+
+  Splicer(Network::Connection& downstream, Network::Connection& upstream, Callbacks& callbacks);
+
+  bool duplicateSockets(Network::IoHandle& downstream_handle, Network::IoHandle& upstream_handle);
+  bool openPipe(Direction& direction);
+  void onFileEvent();
+  // Moves bytes until neither the source nor the pipe make progress. Returns false on errors.
+  bool transfer(Direction& direction, uint64_t& bytes);
+  void finish(Direction& direction);
+  void abort();
+  // Read enables the source of a direction, so that it reads the rest of the stream by itself.
+  void handBack(Direction& direction);
+  void updateFileEvents();
+
+  Network::Connection& downstream_;
+  Network::Connection& upstream_;
+  Callbacks& callbacks_;
+  Direction downstream_to_upstream_;
+  Direction upstream_to_downstream_;
+  // The duplicates of the connections' sockets. They are owned by the splicer.
+  os_fd_t downstream_fd_{INVALID_SOCKET};
+  os_fd_t upstream_fd_{INVALID_SOCKET};
+  Event::FileEventPtr downstream_file_event_;
+  Event::FileEventPtr upstream_file_event_;
+};
+
+using SplicerPtr = std::unique_ptr<Splicer>;
+
+} // namespace TcpProxy
+} // namespace Envoy
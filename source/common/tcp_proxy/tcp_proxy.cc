@@ -71,7 +71,7 @@ Config::SharedConfig::SharedConfig(
     const envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy& config,
     Server::Configuration::FactoryContext& context)
     : stats_scope_(context.scope().createScope(fmt::format("tcp.{}", config.stat_prefix()))),
-      stats_(generateStats(*stats_scope_)) {
+      stats_(generateStats(*stats_scope_)), use_splice_(config.use_splice()) {
   if (config.has_idle_timeout()) {
     const uint64_t timeout = DurationUtil::durationToMilliseconds(config.idle_timeout());
     if (timeout > 0) {
@@ -248,6 +248,7 @@ void Filter::initialize(Network::ReadFilterCallbacks& callbacks, bool set_connec
   getStreamInfo().setUpstreamInfo(std::make_shared<StreamInfo::UpstreamInfoImpl>());
 
   config_->stats().downstream_cx_total_.inc();
+  connection_stats_set_ = set_connection_stats;
   if (set_connection_stats) {
     read_callbacks_->connection().setConnectionStats(
         {config_->stats().downstream_cx_rx_bytes_total_,
@@ -367,6 +368,10 @@ void Filter::UpstreamCallbacks::onBytesSent() {
   }
 }
 
+bool Filter::UpstreamCallbacks::onBytesSentBeforeSplice() {
+  return drainer_ == nullptr && parent_->maybeStartSplice();
+}
+
 void Filter::UpstreamCallbacks::onIdleTimeout() {
   if (drainer_ == nullptr) {
     parent_->onIdleTimeout();
@@ -563,6 +568,14 @@ void Filter::onGenericPoolReady(StreamInfo::StreamInfo* info,
   if (info) {
     upstream_info.setUpstreamFilterState(info->filterState());
   }
+  if (maybeStartSplice()) {
+    // Bytes are still buffered on either connection, try again once they have been written.
+    read_callbacks_->connection().addBytesSentCallback(
+        [this](uint64_t) { return maybeStartSplice(); });
+    upstream_->addBytesSentCallback([upstream_callbacks = upstream_callbacks_](uint64_t) -> bool {
+      return upstream_callbacks->onBytesSentBeforeSplice();
+    });
+  }
 }
 
 const Router::MetadataMatchCriteria* Filter::metadataMatchCriteria() {
@@ -707,6 +720,7 @@ void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::LocalClose ||
       event == Network::ConnectionEvent::RemoteClose) {
     downstream_closed_ = true;
+    splicer_.reset();
     // Cancel the potential odcds callback.
     cluster_discovery_handle_ = nullptr;
   }
@@ -758,6 +772,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    splicer_.reset();
     upstream_.reset();
     disableIdleTimer();
 
@@ -823,6 +838,7 @@ void Filter::onIdleTimeout() {
   config_->stats().idle_timeout_.inc();
 
   // This results in also closing the upstream connection.
+  splicer_.reset();
   read_callbacks_->connection().close(Network::ConnectionCloseType::NoFlush,
                                       StreamInfo::LocalCloseReasons::get().TcpSessionIdleTimeout);
 }
@@ -831,6 +847,7 @@ void Filter::onMaxDownstreamConnectionDuration() {
   ENVOY_CONN_LOG(debug, "max connection duration reached", read_callbacks_->connection());
   getStreamInfo().setResponseFlag(StreamInfo::ResponseFlag::DurationTimeout);
   config_->stats().max_downstream_connection_duration_.inc();
+  splicer_.reset();
   read_callbacks_->connection().close(
       Network::ConnectionCloseType::NoFlush,
       StreamInfo::LocalCloseReasons::get().MaxConnectionDurationReached);
@@ -871,6 +888,52 @@ void Filter::disableIdleTimer() {
   }
 }
 
+bool Filter::maybeStartSplice() {
+  if (!config_->useSplice() || splicer_ != nullptr || upstream_ == nullptr) {
+    return false;
+  }
+  OptRef<Network::Connection> upstream_connection = upstream_->connection();
+  if (!upstream_connection.has_value()) {
+    // The bytes are encapsulated, e.g. when tunneling over HTTP.
+    return false;
+  }
+  if (read_callbacks_->connection().state() != Network::Connection::State::Open ||
+      upstream_connection->state() != Network::Connection::State::Open) {
+    return false;
+  }
+  Splicer::CreateResult result =
+      Splicer::create(read_callbacks_->connection(), *upstream_connection, *this);
+  if (result.status_ != Splicer::CreateStatus::Started) {
+    // Only retry if either connection still buffers bytes, which it may have written next time.
+    return result.status_ == Splicer::CreateStatus::RetryLater;
+  }
+  splicer_ = std::move(result.splicer_);
+  config_->stats().downstream_cx_splice_total_.inc();
+  return false;
+}
+
+void Filter::onDownstreamBytesSpliced(uint64_t bytes) {
+  getStreamInfo().addBytesReceived(bytes);
+  getStreamInfo().getDownstreamBytesMeter()->addWireBytesReceived(bytes);
+  getStreamInfo().getUpstreamBytesMeter()->addWireBytesSent(bytes);
+  if (connection_stats_set_) {
+    config_->stats().downstream_cx_rx_bytes_total_.add(bytes);
+  }
+  read_callbacks_->upstreamHost()->cluster().trafficStats()->upstream_cx_tx_bytes_total_.add(bytes);
+  resetIdleTimer();
+}
+
+void Filter::onUpstreamBytesSpliced(uint64_t bytes) {
+  getStreamInfo().addBytesSent(bytes);
+  getStreamInfo().getUpstreamBytesMeter()->addWireBytesReceived(bytes);
+  getStreamInfo().getDownstreamBytesMeter()->addWireBytesSent(bytes);
+  if (connection_stats_set_) {
+    config_->stats().downstream_cx_tx_bytes_total_.add(bytes);
+  }
+  read_callbacks_->upstreamHost()->cluster().trafficStats()->upstream_cx_rx_bytes_total_.add(bytes);
+  resetIdleTimer();
+}
+
 UpstreamDrainManager::~UpstreamDrainManager() {
   // If connections aren't closed before they are destructed an ASSERT fires,
   // so cancel all pending drains, which causes the connections to be closed.
@@ -30,6 +30,7 @@
 #include "source/common/network/hash_policy.h"
 #include "source/common/network/utility.h"
 #include "source/common/stream_info/stream_info_impl.h"
+#include "source/common/tcp_proxy/splicer.h"
 #include "source/common/tcp_proxy/upstream.h"
 #include "source/common/upstream/load_balancer_impl.h"
 
@@ -44,6 +45,7 @@ namespace TcpProxy {
 #define ALL_TCP_PROXY_STATS(COUNTER, GAUGE)                                                        \
   COUNTER(downstream_cx_no_route)                                                                  \
   COUNTER(downstream_cx_rx_bytes_total)                                                            \
+  COUNTER(downstream_cx_splice_total)                                                              \
   COUNTER(downstream_cx_total)                                                                     \
   COUNTER(downstream_cx_tx_bytes_total)                                                            \
   COUNTER(downstream_flow_control_paused_reading_total)                                            \
@@ -223,6 +225,7 @@ public:
     const TcpProxyStats& stats() { return stats_; }
     const absl::optional<std::chrono::milliseconds>& idleTimeout() { return idle_timeout_; }
     bool flushAccessLogOnConnected() const { return flush_access_log_on_connected_; }
+    bool useSplice() const { return use_splice_; }
     const absl::optional<std::chrono::milliseconds>& maxDownstreamConnectionDuration() const {
       return max_downstream_connection_duration_;
     }
@@ -253,6 +256,7 @@ public:
 
     const TcpProxyStats stats_;
     bool flush_access_log_on_connected_;
+    const bool use_splice_;
     absl::optional<std::chrono::milliseconds> idle_timeout_;
     absl::optional<std::chrono::milliseconds> max_downstream_connection_duration_;
     absl::optional<std::chrono::milliseconds> access_log_flush_interval_;
@@ -311,6 +315,7 @@ public:
   const OnDemandStats& onDemandStats() const { return shared_config_->onDemandConfig()->stats(); }
   Random::RandomGenerator& randomGenerator() { return random_generator_; }
   bool flushAccessLogOnConnected() const { return shared_config_->flushAccessLogOnConnected(); }
+  bool useSplice() const { return shared_config_->useSplice(); }
 
 private:
   struct SimpleRouteImpl : public Route {
@@ -388,7 +393,8 @@ private:
 class Filter : public Network::ReadFilter,
                public Upstream::LoadBalancerContextBase,
                protected Logger::Loggable<Logger::Id::filter>,
-               public GenericConnectionPoolCallbacks {
+               public GenericConnectionPoolCallbacks,
+               public Splicer::Callbacks {
 public:
   Filter(ConfigSharedPtr config, Upstream::ClusterManager& cluster_manager);
   ~Filter() override;
@@ -408,6 +414,10 @@ public:
                             absl::string_view failure_reason,
                             Upstream::HostDescriptionConstSharedPtr host) override;
 
+  // Splicer::Callbacks
+  void onDownstreamBytesSpliced(uint64_t bytes) override;
+  void onUpstreamBytesSpliced(uint64_t bytes) override;
+
   // Upstream::LoadBalancerContext
   const Router::MetadataMatchCriteria* metadataMatchCriteria() override;
   absl::optional<uint64_t> computeHashKey() override {
@@ -445,6 +455,7 @@ public:
     void onBelowWriteBufferLowWatermark() override;
 
     void onBytesSent();
+    bool onBytesSentBeforeSplice();
     void onIdleTimeout();
     void drain(Drainer& drainer);
 
@@ -507,6 +518,9 @@ protected:
   void onIdleTimeout();
   void resetIdleTimer();
   void disableIdleTimer();
+  // Starts splicing if it is enabled and both connections allow it. Returns true only if splicing
+  // may still start once the connections have written the bytes they buffer.
+  bool maybeStartSplice();
   void onMaxDownstreamConnectionDuration();
   void onAccessLogFlushInterval();
   void resetAccessLogFlushTimer();
@@ -533,6 +547,9 @@ protected:
   // This will be non-null from when an upstream connection is attempted until
   // it either succeeds or fails.
   std::unique_ptr<GenericConnPool> generic_conn_pool_;
+  // Moves the bytes between |upstream_| and the downstream connection once splicing started. It is
+  // reset before this filter closes either connection, and from the close events otherwise.
+  SplicerPtr splicer_;
   RouteConstSharedPtr route_;
   Router::MetadataMatchCriteriaConstPtr metadata_match_criteria_;
   Network::TransportSocketOptionsConstSharedPtr transport_socket_options_;
@@ -540,6 +557,7 @@ protected:
   uint32_t connect_attempts_{};
   bool connecting_{};
   bool downstream_closed_{};
+  bool connection_stats_set_{};
 };
 
 // This class deals with an upstream connection that needs to finish flushing, when the downstream
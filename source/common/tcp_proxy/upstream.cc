@@ -49,6 +49,13 @@ bool TcpUpstream::startUpstreamSecureTransport() {
              : upstream_conn_data_->connection().startSecureTransport();
 }
 
+OptRef<Network::Connection> TcpUpstream::connection() {
+  if (upstream_conn_data_ == nullptr) {
+    return {};
+  }
+  return upstream_conn_data_->connection();
+}
+
 Tcp::ConnectionPool::ConnectionData*
 TcpUpstream::onDownstreamEvent(Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::RemoteClose) {
@@ -117,6 +117,7 @@ public:
   void addBytesSentCallback(Network::Connection::BytesSentCb cb) override;
   Tcp::ConnectionPool::ConnectionData* onDownstreamEvent(Network::ConnectionEvent event) override;
   bool startUpstreamSecureTransport() override;
+  OptRef<Network::Connection> connection() override;
 
 private:
   Tcp::ConnectionPool::ConnectionDataPtr upstream_conn_data_;
@@ -142,6 +143,7 @@ public:
   // HTTP upstream must not implement converting upstream transport
   // socket from non-secure to secure mode.
   bool startUpstreamSecureTransport() override { return false; }
+  OptRef<Network::Connection> connection() override { return {}; }
 
   // Http::StreamCallbacks
   void onResetStream(Http::StreamResetReason reason,
@@ -13,6 +13,21 @@
 
 namespace Envoy {
 namespace Upstream {
+namespace {
+
+// Serializes the cluster deterministically, so that equal clusters have the same serialized form.
+std::string serializeCluster(const envoy::config::cluster::v3::Cluster& cluster) {
+  std::string serialized;
+  {
+    Protobuf::io::StringOutputStream stream(&serialized);
+    Protobuf::io::CodedOutputStream coded_stream(&stream);
+    coded_stream.SetSerializationDeterministic(true);
+    cluster.SerializeToCodedStream(&coded_stream);
+  }
+  return serialized;
+}
+
+} // namespace
 
 std::vector<std::string>
 CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& added_resources,
@@ -36,35 +51,71 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
   bool any_applied = false;
   uint32_t added_or_updated = 0;
   uint32_t skipped = 0;
+  const bool skip_by_wire_hash = Runtime::runtimeFeatureEnabled(
+      "envoy.reloadable_features.cds_skip_clusters_with_unchanged_wire_hash");
+  if (!skip_by_wire_hash) {
+    applied_clusters_.clear();
+  }
   for (const auto& resource : added_resources) {
-    envoy::config::cluster::v3::Cluster cluster;
+    std::string cluster_name;
     TRY_ASSERT_MAIN_THREAD {
-      cluster = dynamic_cast<const envoy::config::cluster::v3::Cluster&>(resource.get().resource());
-      if (!cluster_names.insert(cluster.name()).second) {
+      const auto& cluster =
+          dynamic_cast<const envoy::config::cluster::v3::Cluster&>(resource.get().resource());
+      cluster_name = cluster.name();
+      if (!cluster_names.insert(cluster_name).second) {
         // NOTE: at this point, the first of these duplicates has already been successfully applied.
-        throw EnvoyException(fmt::format("duplicate cluster {} found", cluster.name()));
+        throw EnvoyException(fmt::format("duplicate cluster {} found", cluster_name));
       }
-      if (cm_.addOrUpdateCluster(cluster, resource.get().version())) {
-        any_applied = true;
-        ENVOY_LOG(debug, "{}: add/update cluster '{}'", name_, cluster.name());
-        ++added_or_updated;
-      } else {
-        ENVOY_LOG(debug, "{}: add/update cluster '{}' skipped", name_, cluster.name());
+      const absl::optional<uint64_t> wire_hash = resource.get().wireHash();
+      auto applied_cluster = applied_clusters_.find(cluster_name);
+      // Only serialized when the wire hash is unchanged, or when the cluster is applied.
+      absl::optional<std::string> serialized_cluster;
+      if (wire_hash.has_value() && applied_cluster != applied_clusters_.end() &&
+          applied_cluster->second.wire_hash_ == wire_hash.value()) {
+        serialized_cluster = serializeCluster(cluster);
+      }
+      if (serialized_cluster.has_value() &&
+          applied_cluster->second.serialized_cluster_ == serialized_cluster.value()) {
+        ENVOY_LOG(debug, "{}: add/update cluster '{}' skipped", name_, cluster_name);
         ++skipped;
+        stats_.cluster_skipped_by_wire_hash_.inc();
+      } else {
+        // Forget the previously applied cluster in case the update throws.
+        if (applied_cluster != applied_clusters_.end()) {
+          applied_clusters_.erase(applied_cluster);
+        }
+        if (cm_.addOrUpdateCluster(cluster, resource.get().version())) {
+          any_applied = true;
+          ENVOY_LOG(debug, "{}: add/update cluster '{}'", name_, cluster_name);
+          ++added_or_updated;
+        } else {
+          ENVOY_LOG(debug, "{}: add/update cluster '{}' skipped", name_, cluster_name);
+          ++skipped;
+        }
+        if (skip_by_wire_hash && wire_hash.has_value()) {
+          applied_clusters_.emplace(
+              cluster_name,
+              AppliedCluster{wire_hash.value(), serialized_cluster.has_value()
+                                                    ? std::move(serialized_cluster.value())
+                                                    : serializeCluster(cluster)});
+        }
       }
     }
     END_TRY
     catch (const EnvoyException& e) {
-      exception_msgs.push_back(fmt::format("{}: {}", cluster.name(), e.what()));
+      exception_msgs.push_back(fmt::format("{}: {}", cluster_name, e.what()));
     }
   }
   for (const auto& resource_name : removed_resources) {
+    applied_clusters_.erase(resource_name);
     if (cm_.removeCluster(resource_name)) {
       any_applied = true;
       ENVOY_LOG(debug, "{}: remove cluster '{}'", name_, resource_name);
     }
   }
 
+  stats_.cluster_applied_.add(added_or_updated);
+  stats_.cluster_skipped_.add(skipped);
   ENVOY_LOG(info, "{}: added/updated {} cluster(s), skipped {} unmodified cluster(s)", name_,
             added_or_updated, skipped);
 
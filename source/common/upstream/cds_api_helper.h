@@ -4,21 +4,41 @@
 #include <vector>
 
 #include "envoy/config/subscription.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/common/logger.h"
 #include "source/common/protobuf/protobuf.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
+/**
+ * All CDS helper stats. @see stats_macros.h
+ */
+#define ALL_CDS_HELPER_STATS(COUNTER)                                                              \
+  COUNTER(cluster_applied)                                                                         \
+  COUNTER(cluster_skipped)                                                                         \
+  COUNTER(cluster_skipped_by_wire_hash)
+
+/**
+ * Struct definition for all CDS helper stats. @see stats_macros.h
+ */
+struct CdsHelperStats {
+  ALL_CDS_HELPER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
 /**
  * A named helper class for handling a successful cluster configuration update from Subscription. A
  * name is used mostly for logging to differentiate between different users of the helper class.
  */
 class CdsApiHelper : Logger::Loggable<Logger::Id::upstream> {
 public:
-  CdsApiHelper(ClusterManager& cm, std::string name) : cm_(cm), name_(std::move(name)) {}
+  CdsApiHelper(ClusterManager& cm, std::string name, Stats::Scope& scope)
+      : cm_(cm), name_(std::move(name)), stats_({ALL_CDS_HELPER_STATS(POOL_COUNTER(scope))}) {}
   /**
    * onConfigUpdate handles the addition and removal of clusters by notifying the ClusterManager
    * about the cluster changes. It closely follows the onConfigUpdate API from
@@ -38,7 +58,19 @@ public:
 private:
   ClusterManager& cm_;
   const std::string name_;
+  CdsHelperStats stats_;
   std::string system_version_info_;
+  // A cluster last handed to the cluster manager.
+  struct AppliedCluster {
+    uint64_t wire_hash_;
+    // Deterministically serialized, and compared to a cluster resent with the same wire hash, as
+    // wire hashes may collide.
+    std::string serialized_cluster_;
+  };
+  // The clusters last handed to the cluster manager, keyed by cluster name. A cluster which is
+  // resent with the same wire hash and serialized form is skipped without the cluster manager
+  // comparing it, which requires hashing its text representation.
+  absl::flat_hash_map<std::string, AppliedCluster> applied_clusters_;
 };
 
 } // namespace Upstream
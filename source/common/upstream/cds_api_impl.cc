@@ -22,7 +22,7 @@ CdsApiImpl::CdsApiImpl(const envoy::config::core::v3::ConfigSource& cds_config,
                        ProtobufMessage::ValidationVisitor& validation_visitor)
     : Envoy::Config::SubscriptionBase<envoy::config::cluster::v3::Cluster>(validation_visitor,
                                                                            "name"),
-      helper_(cm, "cds"), cm_(cm), scope_(scope.createScope("cluster_manager.cds.")) {
+      cm_(cm), scope_(scope.createScope("cluster_manager.cds.")), helper_(cm, "cds", *scope_) {
   const auto resource_name = getResourceName();
   if (cds_resources_locator == nullptr) {
     subscription_ = cm_.subscriptionFactory().subscriptionFromConfigSource(
@@ -51,9 +51,9 @@ private:
              Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor);
   void runInitializeCallbackIfAny();
 
-  CdsApiHelper helper_;
   ClusterManager& cm_;
   Stats::ScopeSharedPtr scope_;
+  CdsApiHelper helper_;
   Config::SubscriptionPtr subscription_;
   std::function<void()> initialize_callback_;
 };
@@ -0,0 +1,40 @@
+#include "source/common/upstream/inherited_host_health.h"
+
+namespace Envoy {
+namespace Upstream {
+
+void InheritedHostHealth::add(absl::string_view cluster_name, absl::string_view address,
+                              const State& state) {
+  hosts_[std::make_pair(std::string(cluster_name), std::string(address))] = state;
+}
+
+bool InheritedHostHealth::apply(Cluster& cluster, Host& host) {
+  InheritedHostHealth* inherited = InheritedHostHealthSingleton::getExisting();
+  if (inherited == nullptr || inherited->hosts_.empty()) {
+    return false;
+  }
+  auto it =
+      inherited->hosts_.find(std::make_pair(cluster.info()->name(), host.address()->asString()));
+  if (it == inherited->hosts_.end()) {
+    return false;
+  }
+  const State state = it->second;
+  inherited->hosts_.erase(it);
+
+  if (cluster.outlierDetector() != nullptr && state.failed_outlier_check_) {
+    host.healthFlagSet(Host::HealthFlag::FAILED_OUTLIER_CHECK);
+  }
+  if (cluster.healthChecker() == nullptr || host.disableActiveHealthCheck()) {
+    return false;
+  }
+  if (state.failed_active_health_check_) {
+    host.healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  }
+  if (state.degraded_active_health_check_) {
+    host.healthFlagSet(Host::HealthFlag::DEGRADED_ACTIVE_HC);
+  }
+  return true;
+}
+
+} // namespace Upstream
+} // namespace Envoy
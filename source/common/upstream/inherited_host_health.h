@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/singleton/threadsafe_singleton.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * The health of upstream hosts inherited from the parent process during a hot restart. The server
+ * loads it from the parent before the cluster manager is created and drops it once initialization
+ * is done. In between, new hosts matching a host of the parent by cluster name and address start
+ * out with the active health checking and outlier detection state the parent last saw, instead of
+ * as unhealthy until active health checking passes and with all outlier ejections forgotten.
+ *
+ * The inherited health of a host is consumed the first time the host is created, so hosts created
+ * again later, e.g. by a cluster update during initialization, start out as they would without a
+ * parent. It's only used on the main thread.
+ */
+class InheritedHostHealth {
+public:
+  struct State {
+    bool failed_active_health_check_{};
+    bool degraded_active_health_check_{};
+    bool failed_outlier_check_{};
+  };
+
+  /**
+   * Adds the health of a host of the parent.
+   * @param cluster_name supplies the name of the cluster of the host.
+   * @param address supplies the address of the host, as returned by asString().
+   * @param state supplies the health of the host.
+   */
+  void add(absl::string_view cluster_name, absl::string_view address, const State& state);
+
+  /**
+   * @return the number of hosts whose health hasn't been consumed yet.
+   */
+  size_t size() const { return hosts_.size(); }
+
+  /**
+   * Sets the initial health flags of a new host from its inherited health, if any. Active health
+   * checking flags are only inherited if the cluster has a health checker and the host is
+   * actively health checked, and outlier ejections only if the cluster has an outlier detector,
+   * which then keeps the host ejected for a base ejection time.
+   * @param cluster supplies the cluster of the host.
+   * @param host supplies the new host.
+   * @return whether the host inherited its active health checking flags, in which case the caller
+   *         must not initialize them as unhealthy.
+   */
+  static bool apply(Cluster& cluster, Host& host);
+
+private:
+  absl::flat_hash_map<std::pair<std::string, std::string>, State> hosts_;
+};
+
+using InheritedHostHealthSingleton = InjectableSingleton<InheritedHostHealth>;
+using ScopedInheritedHostHealth = ScopedInjectableLoader<InheritedHostHealth>;
+
+} // namespace Upstream
+} // namespace Envoy
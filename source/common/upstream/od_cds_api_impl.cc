@@ -24,8 +24,8 @@ OdCdsApiImpl::OdCdsApiImpl(const envoy::config::core::v3::ConfigSource& odcds_co
                            ProtobufMessage::ValidationVisitor& validation_visitor)
     : Envoy::Config::SubscriptionBase<envoy::config::cluster::v3::Cluster>(validation_visitor,
                                                                            "name"),
-      helper_(cm, "odcds"), cm_(cm), notifier_(notifier),
-      scope_(scope.createScope("cluster_manager.odcds.")), status_(StartStatus::NotStarted) {
+      cm_(cm), notifier_(notifier), scope_(scope.createScope("cluster_manager.odcds.")),
+      helper_(cm, "odcds", *scope_), status_(StartStatus::NotStarted) {
   // TODO(krnowak): Move the subscription setup to CdsApiHelper. Maybe make CdsApiHelper a base
   // class for CDS and ODCDS.
   const auto resource_name = getResourceName();
@@ -84,10 +84,10 @@ private:
                ProtobufMessage::ValidationVisitor& validation_visitor);
   void sendAwaiting();
 
-  CdsApiHelper helper_;
   ClusterManager& cm_;
   MissingClusterNotifier& notifier_;
   Stats::ScopeSharedPtr scope_;
+  CdsApiHelper helper_;
   StartStatus status_;
   absl::flat_hash_set<std::string> awaiting_names_;
   Config::SubscriptionPtr subscription_;
@@ -56,6 +56,16 @@ void DetectorHostMonitorImpl::eject(MonotonicTime ejection_time) {
   last_ejection_time_ = ejection_time;
 }
 
+void DetectorHostMonitorImpl::inheritEjection(MonotonicTime ejection_time) {
+  ASSERT(host_.lock()->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  num_ejections_++;
+  last_ejection_time_ = ejection_time;
+  // The host is unejected after one base ejection time, as if it had been ejected for the first
+  // time just now.
+  eject_time_backoff_ = 1;
+  jitter_ = std::chrono::milliseconds(0);
+}
+
 void DetectorHostMonitorImpl::uneject(MonotonicTime unejection_time) {
   last_unejection_time_ = (unejection_time);
 }
@@ -344,6 +354,12 @@ void DetectorImpl::addHostMonitor(HostSharedPtr host) {
   DetectorHostMonitorImpl* monitor = new DetectorHostMonitorImpl(shared_from_this(), host);
   host_monitors_[host] = monitor;
   host->setOutlierDetector(DetectorHostMonitorPtr{monitor});
+  if (host->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
+    // Only hosts which inherited their ejection from the parent process during a hot restart are
+    // already ejected when they are added.
+    ejections_active_helper_.inc();
+    monitor->inheritEjection(time_source_.monotonicTime());
+  }
 }
 
 void DetectorImpl::armIntervalTimer() {
@@ -125,6 +125,9 @@ public:
 
   void eject(MonotonicTime ejection_time);
   void uneject(MonotonicTime ejection_time);
+  // Records the ejection of a host which was ejected when it was added, i.e. whose ejection was
+  // inherited from the parent process during a hot restart.
+  void inheritEjection(MonotonicTime ejection_time);
 
   uint32_t& ejectTimeBackoff() { return eject_time_backoff_; }
 
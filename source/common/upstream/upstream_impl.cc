@@ -50,6 +50,7 @@
 #include "source/common/runtime/runtime_impl.h"
 #include "source/common/upstream/cluster_factory_impl.h"
 #include "source/common/upstream/health_checker_impl.h"
+#include "source/common/upstream/inherited_host_health.h"
 #include "source/extensions/filters/network/http_connection_manager/config.h"
 #include "source/server/transport_socket_config_impl.h"
 
@@ -1520,27 +1521,34 @@ void ClusterImplBase::onPreInitComplete() {
 }
 
 void ClusterImplBase::onInitDone() {
-  if (health_checker_ && pending_initialize_health_checks_ == 0) {
+  if (health_checker_ && pending_initialize_health_checks_.empty()) {
+    // Hosts which were healthy in the parent process during a hot restart don't hold up
+    // initialization.
+    const bool inherited_host_health = InheritedHostHealthSingleton::getExisting() != nullptr;
     for (auto& host_set : prioritySet().hostSetsPerPriority()) {
       for (auto& host : host_set->hosts()) {
-        if (host->disableActiveHealthCheck()) {
+        if (host->disableActiveHealthCheck() ||
+            (inherited_host_health && !host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC))) {
           continue;
         }
-        ++pending_initialize_health_checks_;
+        pending_initialize_health_checks_.insert(host.get());
       }
     }
     ENVOY_LOG(debug, "Cluster onInitDone pending initialize health check count {}",
-              pending_initialize_health_checks_);
+              pending_initialize_health_checks_.size());
 
     // TODO(mattklein123): Remove this callback when done.
-    health_checker_->addHostCheckCompleteCb([this](HostSharedPtr, HealthTransition) -> void {
-      if (pending_initialize_health_checks_ > 0 && --pending_initialize_health_checks_ == 0) {
+    // Checks of hosts which don't hold up initialization, and further checks of hosts which already
+    // completed one, are ignored.
+    health_checker_->addHostCheckCompleteCb([this](HostSharedPtr host, HealthTransition) -> void {
+      if (pending_initialize_health_checks_.erase(host.get()) > 0 &&
+          pending_initialize_health_checks_.empty()) {
         finishInitialization();
       }
     });
   }
 
-  if (pending_initialize_health_checks_ == 0) {
+  if (pending_initialize_health_checks_.empty()) {
     finishInitialization();
   }
 }
@@ -1906,8 +1914,10 @@ void PriorityStateManager::updateClusterPrioritySet(
     // Take into consideration when a non-EDS cluster has active health checking, i.e. to mark all
     // the hosts unhealthy (host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC)) and then fire
     // update callbacks to start the health checking process. The endpoint with disabled active
-    // health check should not be set FAILED_ACTIVE_HC here.
-    if (health_checker_flag.has_value() && !host->disableActiveHealthCheck()) {
+    // health check should not be set FAILED_ACTIVE_HC here. Neither should hosts inheriting their
+    // health from the parent process during a hot restart.
+    if (!InheritedHostHealth::apply(parent_, *host) && health_checker_flag.has_value() &&
+        !host->disableActiveHealthCheck()) {
       host->healthFlagSet(health_checker_flag.value());
     }
     hosts_per_locality[host->locality()].push_back(host);
@@ -2086,8 +2096,10 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(
         max_host_weight = host->weight();
       }
 
-      // If we are depending on a health checker, we initialize to unhealthy.
-      if (health_checker_ != nullptr && !host->disableActiveHealthCheck()) {
+      // If we are depending on a health checker, we initialize to unhealthy, unless the host
+      // inherits its health from the parent process during a hot restart.
+      if (!InheritedHostHealth::apply(*this, *host) && health_checker_ != nullptr &&
+          !host->disableActiveHealthCheck()) {
         host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
 
         // If we want to exclude hosts until they have been health checked, mark them with
@@ -65,6 +65,7 @@
 #include "source/extensions/upstreams/tcp/config.h"
 #include "source/server/transport_socket_config_impl.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/synchronization/mutex.h"
 
@@ -1206,7 +1207,9 @@ private:
 
   bool initialization_started_{};
   std::function<void()> initialization_complete_callback_;
-  uint64_t pending_initialize_health_checks_{};
+  // The hosts whose first health check holds up initialization. Hosts are only compared by
+  // address, and never dereferenced.
+  absl::flat_hash_set<const Host*> pending_initialize_health_checks_;
   const bool local_cluster_;
   Config::ConstMetadataSharedPoolSharedPtr const_metadata_shared_pool_;
   Common::CallbackHandlePtr priority_update_cb_;
@@ -0,0 +1,297 @@
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/common/async_files/async_file_action.h"
+#include "source/extensions/common/async_files/async_file_context_base.h"
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+
+template <typename T> class AsyncFileActionContextIoUring : public AsyncFileActionIoUring<T> {
+public:
+  explicit AsyncFileActionContextIoUring(AsyncFileHandle handle,
+                                         std::function<void(T)> on_complete)
+      : AsyncFileActionIoUring<T>(on_complete), handle_(std::move(handle)) {}
+
+protected:
+  int& fileDescriptor() { return context()->fileDescriptor(); }
+  AsyncFileContextIoUring* context() const {
+    return static_cast<AsyncFileContextIoUring*>(handle_.get());
+  }
+
+  Api::OsSysCalls& posix() const { return context()->ioUringManager().posix(); }
+
+  AsyncFileHandle handle_;
+};
+
+class ActionStat : public AsyncFileActionContextIoUring<absl::StatusOr<struct stat>> {
+public:
+  ActionStat(AsyncFileHandle handle, std::function<void(absl::StatusOr<struct stat>)> on_complete)
+      : AsyncFileActionContextIoUring<absl::StatusOr<struct stat>>(handle, on_complete) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) override {
+    ASSERT(fileDescriptor() != -1);
+    return ring.prepareStatx(fileDescriptor(), "", AT_EMPTY_PATH, STATX_BASIC_STATS, &statx_buf_,
+                             user_data);
+  }
+
+  absl::StatusOr<struct stat> resultFromCompletion(int32_t result) override {
+    if (result < 0) {
+      return statusAfterCompletionError(result);
+    }
+    return statFromStatx(statx_buf_);
+  }
+
+private:
+  struct statx statx_buf_ {};
+};
+
+class ActionCreateHardLink : public AsyncFileActionContextIoUring<absl::Status> {
+public:
+  ActionCreateHardLink(AsyncFileHandle handle, absl::string_view filename,
+                       std::function<void(absl::Status)> on_complete)
+      : AsyncFileActionContextIoUring<absl::Status>(handle, on_complete), filename_(filename),
+        procfile_(absl::StrCat("/proc/self/fd/", fileDescriptor())) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) override {
+    return ring.prepareLinkat(AT_FDCWD, procfile_.c_str(), AT_FDCWD, filename_.c_str(),
+                              AT_SYMLINK_FOLLOW, user_data);
+  }
+
+  absl::Status resultFromCompletion(int32_t result) override {
+    if (result < 0) {
+      return statusAfterCompletionError(result);
+    }
+    return absl::OkStatus();
+  }
+
+  void onCancelledBeforeCallback(absl::Status result) override {
+    if (result.ok()) {
+      posix().unlink(filename_.c_str());
+    }
+  }
+
+private:
+  const std::string filename_;
+  const std::string procfile_;
+};
+
+class ActionCloseFile : public AsyncFileActionContextIoUring<absl::Status> {
+public:
+  // Here we take a copy of the AsyncFileContext's file descriptor, because the close function
+  // sets the AsyncFileContext's file descriptor to -1. This way there will be no race of trying
+  // to use the handle again while the close is in flight.
+  explicit ActionCloseFile(AsyncFileHandle handle, std::function<void(absl::Status)> on_complete)
+      : AsyncFileActionContextIoUring<absl::Status>(handle, on_complete),
+        file_descriptor_(fileDescriptor()) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) override {
+    return ring.prepareClose(file_descriptor_, user_data);
+  }
+
+  absl::Status resultFromCompletion(int32_t result) override {
+    if (result < 0) {
+      return statusAfterCompletionError(result);
+    }
+    return absl::OkStatus();
+  }
+
+private:
+  const int file_descriptor_;
+};
+
+class ActionReadFile : public AsyncFileActionContextIoUring<absl::StatusOr<Buffer::InstancePtr>> {
+public:
+  // The buffer is reserved by the requesting thread, so that the kernel reads straight into it.
+  ActionReadFile(AsyncFileHandle handle, off_t offset, size_t length,
+                 std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete)
+      : AsyncFileActionContextIoUring<absl::StatusOr<Buffer::InstancePtr>>(handle, on_complete),
+        offset_(offset), length_(length), buffer_(std::make_unique<Buffer::OwnedImpl>()),
+        reservation_(buffer_->reserveSingleSlice(length_)) {
+    iovec_.iov_base = reservation_.slice().mem_;
+    iovec_.iov_len = length_;
+  }
+
+  Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) override {
+    ASSERT(fileDescriptor() != -1);
+    return ring.prepareReadv(fileDescriptor(), &iovec_, 1, offset_, user_data);
+  }
+
+  absl::StatusOr<Buffer::InstancePtr> resultFromCompletion(int32_t result) override {
+    if (result < 0) {
+      return statusAfterCompletionError(result);
+    }
+    // A short read, e.g. at the end of the file, commits only the bytes read.
+    reservation_.commit(result);
+    return std::move(buffer_);
+  }
+
+private:
+  const off_t offset_;
+  const size_t length_;
+  Buffer::InstancePtr buffer_;
+  Buffer::ReservationSingleSlice reservation_;
+  struct iovec iovec_ {};
+};
+
+class ActionWriteFile : public AsyncFileActionContextIoUring<absl::StatusOr<size_t>> {
+public:
+  ActionWriteFile(AsyncFileHandle handle, Buffer::Instance& contents, off_t offset,
+                  std::function<void(absl::StatusOr<size_t>)> on_complete)
+      : AsyncFileActionContextIoUring<absl::StatusOr<size_t>>(handle, on_complete),
+        offset_(offset) {
+    contents_.move(contents);
+  }
+
+  Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) override {
+    ASSERT(fileDescriptor() != -1);
+    iovecs_.clear();
+    for (const Buffer::RawSlice& slice : contents_.getRawSlices(IOV_MAX)) {
+      iovecs_.push_back({slice.mem_, slice.len_});
+    }
+    return ring.prepareWritev(fileDescriptor(), iovecs_.data(), iovecs_.size(),
+                              offset_ + bytes_written_, user_data);
+  }
+
+  bool onCompletion(int32_t result) override {
+    if (result > 0 && static_cast<uint64_t>(result) < contents_.length()) {
+      // Like pwrite, writev may write less than it was given, or the contents had more slices
+      // than fit in one call. Write the rest with another operation.
+      bytes_written_ += result;
+      contents_.drain(result);
+      return true;
+    }
+    return AsyncFileActionContextIoUring<absl::StatusOr<size_t>>::onCompletion(result);
+  }
+
+  absl::StatusOr<size_t> resultFromCompletion(int32_t result) override {
+    if (result < 0) {
+      return statusAfterCompletionError(result);
+    }
+    return bytes_written_ + result;
+  }
+
+private:
+  Buffer::OwnedImpl contents_;
+  const off_t offset_;
+  size_t bytes_written_{};
+  std::vector<struct iovec> iovecs_;
+};
+
+// There is no io_uring operation duplicating a file descriptor, so this is performed on the
+// completion thread.
+class ActionDuplicateFile : public AsyncFileActionWithResult<absl::StatusOr<AsyncFileHandle>> {
+public:
+  ActionDuplicateFile(AsyncFileHandle handle,
+                      std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : AsyncFileActionWithResult<absl::StatusOr<AsyncFileHandle>>(on_complete),
+        handle_(std::move(handle)) {}
+
+  absl::StatusOr<AsyncFileHandle> executeImpl() override {
+    ASSERT(context()->fileDescriptor() != -1);
+    auto newfd = context()->ioUringManager().posix().duplicate(context()->fileDescriptor());
+    if (newfd.return_value_ == -1) {
+      return statusAfterFileError(newfd);
+    }
+    return std::make_shared<AsyncFileContextIoUring>(context()->ioUringManager(),
+                                                     newfd.return_value_);
+  }
+
+  void onCancelledBeforeCallback(absl::StatusOr<AsyncFileHandle> result) override {
+    if (result.ok()) {
+      result.value()->close([](absl::Status) {}).IgnoreError();
+    }
+  }
+
+private:
+  AsyncFileContextIoUring* context() const {
+    return static_cast<AsyncFileContextIoUring*>(handle_.get());
+  }
+
+  AsyncFileHandle handle_;
+};
+
+} // namespace
+
+template <typename Action>
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::checkFileAndSubmit(std::shared_ptr<Action> action) {
+  if (fileDescriptor() == -1) {
+    return absl::FailedPreconditionError("file was already closed");
+  }
+  return ioUringManager().submitAction(std::move(action));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::stat(std::function<void(absl::StatusOr<struct stat>)> on_complete) {
+  return checkFileAndSubmit(std::make_shared<ActionStat>(handle(), std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::createHardLink(absl::string_view filename,
+                                        std::function<void(absl::Status)> on_complete) {
+  return checkFileAndSubmit(
+      std::make_shared<ActionCreateHardLink>(handle(), filename, std::move(on_complete)));
+}
+
+absl::Status AsyncFileContextIoUring::close(std::function<void(absl::Status)> on_complete) {
+  auto status =
+      checkFileAndSubmit(std::make_shared<ActionCloseFile>(handle(), std::move(on_complete)))
+          .status();
+  fileDescriptor() = -1;
+  return status;
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::read(
+    off_t offset, size_t length,
+    std::function<void(absl::StatusOr<Buffer::InstancePtr>)> on_complete) {
+  return checkFileAndSubmit(
+      std::make_shared<ActionReadFile>(handle(), offset, length, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction>
+AsyncFileContextIoUring::write(Buffer::Instance& contents, off_t offset,
+                               std::function<void(absl::StatusOr<size_t>)> on_complete) {
+  return checkFileAndSubmit(
+      std::make_shared<ActionWriteFile>(handle(), contents, offset, std::move(on_complete)));
+}
+
+absl::StatusOr<CancelFunction> AsyncFileContextIoUring::duplicate(
+    std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  if (fileDescriptor() == -1) {
+    return absl::FailedPreconditionError("file was already closed");
+  }
+  return enqueue(std::make_shared<ActionDuplicateFile>(handle(), std::move(on_complete)));
+}
+
+AsyncFileManagerIoUring& AsyncFileContextIoUring::ioUringManager() const {
+  return static_cast<AsyncFileManagerIoUring&>(manager());
+}
+
+AsyncFileContextIoUring::AsyncFileContextIoUring(AsyncFileManagerIoUring& manager, int fd)
+    : AsyncFileContextBase(manager), file_descriptor_(fd) {}
+
+AsyncFileContextIoUring::~AsyncFileContextIoUring() { ASSERT(file_descriptor_ == -1); }
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -17,6 +17,7 @@ namespace AsyncFiles {
 // An AsyncFileManager should be a singleton or singleton-like.
 // Possible subclasses currently are:
 //   * AsyncFileManagerThreadPool
+//   * AsyncFileManagerIoUring
 class AsyncFileManager {
 public:
   virtual ~AsyncFileManager() = default;
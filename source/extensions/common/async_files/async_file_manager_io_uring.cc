@@ -0,0 +1,391 @@
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/io/io_uring_impl.h"
+#include "source/extensions/common/async_files/async_file_action.h"
+#include "source/extensions/common/async_files/async_file_context_io_uring.h"
+#include "source/extensions/common/async_files/status_after_file_error.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+
+// Creates a named file with mkstemp and unlinks it while it is open, for where O_TMPFILE isn't
+// supported.
+absl::StatusOr<AsyncFileHandle> createAnonymousFileWithMkstemp(AsyncFileManagerIoUring& manager,
+                                                               const std::string& path) {
+  Api::OsSysCalls& posix = manager.posix();
+  char filename[4096];
+  static const char file_suffix[] = "/buffer.XXXXXX";
+  if (path.size() + sizeof(file_suffix) > sizeof(filename)) {
+    return absl::InvalidArgumentError(
+        "AsyncFileManagerIoUring::createAnonymousFile: pathname too long for tmpfile");
+  }
+  snprintf(filename, sizeof(filename), "%s%s", path.c_str(), file_suffix);
+  Api::SysCallIntResult open_result = posix.mkstemp(filename);
+  if (open_result.return_value_ == -1) {
+    return statusAfterFileError(open_result);
+  }
+  if (posix.unlink(filename).return_value_ != 0) {
+    posix.close(open_result.return_value_);
+    posix.unlink(filename);
+    return absl::UnimplementedError(
+        "AsyncFileManagerIoUring::createAnonymousFile: not supported for "
+        "target filesystem (failed to unlink an open file)");
+  }
+  return std::make_shared<AsyncFileContextIoUring>(manager, open_result.return_value_);
+}
+
+// Performs an AsyncFileAction on the completion thread, by completing an operation doing nothing.
+class ActionOnCompletionThread : public IoUringOperation {
+public:
+  explicit ActionOnCompletionThread(std::shared_ptr<AsyncFileAction> action)
+      : action_(std::move(action)) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) override {
+    return ring.prepareNop(user_data);
+  }
+
+  bool onCompletion(int32_t) override {
+    action_->execute();
+    return false;
+  }
+
+private:
+  const std::shared_ptr<AsyncFileAction> action_;
+};
+
+class ActionWithFileResult : public AsyncFileActionIoUring<absl::StatusOr<AsyncFileHandle>> {
+public:
+  ActionWithFileResult(AsyncFileManagerIoUring& manager,
+                       std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : AsyncFileActionIoUring(on_complete), manager_(manager) {}
+
+protected:
+  void onCancelledBeforeCallback(absl::StatusOr<AsyncFileHandle> result) override {
+    if (result.ok()) {
+      result.value()->close([](absl::Status) {}).IgnoreError();
+    }
+  }
+  AsyncFileHandle handleFor(int fd) {
+    return std::make_shared<AsyncFileContextIoUring>(manager_, fd);
+  }
+  AsyncFileManagerIoUring& manager_;
+};
+
+class ActionCreateAnonymousFile : public ActionWithFileResult {
+public:
+  ActionCreateAnonymousFile(AsyncFileManagerIoUring& manager, absl::string_view path,
+                            std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : ActionWithFileResult(manager, on_complete), path_(path) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) override {
+    return ring.prepareOpenat(AT_FDCWD, path_.c_str(), O_TMPFILE | O_RDWR, S_IRUSR | S_IWUSR,
+                              user_data);
+  }
+
+  absl::StatusOr<AsyncFileHandle> resultFromCompletion(int32_t result) override {
+    if (result == -EOPNOTSUPP || result == -EISDIR) {
+      // The file system doesn't support O_TMPFILE, or the kernel doesn't know it and opened the
+      // directory.
+      manager_.o_tmpfile_unsupported_ = true;
+      return createAnonymousFileWithMkstemp(manager_, path_);
+    }
+    if (result < 0) {
+      return statusAfterCompletionError(result);
+    }
+    return handleFor(result);
+  }
+
+private:
+  const std::string path_;
+};
+
+// Creates an anonymous file with mkstemp on the completion thread, once O_TMPFILE proved not to
+// work.
+class ActionCreateAnonymousFileWithMkstemp
+    : public AsyncFileActionWithResult<absl::StatusOr<AsyncFileHandle>> {
+public:
+  ActionCreateAnonymousFileWithMkstemp(
+      AsyncFileManagerIoUring& manager, absl::string_view path,
+      std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : AsyncFileActionWithResult(on_complete), manager_(manager), path_(path) {}
+
+  absl::StatusOr<AsyncFileHandle> executeImpl() override {
+    return createAnonymousFileWithMkstemp(manager_, path_);
+  }
+
+protected:
+  void onCancelledBeforeCallback(absl::StatusOr<AsyncFileHandle> result) override {
+    if (result.ok()) {
+      result.value()->close([](absl::Status) {}).IgnoreError();
+    }
+  }
+
+private:
+  AsyncFileManagerIoUring& manager_;
+  const std::string path_;
+};
+
+class ActionOpenExistingFile : public ActionWithFileResult {
+public:
+  ActionOpenExistingFile(AsyncFileManagerIoUring& manager, absl::string_view filename,
+                         AsyncFileManager::Mode mode,
+                         std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete)
+      : ActionWithFileResult(manager, on_complete), filename_(filename), mode_(mode) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) override {
+    return ring.prepareOpenat(AT_FDCWD, filename_.c_str(), openFlags(), 0, user_data);
+  }
+
+  absl::StatusOr<AsyncFileHandle> resultFromCompletion(int32_t result) override {
+    if (result < 0) {
+      return statusAfterCompletionError(result);
+    }
+    return handleFor(result);
+  }
+
+private:
+  int openFlags() const {
+    switch (mode_) {
+    case AsyncFileManager::Mode::ReadOnly:
+      return O_RDONLY;
+    case AsyncFileManager::Mode::WriteOnly:
+      return O_WRONLY;
+    case AsyncFileManager::Mode::ReadWrite:
+      return O_RDWR;
+    }
+    PANIC_DUE_TO_CORRUPT_ENUM;
+  }
+  const std::string filename_;
+  const AsyncFileManager::Mode mode_;
+};
+
+class ActionStat : public AsyncFileActionIoUring<absl::StatusOr<struct stat>> {
+public:
+  ActionStat(absl::string_view filename,
+             std::function<void(absl::StatusOr<struct stat>)> on_complete)
+      : AsyncFileActionIoUring(on_complete), filename_(filename) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) override {
+    return ring.prepareStatx(AT_FDCWD, filename_.c_str(), 0, STATX_BASIC_STATS, &statx_buf_,
+                             user_data);
+  }
+
+  absl::StatusOr<struct stat> resultFromCompletion(int32_t result) override {
+    if (result < 0) {
+      return statusAfterCompletionError(result);
+    }
+    return statFromStatx(statx_buf_);
+  }
+
+private:
+  const std::string filename_;
+  struct statx statx_buf_ {};
+};
+
+class ActionUnlink : public AsyncFileActionIoUring<absl::Status> {
+public:
+  ActionUnlink(absl::string_view filename, std::function<void(absl::Status)> on_complete)
+      : AsyncFileActionIoUring(on_complete), filename_(filename) {}
+
+  Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) override {
+    return ring.prepareUnlinkat(AT_FDCWD, filename_.c_str(), 0, user_data);
+  }
+
+  absl::Status resultFromCompletion(int32_t result) override {
+    if (result < 0) {
+      return statusAfterCompletionError(result);
+    }
+    return absl::OkStatus();
+  }
+
+private:
+  const std::string filename_;
+};
+
+} // namespace
+
+absl::Status statusAfterCompletionError(int32_t result) {
+  ASSERT(result < 0);
+  return statusAfterFileError(-result);
+}
+
+struct stat statFromStatx(const struct statx& statx_buf) {
+  struct stat ret {};
+  ret.st_dev = makedev(statx_buf.stx_dev_major, statx_buf.stx_dev_minor);
+  ret.st_ino = statx_buf.stx_ino;
+  ret.st_mode = statx_buf.stx_mode;
+  ret.st_nlink = statx_buf.stx_nlink;
+  ret.st_uid = statx_buf.stx_uid;
+  ret.st_gid = statx_buf.stx_gid;
+  ret.st_rdev = makedev(statx_buf.stx_rdev_major, statx_buf.stx_rdev_minor);
+  ret.st_size = statx_buf.stx_size;
+  ret.st_blksize = statx_buf.stx_blksize;
+  ret.st_blocks = statx_buf.stx_blocks;
+  ret.st_atim.tv_sec = statx_buf.stx_atime.tv_sec;
+  ret.st_atim.tv_nsec = statx_buf.stx_atime.tv_nsec;
+  ret.st_mtim.tv_sec = statx_buf.stx_mtime.tv_sec;
+  ret.st_mtim.tv_nsec = statx_buf.stx_mtime.tv_nsec;
+  ret.st_ctim.tv_sec = statx_buf.stx_ctime.tv_sec;
+  ret.st_ctim.tv_nsec = statx_buf.stx_ctime.tv_nsec;
+  return ret;
+}
+
+AsyncFileManagerIoUring::AsyncFileManagerIoUring(
+    const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+    Api::OsSysCalls& posix)
+    : ring_size_(config.io_uring().ring_size() == 0 ? DefaultRingSize
+                                                    : config.io_uring().ring_size()),
+      posix_(posix) {
+  if (!posix.supportsAllPosixFileOperations() || !Io::isIoUringSupported()) {
+    throw EnvoyException("AsyncFileManagerIoUring not supported");
+  }
+  if (!requiredOperationsSupported()) {
+    throw EnvoyException("AsyncFileManagerIoUring not supported: the kernel lacks io_uring "
+                         "openat, statx, unlinkat or linkat (requires Linux 5.15)");
+  }
+  io_uring_ = std::make_unique<Io::IoUringImpl>(ring_size_, false);
+  event_fd_ = io_uring_->registerEventfd();
+  ENVOY_LOG(info, fmt::format("AsyncFileManagerIoUring created with id '{}', with ring size {}",
+                              config.id(), ring_size_));
+  completion_thread_ = std::thread([this]() { completionThread(); });
+}
+
+AsyncFileManagerIoUring::~AsyncFileManagerIoUring() ABSL_LOCKS_EXCLUDED(mutex_) {
+  {
+    absl::MutexLock lock(&mutex_);
+    // Operations in flight have to complete as the kernel may still use their buffers, and the
+    // completion thread submits the waiting ones as they do, so that every callback is called.
+    // Dropping the waiting operations instead would destroy them after the completion thread
+    // stopped, where destroying a handle they hold can't submit its close anymore.
+    const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+      return in_flight_.empty() && waiting_.empty();
+    };
+    mutex_.Await(absl::Condition(&condition));
+    // A completion without user data stops the completion thread.
+    io_uring_->prepareNop(nullptr);
+    io_uring_->submit();
+  }
+  completion_thread_.join();
+  io_uring_->unregisterEventfd();
+  ::close(event_fd_);
+}
+
+bool AsyncFileManagerIoUring::requiredOperationsSupported() {
+  return Io::areIoUringOpcodesSupported(
+      {IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_UNLINKAT, IORING_OP_LINKAT});
+}
+
+std::string AsyncFileManagerIoUring::describe() const {
+  return absl::StrCat("io_uring ring_size = ", ring_size_);
+}
+
+void AsyncFileManagerIoUring::submit(std::shared_ptr<IoUringOperation> operation) {
+  absl::MutexLock lock(&mutex_);
+  // Operations are submitted in order, so nothing overtakes operations which are waiting.
+  if (in_flight_.size() >= ring_size_ || !waiting_.empty()) {
+    waiting_.push_back(std::move(operation));
+    return;
+  }
+  prepareLocked(std::move(operation));
+  io_uring_->submit();
+}
+
+CancelFunction AsyncFileManagerIoUring::enqueue(std::shared_ptr<AsyncFileAction> action) {
+  auto cancel_func = [action]() { action->cancel(); };
+  submit(std::make_shared<ActionOnCompletionThread>(std::move(action)));
+  return cancel_func;
+}
+
+void AsyncFileManagerIoUring::prepareLocked(std::shared_ptr<IoUringOperation> operation) {
+  // The completion queue holds twice as many entries as the submission queue, and at most
+  // ring_size_ operations are in flight, so neither of them can overflow.
+  IoUringOperation* key = operation.get();
+  const Io::IoUringResult result = operation->prepare(*io_uring_, key);
+  RELEASE_ASSERT(result == Io::IoUringResult::Ok, "io_uring submission queue is full");
+  in_flight_.emplace(key, std::move(operation));
+}
+
+void AsyncFileManagerIoUring::completionThread() {
+  bool terminate = false;
+  while (!terminate) {
+    // Blocks on the eventfd until there are completions.
+    io_uring_->forEveryCompletion([this, &terminate](void* user_data, int32_t result) {
+      if (user_data == nullptr) {
+        terminate = true;
+        return;
+      }
+      onCompletion(static_cast<IoUringOperation*>(user_data), result);
+    });
+  }
+}
+
+void AsyncFileManagerIoUring::onCompletion(IoUringOperation* operation, int32_t result) {
+  // The operation is kept alive by in_flight_ while its callback runs, and still counts as in
+  // flight so that the destructor waits for the callback.
+  const bool prepare_again = operation->onCompletion(result);
+  std::shared_ptr<IoUringOperation> completed;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = in_flight_.find(operation);
+    ASSERT(it != in_flight_.end());
+    completed = std::move(it->second);
+    in_flight_.erase(it);
+    if (prepare_again) {
+      prepareLocked(std::move(completed));
+    }
+    while (in_flight_.size() < ring_size_ && !waiting_.empty()) {
+      prepareLocked(std::move(waiting_.front()));
+      waiting_.pop_front();
+    }
+    io_uring_->submit();
+  }
+  // Destroyed outside of the lock, as destroying a handle may close it and submit again.
+}
+
+CancelFunction AsyncFileManagerIoUring::createAnonymousFile(
+    absl::string_view path, std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  if (o_tmpfile_unsupported_) {
+    return enqueue(
+        std::make_shared<ActionCreateAnonymousFileWithMkstemp>(*this, path, on_complete));
+  }
+  return submitAction(std::make_shared<ActionCreateAnonymousFile>(*this, path, on_complete));
+}
+
+CancelFunction AsyncFileManagerIoUring::openExistingFile(
+    absl::string_view filename, Mode mode,
+    std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete) {
+  return submitAction(
+      std::make_shared<ActionOpenExistingFile>(*this, filename, mode, on_complete));
+}
+
+CancelFunction
+AsyncFileManagerIoUring::stat(absl::string_view filename,
+                              std::function<void(absl::StatusOr<struct stat>)> on_complete) {
+  return submitAction(std::make_shared<ActionStat>(filename, on_complete));
+}
+
+CancelFunction AsyncFileManagerIoUring::unlink(absl::string_view filename,
+                                               std::function<void(absl::Status)> on_complete) {
+  return submitAction(std::make_shared<ActionUnlink>(filename, on_complete));
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
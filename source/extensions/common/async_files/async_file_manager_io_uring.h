@@ -0,0 +1,158 @@
+#pragma once
+
+#include <sys/stat.h>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "envoy/api/os_sys_calls.h"
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/common/logger.h"
+#include "source/common/io/io_uring.h"
+#include "source/extensions/common/async_files/async_file_action.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+// An operation submitted to the io_uring of an AsyncFileManagerIoUring.
+class IoUringOperation {
+public:
+  virtual ~IoUringOperation() = default;
+
+  // Puts the operation into the submission queue of the ring, with the given user data.
+  virtual Io::IoUringResult prepare(Io::IoUring& ring, void* user_data) PURE;
+
+  // Called on the completion thread with the result of the operation, i.e. the return value of
+  // the system call or a negated errno. Returns true if the operation has to be prepared again,
+  // e.g. to write the rest of a short write.
+  virtual bool onCompletion(int32_t result) PURE;
+};
+
+// An AsyncFileAction performed by a single io_uring operation. The callback is called on the
+// completion thread, with the result of the operation converted by resultFromCompletion.
+template <typename T>
+class AsyncFileActionIoUring : public AsyncFileActionWithResult<T>, public IoUringOperation {
+public:
+  explicit AsyncFileActionIoUring(std::function<void(T)> on_complete)
+      : AsyncFileActionWithResult<T>(on_complete) {}
+
+  bool onCompletion(int32_t result) override {
+    result_ = result;
+    this->execute();
+    if (!executed_) {
+      // The action was cancelled while the operation was in flight, which has to be undone the
+      // same way as if it was cancelled while executing.
+      this->onCancelledBeforeCallback(resultFromCompletion(result));
+    }
+    return false;
+  }
+
+protected:
+  T executeImpl() final {
+    executed_ = true;
+    return resultFromCompletion(result_);
+  }
+
+  // Converts the result of the operation into the result passed to the callback.
+  virtual T resultFromCompletion(int32_t result) PURE;
+
+private:
+  int32_t result_{};
+  bool executed_{};
+};
+
+// An AsyncFileManager which submits file operations to an io_uring from the thread requesting
+// them, so that no thread hands an operation to another before the kernel performs it. A single
+// completion thread reaps the completions and calls the callbacks, which may chain further
+// actions by submitting them directly.
+//
+// At most ring_size operations are in flight at once; further operations wait in a queue, and
+// are submitted by the completion thread as earlier ones complete. Operations io_uring can't
+// perform, e.g. duplicating a file descriptor or whenReady, are performed on the completion
+// thread. On destruction, the manager waits for all operations, including the waiting ones, to
+// complete and call their callbacks.
+class AsyncFileManagerIoUring : public AsyncFileManager,
+                                protected Logger::Loggable<Logger::Id::main> {
+public:
+  static constexpr uint32_t DefaultRingSize = 256;
+
+  explicit AsyncFileManagerIoUring(
+      const envoy::extensions::common::async_files::v3::AsyncFileManagerConfig& config,
+      Api::OsSysCalls& posix);
+  ~AsyncFileManagerIoUring() ABSL_LOCKS_EXCLUDED(mutex_) override;
+
+  // Returns whether the kernel supports all the io_uring operations the manager submits, i.e.
+  // openat and statx (Linux 5.6), unlinkat (5.11) and linkat (5.15).
+  static bool requiredOperationsSupported();
+  CancelFunction
+  createAnonymousFile(absl::string_view path,
+                      std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete) override;
+  CancelFunction
+  openExistingFile(absl::string_view filename, Mode mode,
+                   std::function<void(absl::StatusOr<AsyncFileHandle>)> on_complete) override;
+  CancelFunction stat(absl::string_view filename,
+                      std::function<void(absl::StatusOr<struct stat>)> on_complete) override;
+  CancelFunction unlink(absl::string_view filename,
+                        std::function<void(absl::Status)> on_complete) override;
+  std::string describe() const override;
+  Api::OsSysCalls& posix() const { return posix_; }
+
+  // Submits an operation, or queues it if ring_size operations are already in flight. The
+  // operation is kept alive until it completes.
+  void submit(std::shared_ptr<IoUringOperation> operation) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Submits an action which is also an IoUringOperation, and returns the function cancelling it.
+  template <typename Action> CancelFunction submitAction(std::shared_ptr<Action> action) {
+    submit(action);
+    return [action]() { action->cancel(); };
+  }
+
+  // Set once opening a file with O_TMPFILE failed because the kernel or the file system doesn't
+  // support it, after which anonymous files are created with mkstemp and unlink instead.
+  std::atomic<bool> o_tmpfile_unsupported_{false};
+
+private:
+  CancelFunction enqueue(std::shared_ptr<AsyncFileAction> action)
+      ABSL_LOCKS_EXCLUDED(mutex_) override;
+  void prepareLocked(std::shared_ptr<IoUringOperation> operation)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void completionThread() ABSL_LOCKS_EXCLUDED(mutex_);
+  void onCompletion(IoUringOperation* operation, int32_t result) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const uint32_t ring_size_;
+  Api::OsSysCalls& posix_;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<IoUringOperation*, std::shared_ptr<IoUringOperation>>
+      in_flight_ ABSL_GUARDED_BY(mutex_);
+  std::deque<std::shared_ptr<IoUringOperation>> waiting_ ABSL_GUARDED_BY(mutex_);
+  // The submission queue is only used while holding mutex_, and the completion queue only by the
+  // completion thread.
+  std::unique_ptr<Io::IoUring> io_uring_;
+  os_fd_t event_fd_;
+  std::thread completion_thread_;
+};
+
+// Converts the negated errno an io_uring operation completed with into a status.
+absl::Status statusAfterCompletionError(int32_t result);
+
+// Converts the result of statx into a stat structure.
+struct stat statFromStatx(const struct statx& statx_buf);
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Common {
+namespace Compressor {
+
+/**
+ * Per-worker pool of reset-able compression contexts. Creating and initializing a compression
+ * context (e.g. a `ZSTD_CCtx` or a zlib `z_stream`) allocates and zeroes the encoder's internal
+ * tables, which for higher compression levels costs hundreds of kilobytes per stream. The pool
+ * keeps up to `max_size` idle contexts per thread and hands them back out to subsequent streams
+ * after resetting them to their initial state.
+ *
+ * Contexts must be acquired and released on the same thread. This is guaranteed for compressors
+ * created by the HTTP compressor filter, which are owned by a stream living on a single worker.
+ *
+ * The pool must outlive every context it hands out, as their deleters refer to it. This holds
+ * for the compressor factories owning a pool, which are kept alive by the filter configuration
+ * of every stream using one of their compressors.
+ */
+template <class T> class ContextPool : NonCopyable {
+public:
+  /**
+   * Deleter of the contexts handed out by acquire(), which returns them to the pool. It is a plain
+   * functor rather than a std::function so that handing out a context doesn't allocate. It can
+   * also hold a destroy function, for contexts of the same type that are not pooled. It doesn't
+   * keep the pool alive, @see ContextPool.
+   */
+  class Deleter {
+  public:
+    explicit Deleter(ContextPool& pool) : pool_(&pool) {}
+    explicit Deleter(void (*destroyer)(T*)) : destroyer_(destroyer) {}
+
+    void operator()(T* context) const {
+      if (pool_ != nullptr) {
+        pool_->release(context);
+      } else {
+        destroyer_(context);
+      }
+    }
+
+  private:
+    ContextPool* pool_{};
+    void (*destroyer_)(T*){};
+  };
+
+  using ContextPtr = std::unique_ptr<T, Deleter>;
+  // Creates a new fully initialized context.
+  using ContextCreator = std::function<T*()>;
+  // Resets a context so that it can be used for a new stream. Returns false if the context can't
+  // be reused, in which case it is destroyed.
+  using ContextResetter = std::function<bool(T*)>;
+  // Releases all resources held by a context.
+  using ContextDestroyer = std::function<void(T*)>;
+
+  ContextPool(ThreadLocal::SlotAllocator& tls, uint32_t max_size, ContextCreator creator,
+              ContextResetter resetter, ContextDestroyer destroyer)
+      : max_size_(max_size), creator_(std::move(creator)), resetter_(std::move(resetter)),
+        destroyer_(destroyer),
+        tls_slot_(ThreadLocal::TypedSlot<ThreadLocalPool>::makeUnique(tls)) {
+    tls_slot_->set([max_size, destroyer](Event::Dispatcher&) {
+      return std::make_shared<ThreadLocalPool>(max_size, destroyer);
+    });
+  }
+
+  ~ContextPool() {
+    ASSERT(outstanding_.load(std::memory_order_relaxed) == 0,
+           "compression contexts must be destroyed before their pool");
+  }
+
+  /**
+   * @return ContextPtr an initialized context, either taken from the calling thread's free list
+   * or freshly created. Destroying the returned pointer hands the context back to the free list
+   * of the calling thread if there is room for it. The pool must outlive the returned pointer.
+   */
+  ContextPtr acquire() {
+    ThreadLocalPool& local = **tls_slot_;
+    T* context;
+    if (local.contexts_.empty()) {
+      context = creator_();
+      local.created_++;
+    } else {
+      context = local.contexts_.back();
+      local.contexts_.pop_back();
+      local.reused_++;
+    }
+    RELEASE_ASSERT(context != nullptr, "unable to create compression context");
+    outstanding_.fetch_add(1, std::memory_order_relaxed);
+    return ContextPtr(context, Deleter(*this));
+  }
+
+  /**
+   * @return uint64_t the number of contexts created on the calling thread.
+   */
+  uint64_t created() const { return (*tls_slot_)->created_; }
+
+  /**
+   * @return uint64_t the number of contexts handed out from the calling thread's free list.
+   */
+  uint64_t reused() const { return (*tls_slot_)->reused_; }
+
+  /**
+   * @return size_t the number of idle contexts currently held by the calling thread.
+   */
+  size_t idle() const { return (*tls_slot_)->contexts_.size(); }
+
+  uint32_t maxSize() const { return max_size_; }
+
+private:
+  struct ThreadLocalPool : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalPool(uint32_t max_size, ContextDestroyer destroyer)
+        : destroyer_(std::move(destroyer)) {
+      contexts_.reserve(max_size);
+    }
+    ~ThreadLocalPool() override {
+      for (T* context : contexts_) {
+        destroyer_(context);
+      }
+    }
+
+    const ContextDestroyer destroyer_;
+    std::vector<T*> contexts_;
+    uint64_t created_{0};
+    uint64_t reused_{0};
+  };
+
+  void release(T* context) {
+    outstanding_.fetch_sub(1, std::memory_order_relaxed);
+    ThreadLocalPool& local = **tls_slot_;
+    if (local.contexts_.size() < max_size_ && resetter_(context)) {
+      local.contexts_.push_back(context);
+      return;
+    }
+    destroyer_(context);
+  }
+
+  const uint32_t max_size_;
+  const ContextCreator creator_;
+  const ContextResetter resetter_;
+  const ContextDestroyer destroyer_;
+  ThreadLocal::TypedSlotPtr<ThreadLocalPool> tls_slot_;
+  // The number of contexts handed out and not released yet, on all threads.
+  std::atomic<uint64_t> outstanding_{0};
+};
+
+template <class T> using ContextPoolPtr = std::unique_ptr<ContextPool<T>>;
+
+} // namespace Compressor
+} // namespace Common
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
@@ -6,9 +6,13 @@ namespace Compression {
 namespace Gzip {
 namespace Common {
 
-Base::Base(uint64_t chunk_size, std::function<void(z_stream*)> zstream_deleter)
+Base::Base(uint64_t chunk_size, void (*zstream_deleter)(z_stream*))
     : chunk_size_{chunk_size}, chunk_char_ptr_(new unsigned char[chunk_size]),
-      zstream_ptr_(new z_stream(), zstream_deleter) {}
+      zstream_ptr_(new z_stream(), ZStreamDeleter(zstream_deleter)) {}
+
+Base::Base(uint64_t chunk_size, ZStreamPtr zstream)
+    : chunk_size_{chunk_size}, chunk_char_ptr_(new unsigned char[chunk_size]),
+      zstream_ptr_(std::move(zstream)) {}
 
 uint64_t Base::checksum() { return zstream_ptr_->adler; }
 
@@ -4,6 +4,8 @@
 
 #include "envoy/buffer/buffer.h"
 
+#include "source/extensions/compression/common/compressor/context_pool.h"
+
 #include "zlib.h"
 
 namespace Envoy {
@@ -12,12 +14,21 @@ namespace Compression {
 namespace Gzip {
 namespace Common {
 
+// A stream is either returned to a context pool or destroyed by a plain function when released.
+using ZStreamDeleter = Compression::Common::Compressor::ContextPool<z_stream>::Deleter;
+using ZStreamPtr = std::unique_ptr<z_stream, ZStreamDeleter>;
+
 /**
  * Shared code between the compressor and the decompressor.
  */
 class Base {
 public:
-  Base(uint64_t chunk_size, std::function<void(z_stream*)> zstream_deleter);
+  Base(uint64_t chunk_size, void (*zstream_deleter)(z_stream*));
+
+  /**
+   * Constructor taking ownership of an existing stream, e.g. one handed out by a context pool.
+   */
+  Base(uint64_t chunk_size, ZStreamPtr zstream);
 
   /**
    * It returns the checksum of all output produced so far. Compressor's checksum at the end of
@@ -36,7 +47,7 @@ protected:
   bool initialized_{false};
 
   const std::unique_ptr<unsigned char[]> chunk_char_ptr_;
-  const std::unique_ptr<z_stream, std::function<void(z_stream*)>> zstream_ptr_;
+  const ZStreamPtr zstream_ptr_;
 };
 
 } // namespace Common
@@ -38,7 +38,8 @@ const std::string& gzipExtensionName() {
 
 class GzipCompressorFactory : public Envoy::Compression::Compressor::CompressorFactory {
 public:
-  GzipCompressorFactory(const envoy::extensions::compression::gzip::compressor::v3::Gzip& gzip);
+  GzipCompressorFactory(const envoy::extensions::compression::gzip::compressor::v3::Gzip& gzip,
+                        ThreadLocal::SlotAllocator& tls);
 
   // Envoy::Compression::Compressor::CompressorFactory
   Envoy::Compression::Compressor::CompressorPtr createCompressor() override;
@@ -47,6 +48,9 @@ public:
     return Http::CustomHeaders::get().ContentEncodingValues.Gzip;
   }
 
+  // Exposed for tests and benchmarks.
+  const ZlibStreamPool* contextPool() const { return stream_pool_.get(); }
+
 private:
   static ZlibCompressorImpl::CompressionLevel
   compressionLevelEnum(envoy::extensions::compression::gzip::compressor::v3::Gzip::CompressionLevel
@@ -60,6 +64,7 @@ private:
   const int32_t memory_level_;
   const int32_t window_bits_;
   const uint32_t chunk_size_;
+  ZlibStreamPoolPtr stream_pool_;
 };
 
 class GzipCompressorLibraryFactory
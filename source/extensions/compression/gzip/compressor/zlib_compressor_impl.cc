@@ -28,6 +28,33 @@ ZlibCompressorImpl::ZlibCompressorImpl(uint64_t chunk_size)
   zstream_ptr_->next_out = chunk_char_ptr_.get();
 }
 
+ZlibCompressorImpl::ZlibCompressorImpl(ZlibStreamPtr zstream, uint64_t chunk_size)
+    : Common::Base(chunk_size, std::move(zstream)) {
+  zstream_ptr_->avail_out = chunk_size_;
+  zstream_ptr_->next_out = chunk_char_ptr_.get();
+  initialized_ = true;
+}
+
+z_stream* ZlibCompressorImpl::createStream(CompressionLevel comp_level,
+                                           CompressionStrategy comp_strategy, int64_t window_bits,
+                                           uint64_t memory_level) {
+  z_stream* zstream = new z_stream();
+  zstream->zalloc = Z_NULL;
+  zstream->zfree = Z_NULL;
+  zstream->opaque = Z_NULL;
+  const int result = deflateInit2(zstream, static_cast<int64_t>(comp_level), Z_DEFLATED,
+                                  window_bits, memory_level, static_cast<uint64_t>(comp_strategy));
+  RELEASE_ASSERT(result >= 0, "");
+  return zstream;
+}
+
+bool ZlibCompressorImpl::resetStream(z_stream* zstream) { return deflateReset(zstream) == Z_OK; }
+
+void ZlibCompressorImpl::destroyStream(z_stream* zstream) {
+  deflateEnd(zstream);
+  delete zstream;
+}
+
 void ZlibCompressorImpl::init(CompressionLevel comp_level, CompressionStrategy comp_strategy,
                               int64_t window_bits, uint64_t memory_level = 8) {
   ASSERT(initialized_ == false);
@@ -2,6 +2,7 @@
 
 #include "envoy/compression/compressor/compressor.h"
 
+#include "source/extensions/compression/common/compressor/context_pool.h"
 #include "source/extensions/compression/gzip/common/base.h"
 
 #include "zlib.h"
@@ -12,6 +13,10 @@ namespace Compression {
 namespace Gzip {
 namespace Compressor {
 
+using ZlibStreamPool = Compression::Common::Compressor::ContextPool<z_stream>;
+using ZlibStreamPoolPtr = std::unique_ptr<ZlibStreamPool>;
+using ZlibStreamPtr = ZlibStreamPool::ContextPtr;
+
 /**
  * Implementation of compressor's interface.
  */
@@ -29,6 +34,14 @@ public:
    */
   ZlibCompressorImpl(uint64_t chunk_size);
 
+  /**
+   * Constructor taking a stream which has already been initialized for deflate, e.g. one acquired
+   * from a ZlibStreamPool. init() must not be called on compressors created this way.
+   * @param zstream initialized deflate stream, @see createStream().
+   * @param chunk_size amount of memory reserved for the compressor output.
+   */
+  ZlibCompressorImpl(ZlibStreamPtr zstream, uint64_t chunk_size);
+
   /**
    * Enum values used to set compression level during initialization.
    * best: gives best compression.
@@ -82,6 +95,23 @@ public:
   void init(CompressionLevel level, CompressionStrategy strategy, int64_t window_bits,
             uint64_t memory_level);
 
+  /**
+   * Creates a deflate stream initialized with the given parameters. @see init().
+   */
+  static z_stream* createStream(CompressionLevel level, CompressionStrategy strategy,
+                                int64_t window_bits, uint64_t memory_level);
+
+  /**
+   * Resets a deflate stream to its initial state, keeping its parameters and allocated state.
+   * @return bool whether the reset succeeded.
+   */
+  static bool resetStream(z_stream* zstream);
+
+  /**
+   * Releases a stream created with createStream().
+   */
+  static void destroyStream(z_stream* zstream);
+
   // Compression::Compressor::Compressor
   void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
 
@@ -22,9 +22,22 @@ ZstdCompressorFactory::ZstdCompressorFactory(
           return ZSTD_createCDict(dict_buffer, dict_size, compression_level_);
         });
   }
+  if (zstd.max_pooled_contexts() > 0) {
+    cctx_pool_ = std::make_unique<ZstdCCtxPool>(
+        tls, zstd.max_pooled_contexts(),
+        [this]() {
+          return ZstdCompressorImpl::createContext(compression_level_, enable_checksum_, strategy_,
+                                                   cdict_manager_ != nullptr);
+        },
+        &ZstdCompressorImpl::resetContext, &ZstdCompressorImpl::freeContext);
+  }
 }
 
 Envoy::Compression::Compressor::CompressorPtr ZstdCompressorFactory::createCompressor() {
+  if (cctx_pool_) {
+    return std::make_unique<ZstdCompressorImpl>(cctx_pool_->acquire(), cdict_manager_,
+                                                chunk_size_);
+  }
   return std::make_unique<ZstdCompressorImpl>(compression_level_, enable_checksum_, strategy_,
                                               cdict_manager_, chunk_size_);
 }
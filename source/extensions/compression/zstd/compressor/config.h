@@ -36,12 +36,16 @@ public:
     return Http::CustomHeaders::get().ContentEncodingValues.Zstd;
   }
 
+  // Exposed for tests and benchmarks.
+  const ZstdCCtxPool* contextPool() const { return cctx_pool_.get(); }
+
 private:
   const uint32_t compression_level_;
   const bool enable_checksum_;
   const uint32_t strategy_;
   const uint32_t chunk_size_;
   ZstdCDictManagerPtr cdict_manager_{nullptr};
+  ZstdCCtxPoolPtr cctx_pool_{nullptr};
 };
 
 class ZstdCompressorLibraryFactory
@@ -11,24 +11,51 @@ namespace Compressor {
 ZstdCompressorImpl::ZstdCompressorImpl(uint32_t compression_level, bool enable_checksum,
                                        uint32_t strategy, const ZstdCDictManagerPtr& cdict_manager,
                                        uint32_t chunk_size)
-    : Common::Base(chunk_size), cctx_(ZSTD_createCCtx(), &ZSTD_freeCCtx),
-      cdict_manager_(cdict_manager), compression_level_(compression_level) {
+    : ZstdCompressorImpl(
+          ZstdCCtxPtr(createContext(compression_level, enable_checksum, strategy,
+                                    cdict_manager != nullptr),
+                      ZstdCCtxPool::Deleter(&freeContext)),
+          cdict_manager, chunk_size) {}
+
+ZstdCompressorImpl::ZstdCompressorImpl(ZstdCCtxPtr cctx, const ZstdCDictManagerPtr& cdict_manager,
+                                       uint32_t chunk_size)
+    : Common::Base(chunk_size), cctx_(std::move(cctx)), cdict_manager_(cdict_manager) {
+  // The dictionary is looked up for every stream, as dictionaries watched on the file system may
+  // have been replaced since a pooled context was last used.
+  if (cdict_manager_) {
+    ZSTD_CDict* cdict = cdict_manager_->getFirstDictionary();
+    const size_t result = ZSTD_CCtx_refCDict(cctx_.get(), cdict);
+    RELEASE_ASSERT(!ZSTD_isError(result), "");
+  }
+}
+
+ZSTD_CCtx* ZstdCompressorImpl::createContext(uint32_t compression_level, bool enable_checksum,
+                                             uint32_t strategy, bool use_dictionary) {
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  RELEASE_ASSERT(cctx != nullptr, "");
+
   size_t result;
-  result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_checksumFlag, enable_checksum);
+  result = ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, enable_checksum);
   RELEASE_ASSERT(!ZSTD_isError(result), "");
 
-  result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_strategy, strategy);
+  result = ZSTD_CCtx_setParameter(cctx, ZSTD_c_strategy, strategy);
   RELEASE_ASSERT(!ZSTD_isError(result), "");
 
-  if (cdict_manager_) {
-    ZSTD_CDict* cdict = cdict_manager_->getFirstDictionary();
-    result = ZSTD_CCtx_refCDict(cctx_.get(), cdict);
-  } else {
-    result = ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_compressionLevel, compression_level_);
+  if (!use_dictionary) {
+    result = ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, compression_level);
+    RELEASE_ASSERT(!ZSTD_isError(result), "");
   }
-  RELEASE_ASSERT(!ZSTD_isError(result), "");
+  return cctx;
 }
 
+bool ZstdCompressorImpl::resetContext(ZSTD_CCtx* cctx) {
+  // Only the session is reset: the compression parameters are kept, and the referenced
+  // dictionary, if any, is replaced by the next owner of the context.
+  return !ZSTD_isError(ZSTD_CCtx_reset(cctx, ZSTD_reset_session_only));
+}
+
+void ZstdCompressorImpl::freeContext(ZSTD_CCtx* cctx) { ZSTD_freeCCtx(cctx); }
+
 void ZstdCompressorImpl::compress(Buffer::Instance& buffer,
                                   Envoy::Compression::Compressor::State state) {
   Buffer::OwnedImpl accumulation_buffer;
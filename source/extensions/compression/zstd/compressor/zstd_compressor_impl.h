@@ -2,6 +2,7 @@
 
 #include "envoy/compression/compressor/compressor.h"
 
+#include "source/extensions/compression/common/compressor/context_pool.h"
 #include "source/extensions/compression/zstd/common/base.h"
 #include "source/extensions/compression/zstd/common/dictionary_manager.h"
 
@@ -14,6 +15,9 @@ namespace Compressor {
 using ZstdCDictManager =
     Common::DictionaryManager<ZSTD_CDict, ZSTD_freeCDict, ZSTD_getDictID_fromCDict>;
 using ZstdCDictManagerPtr = std::unique_ptr<ZstdCDictManager>;
+using ZstdCCtxPool = Compression::Common::Compressor::ContextPool<ZSTD_CCtx>;
+using ZstdCCtxPoolPtr = std::unique_ptr<ZstdCCtxPool>;
+using ZstdCCtxPtr = ZstdCCtxPool::ContextPtr;
 
 /**
  * Implementation of compressor's interface.
@@ -25,15 +29,42 @@ public:
   ZstdCompressorImpl(uint32_t compression_level, bool enable_checksum, uint32_t strategy,
                      const ZstdCDictManagerPtr& cdict_manager, uint32_t chunk_size);
 
+  /**
+   * Constructor taking an already configured compression context, e.g. one acquired from a
+   * ZstdCCtxPool. The context must have been created with createContext() and must be in its
+   * initial (reset) state.
+   */
+  ZstdCompressorImpl(ZstdCCtxPtr cctx, const ZstdCDictManagerPtr& cdict_manager,
+                     uint32_t chunk_size);
+
+  /**
+   * Creates a compression context with the given parameters applied.
+   * @param use_dictionary whether the compression level is taken from a dictionary referenced
+   * later, in which case it is not set on the context.
+   */
+  static ZSTD_CCtx* createContext(uint32_t compression_level, bool enable_checksum,
+                                  uint32_t strategy, bool use_dictionary);
+
+  /**
+   * Resets a context to its initial state while keeping its parameters, so that it can be reused
+   * for a new frame.
+   * @return bool whether the reset succeeded.
+   */
+  static bool resetContext(ZSTD_CCtx* cctx);
+
+  /**
+   * Frees a context created with createContext().
+   */
+  static void freeContext(ZSTD_CCtx* cctx);
+
   // Compression::Compressor::Compressor
   void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
 
 private:
   void process(Buffer::Instance& output_buffer, ZSTD_EndDirective mode);
 
-  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx_;
+  ZstdCCtxPtr cctx_;
   const ZstdCDictManagerPtr& cdict_manager_;
-  const uint32_t compression_level_;
 };
 
 } // namespace Compressor
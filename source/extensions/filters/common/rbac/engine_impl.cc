@@ -1,15 +1,164 @@
 #include "source/extensions/filters/common/rbac/engine_impl.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "envoy/config/rbac/v3/rbac.pb.h"
 #include "envoy/config/rbac/v3/rbac.pb.validate.h"
 
 #include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
 namespace Common {
 namespace RBAC {
+namespace {
+
+// Returns whether a principal only depends on the downstream connection, and thus matches all of
+// the requests of a connection if it matches one of them.
+bool dependsOnConnectionOnly(const envoy::config::rbac::v3::Principal& principal) {
+  switch (principal.identifier_case()) {
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kAndIds:
+    return std::all_of(principal.and_ids().ids().begin(), principal.and_ids().ids().end(),
+                       dependsOnConnectionOnly);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kOrIds:
+    return std::all_of(principal.or_ids().ids().begin(), principal.or_ids().ids().end(),
+                       dependsOnConnectionOnly);
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kNotId:
+    return dependsOnConnectionOnly(principal.not_id());
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kAny:
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kAuthenticated:
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kSourceIp:
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kDirectRemoteIp:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Returns whether a principal can be looked up in a PrincipalIndex.
+bool indexable(const envoy::config::rbac::v3::Principal& principal) {
+  switch (principal.identifier_case()) {
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kSourceIp:
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kDirectRemoteIp:
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kRemoteIp:
+    return true;
+  case envoy::config::rbac::v3::Principal::IdentifierCase::kHeader: {
+    const auto& header = principal.header();
+    return header.header_match_specifier_case() ==
+               envoy::config::route::v3::HeaderMatcher::HeaderMatchSpecifierCase::kStringMatch &&
+           header.string_match().match_pattern_case() ==
+               envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kExact &&
+           !header.string_match().ignore_case() && !header.invert_match() &&
+           !header.treat_missing_header_as_empty();
+  }
+  default:
+    return false;
+  }
+}
+
+std::atomic<uint64_t> next_engine_id{0};
+
+} // namespace
+
+PrincipalIndex::PrincipalIndex(const std::vector<const PrincipalList*>& principal_lists) {
+  absl::flat_hash_map<IPMatcher::Type,
+                      std::vector<std::pair<uint32_t, std::vector<Network::Address::CidrRange>>>>
+      ranges;
+  absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, std::vector<uint32_t>>>
+      header_values;
+  for (uint32_t list = 0; list < principal_lists.size(); ++list) {
+    if (!std::all_of(principal_lists[list]->begin(), principal_lists[list]->end(), indexable)) {
+      continue;
+    }
+    indexed_lists_.push_back(list);
+    for (const auto& principal : *principal_lists[list]) {
+      switch (principal.identifier_case()) {
+      case envoy::config::rbac::v3::Principal::IdentifierCase::kSourceIp:
+        ranges[IPMatcher::ConnectionRemote].push_back(
+            {list, {Network::Address::CidrRange::create(principal.source_ip())}});
+        break;
+      case envoy::config::rbac::v3::Principal::IdentifierCase::kDirectRemoteIp:
+        ranges[IPMatcher::DownstreamDirectRemote].push_back(
+            {list, {Network::Address::CidrRange::create(principal.direct_remote_ip())}});
+        break;
+      case envoy::config::rbac::v3::Principal::IdentifierCase::kRemoteIp:
+        ranges[IPMatcher::DownstreamRemote].push_back(
+            {list, {Network::Address::CidrRange::create(principal.remote_ip())}});
+        break;
+      case envoy::config::rbac::v3::Principal::IdentifierCase::kHeader:
+        header_values[Envoy::Http::LowerCaseString(principal.header().name()).get()]
+                     [principal.header().string_match().exact()]
+                         .push_back(list);
+        break;
+      default:
+        PANIC("unexpected principal in principal index");
+      }
+    }
+  }
+
+  for (auto& [type, type_ranges] : ranges) {
+    ip_tries_.emplace_back(type, std::make_unique<IpTrie>(type_ranges));
+  }
+  for (auto& [name, values] : header_values) {
+    header_values_.emplace_back(Envoy::Http::LowerCaseString(name), std::move(values));
+  }
+}
+
+void PrincipalIndex::lookup(const Network::Connection& connection,
+                            const Envoy::Http::RequestHeaderMap& headers,
+                            const StreamInfo::StreamInfo& info,
+                            std::vector<PrincipalResult>& results) const {
+  for (const uint32_t list : indexed_lists_) {
+    results[list] = PrincipalResult::NotMatched;
+  }
+  for (const auto& [type, trie] : ip_tries_) {
+    const auto& address = IPMatcher::address(type, connection, info);
+    if (address->ip() == nullptr) {
+      continue;
+    }
+    for (const uint32_t list : trie->getData(address)) {
+      results[list] = PrincipalResult::Matched;
+    }
+  }
+  for (const auto& [name, values] : header_values_) {
+    const auto value = Envoy::Http::HeaderUtility::getAllOfHeaderAsString(headers, name);
+    if (!value.result().has_value()) {
+      continue;
+    }
+    const auto it = values.find(value.result().value());
+    if (it != values.end()) {
+      for (const uint32_t list : it->second) {
+        results[list] = PrincipalResult::Matched;
+      }
+    }
+  }
+}
+
+const std::string& ConnectionPrincipalResults::key() {
+  CONSTRUCT_ON_FIRST_USE(std::string, "envoy.filters.common.rbac.connection_principal_results");
+}
+
+std::vector<PrincipalResult>&
+ConnectionPrincipalResults::results(const std::shared_ptr<const uint64_t>& engine_id,
+                                    size_t num_principal_lists) {
+  for (auto& engine_results : results_) {
+    if (engine_results.engine_id_ == *engine_id) {
+      return engine_results.results_;
+    }
+  }
+  results_.erase(std::remove_if(results_.begin(), results_.end(),
+                                [](const EngineResults& engine_results) {
+                                  return engine_results.engine_.expired();
+                                }),
+                 results_.end());
+  results_.push_back(
+      {*engine_id, engine_id,
+       std::vector<PrincipalResult>(num_principal_lists, PrincipalResult::Unknown)});
+  return results_.back().results_;
+}
 
 Envoy::Matcher::ActionFactoryCb
 ActionFactory::createActionFactoryCb(const Protobuf::Message& config, ActionContext& context,
@@ -43,7 +192,9 @@ void generateLog(StreamInfo::StreamInfo& info, EnforcementMode mode, bool log) {
 RoleBasedAccessControlEngineImpl::RoleBasedAccessControlEngineImpl(
     const envoy::config::rbac::v3::RBAC& rules,
     ProtobufMessage::ValidationVisitor& validation_visitor, const EnforcementMode mode)
-    : action_(rules.action()), mode_(mode) {
+    : action_(rules.action()), mode_(mode),
+      cache_connection_principals_(rules.cache_connection_principals()),
+      id_(std::make_shared<const uint64_t>(next_engine_id++)) {
   // guard expression builder by presence of a condition in policies
   for (const auto& policy : rules.policies()) {
     if (policy.second.has_condition()) {
@@ -52,10 +203,43 @@ RoleBasedAccessControlEngineImpl::RoleBasedAccessControlEngineImpl(
     }
   }
 
+  // Policies are evaluated in the lexicographic order of their names.
+  std::map<std::string, const envoy::config::rbac::v3::Policy*> sorted_policies;
   for (const auto& policy : rules.policies()) {
-    policies_.emplace(policy.first, std::make_unique<PolicyMatcher>(policy.second, builder_.get(),
-                                                                    validation_visitor));
+    sorted_policies.emplace(policy.first, &policy.second);
   }
+
+  // Identical principal lists, found by hash, are compiled once.
+  absl::flat_hash_map<size_t, std::vector<uint32_t>> principal_lists_by_hash;
+  std::vector<const PrincipalList*> principal_lists;
+  for (const auto& [name, policy] : sorted_policies) {
+    const PrincipalList& principals = policy->principals();
+    std::vector<uint32_t>& candidates = principal_lists_by_hash[MessageUtil::hash(principals)];
+    auto it = std::find_if(candidates.begin(), candidates.end(), [&](uint32_t candidate) {
+      const PrincipalList& other = *principal_lists[candidate];
+      return other.size() == principals.size() &&
+             std::equal(other.begin(), other.end(), principals.begin(),
+                        [](const auto& lhs, const auto& rhs) {
+                          return Protobuf::util::MessageDifferencer::Equals(lhs, rhs);
+                        });
+    });
+    uint32_t principal_list;
+    if (it != candidates.end()) {
+      principal_list = *it;
+    } else {
+      principal_list = principal_lists.size();
+      candidates.push_back(principal_list);
+      principal_lists.push_back(&principals);
+      principal_lists_.push_back(std::make_unique<OrMatcher>(principals));
+      connection_principal_lists_.push_back(
+          std::all_of(principals.begin(), principals.end(), dependsOnConnectionOnly));
+    }
+    policies_.push_back(
+        {name,
+         std::make_unique<PolicyPermissionsMatcher>(*policy, builder_.get(), validation_visitor),
+         principal_list});
+  }
+  principal_index_ = std::make_unique<PrincipalIndex>(principal_lists);
 }
 
 bool RoleBasedAccessControlEngineImpl::handleAction(const Network::Connection& connection,
@@ -87,21 +271,64 @@ bool RoleBasedAccessControlEngineImpl::handleAction(const Network::Connection& c
 }
 
 bool RoleBasedAccessControlEngineImpl::checkPolicyMatch(
-    const Network::Connection& connection, const StreamInfo::StreamInfo& info,
+    const Network::Connection& connection, StreamInfo::StreamInfo& info,
     const Envoy::Http::RequestHeaderMap& headers, std::string* effective_policy_id) const {
-  bool matched = false;
+  if (policies_.empty()) {
+    return false;
+  }
+
+  std::vector<PrincipalResult> results(principal_lists_.size(), PrincipalResult::Unknown);
+  principal_index_->lookup(connection, headers, info, results);
+  std::vector<PrincipalResult>* connection_results =
+      cache_connection_principals_ ? &connectionPrincipalResults(info) : nullptr;
+
+  const auto principals_match = [&](uint32_t list) {
+    PrincipalResult& result = results[list];
+    if (result == PrincipalResult::Unknown) {
+      PrincipalResult* cached_result = connection_results != nullptr &&
+                                               connection_principal_lists_[list]
+                                           ? &(*connection_results)[list]
+                                           : nullptr;
+      if (cached_result != nullptr && *cached_result != PrincipalResult::Unknown) {
+        result = *cached_result;
+      } else {
+        result = principal_lists_[list]->matches(connection, headers, info)
+                     ? PrincipalResult::Matched
+                     : PrincipalResult::NotMatched;
+        if (cached_result != nullptr) {
+          *cached_result = result;
+        }
+      }
+    }
+    return result == PrincipalResult::Matched;
+  };
 
   for (const auto& policy : policies_) {
-    if (policy.second->matches(connection, headers, info)) {
-      matched = true;
+    if (principals_match(policy.principal_list_) &&
+        policy.matcher_->matches(connection, headers, info)) {
       if (effective_policy_id != nullptr) {
-        *effective_policy_id = policy.first;
+        *effective_policy_id = policy.name_;
       }
-      break;
+      return true;
     }
   }
 
-  return matched;
+  return false;
+}
+
+std::vector<PrincipalResult>&
+RoleBasedAccessControlEngineImpl::connectionPrincipalResults(StreamInfo::StreamInfo& info) const {
+  auto* connection_results = info.filterState()->getDataMutable<ConnectionPrincipalResults>(
+      ConnectionPrincipalResults::key());
+  if (connection_results == nullptr) {
+    auto new_connection_results = std::make_shared<ConnectionPrincipalResults>();
+    connection_results = new_connection_results.get();
+    info.filterState()->setData(ConnectionPrincipalResults::key(),
+                                std::move(new_connection_results),
+                                StreamInfo::FilterState::StateType::Mutable,
+                                StreamInfo::FilterState::LifeSpan::Connection);
+  }
+  return connection_results->results(id_, principal_lists_.size());
 }
 
 RoleBasedAccessControlMatcherEngineImpl::RoleBasedAccessControlMatcherEngineImpl(
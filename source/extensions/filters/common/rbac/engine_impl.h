@@ -1,12 +1,15 @@
 #pragma once
 
 #include "envoy/config/rbac/v3/rbac.pb.h"
+#include "envoy/stream_info/filter_state.h"
 
 #include "source/common/http/matching/data_impl.h"
 #include "source/common/matcher/matcher.h"
+#include "source/common/network/lc_trie.h"
 #include "source/extensions/filters/common/rbac/engine.h"
 #include "source/extensions/filters/common/rbac/matchers.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "xds/type/matcher/v3/matcher.pb.h"
 
 namespace Envoy {
@@ -61,6 +64,78 @@ using ActionValidationVisitor = Envoy::Matcher::MatchTreeValidationVisitor<Http:
 
 void generateLog(StreamInfo::StreamInfo& info, EnforcementMode mode, bool log);
 
+using PrincipalList = Protobuf::RepeatedPtrField<envoy::config::rbac::v3::Principal>;
+
+/**
+ * Whether the principals of a policy match a request, computed at most once per request.
+ */
+enum class PrincipalResult : uint8_t { Unknown, Matched, NotMatched };
+
+/**
+ * Index of the principals of RBAC policies which can be looked up instead of being evaluated one
+ * by one: IP ranges, looked up in LC tries, and exact header values, looked up in hash maps. A
+ * principal list is indexed if all of its principals can be.
+ */
+class PrincipalIndex {
+public:
+  explicit PrincipalIndex(const std::vector<const PrincipalList*>& principal_lists);
+
+  /**
+   * Sets the results of all of the indexed principal lists.
+   * @param results supplies the results of the principal lists, indexed like the lists given to
+   *        the constructor.
+   */
+  void lookup(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
+              const StreamInfo::StreamInfo& info, std::vector<PrincipalResult>& results) const;
+
+private:
+  using IpTrie = Network::LcTrie::LcTrie<uint32_t>;
+
+  std::vector<uint32_t> indexed_lists_;
+  std::vector<std::pair<IPMatcher::Type, std::unique_ptr<IpTrie>>> ip_tries_;
+  std::vector<std::pair<Envoy::Http::LowerCaseString,
+                        absl::flat_hash_map<std::string, std::vector<uint32_t>>>>
+      header_values_;
+};
+
+/**
+ * The results of the principal lists which only depend on the connection, for each engine which
+ * evaluated them on the connection. Stored in the filter state of the connection. The results of
+ * engines which have been destroyed, e.g. replaced by config updates during a long-lived
+ * connection, are dropped when the results of another engine are added, so that they don't grow
+ * without bound, while the engines in use never evict each other's results.
+ */
+class ConnectionPrincipalResults : public StreamInfo::FilterState::Object {
+public:
+  static const std::string& key();
+
+  /**
+   * @param engine_id supplies the id of the engine, owned by the engine for as long as it exists.
+   * @return the results of the principal lists of an engine, initially unknown. They are valid
+   *         until the results of another engine are requested.
+   */
+  std::vector<PrincipalResult>& results(const std::shared_ptr<const uint64_t>& engine_id,
+                                        size_t num_principal_lists);
+
+  size_t numEnginesForTest() const { return results_.size(); }
+
+private:
+  struct EngineResults {
+    uint64_t engine_id_;
+    // Expires when the engine is destroyed.
+    std::weak_ptr<const uint64_t> engine_;
+    std::vector<PrincipalResult> results_;
+  };
+
+  std::vector<EngineResults> results_;
+};
+
+/**
+ * Evaluates RBAC policies. The principals of the policies are compiled at config time: identical
+ * principal lists are shared by the policies using them and evaluated at most once per request,
+ * principal lists made of IP ranges and exact header values are looked up in a PrincipalIndex, and
+ * the results of principal lists only depending on the connection can be cached in the connection.
+ */
 class RoleBasedAccessControlEngineImpl : public RoleBasedAccessControlEngine, NonCopyable {
 public:
   RoleBasedAccessControlEngineImpl(const envoy::config::rbac::v3::RBAC& rules,
@@ -75,18 +150,40 @@ public:
                     std::string* effective_policy_id) const override;
 
 private:
+  struct CompiledPolicy {
+    std::string name_;
+    // Matches the permissions and the condition of the policy.
+    std::unique_ptr<PolicyPermissionsMatcher> matcher_;
+    // The index of the principals of the policy in principal_lists_.
+    uint32_t principal_list_;
+  };
+
   // Checks whether the request matches any policies
-  bool checkPolicyMatch(const Network::Connection& connection, const StreamInfo::StreamInfo& info,
+  bool checkPolicyMatch(const Network::Connection& connection, StreamInfo::StreamInfo& info,
                         const Envoy::Http::RequestHeaderMap& headers,
                         std::string* effective_policy_id) const;
 
+  // Returns the results cached in the connection for the principal lists of this engine.
+  std::vector<PrincipalResult>& connectionPrincipalResults(StreamInfo::StreamInfo& info) const;
+
   const envoy::config::rbac::v3::RBAC::Action action_;
   const EnforcementMode mode_;
-
-  std::map<std::string, std::unique_ptr<PolicyMatcher>> policies_;
+  const bool cache_connection_principals_;
+  // Identifies the engine in ConnectionPrincipalResults. Unlike its address, it isn't reused by
+  // engines created after this one is destroyed. Shared so that ConnectionPrincipalResults can tell
+  // when the engine is destroyed.
+  const std::shared_ptr<const uint64_t> id_;
 
   Protobuf::Arena constant_arena_;
   Expr::BuilderPtr builder_;
+
+  // The policies, in the lexicographic order of their names in which they are evaluated.
+  std::vector<CompiledPolicy> policies_;
+  // The distinct principal lists of the policies.
+  std::vector<std::unique_ptr<OrMatcher>> principal_lists_;
+  // Whether each principal list only depends on the connection.
+  std::vector<bool> connection_principal_lists_;
+  std::unique_ptr<PrincipalIndex> principal_index_;
 };
 
 class RoleBasedAccessControlMatcherEngineImpl : public RoleBasedAccessControlEngine, NonCopyable {
@@ -4,13 +4,79 @@
 #include "envoy/upstream/upstream.h"
 
 #include "source/common/config/utility.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/extensions/filters/common/rbac/matcher_extension.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
 namespace Common {
 namespace RBAC {
+namespace {
+
+// Returns the pattern of a header rule which matches the same values as a StringMatcherSet
+// pattern, or absl::nullopt if the rule has to be evaluated on its own.
+absl::optional<Matchers::StringMatcherSet::Pattern>
+toStringMatcherSetPattern(const envoy::config::route::v3::HeaderMatcher& header) {
+  if (header.header_match_specifier_case() !=
+          envoy::config::route::v3::HeaderMatcher::HeaderMatchSpecifierCase::kStringMatch ||
+      header.invert_match() || header.treat_missing_header_as_empty()) {
+    return absl::nullopt;
+  }
+  return Matchers::StringMatcherSet::toPattern(header.string_match());
+}
+
+// Creates the matchers of OR-ed rules. Header rules using string matchers on the same header are
+// merged into a HeaderStringSetMatcher, which takes the place of the first of them. header_of
+// returns the header rule of a rule, or nullptr if the rule isn't a header rule.
+template <class RuleType, class HeaderOf, class Create>
+std::vector<MatcherConstSharedPtr>
+createOrMatchers(const Protobuf::RepeatedPtrField<RuleType>& rules, HeaderOf header_of,
+                 Create create) {
+  std::vector<MatcherConstSharedPtr> matchers;
+  if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.merge_or_string_matchers")) {
+    for (const auto& rule : rules) {
+      matchers.push_back(create(rule));
+    }
+    return matchers;
+  }
+
+  std::vector<absl::optional<Matchers::StringMatcherSet::Pattern>> patterns;
+  absl::flat_hash_map<std::string, std::vector<Matchers::StringMatcherSet::Pattern>>
+      patterns_by_header;
+  for (const auto& rule : rules) {
+    const envoy::config::route::v3::HeaderMatcher* header = header_of(rule);
+    patterns.push_back(header != nullptr ? toStringMatcherSetPattern(*header) : absl::nullopt);
+    if (patterns.back().has_value()) {
+      patterns_by_header[Envoy::Http::LowerCaseString(header->name()).get()].push_back(
+          *patterns.back());
+    }
+  }
+
+  for (int i = 0; i < rules.size(); ++i) {
+    if (!patterns[i].has_value()) {
+      matchers.push_back(create(rules[i]));
+      continue;
+    }
+    const std::string name = Envoy::Http::LowerCaseString(header_of(rules[i])->name()).get();
+    auto it = patterns_by_header.find(name);
+    if (it == patterns_by_header.end()) {
+      // The rule has been merged into the matcher created for an earlier rule.
+      continue;
+    }
+    if (it->second.size() == 1) {
+      matchers.push_back(create(rules[i]));
+    } else {
+      matchers.push_back(std::make_shared<const HeaderStringSetMatcher>(name, it->second));
+    }
+    patterns_by_header.erase(it);
+  }
+  return matchers;
+}
+
+} // namespace
 
 MatcherConstSharedPtr Matcher::create(const envoy::config::rbac::v3::Permission& permission,
                                       ProtobufMessage::ValidationVisitor& validation_visitor) {
@@ -110,17 +176,28 @@ bool AndMatcher::matches(const Network::Connection& connection,
 }
 
 OrMatcher::OrMatcher(const Protobuf::RepeatedPtrField<envoy::config::rbac::v3::Permission>& rules,
-                     ProtobufMessage::ValidationVisitor& validation_visitor) {
-  for (const auto& rule : rules) {
-    matchers_.push_back(Matcher::create(rule, validation_visitor));
-  }
-}
+                     ProtobufMessage::ValidationVisitor& validation_visitor)
+    : matchers_(createOrMatchers(
+          rules,
+          [](const envoy::config::rbac::v3::Permission& rule) {
+            return rule.rule_case() == envoy::config::rbac::v3::Permission::RuleCase::kHeader
+                       ? &rule.header()
+                       : nullptr;
+          },
+          [&validation_visitor](const envoy::config::rbac::v3::Permission& rule) {
+            return Matcher::create(rule, validation_visitor);
+          })) {}
 
-OrMatcher::OrMatcher(const Protobuf::RepeatedPtrField<envoy::config::rbac::v3::Principal>& ids) {
-  for (const auto& id : ids) {
-    matchers_.push_back(Matcher::create(id));
-  }
-}
+OrMatcher::OrMatcher(const Protobuf::RepeatedPtrField<envoy::config::rbac::v3::Principal>& ids)
+    : matchers_(createOrMatchers(
+          ids,
+          [](const envoy::config::rbac::v3::Principal& id) {
+            return id.identifier_case() ==
+                           envoy::config::rbac::v3::Principal::IdentifierCase::kHeader
+                       ? &id.header()
+                       : nullptr;
+          },
+          [](const envoy::config::rbac::v3::Principal& id) { return Matcher::create(id); })) {}
 
 bool OrMatcher::matches(const Network::Connection& connection,
                         const Envoy::Http::RequestHeaderMap& headers,
@@ -146,24 +223,32 @@ bool HeaderMatcher::matches(const Network::Connection&,
   return Envoy::Http::HeaderUtility::matchHeaders(headers, header_);
 }
 
+bool HeaderStringSetMatcher::matches(const Network::Connection&,
+                                     const Envoy::Http::RequestHeaderMap& headers,
+                                     const StreamInfo::StreamInfo&) const {
+  const auto header_value = Envoy::Http::HeaderUtility::getAllOfHeaderAsString(headers, name_);
+  return header_value.result().has_value() && matcher_set_.matchAny(header_value.result().value());
+}
+
 bool IPMatcher::matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap&,
                         const StreamInfo::StreamInfo& info) const {
-  Envoy::Network::Address::InstanceConstSharedPtr ip;
-  switch (type_) {
+  return range_.isInRange(*address(type_, connection, info));
+}
+
+const Envoy::Network::Address::InstanceConstSharedPtr&
+IPMatcher::address(Type type, const Network::Connection& connection,
+                   const StreamInfo::StreamInfo& info) {
+  switch (type) {
   case ConnectionRemote:
-    ip = connection.connectionInfoProvider().remoteAddress();
-    break;
+    return connection.connectionInfoProvider().remoteAddress();
   case DownstreamLocal:
-    ip = info.downstreamAddressProvider().localAddress();
-    break;
+    return info.downstreamAddressProvider().localAddress();
   case DownstreamDirectRemote:
-    ip = info.downstreamAddressProvider().directRemoteAddress();
-    break;
+    return info.downstreamAddressProvider().directRemoteAddress();
   case DownstreamRemote:
-    ip = info.downstreamAddressProvider().remoteAddress();
-    break;
+    return info.downstreamAddressProvider().remoteAddress();
   }
-  return range_.isInRange(*ip.get());
+  PANIC_DUE_TO_CORRUPT_ENUM;
 }
 
 bool PortMatcher::matches(const Network::Connection&, const Envoy::Http::RequestHeaderMap&,
@@ -248,6 +333,13 @@ bool PolicyMatcher::matches(const Network::Connection& connection,
          (expr_ == nullptr ? true : Expr::matches(*expr_, info, headers));
 }
 
+bool PolicyPermissionsMatcher::matches(const Network::Connection& connection,
+                                       const Envoy::Http::RequestHeaderMap& headers,
+                                       const StreamInfo::StreamInfo& info) const {
+  return permissions_.matches(connection, headers, info) &&
+         (expr_ == nullptr ? true : Expr::matches(*expr_, info, headers));
+}
+
 bool RequestedServerNameMatcher::matches(const Network::Connection& connection,
                                          const Envoy::Http::RequestHeaderMap&,
                                          const StreamInfo::StreamInfo&) const {
@@ -11,6 +11,7 @@
 #include "envoy/type/matcher/v3/string.pb.h"
 
 #include "source/common/common/matchers.h"
+#include "source/common/common/string_matcher_set.h"
 #include "source/common/http/header_utility.h"
 #include "source/common/network/cidr_range.h"
 #include "source/extensions/filters/common/expr/evaluator.h"
@@ -136,6 +137,26 @@ private:
   const Envoy::Http::HeaderUtility::HeaderData header_;
 };
 
+/**
+ * Perform a match of several string matchers against the same HTTP header, matching if any of them
+ * matches. This is equivalent to OR-ing a HeaderMatcher per string matcher, but scans the header
+ * value once instead of once per string matcher. Will always fail to match on any non-HTTP
+ * connection, or if the header is missing.
+ */
+class HeaderStringSetMatcher : public Matcher {
+public:
+  HeaderStringSetMatcher(const std::string& name,
+                         const std::vector<Matchers::StringMatcherSet::Pattern>& patterns)
+      : name_(name), matcher_set_(patterns) {}
+
+  bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
+               const StreamInfo::StreamInfo&) const override;
+
+private:
+  const Envoy::Http::LowerCaseString name_;
+  const Matchers::StringMatcherSet matcher_set_;
+};
+
 /**
  * Perform a match against an IP CIDR range. This rule can be applied to connection remote,
  * downstream local address, downstream direct remote address or downstream remote address.
@@ -150,6 +171,12 @@ public:
   bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
                const StreamInfo::StreamInfo& info) const override;
 
+  /**
+   * @return the address matched by IPMatchers of the given type.
+   */
+  static const Network::Address::InstanceConstSharedPtr&
+  address(Type type, const Network::Connection& connection, const StreamInfo::StreamInfo& info);
+
 private:
   const Network::Address::CidrRange range_;
   const Type type_;
@@ -228,6 +255,29 @@ private:
   Expr::ExpressionPtr expr_;
 };
 
+/**
+ * Matches the permissions and the condition of a policy, regardless of its principals. This is
+ * used by engines which evaluate the principals of policies on their own.
+ */
+class PolicyPermissionsMatcher : public Matcher, NonCopyable {
+public:
+  PolicyPermissionsMatcher(const envoy::config::rbac::v3::Policy& policy, Expr::Builder* builder,
+                           ProtobufMessage::ValidationVisitor& validation_visitor)
+      : permissions_(policy.permissions(), validation_visitor), condition_(policy.condition()) {
+    if (policy.has_condition()) {
+      expr_ = Expr::createExpression(*builder, condition_);
+    }
+  }
+
+  bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
+               const StreamInfo::StreamInfo& info) const override;
+
+private:
+  const OrMatcher permissions_;
+  const google::api::expr::v1alpha1::Expr condition_;
+  Expr::ExpressionPtr expr_;
+};
+
 class MetadataMatcher : public Matcher {
 public:
   MetadataMatcher(const Envoy::Matchers::MetadataMatcher& matcher) : matcher_(matcher) {}
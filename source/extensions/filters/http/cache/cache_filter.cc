@@ -11,6 +11,7 @@
 #include "source/extensions/filters/http/cache/cacheability_utils.h"
 
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 
@@ -23,6 +24,32 @@ namespace {
 inline bool isResponseNotModified(const Http::ResponseHeaderMap& response_headers) {
   return Http::Utility::getResponseStatus(response_headers) == enumToInt(Http::Code::NotModified);
 }
+
+// Checks whether a stale cached response may still be served while it is being validated, according
+// to its stale-while-revalidate directive:
+// https://httpwg.org/specs/rfc5861.html#n-the-stale-while-revalidate-cache-control-extension
+bool withinStaleWhileRevalidate(const Http::ResponseHeaderMap& cached_headers) {
+  const ResponseCacheControl cache_control(
+      cached_headers.getInlineValue(CacheCustomHeaders::responseCacheControl()));
+  if (cache_control.must_validate_ || cache_control.no_stale_ ||
+      !cache_control.stale_while_revalidate_.has_value()) {
+    return false;
+  }
+  SystemTime::duration freshness_lifetime;
+  if (cache_control.max_age_.has_value()) {
+    freshness_lifetime = cache_control.max_age_.value();
+  } else {
+    freshness_lifetime =
+        CacheHeadersUtils::httpTime(cached_headers.getInline(CacheCustomHeaders::expires())) -
+        CacheHeadersUtils::httpTime(cached_headers.Date());
+  }
+  // The age was set by the lookup.
+  uint64_t age;
+  if (!absl::SimpleAtoi(cached_headers.getInlineValue(CacheCustomHeaders::age()), &age)) {
+    return false;
+  }
+  return Seconds(age) <= freshness_lifetime + cache_control.stale_while_revalidate_.value();
+}
 } // namespace
 
 struct CacheResponseCodeDetailValues {
@@ -33,18 +60,23 @@ using CacheResponseCodeDetails = ConstSingleton<CacheResponseCodeDetailValues>;
 
 CacheFilter::CacheFilter(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
                          const std::string&, Stats::Scope&, TimeSource& time_source,
-                         OptRef<HttpCache> http_cache)
+                         OptRef<HttpCache> http_cache,
+                         RequestCollapserSharedPtr request_collapser)
     : time_source_(time_source), cache_(http_cache),
-      vary_allow_list_(config.allowed_vary_headers()) {}
+      vary_allow_list_(config.allowed_vary_headers()),
+      request_collapser_(std::move(request_collapser)) {}
 
 void CacheFilter::onDestroy() {
   filter_state_ = FilterState::Destroyed;
+  stopWaitingForLeader();
   if (lookup_) {
     lookup_->onDestroy();
   }
   if (insert_) {
     insert_->onDestroy();
   }
+  // If the insert hadn't completed, it never will.
+  leaderDone(false);
 }
 
 void CacheFilter::onStreamComplete() {
@@ -81,8 +113,13 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
   ASSERT(decoder_callbacks_);
 
   LookupRequest lookup_request(headers, time_source_.systemTime(), vary_allow_list_);
-  request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
+  const RequestCacheControl& request_cache_control = lookup_request.requestCacheControl();
+  request_allows_inserts_ = !request_cache_control.no_store_;
+  request_allows_stale_ = !request_cache_control.must_validate_ &&
+                          !request_cache_control.max_age_.has_value() &&
+                          !request_cache_control.min_fresh_.has_value();
   is_head_request_ = headers.getMethodValue() == Http::Headers::get().MethodValues.Head;
+  key_hash_ = stableHashKey(lookup_request.key());
   lookup_ = cache_->makeLookupContext(std::move(lookup_request), *decoder_callbacks_);
 
   ASSERT(lookup_);
@@ -141,8 +178,7 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     // that an insert has failed. If an insert fails partway, it's better not to send additional
     // chunks to the cache if we're already in a failure state and should abort, but we can only do
     // that if we can communicate failures back to the filter, so we should fix this.
-    insert_->insertHeaders(
-        headers, metadata, [](bool) {}, end_stream);
+    insert_->insertHeaders(headers, metadata, insertCallback(end_stream), end_stream);
     if (end_stream) {
       insert_status_ = InsertStatus::InsertSucceeded;
     }
@@ -150,6 +186,7 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     // insertion yet.
   } else {
     insert_status_ = InsertStatus::NoInsertResponseNotCacheable;
+    leaderDone(false);
   }
   filter_state_ = FilterState::NotServingFromCache;
   return Http::FilterHeadersStatus::Continue;
@@ -168,8 +205,7 @@ Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_
   if (insert_) {
     ENVOY_STREAM_LOG(debug, "CacheFilter::encodeData inserting body", *encoder_callbacks_);
     // TODO(toddmgreer): Wait for the cache if necessary.
-    insert_->insertBody(
-        data, [](bool) {}, end_stream);
+    insert_->insertBody(data, insertCallback(end_stream), end_stream);
     if (end_stream) {
       insert_status_ = InsertStatus::InsertSucceeded;
     }
@@ -192,7 +228,7 @@ Http::FilterTrailersStatus CacheFilter::encodeTrailers(Http::ResponseTrailerMap&
   response_has_trailers_ = !trailers.empty();
   if (insert_) {
     ENVOY_STREAM_LOG(debug, "CacheFilter::encodeTrailers inserting trailers", *encoder_callbacks_);
-    insert_->insertTrailers(trailers, [](bool) {});
+    insert_->insertTrailers(trailers, insertCallback(true));
   }
   insert_status_ = InsertStatus::InsertSucceeded;
 
@@ -361,6 +397,13 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     return;
   }
 
+  if (collapseRequest(result, request_headers)) {
+    return;
+  }
+  if (collapsed_ && result.cache_entry_status_ == CacheEntryStatus::Ok) {
+    request_collapser_->stats().collapsed_hit_.inc();
+  }
+
   // TODO(yosrym93): Handle request only-if-cached directive
   lookup_result_ = std::make_unique<LookupResult>(std::move(result));
   switch (lookup_result_->cache_entry_status_) {
@@ -395,6 +438,112 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
   decoder_callbacks_->continueDecoding();
 }
 
+bool CacheFilter::collapseRequest(LookupResult& result, Http::RequestHeaderMap& request_headers) {
+  // Only a request whose response can be inserted can fill the cache for the others.
+  if (!request_collapser_ || leader_id_.has_value() || !request_allows_inserts_ ||
+      is_head_request_) {
+    return false;
+  }
+  const CacheEntryStatus status = result.cache_entry_status_;
+  if (status != CacheEntryStatus::Unusable && status != CacheEntryStatus::RequiresValidation) {
+    return false;
+  }
+  leader_id_ = request_collapser_->lead(key_hash_);
+  if (leader_id_.has_value()) {
+    return false;
+  }
+  if (status == CacheEntryStatus::RequiresValidation && request_allows_stale_ &&
+      withinStaleWhileRevalidate(*result.headers_)) {
+    request_collapser_->stats().served_stale_.inc();
+    result.cache_entry_status_ = CacheEntryStatus::Ok;
+    return false;
+  }
+  if (collapsed_) {
+    return false;
+  }
+  // See getHeaders for why a weak_ptr is captured.
+  CacheFilterWeakPtr self = weak_from_this();
+  follower_id_ = request_collapser_->follow(
+      key_hash_, decoder_callbacks_->dispatcher(), [self, &request_headers](bool cache_filled) {
+        if (CacheFilterSharedPtr cache_filter = self.lock()) {
+          cache_filter->onCollapseDone(cache_filled, request_headers);
+        }
+      });
+  if (!follower_id_.has_value()) {
+    // The leader was done before this request could wait for it.
+    return false;
+  }
+  ENVOY_STREAM_LOG(debug, "CacheFilter waiting for another request for the same key",
+                   *decoder_callbacks_);
+  collapsed_ = true;
+  collapsed_lookup_result_ = std::make_unique<LookupResult>(std::move(result));
+  collapse_timer_ = decoder_callbacks_->dispatcher().createTimer([this, &request_headers]() {
+    request_collapser_->stats().timed_out_.inc();
+    onCollapseDone(false, request_headers);
+  });
+  collapse_timer_->enableTimer(request_collapser_->maxWait());
+  return true;
+}
+
+void CacheFilter::onCollapseDone(bool cache_filled, Http::RequestHeaderMap& request_headers) {
+  if (filter_state_ == FilterState::Destroyed || !follower_id_.has_value()) {
+    return;
+  }
+  stopWaitingForLeader();
+  if (cache_filled) {
+    ENVOY_STREAM_LOG(debug, "CacheFilter looking up the response of the request it waited for",
+                     *decoder_callbacks_);
+    collapsed_lookup_result_.reset();
+    lookup_->onDestroy();
+    lookup_ = cache_->makeLookupContext(
+        LookupRequest(request_headers, time_source_.systemTime(), vary_allow_list_),
+        *decoder_callbacks_);
+    getHeaders(request_headers);
+    return;
+  }
+  onHeaders(std::move(*collapsed_lookup_result_), request_headers);
+  collapsed_lookup_result_.reset();
+}
+
+void CacheFilter::stopWaitingForLeader() {
+  if (!follower_id_.has_value()) {
+    return;
+  }
+  request_collapser_->leave(key_hash_, follower_id_.value());
+  follower_id_.reset();
+  if (collapse_timer_) {
+    collapse_timer_->disableTimer();
+  }
+}
+
+void CacheFilter::leaderDone(bool cache_filled) {
+  if (!leader_id_.has_value()) {
+    return;
+  }
+  request_collapser_->done(key_hash_, leader_id_.value(), cache_filled);
+  leader_id_.reset();
+}
+
+InsertCallback CacheFilter::insertCallback(bool end_stream) {
+  if (!leader_id_.has_value()) {
+    return [](bool) {};
+  }
+  // The cache may call this on any thread, and after the filter is destroyed, so it doesn't use
+  // the filter. RequestCollapser::done does nothing if the leader is done already.
+  InsertCallback callback = [request_collapser = request_collapser_, key_hash = key_hash_,
+                             leader_id = leader_id_.value(), end_stream](bool success) {
+    if (!success || end_stream) {
+      request_collapser->done(key_hash, leader_id, success);
+    }
+  };
+  if (end_stream) {
+    // The insert may complete after the filter is destroyed; from here on only the callback tells
+    // the followers that it did.
+    leader_id_.reset();
+  }
+  return callback;
+}
+
 // TODO(toddmgreer): Handle downstream backpressure.
 void CacheFilter::onBody(Buffer::InstancePtr&& body) {
   // Can be called during decoding if a valid cache hit is found,
@@ -551,9 +700,19 @@ void CacheFilter::processSuccessfulValidation(Http::ResponseHeaderMap& response_
     // TODO(yosrym93): else the cached entry should be deleted.
     // Update metadata associated with the cached response. Right now this is only response_time;
     const ResponseMetadata metadata = {time_source_.systemTime()};
-    cache_->updateHeaders(*lookup_, response_headers, metadata,
-                          [](bool updated ABSL_ATTRIBUTE_UNUSED) {});
+    std::function<void(bool)> on_complete = [](bool updated ABSL_ATTRIBUTE_UNUSED) {};
+    if (leader_id_.has_value()) {
+      // As for insertCallback, the cache may call this on any thread.
+      on_complete = [request_collapser = request_collapser_, key_hash = key_hash_,
+                     leader_id = leader_id_.value()](bool updated) {
+        request_collapser->done(key_hash, leader_id, updated);
+      };
+      leader_id_.reset();
+    }
+    cache_->updateHeaders(*lookup_, response_headers, metadata, std::move(on_complete));
     insert_status_ = InsertStatus::HeaderUpdate;
+  } else {
+    leaderDone(false);
   }
 
   // A cache entry was successfully validated -> encode cached body and trailers.
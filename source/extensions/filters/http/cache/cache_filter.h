@@ -5,12 +5,14 @@
 #include <string>
 #include <vector>
 
+#include "envoy/event/timer.h"
 #include "envoy/extensions/filters/http/cache/v3/cache.pb.h"
 
 #include "source/common/common/logger.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/filters/http/cache/request_collapser.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
 
 namespace Envoy {
@@ -54,7 +56,7 @@ class CacheFilter : public Http::PassThroughFilter,
 public:
   CacheFilter(const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
               const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source,
-              OptRef<HttpCache> http_cache);
+              OptRef<HttpCache> http_cache, RequestCollapserSharedPtr request_collapser);
   // Http::StreamFilterBase
   void onDestroy() override;
   void onStreamComplete() override;
@@ -81,6 +83,28 @@ private:
   void onBody(Buffer::InstancePtr&& body);
   void onTrailers(Http::ResponseTrailerMapPtr&& trailers);
 
+  // Called by onHeaders before it handles a cache miss or a cache entry that requires validation.
+  // Makes this request the leader for its key if no other request is, or makes it wait for the
+  // leader. If the entry may be served stale while the leader validates it, sets the status of
+  // result to Ok instead. Returns true if the request is waiting.
+  bool collapseRequest(LookupResult& result, Http::RequestHeaderMap& request_headers);
+
+  // Called when the leader this request waits for is done, or when waiting for it timed out.
+  // Looks up the cache again if the leader filled it, otherwise handles the original lookup
+  // result without waiting.
+  void onCollapseDone(bool cache_filled, Http::RequestHeaderMap& request_headers);
+
+  // Stops waiting for the leader, if this request is waiting.
+  void stopWaitingForLeader();
+
+  // Tells the followers of this request that it is done, if it is a leader.
+  void leaderDone(bool cache_filled);
+
+  // Returns the callback to pass to an insert operation, which tells the followers of this request
+  // that it is done when the operation fails or completes the insert. If end_stream, the callback
+  // takes over telling them from the filter.
+  InsertCallback insertCallback(bool end_stream);
+
   // Set required state in the CacheFilter for handling a cache hit.
   void handleCacheHit();
 
@@ -151,6 +175,24 @@ private:
   // https://httpwg.org/specs/rfc7234.html#response.cacheability
   bool request_allows_inserts_ = false;
 
+  // True if the request doesn't restrict the age of the response it accepts, so that it may be
+  // served a stale response allowed by stale-while-revalidate.
+  bool request_allows_stale_ = false;
+
+  // Shared by the filters of all workers if request collapsing is configured, otherwise null.
+  RequestCollapserSharedPtr request_collapser_;
+  // The stable hash of this request's cache key.
+  uint64_t key_hash_ = 0;
+  // Set while this request is the leader for its key.
+  absl::optional<uint64_t> leader_id_;
+  // Set while this request is waiting for the leader for its key.
+  absl::optional<uint64_t> follower_id_;
+  Event::TimerPtr collapse_timer_;
+  // The lookup result this request found before it started waiting for the leader.
+  LookupResultPtr collapsed_lookup_result_;
+  // True once this request has waited for a leader; it doesn't wait again.
+  bool collapsed_ = false;
+
   FilterState filter_state_ = FilterState::Initial;
 
   bool is_head_request_ = false;
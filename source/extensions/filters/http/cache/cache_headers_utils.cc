@@ -108,6 +108,8 @@ ResponseCacheControl::ResponseCacheControl(absl::string_view cache_control_heade
       max_age_ = parseDuration(argument);
     } else if (!max_age_.has_value() && directive == "max-age") {
       max_age_ = parseDuration(argument);
+    } else if (directive == "stale-while-revalidate") {
+      stale_while_revalidate_ = parseDuration(argument);
     }
   }
 }
@@ -122,7 +124,8 @@ bool operator==(const RequestCacheControl& lhs, const RequestCacheControl& rhs)
 bool operator==(const ResponseCacheControl& lhs, const ResponseCacheControl& rhs) {
   return (lhs.must_validate_ == rhs.must_validate_) && (lhs.no_store_ == rhs.no_store_) &&
          (lhs.no_transform_ == rhs.no_transform_) && (lhs.no_stale_ == rhs.no_stale_) &&
-         (lhs.is_public_ == rhs.is_public_) && (lhs.max_age_ == rhs.max_age_);
+         (lhs.is_public_ == rhs.is_public_) && (lhs.max_age_ == rhs.max_age_) &&
+         (lhs.stale_while_revalidate_ == rhs.stale_while_revalidate_);
 }
 
 SystemTime CacheHeadersUtils::httpTime(const Http::HeaderEntry* header_entry) {
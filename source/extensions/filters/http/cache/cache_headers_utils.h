@@ -89,6 +89,11 @@ struct ResponseCacheControl {
   // max_age is set if to 's-maxage' if present, if not it is set to 'max-age' if present.
   // Indicates the maximum time after which this response will be considered stale
   OptionalDuration max_age_;
+
+  // stale_while_revalidate is set if 'stale-while-revalidate' is present, see:
+  // https://httpwg.org/specs/rfc5861.html#n-the-stale-while-revalidate-cache-control-extension
+  // Once stale, this response may be served for this long while it is being validated
+  OptionalDuration stale_while_revalidate_;
 };
 
 bool operator==(const RequestCacheControl& lhs, const RequestCacheControl& rhs);
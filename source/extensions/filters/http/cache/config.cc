@@ -1,6 +1,8 @@
 #include "source/extensions/filters/http/cache/config.h"
 
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/cache/cache_filter.h"
+#include "source/extensions/filters/http/cache/request_collapser.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -11,6 +13,7 @@ Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::cache::v3::CacheConfig& config,
     const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
   std::shared_ptr<HttpCache> cache;
+  RequestCollapserSharedPtr request_collapser;
   if (!config.disabled().value()) {
     if (!config.has_typed_config()) {
       throw EnvoyException("at least one of typed_config or disabled must be set");
@@ -24,13 +27,19 @@ Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
     }
 
     cache = http_cache_factory->getCache(config, context);
+    if (config.has_request_collapsing()) {
+      request_collapser = std::make_shared<RequestCollapser>(
+          std::chrono::milliseconds(
+              PROTOBUF_GET_MS_OR_DEFAULT(config.request_collapsing(), max_wait, 5000)),
+          context.scope(), stats_prefix);
+    }
   }
 
-  return [config, stats_prefix, &context,
-          cache](Http::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addStreamFilter(std::make_shared<CacheFilter>(config, stats_prefix, context.scope(),
-                                                            context.timeSource(),
-                                                            cache ? *cache : OptRef<HttpCache>{}));
+  return [config, stats_prefix, &context, cache,
+          request_collapser](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<CacheFilter>(
+        config, stats_prefix, context.scope(), context.timeSource(),
+        cache ? *cache : OptRef<HttpCache>{}, request_collapser));
   };
 }
 
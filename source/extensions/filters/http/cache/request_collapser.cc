@@ -0,0 +1,82 @@
+#include "source/extensions/filters/http/cache/request_collapser.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+RequestCollapser::RequestCollapser(std::chrono::milliseconds max_wait, Stats::Scope& scope,
+                                   const std::string& stats_prefix)
+    : max_wait_(max_wait),
+      stats_{ALL_REQUEST_COLLAPSING_STATS(
+          POOL_COUNTER_PREFIX(scope, absl::StrCat(stats_prefix, "cache.request_collapsing.")),
+          POOL_GAUGE_PREFIX(scope, absl::StrCat(stats_prefix, "cache.request_collapsing.")))} {}
+
+absl::optional<uint64_t> RequestCollapser::lead(uint64_t key_hash) {
+  absl::MutexLock lock(&mu_);
+  auto [it, inserted] = in_flight_.try_emplace(key_hash);
+  if (!inserted) {
+    return absl::nullopt;
+  }
+  it->second.leader_id_ = next_id_++;
+  return it->second.leader_id_;
+}
+
+absl::optional<uint64_t> RequestCollapser::follow(uint64_t key_hash, Event::Dispatcher& dispatcher,
+                                                  WakeCallback on_done) {
+  absl::MutexLock lock(&mu_);
+  auto it = in_flight_.find(key_hash);
+  if (it == in_flight_.end()) {
+    return absl::nullopt;
+  }
+  const uint64_t id = next_id_++;
+  it->second.followers_.push_back(Follower{id, &dispatcher, std::move(on_done)});
+  stats_.collapsed_.inc();
+  stats_.waiting_.inc();
+  return id;
+}
+
+void RequestCollapser::leave(uint64_t key_hash, uint64_t follower_id) {
+  absl::MutexLock lock(&mu_);
+  auto it = in_flight_.find(key_hash);
+  if (it == in_flight_.end()) {
+    return;
+  }
+  std::vector<Follower>& followers = it->second.followers_;
+  for (auto follower = followers.begin(); follower != followers.end(); ++follower) {
+    if (follower->id_ == follower_id) {
+      followers.erase(follower);
+      stats_.waiting_.dec();
+      return;
+    }
+  }
+}
+
+void RequestCollapser::done(uint64_t key_hash, uint64_t leader_id, bool cache_filled) {
+  std::vector<Follower> followers;
+  {
+    absl::MutexLock lock(&mu_);
+    auto it = in_flight_.find(key_hash);
+    if (it == in_flight_.end() || it->second.leader_id_ != leader_id) {
+      return;
+    }
+    followers = std::move(it->second.followers_);
+    in_flight_.erase(it);
+    stats_.waiting_.sub(followers.size());
+  }
+  if (!cache_filled) {
+    stats_.released_.add(followers.size());
+  }
+  // Followers are woken outside the lock, so that they can lead or follow again straight away.
+  for (Follower& follower : followers) {
+    follower.dispatcher_->post(
+        [on_done = std::move(follower.on_done_), cache_filled]() { on_done(cache_filled); });
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * All request collapsing stats. @see stats_macros.h
+ */
+#define ALL_REQUEST_COLLAPSING_STATS(COUNTER, GAUGE)                                               \
+  COUNTER(collapsed)                                                                               \
+  COUNTER(collapsed_hit)                                                                           \
+  COUNTER(released)                                                                                \
+  COUNTER(timed_out)                                                                               \
+  COUNTER(served_stale)                                                                            \
+  GAUGE(waiting, Accumulate)
+
+/**
+ * Struct definition for all request collapsing stats. @see stats_macros.h
+ */
+struct RequestCollapsingStats {
+  ALL_REQUEST_COLLAPSING_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Tracks the requests that are being sent upstream to fill the cache, so that concurrent requests
+ * for the same cache key can wait for them instead of also being sent upstream. One instance is
+ * shared by the cache filters of all worker threads.
+ *
+ * The first request for a key to miss the cache becomes the leader for that key. Requests for the
+ * key that miss the cache while the leader is in flight follow it: they are woken on their own
+ * dispatcher when the leader is done, and told whether the leader filled the cache.
+ *
+ * Keys are compared by hash. A collision only makes a request wait for a leader that doesn't
+ * fill its entry, after which it is sent upstream as it would have been without collapsing.
+ *
+ * All functions are thread-safe.
+ */
+class RequestCollapser {
+public:
+  // Called on the follower's dispatcher with true if the leader filled the cache.
+  using WakeCallback = std::function<void(bool cache_filled)>;
+
+  RequestCollapser(std::chrono::milliseconds max_wait, Stats::Scope& scope,
+                   const std::string& stats_prefix);
+
+  /**
+   * Makes the caller the leader for a key, if no other request is.
+   * @param key_hash the stable hash of the cache key.
+   * @return an id to pass to done(), or nullopt if another request is the leader.
+   */
+  absl::optional<uint64_t> lead(uint64_t key_hash) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Makes the caller wait for the leader for a key.
+   * @param key_hash the stable hash of the cache key.
+   * @param dispatcher the dispatcher to call on_done on.
+   * @param on_done called when the leader is done. Not called if the follower leaves first.
+   * @return an id to pass to leave(), or nullopt if there is no leader for the key.
+   */
+  absl::optional<uint64_t> follow(uint64_t key_hash, Event::Dispatcher& dispatcher,
+                                  WakeCallback on_done) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Stops a follower from waiting. Does nothing if it has already been woken.
+   * @param key_hash the stable hash of the cache key.
+   * @param follower_id the id returned by follow().
+   */
+  void leave(uint64_t key_hash, uint64_t follower_id) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Wakes the followers of a leader, and lets the next request for the key lead. Does nothing if
+   * that leader is already done, so it is safe to call more than once.
+   * @param key_hash the stable hash of the cache key.
+   * @param leader_id the id returned by lead().
+   * @param cache_filled true if the leader's response is now in the cache.
+   */
+  void done(uint64_t key_hash, uint64_t leader_id, bool cache_filled) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * @return how long a follower waits before it gives up on the leader.
+   */
+  std::chrono::milliseconds maxWait() const { return max_wait_; }
+
+  RequestCollapsingStats& stats() { return stats_; }
+
+private:
+  struct Follower {
+    uint64_t id_;
+    Event::Dispatcher* dispatcher_;
+    WakeCallback on_done_;
+  };
+  struct InFlight {
+    uint64_t leader_id_;
+    std::vector<Follower> followers_;
+  };
+
+  const std::chrono::milliseconds max_wait_;
+  RequestCollapsingStats stats_;
+  absl::Mutex mu_;
+  uint64_t next_id_ ABSL_GUARDED_BY(mu_) = 1;
+  absl::flat_hash_map<uint64_t, InFlight> in_flight_ ABSL_GUARDED_BY(mu_);
+};
+
+using RequestCollapserSharedPtr = std::shared_ptr<RequestCollapser>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
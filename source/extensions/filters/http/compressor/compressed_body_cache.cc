@@ -0,0 +1,51 @@
+#include "source/extensions/filters/http/compressor/compressed_body_cache.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/crypto/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+std::string CompressedBodyCache::key(const Buffer::Instance& body) {
+  // A cryptographic digest is used so that an upstream can't craft colliding bodies and have a
+  // different compressed body served for its response.
+  const std::vector<uint8_t> digest =
+      Envoy::Common::Crypto::UtilitySingleton::get().getSha256Digest(body);
+  return {digest.begin(), digest.end()};
+}
+
+const std::string* CompressedBodyCache::lookup(const std::string& key) {
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return &it->second->compressed_body_;
+}
+
+void CompressedBodyCache::insert(const std::string& key, std::string compressed_body) {
+  if (compressed_body.size() > max_bytes_ || index_.contains(key)) {
+    return;
+  }
+  bytes_ += compressed_body.size();
+  entries_.push_front({key, std::move(compressed_body)});
+  index_.emplace(key, entries_.begin());
+  while (bytes_ > max_bytes_) {
+    evict();
+  }
+}
+
+void CompressedBodyCache::evict() {
+  ASSERT(!entries_.empty());
+  const Entry& entry = entries_.back();
+  bytes_ -= entry.compressed_body_.size();
+  index_.erase(entry.key_);
+  entries_.pop_back();
+}
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <list>
+#include <string>
+
+#include "envoy/buffer/buffer.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+
+/**
+ * Bounded LRU cache of compressed response bodies keyed by a digest of the uncompressed body.
+ * Each compressor filter config owns one cache per worker thread, so the content encoding is
+ * implied by the cache instance. Not thread-safe.
+ */
+class CompressedBodyCache {
+public:
+  /**
+   * @param max_bytes the maximum total size of the compressed bodies held by the cache.
+   */
+  explicit CompressedBodyCache(uint64_t max_bytes) : max_bytes_(max_bytes) {}
+
+  /**
+   * @return std::string the cache key for an uncompressed body, i.e. its SHA-256 digest.
+   */
+  static std::string key(const Buffer::Instance& body);
+
+  /**
+   * Looks up a compressed body and marks it as the most recently used entry.
+   * @return const std::string* the compressed body, or nullptr if it isn't cached.
+   */
+  const std::string* lookup(const std::string& key);
+
+  /**
+   * Inserts a compressed body, evicting the least recently used entries as needed to stay within
+   * the size limit. Bodies larger than the limit are not cached.
+   */
+  void insert(const std::string& key, std::string compressed_body);
+
+  size_t size() const { return index_.size(); }
+  uint64_t bytes() const { return bytes_; }
+
+private:
+  struct Entry {
+    std::string key_;
+    std::string compressed_body_;
+  };
+  using EntryList = std::list<Entry>;
+
+  void evict();
+
+  const uint64_t max_bytes_;
+  uint64_t bytes_{0};
+  // Most recently used entries are at the front.
+  EntryList entries_;
+  absl::flat_hash_map<std::string, EntryList::iterator> index_;
+};
+
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -30,6 +30,12 @@ Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::Respons
 // Default minimum length of an upstream response that allows compression.
 const uint64_t DefaultMinimumContentLength = 30;
 
+// Default maximum length of an uncompressed response body looked up in the compressed body cache.
+const uint32_t DefaultCompressedBodyCacheMaxBodyBytes = 256 * 1024;
+
+// Default maximum total size of the compressed bodies cached by each worker.
+const uint64_t DefaultCompressedBodyCacheMaxCacheBytes = 16 * 1024 * 1024;
+
 // Default content types will be used if any is provided by the user.
 const std::vector<std::string>& defaultContentEncoding() {
   CONSTRUCT_ON_FIRST_USE(std::vector<std::string>, {"text/html",
@@ -86,6 +92,7 @@ CompressorFilterConfig::DirectionConfig::DirectionConfig(
 CompressorFilterConfig::CompressorFilterConfig(
     const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
     const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+    ThreadLocal::SlotAllocator& tls,
     Compression::Compressor::CompressorFactoryPtr compressor_factory)
     : common_stats_prefix_(fmt::format("{}compressor.{}.{}", stats_prefix,
                                        proto_config.compressor_library().name(),
@@ -94,7 +101,16 @@ CompressorFilterConfig::CompressorFilterConfig(
       response_direction_config_(proto_config, common_stats_prefix_, scope, runtime),
       content_encoding_(compressor_factory->contentEncoding()),
       compressor_factory_(std::move(compressor_factory)),
-      choose_first_(proto_config.choose_first()) {}
+      choose_first_(proto_config.choose_first()) {
+  if (response_direction_config_.compressedBodyCacheEnabled()) {
+    compressed_body_cache_slot_ =
+        ThreadLocal::TypedSlot<ThreadLocalCompressedBodyCache>::makeUnique(tls);
+    const uint64_t max_cache_bytes = response_direction_config_.compressedBodyCacheMaxCacheBytes();
+    compressed_body_cache_slot_->set([max_cache_bytes](Event::Dispatcher&) {
+      return std::make_shared<ThreadLocalCompressedBodyCache>(max_cache_bytes);
+    });
+  }
+}
 
 StringUtil::CaseUnorderedSet CompressorFilterConfig::DirectionConfig::contentTypeSet(
     const Protobuf::RepeatedPtrField<std::string>& types) {
@@ -130,6 +146,14 @@ CompressorFilterConfig::ResponseDirectionConfig::ResponseDirectionConfig(
           proto_config.has_response_direction_config()
               ? proto_config.response_direction_config().remove_accept_encoding_header()
               : proto_config.remove_accept_encoding_header()),
+      compressed_body_cache_enabled_(
+          proto_config.response_direction_config().has_compressed_body_cache()),
+      compressed_body_cache_max_body_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          proto_config.response_direction_config().compressed_body_cache(), max_body_bytes,
+          DefaultCompressedBodyCacheMaxBodyBytes)),
+      compressed_body_cache_max_cache_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          proto_config.response_direction_config().compressed_body_cache(), max_cache_bytes,
+          DefaultCompressedBodyCacheMaxCacheBytes)),
       response_stats_{generateResponseStats(stats_prefix, scope)} {}
 
 const envoy::extensions::filters::http::compressor::v3::Compressor::CommonDirectionConfig
@@ -163,6 +187,13 @@ Envoy::Compression::Compressor::CompressorPtr CompressorFilterConfig::makeCompre
   return compressor_factory_->createCompressor();
 }
 
+CompressedBodyCache* CompressorFilterConfig::compressedBodyCache() {
+  if (compressed_body_cache_slot_ == nullptr) {
+    return nullptr;
+  }
+  return &(*compressed_body_cache_slot_)->cache_;
+}
+
 CompressorFilter::CompressorFilter(const CompressorFilterConfigSharedPtr config)
     : config_(std::move(config)) {}
 
@@ -277,12 +308,17 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
       isEtagAllowed(headers) && !headers.getInline(response_content_encoding_handle.handle());
   if (!end_stream && isAcceptEncodingAllowed(isEnabledAndContentLengthBigEnough, headers) &&
       isCompressible && isTransferEncodingAllowed(headers)) {
+    // This must be checked before the Content-Length header is removed.
+    buffering_for_body_cache_ = isCompressedBodyCacheable(headers);
     sanitizeEtagHeader(headers);
     headers.removeContentLength();
     headers.setInline(response_content_encoding_handle.handle(), config_->contentEncoding());
     config.stats().compressed_.inc();
-    // Finally instantiate the compressor.
-    response_compressor_ = config_->makeCompressor();
+    // Finally instantiate the compressor, unless the body is going to be looked up in the
+    // compressed body cache once it's buffered.
+    if (!buffering_for_body_cache_) {
+      response_compressor_ = config_->makeCompressor();
+    }
   } else {
     config.stats().not_compressed_.inc();
   }
@@ -298,6 +334,20 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
 }
 
 Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool end_stream) {
+  if (buffering_for_body_cache_) {
+    if (end_stream) {
+      encoder_callbacks_->addEncodedData(data, false);
+      compressBufferedResponse(true);
+      return Http::FilterDataStatus::Continue;
+    }
+    if (bufferedResponseLength() + data.length() <=
+        config_->responseDirectionConfig().compressedBodyCacheMaxBodyBytes()) {
+      return Http::FilterDataStatus::StopIterationAndBuffer;
+    }
+    // The body turned out to be larger than announced by Content-Length. Compress what has been
+    // buffered so far and stream the rest of the response.
+    compressBufferedResponse(false);
+  }
   if (response_compressor_ != nullptr) {
     compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(), data,
                            end_stream);
@@ -306,6 +356,10 @@ Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool
 }
 
 Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::ResponseTrailerMap&) {
+  if (buffering_for_body_cache_) {
+    compressBufferedResponse(true);
+    return Http::FilterTrailersStatus::Continue;
+  }
   if (response_compressor_ != nullptr) {
     Buffer::OwnedImpl empty_buffer;
     // The presence of trailers means the stream is ended, but encodeData()
@@ -318,6 +372,63 @@ Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::ResponseTraile
   return Http::FilterTrailersStatus::Continue;
 }
 
+bool CompressorFilter::isCompressedBodyCacheable(const Http::ResponseHeaderMap& headers) const {
+  const auto& config = config_->responseDirectionConfig();
+  if (!config.compressedBodyCacheEnabled() || headers.ContentLength() == nullptr) {
+    return false;
+  }
+  uint64_t content_length;
+  return absl::SimpleAtoi(headers.getContentLengthValue(), &content_length) &&
+         content_length <= config.compressedBodyCacheMaxBodyBytes();
+}
+
+uint64_t CompressorFilter::bufferedResponseLength() {
+  const Buffer::Instance* buffered = encoder_callbacks_->encodingBuffer();
+  return buffered != nullptr ? buffered->length() : 0;
+}
+
+void CompressorFilter::compressBufferedResponse(bool end_stream) {
+  buffering_for_body_cache_ = false;
+  if (end_stream) {
+    if (encoder_callbacks_->encodingBuffer() == nullptr) {
+      Buffer::OwnedImpl empty_buffer;
+      compressWithBodyCache(empty_buffer);
+      encoder_callbacks_->addEncodedData(empty_buffer, false);
+      return;
+    }
+    encoder_callbacks_->modifyEncodingBuffer(
+        [this](Buffer::Instance& body) { compressWithBodyCache(body); });
+    return;
+  }
+
+  response_compressor_ = config_->makeCompressor();
+  if (encoder_callbacks_->encodingBuffer() != nullptr) {
+    encoder_callbacks_->modifyEncodingBuffer([this](Buffer::Instance& body) {
+      compressAndUpdateStats(response_compressor_, config_->responseDirectionConfig().stats(),
+                             body, false);
+    });
+  }
+}
+
+void CompressorFilter::compressWithBodyCache(Buffer::Instance& body) {
+  const auto& config = config_->responseDirectionConfig();
+  CompressedBodyCache* cache = config_->compressedBodyCache();
+  ASSERT(cache != nullptr);
+
+  config.stats().total_uncompressed_bytes_.add(body.length());
+  const std::string key = CompressedBodyCache::key(body);
+  if (const std::string* compressed_body = cache->lookup(key); compressed_body != nullptr) {
+    config.responseStats().compressed_body_cache_hit_.inc();
+    body.drain(body.length());
+    body.add(*compressed_body);
+  } else {
+    config.responseStats().compressed_body_cache_miss_.inc();
+    config_->makeCompressor()->compress(body, Envoy::Compression::Compressor::State::Finish);
+    cache->insert(key, body.toString());
+  }
+  config.stats().total_compressed_bytes_.add(body.length());
+}
+
 bool CompressorFilter::hasCacheControlNoTransform(Http::ResponseHeaderMap& headers) const {
   const Http::HeaderEntry* cache_control = headers.getInline(cache_control_handle.handle());
   if (cache_control) {
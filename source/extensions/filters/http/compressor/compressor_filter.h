@@ -3,10 +3,12 @@
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/extensions/filters/http/compressor/v3/compressor.pb.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/runtime/runtime_protos.h"
 #include "source/extensions/filters/http/common/pass_through_filter.h"
+#include "source/extensions/filters/http/compressor/compressed_body_cache.h"
 
 #include "absl/types/optional.h"
 
@@ -39,6 +41,9 @@ namespace Compressor {
  *
  * "header_gzip" is specific to the gzip filter and is deprecated since it duplicates
  * "header_compressor_used".
+ *
+ * "compressed_body_cache_hit" and "compressed_body_cache_miss" count the responses served from and
+ * inserted into the compressed body cache, if it is configured.
  */
 #define RESPONSE_COMPRESSOR_STATS(COUNTER)                                                         \
   COUNTER(no_accept_header)                                                                        \
@@ -47,7 +52,9 @@ namespace Compressor {
   COUNTER(header_compressor_overshadowed)                                                          \
   COUNTER(header_wildcard)                                                                         \
   COUNTER(header_not_valid)                                                                        \
-  COUNTER(not_compressed_etag)
+  COUNTER(not_compressed_etag)                                                                     \
+  COUNTER(compressed_body_cache_hit)                                                               \
+  COUNTER(compressed_body_cache_miss)
 
 /**
  * Struct definitions for compressor stats. @see stats_macros.h
@@ -121,6 +128,9 @@ public:
     const ResponseCompressorStats& responseStats() const { return response_stats_; }
     bool disableOnEtagHeader() const { return disable_on_etag_header_; }
     bool removeAcceptEncodingHeader() const { return remove_accept_encoding_header_; }
+    bool compressedBodyCacheEnabled() const { return compressed_body_cache_enabled_; }
+    uint32_t compressedBodyCacheMaxBodyBytes() const { return compressed_body_cache_max_body_; }
+    uint64_t compressedBodyCacheMaxCacheBytes() const { return compressed_body_cache_max_cache_; }
 
   private:
     static ResponseCompressorStats generateResponseStats(const std::string& prefix,
@@ -135,6 +145,9 @@ public:
 
     const bool disable_on_etag_header_;
     const bool remove_accept_encoding_header_;
+    const bool compressed_body_cache_enabled_;
+    const uint32_t compressed_body_cache_max_body_;
+    const uint64_t compressed_body_cache_max_cache_;
     const ResponseCompressorStats response_stats_;
   };
 
@@ -142,16 +155,28 @@ public:
   CompressorFilterConfig(
       const envoy::extensions::filters::http::compressor::v3::Compressor& proto_config,
       const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime,
+      ThreadLocal::SlotAllocator& tls,
       Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory);
 
   Envoy::Compression::Compressor::CompressorPtr makeCompressor();
 
+  /**
+   * @return CompressedBodyCache* the calling worker's compressed body cache, or nullptr if the
+   * cache isn't configured.
+   */
+  CompressedBodyCache* compressedBodyCache();
+
   const std::string contentEncoding() const { return content_encoding_; };
   bool chooseFirst() const { return choose_first_; };
   const RequestDirectionConfig& requestDirectionConfig() { return request_direction_config_; }
   const ResponseDirectionConfig& responseDirectionConfig() { return response_direction_config_; }
 
 private:
+  struct ThreadLocalCompressedBodyCache : public ThreadLocal::ThreadLocalObject {
+    explicit ThreadLocalCompressedBodyCache(uint64_t max_bytes) : cache_(max_bytes) {}
+    CompressedBodyCache cache_;
+  };
+
   const std::string common_stats_prefix_;
   const RequestDirectionConfig request_direction_config_;
   const ResponseDirectionConfig response_direction_config_;
@@ -159,6 +184,7 @@ private:
   const std::string content_encoding_;
   const Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory_;
   const bool choose_first_;
+  ThreadLocal::TypedSlotPtr<ThreadLocalCompressedBodyCache> compressed_body_cache_slot_;
 };
 using CompressorFilterConfigSharedPtr = std::shared_ptr<CompressorFilterConfig>;
 
@@ -204,6 +230,10 @@ private:
 
   void sanitizeEtagHeader(Http::ResponseHeaderMap& headers);
   void insertVaryHeader(Http::ResponseHeaderMap& headers);
+  bool isCompressedBodyCacheable(const Http::ResponseHeaderMap& headers) const;
+  uint64_t bufferedResponseLength();
+  void compressBufferedResponse(bool end_stream);
+  void compressWithBodyCache(Buffer::Instance& body);
 
   class EncodingDecision : public StreamInfo::FilterState::Object {
   public:
@@ -230,6 +260,8 @@ private:
   Envoy::Compression::Compressor::CompressorPtr request_compressor_;
   const CompressorFilterConfigSharedPtr config_;
   std::unique_ptr<std::string> accept_encoding_;
+  // Set while the response body is buffered to be looked up in the compressed body cache.
+  bool buffering_for_body_cache_{false};
 };
 
 } // namespace Compressor
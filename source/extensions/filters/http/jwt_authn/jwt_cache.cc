@@ -2,6 +2,7 @@
 
 #include "source/common/common/assert.h"
 
+#include "openssl/sha.h"
 #include "simple_lru_cache/simple_lru_cache_inl.h"
 
 using ::google::simple_lru_cache::SimpleLRUCache;
@@ -17,6 +18,16 @@ constexpr int kJwtCacheDefaultSize = 100;
 // The maximum size of JWT to be cached.
 constexpr int kMaxJwtSizeForCache = 4 * 1024; // 4KiB
 
+// Tokens are cached by their SHA-256 digest rather than by their value, which keeps the keys small.
+// The digest must be collision resistant: a token colliding with a cached one would be accepted
+// without its signature being verified.
+std::string cacheKey(const std::string& token) {
+  std::string key(SHA256_DIGEST_LENGTH, '\0');
+  SHA256(reinterpret_cast<const uint8_t*>(token.data()), token.size(),
+         reinterpret_cast<uint8_t*>(key.data()));
+  return key;
+}
+
 class JwtCacheImpl : public JwtCache {
 public:
   JwtCacheImpl(bool enable_cache, const JwtCacheConfig& config, TimeSource& time_source)
@@ -40,8 +51,9 @@ public:
     if (!jwt_lru_cache_) {
       return nullptr;
     }
+    const std::string key = cacheKey(token);
     SimpleLRUCache<std::string, ::google::jwt_verify::Jwt>::ScopedLookup lookup(
-        jwt_lru_cache_.get(), token);
+        jwt_lru_cache_.get(), key);
     if (lookup.found()) {
       ::google::jwt_verify::Jwt* const found_jwt = lookup.value();
       ASSERT(found_jwt != nullptr);
@@ -49,7 +61,7 @@ public:
           ::google::jwt_verify::Status::JwtExpired) {
         return found_jwt;
       } else {
-        jwt_lru_cache_->remove(token);
+        jwt_lru_cache_->remove(key);
       }
     }
     return nullptr;
@@ -58,7 +70,7 @@ public:
   void insert(const std::string& token, std::unique_ptr<::google::jwt_verify::Jwt>&& jwt) override {
     if (jwt_lru_cache_ && token.size() <= kMaxJwtSizeForCache) {
       // pass the ownership of jwt to cache
-      jwt_lru_cache_->insert(token, jwt.release(), 1);
+      jwt_lru_cache_->insert(cacheKey(token), jwt.release(), 1);
     }
   }
 
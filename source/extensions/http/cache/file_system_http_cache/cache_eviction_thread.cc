@@ -18,6 +18,14 @@ namespace {
 bool isCacheFile(const Filesystem::DirectoryEntry& entry) {
   return entry.type_ == Filesystem::FileType::Regular && absl::StartsWith(entry.name_, "cache-");
 }
+
+Envoy::SystemTime lastTouch(const struct stat& s) {
+#ifdef _DARWIN_FEATURE_64_BIT_INODE
+  return std::max(timespecToChrono(s.st_atimespec), timespecToChrono(s.st_ctimespec));
+#else
+  return std::max(timespecToChrono(s.st_atim), timespecToChrono(s.st_ctim));
+#endif
+}
 } // namespace
 
 CacheEvictionThread::CacheEvictionThread(Thread::ThreadFactory& thread_factory)
@@ -75,6 +83,8 @@ void CacheShared::initStats() {
   if (config_.has_max_cache_entry_count()) {
     stats_.size_limit_count_.set(config_.max_cache_entry_count().value());
   }
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  std::vector<CacheIndex::File> files;
   // TODO(ravenblack): Add support for directory tree structure.
   for (const Filesystem::DirectoryEntry& entry : Filesystem::Directory(std::string{cachePath()})) {
     if (!isCacheFile(entry)) {
@@ -82,6 +92,14 @@ void CacheShared::initStats() {
     }
     size_count_++;
     size_bytes_ += entry.size_bytes_.value_or(0);
+    struct stat s;
+    if (index_ != nullptr &&
+        os_sys_calls.stat(absl::StrCat(cachePath(), entry.name_).c_str(), &s).return_value_ != -1) {
+      files.push_back(CacheIndex::File{entry.name_, entry.size_bytes_.value_or(0), lastTouch(s)});
+    }
+  }
+  if (index_ != nullptr) {
+    index_->build(std::move(files));
   }
   stats_.size_count_.set(size_count_);
   stats_.size_bytes_.set(size_bytes_);
@@ -90,6 +108,10 @@ void CacheShared::initStats() {
 
 void CacheShared::evict() {
   stats_.eviction_runs_.add(1);
+  if (index_ != nullptr) {
+    evictFromIndex();
+    return;
+  }
   auto os_sys_calls = Api::OsSysCallsSingleton::get();
   uint64_t size = 0;
   uint64_t count = 0;
@@ -109,15 +131,7 @@ void CacheShared::evict() {
     size += entry.size_bytes_.value_or(0);
     struct stat s;
     if (os_sys_calls.stat(absl::StrCat(cachePath(), entry.name_).c_str(), &s).return_value_ != -1) {
-#ifdef _DARWIN_FEATURE_64_BIT_INODE
-      Envoy::SystemTime last_touch =
-          std::max(timespecToChrono(s.st_atimespec), timespecToChrono(s.st_ctimespec));
-#else
-      Envoy::SystemTime last_touch =
-          std::max(timespecToChrono(s.st_atim), timespecToChrono(s.st_ctim));
-#endif
-
-      cache_files.push_back(CacheFile{entry.name_, entry.size_bytes_.value_or(0), last_touch});
+      cache_files.push_back(CacheFile{entry.name_, entry.size_bytes_.value_or(0), lastTouch(s)});
     }
   }
   // Sort the vector by last-touch timestamp, highest (i.e. youngest) first.
@@ -159,6 +173,29 @@ void CacheShared::evict() {
   }
 }
 
+void CacheShared::evictFromIndex() {
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  // Unlike evict, this doesn't measure the cache path, so the sizes are only those tracked
+  // since the index was built.
+  const uint64_t size = size_bytes_;
+  const uint64_t count = size_count_;
+  uint64_t excess_size = 0;
+  uint64_t excess_count = 0;
+  if (config_.has_max_cache_size_bytes() && size > config_.max_cache_size_bytes().value()) {
+    excess_size = size - config_.max_cache_size_bytes().value();
+  }
+  if (config_.has_max_cache_entry_count() && count > config_.max_cache_entry_count().value()) {
+    excess_count = count - config_.max_cache_entry_count().value();
+  }
+  for (const auto& [name, file_size] : index_->removeLeastRecentlyUsed(excess_size, excess_count)) {
+    // As in evict, a failure to unlink doesn't reduce the estimated cache size. The entry is
+    // removed from the index either way, so that it isn't the next candidate again.
+    if (os_sys_calls.unlink(absl::StrCat(cachePath(), name).c_str()).return_value_ != -1) {
+      trackFileRemoved(file_size);
+    }
+  }
+}
+
 void CacheEvictionThread::work() {
   ENVOY_LOG(info, "Starting cache eviction thread.");
   while (waitForSignal()) {
@@ -0,0 +1,174 @@
+#include "source/extensions/http/cache/file_system_http_cache/cache_index.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "source/common/common/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+CacheFileIdentity CacheFileIdentity::fromStat(const struct stat& s) {
+#ifdef _DARWIN_FEATURE_64_BIT_INODE
+  SystemTime changed = timespecToChrono(s.st_ctimespec);
+#else
+  SystemTime changed = timespecToChrono(s.st_ctim);
+#endif
+  return CacheFileIdentity{static_cast<uint64_t>(s.st_ino), static_cast<uint64_t>(s.st_size),
+                           changed};
+}
+
+CacheIndex::CacheIndex(uint64_t max_cached_headers_bytes)
+    : max_cached_headers_bytes_(max_cached_headers_bytes) {}
+
+void CacheIndex::build(std::vector<File> files) {
+  // Youngest first, so that each file goes to the end of the list, behind all younger ones.
+  std::sort(files.begin(), files.end(), [](const File& a, const File& b) {
+    return std::tie(a.last_touch_, a.name_) > std::tie(b.last_touch_, b.name_);
+  });
+  absl::MutexLock lock(&mu_);
+  for (File& file : files) {
+    auto [it, inserted] = entries_.try_emplace(std::move(file.name_));
+    if (!inserted) {
+      continue;
+    }
+    it->second.size_ = file.size_;
+    it->second.generation_ = ++last_generation_;
+    it->second.lru_position_ = lru_.insert(lru_.end(), &it->first);
+  }
+  built_ = true;
+}
+
+bool CacheIndex::isBuilt() const {
+  absl::MutexLock lock(&mu_);
+  return built_;
+}
+
+CacheIndex::LookupResult CacheIndex::lookup(absl::string_view name) {
+  absl::MutexLock lock(&mu_);
+  auto it = entries_.find(name);
+  if (it == entries_.end()) {
+    return LookupResult{!built_, nullptr, 0};
+  }
+  Entry& entry = it->second;
+  lru_.splice(lru_.begin(), lru_, entry.lru_position_);
+  if (entry.headers_) {
+    headers_lru_.splice(headers_lru_.begin(), headers_lru_, entry.headers_lru_position_);
+  }
+  return LookupResult{true, entry.headers_, entry.generation_};
+}
+
+void CacheIndex::add(absl::string_view name, uint64_t size) {
+  absl::MutexLock lock(&mu_);
+  auto [it, inserted] = entries_.try_emplace(std::string(name));
+  Entry& entry = it->second;
+  if (inserted) {
+    entry.lru_position_ = lru_.insert(lru_.begin(), &it->first);
+  } else {
+    lru_.splice(lru_.begin(), lru_, entry.lru_position_);
+    dropHeadersLocked(entry);
+  }
+  entry.size_ = size;
+  entry.generation_ = ++last_generation_;
+}
+
+absl::optional<uint64_t> CacheIndex::remove(absl::string_view name) {
+  absl::MutexLock lock(&mu_);
+  auto it = entries_.find(name);
+  if (it == entries_.end()) {
+    return absl::nullopt;
+  }
+  uint64_t size = it->second.size_;
+  eraseLocked(it);
+  return size;
+}
+
+absl::optional<uint64_t> CacheIndex::removeIfUnchanged(absl::string_view name,
+                                                       uint64_t generation) {
+  absl::MutexLock lock(&mu_);
+  auto it = entries_.find(name);
+  if (it == entries_.end() || it->second.generation_ != generation) {
+    return absl::nullopt;
+  }
+  uint64_t size = it->second.size_;
+  eraseLocked(it);
+  return size;
+}
+
+void CacheIndex::setHeaders(absl::string_view name, CachedHeadersSharedPtr headers) {
+  if (!cachesHeaders()) {
+    return;
+  }
+  // The proto is the bulk of it; the rest is the fixed size of CachedHeaders and the
+  // bookkeeping of the entry.
+  const uint64_t headers_bytes = headers->header_proto_.ByteSizeLong() + sizeof(CachedHeaders);
+  if (headers_bytes > max_cached_headers_bytes_) {
+    return;
+  }
+  absl::MutexLock lock(&mu_);
+  auto it = entries_.find(name);
+  if (it == entries_.end()) {
+    return;
+  }
+  Entry& entry = it->second;
+  dropHeadersLocked(entry);
+  entry.headers_ = std::move(headers);
+  entry.headers_bytes_ = headers_bytes;
+  entry.headers_lru_position_ = headers_lru_.insert(headers_lru_.begin(), &it->first);
+  cached_headers_bytes_ += headers_bytes;
+  while (cached_headers_bytes_ > max_cached_headers_bytes_) {
+    auto oldest = entries_.find(*headers_lru_.back());
+    ASSERT(oldest != entries_.end());
+    dropHeadersLocked(oldest->second);
+  }
+}
+
+std::vector<std::pair<std::string, uint64_t>>
+CacheIndex::removeLeastRecentlyUsed(uint64_t bytes, uint64_t count) {
+  std::vector<std::pair<std::string, uint64_t>> removed;
+  uint64_t removed_bytes = 0;
+  absl::MutexLock lock(&mu_);
+  while (!lru_.empty() && (removed_bytes < bytes || removed.size() < count)) {
+    auto it = entries_.find(*lru_.back());
+    ASSERT(it != entries_.end());
+    removed_bytes += it->second.size_;
+    removed.emplace_back(it->first, it->second.size_);
+    eraseLocked(it);
+  }
+  return removed;
+}
+
+size_t CacheIndex::size() const {
+  absl::MutexLock lock(&mu_);
+  return entries_.size();
+}
+
+uint64_t CacheIndex::cachedHeadersBytes() const {
+  absl::MutexLock lock(&mu_);
+  return cached_headers_bytes_;
+}
+
+void CacheIndex::dropHeadersLocked(Entry& entry) {
+  if (!entry.headers_) {
+    return;
+  }
+  headers_lru_.erase(entry.headers_lru_position_);
+  cached_headers_bytes_ -= entry.headers_bytes_;
+  entry.headers_ = nullptr;
+  entry.headers_bytes_ = 0;
+}
+
+void CacheIndex::eraseLocked(EntryMap::iterator it) {
+  dropHeadersLocked(it->second);
+  lru_.erase(it->second.lru_position_);
+  entries_.erase(it);
+}
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <sys/stat.h>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/time.h"
+
+#include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_file_header.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+/**
+ * Identifies one version of a cache entry file. Replacing a cache entry links a new file
+ * with the same name, so headers kept in memory are only used if the file a lookup opened
+ * is the one they were read from.
+ */
+struct CacheFileIdentity {
+  uint64_t inode_;
+  uint64_t size_;
+  SystemTime changed_;
+
+  bool operator==(const CacheFileIdentity& other) const {
+    return inode_ == other.inode_ && size_ == other.size_ && changed_ == other.changed_;
+  }
+  bool operator!=(const CacheFileIdentity& other) const { return !(*this == other); }
+
+  static CacheFileIdentity fromStat(const struct stat& s);
+};
+
+/**
+ * The headers of a cache entry file, as read by a lookup.
+ */
+struct CachedHeaders {
+  CacheFileIdentity file_;
+  CacheFileFixedBlock header_block_;
+  CacheFileHeader header_proto_;
+};
+using CachedHeadersSharedPtr = std::shared_ptr<const CachedHeaders>;
+
+/**
+ * An in-memory index of the entry files of a cache, built from the cache path when the
+ * cache starts, so that lookups of absent entries and eviction don't have to touch the
+ * file system.
+ *
+ * Entries are kept in least-recently-used order, so that eviction takes the entries at the
+ * end of a list rather than reading and sorting every file in the cache path. The headers of
+ * recently read entries may also be kept, up to a total size; those are kept in their own
+ * least-recently-used order.
+ *
+ * All functions are thread-safe.
+ */
+class CacheIndex {
+public:
+  struct File {
+    std::string name_;
+    uint64_t size_;
+    SystemTime last_touch_;
+  };
+
+  struct LookupResult {
+    // False if the index is built and has no entry of that name, in which case there is no
+    // such file unless it was written by something other than this cache.
+    bool maybe_present_;
+    // The headers kept for the entry, if any.
+    CachedHeadersSharedPtr headers_;
+    // Identifies this version of the entry, which changes whenever the entry is added again.
+    uint64_t generation_{};
+  };
+
+  /**
+   * @param max_cached_headers_bytes the maximum total size of headers to keep in memory.
+   */
+  explicit CacheIndex(uint64_t max_cached_headers_bytes);
+
+  /**
+   * Adds the files found in the cache path when the cache started, and marks the index as
+   * built. Entries added while the cache path was being read are more recent than any of
+   * the files, and are kept as they are.
+   * @param files the cache entry files found in the cache path.
+   */
+  void build(std::vector<File> files) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * @return true once build has been called.
+   */
+  bool isBuilt() const ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * @return true if headers are kept in memory at all.
+   */
+  bool cachesHeaders() const { return max_cached_headers_bytes_ > 0; }
+
+  /**
+   * Looks up an entry, making it the most recently used entry if it is present.
+   * @param name the filename of the cache entry.
+   * @return whether the entry may be present, and its headers if they were kept.
+   */
+  LookupResult lookup(absl::string_view name) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Adds an entry as the most recently used, replacing any entry of the same name along
+   * with its headers.
+   * @param name the filename of the cache entry.
+   * @param size the size of the file in bytes.
+   */
+  void add(absl::string_view name, uint64_t size) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Removes an entry.
+   * @param name the filename of the cache entry.
+   * @return the size of the entry, or nullopt if there was no entry of that name.
+   */
+  absl::optional<uint64_t> remove(absl::string_view name) ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Removes an entry, unless it was added again since the lookup which returned the
+   * generation, e.g. because a new file replaced the one the lookup found missing.
+   * @param name the filename of the cache entry.
+   * @param generation the generation of the entry returned by lookup.
+   * @return the size of the entry, or nullopt if no entry of that generation was removed.
+   */
+  absl::optional<uint64_t> removeIfUnchanged(absl::string_view name, uint64_t generation)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Keeps the headers of an entry in memory, if the entry is in the index, replacing any
+   * headers already kept for it. If that makes the total size of kept headers more than
+   * the maximum, the headers of the least recently used entries are dropped.
+   * @param name the filename of the cache entry.
+   * @param headers the headers of the entry, and the identity of the file they were read from.
+   */
+  void setHeaders(absl::string_view name, CachedHeadersSharedPtr headers)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * Removes least recently used entries until both at least `bytes` bytes and at least
+   * `count` entries are removed, or the index is empty.
+   * @param bytes the number of bytes to remove.
+   * @param count the number of entries to remove.
+   * @return the names and sizes of the removed entries, least recently used first.
+   */
+  std::vector<std::pair<std::string, uint64_t>> removeLeastRecentlyUsed(uint64_t bytes,
+                                                                        uint64_t count)
+      ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * @return the number of entries in the index.
+   */
+  size_t size() const ABSL_LOCKS_EXCLUDED(mu_);
+
+  /**
+   * @return the total size of the headers kept in memory.
+   */
+  uint64_t cachedHeadersBytes() const ABSL_LOCKS_EXCLUDED(mu_);
+
+private:
+  // The lists refer to the names of the entries, which are stable in a node_hash_map.
+  using LruList = std::list<const std::string*>;
+  struct Entry {
+    uint64_t size_{0};
+    uint64_t generation_{0};
+    LruList::iterator lru_position_;
+    CachedHeadersSharedPtr headers_;
+    uint64_t headers_bytes_{0};
+    LruList::iterator headers_lru_position_;
+  };
+  using EntryMap = absl::node_hash_map<std::string, Entry>;
+
+  void dropHeadersLocked(Entry& entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void eraseLocked(EntryMap::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const uint64_t max_cached_headers_bytes_;
+  mutable absl::Mutex mu_;
+  bool built_ ABSL_GUARDED_BY(mu_) = false;
+  EntryMap entries_ ABSL_GUARDED_BY(mu_);
+  // Most recently used first.
+  LruList lru_ ABSL_GUARDED_BY(mu_);
+  // Entries with headers kept, most recently used first.
+  LruList headers_lru_ ABSL_GUARDED_BY(mu_);
+  uint64_t cached_headers_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  uint64_t last_generation_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
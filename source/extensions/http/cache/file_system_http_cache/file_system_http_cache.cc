@@ -4,6 +4,7 @@
 
 #include "source/common/filesystem/directory.h"
 #include "source/common/http/header_map_impl.h"
+#include "source/common/protobuf/utility.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_eviction_thread.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_header_proto_util.h"
@@ -22,6 +23,9 @@ namespace FileSystemHttpCache {
 // not worthwhile to carefully tune this.
 const size_t FileSystemHttpCache::max_update_headers_copy_chunk_size_ = 128 * 1024;
 
+// Enough for the headers of tens of thousands of typical responses.
+const uint64_t CacheShared::DefaultMaxCachedHeadersBytes = 16 * 1024 * 1024;
+
 const CacheStats& FileSystemHttpCache::stats() const { return shared_->stats_; }
 const ConfigProto& FileSystemHttpCache::config() const { return shared_->config_; }
 
@@ -33,9 +37,11 @@ void FileSystemHttpCache::writeVaryNodeToDisk(const Key& key,
   auto h = headers->add_headers();
   h->set_key("vary");
   h->set_value(absl::StrJoin(vary_values, ","));
-  std::string filename = absl::StrCat(cachePath(), generateFilename(key));
+  std::string name = generateFilename(key);
+  std::string filename = absl::StrCat(cachePath(), name);
   async_file_manager_->createAnonymousFile(
-      cachePath(), [headers, filename = std::move(filename),
+      cachePath(), [cache = shared_from_this(), headers, name = std::move(name),
+                    filename = std::move(filename),
                     cleanup](absl::StatusOr<AsyncFileHandle> open_result) {
         if (!open_result.ok()) {
           ENVOY_LOG(warn, "writing vary node, failed to createAnonymousFile: {}",
@@ -52,7 +58,7 @@ void FileSystemHttpCache::writeVaryNodeToDisk(const Key& key,
         size_t sz = buf2.length();
         auto queued = file_handle->write(
             buf2, 0,
-            [file_handle, cleanup, sz,
+            [cache, file_handle, cleanup, sz, name = std::move(name),
              filename = std::move(filename)](absl::StatusOr<size_t> write_result) {
               if (!write_result.ok() || write_result.value() != sz) {
                 ENVOY_LOG(warn, "writing vary node, failed to write: {}", write_result.status());
@@ -60,9 +66,11 @@ void FileSystemHttpCache::writeVaryNodeToDisk(const Key& key,
                 return;
               }
               auto queued = file_handle->createHardLink(
-                  filename, [cleanup, file_handle](absl::Status link_result) {
+                  filename, [cache, cleanup, file_handle, name, sz](absl::Status link_result) {
                     if (!link_result.ok()) {
                       ENVOY_LOG(warn, "writing vary node, failed to link: {}", link_result);
+                    } else {
+                      cache->trackFileAdded(name, sz);
                     }
                     file_handle->close([](absl::Status) {}).IgnoreError();
                   });
@@ -88,7 +96,12 @@ FileSystemHttpCache::FileSystemHttpCache(
 
 CacheShared::CacheShared(ConfigProto config, Stats::Scope& stats_scope)
     : config_(config), stat_names_(stats_scope.symbolTable()),
-      stats_(generateStats(stat_names_, stats_scope, cachePath())) {}
+      stats_(generateStats(stat_names_, stats_scope, cachePath())) {
+  if (config_.has_in_memory_index()) {
+    index_ = std::make_unique<CacheIndex>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        config_.in_memory_index(), max_cached_headers_bytes, DefaultMaxCachedHeadersBytes));
+  }
+}
 
 FileSystemHttpCache::~FileSystemHttpCache() { cache_eviction_thread_.removeCache(shared_); }
 
@@ -122,12 +135,12 @@ LookupContextPtr FileSystemHttpCache::makeLookupContext(LookupRequest&& lookup,
 // Helper class to reduce the lambda depth of updateHeaders.
 class HeaderUpdateContext : public Logger::Loggable<Logger::Id::cache_filter> {
 public:
-  HeaderUpdateContext(const FileSystemHttpCache& cache, const Key& key,
-                      std::shared_ptr<Cleanup> cleanup,
+  HeaderUpdateContext(FileSystemHttpCache& cache, const Key& key, std::shared_ptr<Cleanup> cleanup,
                       const Http::ResponseHeaderMap& response_headers,
                       const ResponseMetadata& metadata, std::function<void(bool)> on_complete)
-      : filepath_(absl::StrCat(cache.cachePath(), cache.generateFilename(key))),
-        cache_path_(cache.cachePath()), cleanup_(cleanup),
+      : cache_(cache.shared_from_this()), filename_(cache.generateFilename(key)),
+        filepath_(absl::StrCat(cache.cachePath(), filename_)), cache_path_(cache.cachePath()),
+        cleanup_(cleanup),
         async_file_manager_(cache.asyncFileManager()),
         response_headers_(Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers)),
         response_metadata_(metadata), on_complete_(on_complete) {}
@@ -167,6 +180,8 @@ private:
                   filepath_, unlink_result);
         // But keep going, because unlink might have failed because the file was already
         // deleted after we opened it. Worth a try to replace it!
+      } else {
+        original_unlinked_ = true;
       }
       readHeaderBlock(ctx);
     });
@@ -270,6 +285,11 @@ private:
         fail("failed to link new cache file", link_result);
         return;
       }
+      if (CacheIndex* index = cache_->index()) {
+        // The new file replaces the original, so it must not be taken for the one any
+        // kept headers were read from.
+        index->add(filename_, header_block_.offsetToEnd());
+      }
       on_complete_(true);
     });
     ASSERT(queued.ok());
@@ -277,8 +297,14 @@ private:
   void fail(absl::string_view msg, absl::Status status) {
     ENVOY_LOG(warn, "file_system_http_cache: {} for update cache file {}: {}", msg, filepath_,
               status);
+    CacheIndex* index = cache_->index();
+    if (index != nullptr && original_unlinked_) {
+      index->remove(filename_);
+    }
     on_complete_(false);
   }
+  std::shared_ptr<FileSystemHttpCache> cache_;
+  std::string filename_;
   std::string filepath_;
   std::string cache_path_;
   std::shared_ptr<Cleanup> cleanup_;
@@ -287,6 +313,7 @@ private:
   ResponseMetadata response_metadata_;
   CacheFileFixedBlock header_block_;
   off_t header_size_difference_;
+  bool original_unlinked_ = false;
   CacheFileHeader header_proto_;
   AsyncFileHandle read_handle_;
   AsyncFileHandle write_handle_;
@@ -365,6 +392,22 @@ void CacheShared::trackFileAdded(uint64_t file_size) {
 void FileSystemHttpCache::trackFileRemoved(uint64_t file_size) {
   shared_->trackFileRemoved(file_size);
 }
+
+void FileSystemHttpCache::trackFileAdded(absl::string_view filename, uint64_t file_size) {
+  if (shared_->index_ != nullptr) {
+    shared_->index_->add(filename, file_size);
+  }
+  trackFileAdded(file_size);
+}
+
+void FileSystemHttpCache::trackFileRemoved(absl::string_view filename, uint64_t file_size) {
+  if (shared_->index_ != nullptr) {
+    shared_->index_->remove(filename);
+  }
+  trackFileRemoved(file_size);
+}
+
+CacheIndex* FileSystemHttpCache::index() const { return shared_->index_.get(); }
 void CacheShared::trackFileRemoved(uint64_t file_size) {
   // Atomically decrement-but-clamp-at-zero the count of files in the cache.
   //
@@ -7,6 +7,7 @@
 #include "source/common/common/logger.h"
 #include "source/extensions/common/async_files/async_file_manager.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_index.h"
 #include "source/extensions/http/cache/file_system_http_cache/stats.h"
 
 #include "absl/base/thread_annotations.h"
@@ -177,6 +178,26 @@ public:
    */
   void trackFileRemoved(uint64_t file_size);
 
+  /**
+   * Updates the index, if any, and stats to reflect that a file has been added to the cache.
+   * @param filename the filename of the cache entry (path not included).
+   * @param file_size The size in bytes of the file that was added.
+   */
+  void trackFileAdded(absl::string_view filename, uint64_t file_size);
+
+  /**
+   * Updates the index, if any, and stats to reflect that a file has been removed from the cache.
+   * @param filename the filename of the cache entry (path not included).
+   * @param file_size The size in bytes of the file that was removed.
+   */
+  void trackFileRemoved(absl::string_view filename, uint64_t file_size);
+
+  /**
+   * Returns the in-memory index of this cache, if one is configured.
+   * @return the index, or nullptr if the cache has no index.
+   */
+  CacheIndex* index() const;
+
   // UpdateHeaders copies an existing cache entry to a new file. This value is
   // the size of a copy-chunk. It's public for unit tests only, as the chunk size
   // is totally irrelevant to the outward-facing API.
@@ -201,15 +222,12 @@ private:
 
   absl::Mutex cache_mu_;
   // When a new cache entry is being written, its key will be here and the cache file
-  // will not be present. The cache miss will be detected normally from the filesystem.
+  // will not be present. The cache miss will be detected normally from the filesystem,
+  // or from the index if in_memory_index is configured.
   // This should be checked before writing; cancel the write if another thread is already
   // writing the same entry.
   // TODO(ravenblack): if contention of cache_mu_ causes a performance issue, this could
   // be split into multiple hash tables along key boundaries, each with their own mutex.
-  // TODO(ravenblack): if detecting cache misses by filesystem causes a performance issue
-  // with uncacheable responses, another set could be added to keep track of uncacheable
-  // responses, to skip the filesystem hit. (Using ReaderLock should make such a table
-  // inherently low contention.)
   absl::flat_hash_set<Key, MessageUtil, MessageUtil>
       entries_being_written_ ABSL_GUARDED_BY(cache_mu_);
 
@@ -232,6 +250,7 @@ private:
 // two implementation files, accordingly.
 struct CacheShared {
   CacheShared(ConfigProto config, Stats::Scope& stats_scope);
+  static const uint64_t DefaultMaxCachedHeadersBytes;
   const ConfigProto config_;
   CacheStatNames stat_names_;
   CacheStats stats_;
@@ -245,6 +264,8 @@ struct CacheShared {
   std::atomic<uint64_t> size_count_ = 0;
   std::atomic<uint64_t> size_bytes_ = 0;
   bool needs_init_ = true;
+  // Only set if in_memory_index is configured.
+  std::unique_ptr<CacheIndex> index_;
 
   /**
    * @return true if the eviction thread should do a pass over this cache.
@@ -275,7 +296,14 @@ struct CacheShared {
   void evict();
 
   /**
-   * Initializes the stats for this cache. Runs in the CacheEvictionThread.
+   * Performs an eviction pass by removing the least recently used entries of the index.
+   * Runs in the CacheEvictionThread.
+   */
+  void evictFromIndex();
+
+  /**
+   * Initializes the stats, and the index if any, for this cache. Runs in the
+   * CacheEvictionThread.
    */
   void initStats();
 };
@@ -253,12 +253,12 @@ void InsertOperationQueue::commit(std::shared_ptr<InsertOperationQueue> p,
               cancel_action_in_flight_ = cache_->asyncFileManager()->unlink(
                   absl::StrCat(cache_->cachePath(), cache_->generateFilename(key_)),
                   [this, file_size, p](absl::Status unlink_result) {
-                    if (unlink_result.ok()) {
-                      cache_->trackFileRemoved(file_size);
-                    }
+                    absl::MutexLock lock(&mu_);
                     // We can ignore failure of unlink - the file may or may not have previously
                     // existed.
-                    absl::MutexLock lock(&mu_);
+                    if (unlink_result.ok()) {
+                      cache_->trackFileRemoved(cache_->generateFilename(key_), file_size);
+                    }
                     cancel_action_in_flight_ = nullptr;
                     // Link the file to its filename.
                     auto queued = file_handle_->createHardLink(
@@ -278,7 +278,7 @@ void InsertOperationQueue::commit(std::shared_ptr<InsertOperationQueue> p,
                           callback_in_flight_ = nullptr;
                           uint64_t file_size =
                               header_block_.offsetToTrailers() + header_block_.trailerSize();
-                          cache_->trackFileAdded(file_size);
+                          cache_->trackFileAdded(cache_->generateFilename(key_), file_size);
                           // By clearing cleanup before destructor, we prevent logging an error.
                           cleanup_ = nullptr;
                         });
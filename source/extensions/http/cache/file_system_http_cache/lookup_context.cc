@@ -28,100 +28,172 @@ void FileLookupContext::getHeaders(LookupHeadersCallback&& cb) {
 
 void FileLookupContext::getHeadersWithLock(LookupHeadersCallback cb) {
   mu_.AssertHeld();
+  CachedHeadersSharedPtr cached_headers;
+  uint64_t generation = 0;
+  if (CacheIndex* index = cache_.index()) {
+    CacheIndex::LookupResult indexed = index->lookup(cache_.generateFilename(key_));
+    if (!indexed.maybe_present_) {
+      cache_.stats().cache_miss_.inc();
+      cb(LookupResult{});
+      return;
+    }
+    cached_headers = std::move(indexed.headers_);
+    generation = indexed.generation_;
+  }
   cancel_action_in_flight_ = cache_.asyncFileManager()->openExistingFile(
       filepath(), Common::AsyncFiles::AsyncFileManager::Mode::ReadOnly,
-      [this, cb](absl::StatusOr<AsyncFileHandle> open_result) {
+      [this, cb, cached_headers, generation](absl::StatusOr<AsyncFileHandle> open_result) {
         absl::MutexLock lock(&mu_);
         cancel_action_in_flight_ = nullptr;
         if (!open_result.ok()) {
+          CacheIndex* index = cache_.index();
+          if (index != nullptr && absl::IsNotFound(open_result.status()) && !workInProgress()) {
+            // Something other than this cache removed the file, so the index was out of date,
+            // unless the entry is being written or was written again since the lookup; then the
+            // file is being replaced, and the writer keeps the index up to date.
+            absl::optional<uint64_t> file_size =
+                index->removeIfUnchanged(cache_.generateFilename(key_), generation);
+            if (file_size.has_value()) {
+              cache_.trackFileRemoved(file_size.value());
+            }
+          }
           cache_.stats().cache_miss_.inc();
           cb(LookupResult{});
           return;
         }
         ASSERT(!file_handle_);
         file_handle_ = std::move(open_result.value());
-        auto queued = file_handle_->read(
-            0, CacheFileFixedBlock::size(),
-            [this, cb](absl::StatusOr<Buffer::InstancePtr> read_result) {
-              absl::MutexLock lock(&mu_);
-              cancel_action_in_flight_ = nullptr;
-              if (!read_result.ok() ||
-                  read_result.value()->length() != CacheFileFixedBlock::size()) {
-                invalidateCacheEntry();
-                cache_.stats().cache_miss_.inc();
-                cb(LookupResult{});
-                return;
-              }
-              header_block_.populateFromStringView(read_result.value()->toString());
-              if (!header_block_.isValid()) {
-                invalidateCacheEntry();
-                cache_.stats().cache_miss_.inc();
-                cb(LookupResult{});
-                return;
-              }
-              auto queued = file_handle_->read(
-                  header_block_.offsetToHeaders(), header_block_.headerSize(),
-                  [this, cb](absl::StatusOr<Buffer::InstancePtr> read_result) {
-                    absl::MutexLock lock(&mu_);
-                    cancel_action_in_flight_ = nullptr;
-                    if (!read_result.ok() ||
-                        read_result.value()->length() != header_block_.headerSize()) {
-                      invalidateCacheEntry();
-                      cache_.stats().cache_miss_.inc();
-                      cb(LookupResult{});
-                      return;
-                    }
-                    auto header_proto = makeCacheFileHeaderProto(*read_result.value());
-                    if (header_proto.headers_size() == 1 &&
-                        header_proto.headers().at(0).key() == "vary") {
-                      auto maybe_vary_key = cache_.makeVaryKey(
-                          key_, lookup().varyAllowList(),
-                          absl::StrSplit(header_proto.headers().at(0).value(), ','),
-                          lookup().requestHeaders());
-                      if (!maybe_vary_key.has_value()) {
-                        cache_.stats().cache_miss_.inc();
-                        cb(LookupResult{});
-                        return;
-                      }
-                      key_ = maybe_vary_key.value();
-                      auto fh = std::move(file_handle_);
-                      file_handle_ = nullptr;
-                      // It should be possible to cancel close, to make this safe.
-                      // (it should still close the file, but cancel the callback.)
-                      auto queued = fh->close([this, cb](absl::Status) {
-                        absl::MutexLock lock(&mu_);
-                        // Restart getHeaders with the new key.
-                        return getHeadersWithLock(cb);
-                      });
-                      ASSERT(queued.ok(), queued.ToString());
-                      return;
-                    }
-                    cache_.stats().cache_hit_.inc();
-                    cb(lookup().makeLookupResult(
-                        headersFromHeaderProto(header_proto), metadataFromHeaderProto(header_proto),
-                        header_block_.bodySize(), header_block_.trailerSize() > 0));
-                  });
-              ASSERT(queued.ok(), queued.status().ToString());
-              cancel_action_in_flight_ = queued.value();
-            });
-        ASSERT(queued.ok(), queued.status().ToString());
-        cancel_action_in_flight_ = queued.value();
+        CacheIndex* index = cache_.index();
+        if (index == nullptr || !index->cachesHeaders()) {
+          readHeaderBlock(cb, absl::nullopt);
+          return;
+        }
+        statFile(cb, cached_headers);
+      });
+}
+
+void FileLookupContext::statFile(LookupHeadersCallback cb, CachedHeadersSharedPtr cached_headers) {
+  mu_.AssertHeld();
+  auto queued = file_handle_->stat(
+      [this, cb, cached_headers](absl::StatusOr<struct stat> stat_result) {
+        absl::MutexLock lock(&mu_);
+        cancel_action_in_flight_ = nullptr;
+        if (!stat_result.ok()) {
+          // Without knowing which file this is, its headers can't be kept, only read.
+          readHeaderBlock(cb, absl::nullopt);
+          return;
+        }
+        CacheFileIdentity file = CacheFileIdentity::fromStat(stat_result.value());
+        if (cached_headers != nullptr && cached_headers->file_ == file) {
+          header_block_ = cached_headers->header_block_;
+          onHeaderProto(cb, cached_headers->header_proto_);
+          return;
+        }
+        readHeaderBlock(cb, file);
       });
+  ASSERT(queued.ok(), queued.status().ToString());
+  cancel_action_in_flight_ = queued.value();
+}
+
+void FileLookupContext::readHeaderBlock(LookupHeadersCallback cb,
+                                        absl::optional<CacheFileIdentity> file) {
+  mu_.AssertHeld();
+  auto queued = file_handle_->read(
+      0, CacheFileFixedBlock::size(),
+      [this, cb, file](absl::StatusOr<Buffer::InstancePtr> read_result) {
+        absl::MutexLock lock(&mu_);
+        cancel_action_in_flight_ = nullptr;
+        if (!read_result.ok() || read_result.value()->length() != CacheFileFixedBlock::size()) {
+          invalidateCacheEntry();
+          cache_.stats().cache_miss_.inc();
+          cb(LookupResult{});
+          return;
+        }
+        header_block_.populateFromStringView(read_result.value()->toString());
+        if (!header_block_.isValid()) {
+          invalidateCacheEntry();
+          cache_.stats().cache_miss_.inc();
+          cb(LookupResult{});
+          return;
+        }
+        readHeaderProto(cb, file);
+      });
+  ASSERT(queued.ok(), queued.status().ToString());
+  cancel_action_in_flight_ = queued.value();
+}
+
+void FileLookupContext::readHeaderProto(LookupHeadersCallback cb,
+                                        absl::optional<CacheFileIdentity> file) {
+  mu_.AssertHeld();
+  auto queued = file_handle_->read(
+      header_block_.offsetToHeaders(), header_block_.headerSize(),
+      [this, cb, file](absl::StatusOr<Buffer::InstancePtr> read_result) {
+        absl::MutexLock lock(&mu_);
+        cancel_action_in_flight_ = nullptr;
+        if (!read_result.ok() || read_result.value()->length() != header_block_.headerSize()) {
+          invalidateCacheEntry();
+          cache_.stats().cache_miss_.inc();
+          cb(LookupResult{});
+          return;
+        }
+        auto header_proto = makeCacheFileHeaderProto(*read_result.value());
+        if (file.has_value()) {
+          cache_.index()->setHeaders(
+              cache_.generateFilename(key_),
+              std::make_shared<CachedHeaders>(CachedHeaders{file.value(), header_block_,
+                                                            header_proto}));
+        }
+        onHeaderProto(cb, header_proto);
+      });
+  ASSERT(queued.ok(), queued.status().ToString());
+  cancel_action_in_flight_ = queued.value();
+}
+
+void FileLookupContext::onHeaderProto(LookupHeadersCallback cb,
+                                      const CacheFileHeader& header_proto) {
+  mu_.AssertHeld();
+  if (header_proto.headers_size() == 1 && header_proto.headers().at(0).key() == "vary") {
+    auto maybe_vary_key = cache_.makeVaryKey(
+        key_, lookup().varyAllowList(), absl::StrSplit(header_proto.headers().at(0).value(), ','),
+        lookup().requestHeaders());
+    if (!maybe_vary_key.has_value()) {
+      cache_.stats().cache_miss_.inc();
+      cb(LookupResult{});
+      return;
+    }
+    key_ = maybe_vary_key.value();
+    auto fh = std::move(file_handle_);
+    file_handle_ = nullptr;
+    // It should be possible to cancel close, to make this safe.
+    // (it should still close the file, but cancel the callback.)
+    auto queued = fh->close([this, cb](absl::Status) {
+      absl::MutexLock lock(&mu_);
+      // Restart getHeaders with the new key.
+      return getHeadersWithLock(cb);
+    });
+    ASSERT(queued.ok(), queued.ToString());
+    return;
+  }
+  cache_.stats().cache_hit_.inc();
+  cb(lookup().makeLookupResult(headersFromHeaderProto(header_proto),
+                               metadataFromHeaderProto(header_proto), header_block_.bodySize(),
+                               header_block_.trailerSize() > 0));
 }
 
 void FileLookupContext::invalidateCacheEntry() {
   cache_.asyncFileManager()->stat(
-      filepath(), [file = filepath(),
+      filepath(), [file = filepath(), name = cache_.generateFilename(key_),
                    cache = cache_.shared_from_this()](absl::StatusOr<struct stat> stat_result) {
         size_t file_size = 0;
         if (stat_result.ok()) {
           file_size = stat_result.value().st_size;
         }
-        cache->asyncFileManager()->unlink(file, [cache, file_size](absl::Status unlink_result) {
-          if (unlink_result.ok()) {
-            cache->trackFileRemoved(file_size);
-          }
-        });
+        cache->asyncFileManager()->unlink(
+            file, [cache, name, file_size](absl::Status unlink_result) {
+              if (unlink_result.ok()) {
+                cache->trackFileRemoved(name, file_size);
+              }
+            });
       });
 }
 
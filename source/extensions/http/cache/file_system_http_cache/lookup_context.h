@@ -5,6 +5,9 @@
 #include "source/extensions/common/async_files/async_file_handle.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
 #include "source/extensions/http/cache/file_system_http_cache/cache_file_fixed_block.h"
+#include "source/extensions/http/cache/file_system_http_cache/cache_index.h"
+
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -38,6 +41,22 @@ public:
 private:
   void getHeadersWithLock(LookupHeadersCallback cb) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Stats the open file, to use the headers kept in the index if they were read from the
+  // same file, or otherwise to keep the headers once they're read.
+  void statFile(LookupHeadersCallback cb, CachedHeadersSharedPtr cached_headers)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Reads the header block and then the headers from the open file. If `file` is set, the
+  // headers are kept in the index with that identity.
+  void readHeaderBlock(LookupHeadersCallback cb, absl::optional<CacheFileIdentity> file)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void readHeaderProto(LookupHeadersCallback cb, absl::optional<CacheFileIdentity> file)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Completes the lookup with the headers of the open file, or follows a vary entry.
+  void onHeaderProto(LookupHeadersCallback cb, const CacheFileHeader& header_proto)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // In the event that the cache failed to retrieve, remove the cache entry from the
   // cache so we don't keep repeating the same failure.
   void invalidateCacheEntry() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
@@ -0,0 +1,60 @@
+#include "source/extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/logger.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+CgroupMemoryMonitor::CgroupMemoryMonitor(
+    const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+    std::unique_ptr<Common::CgroupStatsReader> cgroup)
+    : max_memory_bytes_(config.max_memory_bytes()),
+      use_pressure_stall_information_(config.use_pressure_stall_information()),
+      cgroup_(std::move(cgroup)) {}
+
+void CgroupMemoryMonitor::updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) {
+  // The limit of the cgroup is read on every update, as it may be changed at runtime.
+  uint64_t limit = max_memory_bytes_;
+  const absl::optional<uint64_t> cgroup_limit = cgroup_->memoryLimitBytes();
+  if (cgroup_limit.has_value() && (limit == 0 || *cgroup_limit < limit)) {
+    limit = *cgroup_limit;
+  }
+  if (limit == 0) {
+    callbacks.onFailure(EnvoyException("cgroup has no memory limit"));
+    return;
+  }
+
+  const absl::optional<uint64_t> used = cgroup_->memoryUsageBytes();
+  if (!used.has_value()) {
+    callbacks.onFailure(EnvoyException("failed to read cgroup memory usage"));
+    return;
+  }
+
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = *used / static_cast<double>(limit);
+
+  if (use_pressure_stall_information_) {
+    const absl::optional<double> stalled = cgroup_->memoryPressure();
+    if (!stalled.has_value()) {
+      callbacks.onFailure(EnvoyException("failed to read cgroup memory pressure"));
+      return;
+    }
+    usage.resource_pressure_ = std::max(usage.resource_pressure_, *stalled);
+  }
+
+  ENVOY_LOG_MISC(trace, "CgroupMemoryMonitor: used={}, limit={}, pressure={}", *used, limit,
+                 usage.resource_pressure_);
+
+  callbacks.onSuccess(usage);
+}
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
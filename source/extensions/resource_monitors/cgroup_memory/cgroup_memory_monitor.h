@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+#include "envoy/server/resource_monitor.h"
+
+#include "source/extensions/resource_monitors/common/cgroup_stats_reader.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+/**
+ * Reports the memory charged to the cgroup of Envoy relative to its memory limit, and optionally
+ * how much the cgroup is stalled on memory.
+ */
+class CgroupMemoryMonitor : public Server::ResourceMonitor {
+public:
+  CgroupMemoryMonitor(
+      const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+      std::unique_ptr<Common::CgroupStatsReader> cgroup);
+
+  void updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) override;
+
+private:
+  const uint64_t max_memory_bytes_;
+  const bool use_pressure_stall_information_;
+  std::unique_ptr<Common::CgroupStatsReader> cgroup_;
+};
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
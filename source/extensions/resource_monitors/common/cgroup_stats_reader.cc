@@ -0,0 +1,151 @@
+#include "source/extensions/resource_monitors/common/cgroup_stats_reader.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace Common {
+
+namespace {
+
+// cgroup v1 reports the largest page aligned 64 bit value as the memory limit of cgroups without a
+// limit. Anything above this is treated as no limit.
+constexpr uint64_t MaxCgroupV1MemoryLimit = uint64_t(1) << 62;
+
+// Returns the value of a "key value" line of a flat keyed cgroup file such as cpu.stat.
+absl::optional<uint64_t> flatKeyedValue(absl::string_view contents, absl::string_view key) {
+  for (absl::string_view line : absl::StrSplit(contents, '\n', absl::SkipWhitespace())) {
+    std::vector<absl::string_view> fields = absl::StrSplit(line, ' ', absl::SkipEmpty());
+    uint64_t value;
+    if (fields.size() == 2 && fields[0] == key && absl::SimpleAtoi(fields[1], &value)) {
+      return value;
+    }
+  }
+  return absl::nullopt;
+}
+
+} // namespace
+
+CgroupStatsReader::CgroupStatsReader(Filesystem::Instance& file_system, absl::string_view root)
+    : root_(root), is_v2_(file_system.fileExists(absl::StrCat(root, "/cgroup.controllers"))) {}
+
+absl::optional<std::string> CgroupStatsReader::readFile(absl::string_view relative_path) {
+  std::ifstream file(absl::StrCat(root_, "/", relative_path));
+  if (file.fail()) {
+    // Not all controllers and files exist on every kernel and in every hierarchy.
+    return absl::nullopt;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+absl::optional<uint64_t> CgroupStatsReader::readUint64(absl::string_view relative_path) {
+  const absl::optional<std::string> contents = readFile(relative_path);
+  uint64_t value;
+  if (!contents.has_value() || !absl::SimpleAtoi(absl::StripAsciiWhitespace(*contents), &value)) {
+    return absl::nullopt;
+  }
+  return value;
+}
+
+absl::optional<uint64_t> CgroupStatsReader::cpuUsageMicros() {
+  if (is_v2_) {
+    const absl::optional<std::string> contents = readFile("cpu.stat");
+    return contents.has_value() ? flatKeyedValue(*contents, "usage_usec") : absl::nullopt;
+  }
+  const absl::optional<uint64_t> usage_nanos = readUint64("cpuacct/cpuacct.usage");
+  return usage_nanos.has_value() ? absl::make_optional(*usage_nanos / 1000) : absl::nullopt;
+}
+
+absl::optional<double> CgroupStatsReader::cpuLimit() {
+  int64_t quota;
+  uint64_t period;
+  if (is_v2_) {
+    // "$MAX $PERIOD", where $MAX is "max" without a limit.
+    const absl::optional<std::string> contents = readFile("cpu.max");
+    if (!contents.has_value()) {
+      return absl::nullopt;
+    }
+    std::vector<absl::string_view> fields =
+        absl::StrSplit(absl::StripAsciiWhitespace(*contents), ' ', absl::SkipEmpty());
+    if (fields.size() != 2 || !absl::SimpleAtoi(fields[0], &quota) ||
+        !absl::SimpleAtoi(fields[1], &period)) {
+      return absl::nullopt;
+    }
+  } else {
+    // The quota is -1 without a limit.
+    const absl::optional<std::string> quota_contents = readFile("cpu/cpu.cfs_quota_us");
+    const absl::optional<uint64_t> period_value = readUint64("cpu/cpu.cfs_period_us");
+    if (!quota_contents.has_value() || !period_value.has_value() ||
+        !absl::SimpleAtoi(absl::StripAsciiWhitespace(*quota_contents), &quota)) {
+      return absl::nullopt;
+    }
+    period = *period_value;
+  }
+  if (quota <= 0 || period == 0) {
+    return absl::nullopt;
+  }
+  return static_cast<double>(quota) / period;
+}
+
+absl::optional<uint64_t> CgroupStatsReader::memoryUsageBytes() {
+  const absl::optional<uint64_t> usage =
+      readUint64(is_v2_ ? "memory.current" : "memory/memory.usage_in_bytes");
+  if (!usage.has_value()) {
+    return absl::nullopt;
+  }
+  // The usage is reported as is if memory.stat can't be read.
+  const absl::optional<std::string> stat = readFile(is_v2_ ? "memory.stat" : "memory/memory.stat");
+  const absl::optional<uint64_t> inactive_file =
+      stat.has_value() ? flatKeyedValue(*stat, is_v2_ ? "inactive_file" : "total_inactive_file")
+                       : absl::nullopt;
+  return *usage - std::min(*usage, inactive_file.value_or(0));
+}
+
+absl::optional<uint64_t> CgroupStatsReader::memoryLimitBytes() {
+  // memory.max is "max" without a limit, which fails to parse.
+  const absl::optional<uint64_t> limit =
+      readUint64(is_v2_ ? "memory.max" : "memory/memory.limit_in_bytes");
+  if (!limit.has_value() || *limit == 0 || *limit >= MaxCgroupV1MemoryLimit) {
+    return absl::nullopt;
+  }
+  return limit;
+}
+
+absl::optional<double> CgroupStatsReader::memoryPressure() {
+  if (!is_v2_) {
+    return absl::nullopt;
+  }
+  // "some avg10=1.23 avg60=0.50 avg300=0.10 total=12345", followed by the same for "full".
+  const absl::optional<std::string> contents = readFile("memory.pressure");
+  if (!contents.has_value()) {
+    return absl::nullopt;
+  }
+  for (absl::string_view line : absl::StrSplit(*contents, '\n', absl::SkipWhitespace())) {
+    if (!absl::ConsumePrefix(&line, "some ")) {
+      continue;
+    }
+    for (absl::string_view field : absl::StrSplit(line, ' ', absl::SkipEmpty())) {
+      double percent;
+      if (absl::ConsumePrefix(&field, "avg10=") && absl::SimpleAtod(field, &percent)) {
+        return std::clamp(percent / 100, 0.0, 1.0);
+      }
+    }
+  }
+  return absl::nullopt;
+}
+
+} // namespace Common
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
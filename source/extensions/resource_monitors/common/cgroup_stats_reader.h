@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "envoy/filesystem/filesystem.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace Common {
+
+/**
+ * Reads the statistics of the cgroup Envoy runs in. The cgroup file system is expected to be
+ * mounted at the root passed to the constructor, with the cgroup of Envoy at the root of the
+ * mount, as it is in containers. The unified hierarchy of cgroup v2 is used if the root has a
+ * cgroup.controllers file, and the cpu, cpuacct and memory controllers of cgroup v1 otherwise.
+ *
+ * All statistics are read again on every call. Statistics which can't be read or parsed are
+ * returned as absl::nullopt. The files are read directly, as Filesystem::Instance::fileReadToEnd()
+ * refuses to read from /sys and /proc.
+ */
+class CgroupStatsReader {
+public:
+  static constexpr absl::string_view DefaultRoot = "/sys/fs/cgroup";
+
+  CgroupStatsReader(Filesystem::Instance& file_system, absl::string_view root = DefaultRoot);
+
+  /**
+   * @return whether the root is a cgroup v2 hierarchy.
+   */
+  bool isV2() const { return is_v2_; }
+
+  /**
+   * @return the total CPU time used by the cgroup, in microseconds.
+   */
+  absl::optional<uint64_t> cpuUsageMicros();
+
+  /**
+   * @return the number of CPUs the cgroup may use at most, or absl::nullopt if it has no CPU limit
+   *         or the limit can't be read.
+   */
+  absl::optional<double> cpuLimit();
+
+  /**
+   * @return the memory charged to the cgroup, in bytes, without the inactive file cache, which
+   *         the kernel reclaims before reaching the memory limit.
+   */
+  absl::optional<uint64_t> memoryUsageBytes();
+
+  /**
+   * @return the memory limit of the cgroup, in bytes, or absl::nullopt if it has no memory limit
+   *         or the limit can't be read.
+   */
+  absl::optional<uint64_t> memoryLimitBytes();
+
+  /**
+   * @return the share of the last 10 seconds in which some tasks of the cgroup were stalled on
+   *         memory, between 0 and 1, or absl::nullopt without pressure stall information.
+   */
+  absl::optional<double> memoryPressure();
+
+private:
+  absl::optional<std::string> readFile(absl::string_view relative_path);
+  absl::optional<uint64_t> readUint64(absl::string_view relative_path);
+
+  const std::string root_;
+  const bool is_v2_;
+};
+
+} // namespace Common
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
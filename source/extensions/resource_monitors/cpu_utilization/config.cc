@@ -0,0 +1,40 @@
+#include "source/extensions/resource_monitors/cpu_utilization/config.h"
+
+#include <thread>
+
+#include "envoy/extensions/resource_monitors/cpu_utilization/v3/cpu_utilization.pb.h"
+#include "envoy/extensions/resource_monitors/cpu_utilization/v3/cpu_utilization.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/extensions/resource_monitors/common/cgroup_stats_reader.h"
+#include "source/extensions/resource_monitors/cpu_utilization/cpu_utilization_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+
+Server::ResourceMonitorPtr CpuUtilizationMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::extensions::resource_monitors::cpu_utilization::v3::CpuUtilizationConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  CpuStatsReaderPtr reader;
+  if (config.mode() ==
+      envoy::extensions::resource_monitors::cpu_utilization::v3::CpuUtilizationConfig::CONTAINER) {
+    reader = std::make_unique<ContainerCpuStatsReader>(
+        std::make_unique<Common::CgroupStatsReader>(context.api().fileSystem()),
+        context.api().timeSource(), std::thread::hardware_concurrency());
+  } else {
+    reader = std::make_unique<HostCpuStatsReader>();
+  }
+  return std::make_unique<CpuUtilizationMonitor>(std::move(reader));
+}
+
+/**
+ * Static registration for the CPU utilization resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(CpuUtilizationMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,99 @@
+#include "source/extensions/resource_monitors/cpu_utilization/cpu_utilization_monitor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "source/common/common/logger.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+
+HostCpuStatsReader::HostCpuStatsReader(const std::string& proc_stat_path)
+    : proc_stat_path_(proc_stat_path) {}
+
+absl::optional<CpuTimes> HostCpuStatsReader::getCpuTimes() {
+  // Filesystem::Instance::fileReadToEnd() refuses to read from /proc.
+  std::ifstream file(proc_stat_path_);
+  // The first line sums up all CPUs:
+  // cpu  user nice system idle iowait irq softirq steal guest guest_nice
+  // The guest times are already included in the user times.
+  std::string line;
+  if (!std::getline(file, line)) {
+    ENVOY_LOG_MISC(debug, "failed to read {}", proc_stat_path_);
+    return absl::nullopt;
+  }
+  std::vector<absl::string_view> fields = absl::StrSplit(line, ' ', absl::SkipEmpty());
+  if (fields.size() < 5 || fields[0] != "cpu") {
+    return absl::nullopt;
+  }
+  uint64_t times[7] = {};
+  for (size_t i = 0; i < 7 && i + 1 < fields.size(); ++i) {
+    if (!absl::SimpleAtoi(fields[i + 1], &times[i])) {
+      return absl::nullopt;
+    }
+  }
+  // The steal time is left out, as the CPUs weren't available to the host while it was stolen.
+  const uint64_t idle = times[3] + times[4];
+  const uint64_t work = times[0] + times[1] + times[2] + times[5] + times[6];
+  return CpuTimes{static_cast<double>(work), static_cast<double>(work + idle)};
+}
+
+ContainerCpuStatsReader::ContainerCpuStatsReader(std::unique_ptr<Common::CgroupStatsReader> cgroup,
+                                                 TimeSource& time_source, uint32_t host_cpus)
+    : cgroup_(std::move(cgroup)), time_source_(time_source), host_cpus_(std::max(host_cpus, 1u)) {}
+
+absl::optional<CpuTimes> ContainerCpuStatsReader::getCpuTimes() {
+  const absl::optional<uint64_t> usage = cgroup_->cpuUsageMicros();
+  if (!usage.has_value()) {
+    return absl::nullopt;
+  }
+
+  // The limit may change at any time, so the available time is accumulated read by read.
+  const MonotonicTime now = time_source_.monotonicTime();
+  if (last_read_time_.has_value()) {
+    const double elapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(now - *last_read_time_).count();
+    total_time_ += elapsed * cgroup_->cpuLimit().value_or(host_cpus_);
+  }
+  last_read_time_ = now;
+  return CpuTimes{static_cast<double>(*usage), total_time_};
+}
+
+CpuUtilizationMonitor::CpuUtilizationMonitor(CpuStatsReaderPtr reader)
+    : reader_(std::move(reader)), previous_times_(reader_->getCpuTimes()) {}
+
+void CpuUtilizationMonitor::updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) {
+  const absl::optional<CpuTimes> times = reader_->getCpuTimes();
+  if (!times.has_value()) {
+    callbacks.onFailure(EnvoyException("failed to read CPU times"));
+    return;
+  }
+
+  // Keep reporting the previous utilization if no time passed since the previous update.
+  if (previous_times_.has_value() && times->total_time_ > previous_times_->total_time_) {
+    utilization_ = std::clamp((times->work_time_ - previous_times_->work_time_) /
+                                  (times->total_time_ - previous_times_->total_time_),
+                              0.0, 1.0);
+  }
+  previous_times_ = times;
+
+  ENVOY_LOG_MISC(trace, "CpuUtilizationMonitor: utilization={}", utilization_);
+  Server::ResourceUsage usage;
+  usage.resource_pressure_ = utilization_;
+  callbacks.onSuccess(usage);
+}
+
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/server/resource_monitor.h"
+
+#include "source/extensions/resource_monitors/common/cgroup_stats_reader.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+
+/**
+ * Cumulative CPU times since an arbitrary point in time, in an arbitrary unit.
+ */
+struct CpuTimes {
+  // The CPU time which was used.
+  double work_time_;
+  // The CPU time which was available.
+  double total_time_;
+};
+
+class CpuStatsReader {
+public:
+  virtual ~CpuStatsReader() = default;
+
+  /**
+   * @return the current CPU times, or absl::nullopt if they can't be read.
+   */
+  virtual absl::optional<CpuTimes> getCpuTimes() PURE;
+};
+
+using CpuStatsReaderPtr = std::unique_ptr<CpuStatsReader>;
+
+/**
+ * Reads the CPU times of all CPUs of the host from /proc/stat, in clock ticks. Time stolen by the
+ * hypervisor counts neither as used nor as available.
+ */
+class HostCpuStatsReader : public CpuStatsReader {
+public:
+  HostCpuStatsReader(const std::string& proc_stat_path = "/proc/stat");
+
+  absl::optional<CpuTimes> getCpuTimes() override;
+
+private:
+  const std::string proc_stat_path_;
+};
+
+/**
+ * Reads the CPU time used by the cgroup of Envoy, in microseconds. The available CPU time is the
+ * time elapsed between reads, multiplied by the CPU limit of the cgroup, or by the number of CPUs
+ * of the host if the cgroup has no CPU limit.
+ */
+class ContainerCpuStatsReader : public CpuStatsReader {
+public:
+  ContainerCpuStatsReader(std::unique_ptr<Common::CgroupStatsReader> cgroup,
+                          TimeSource& time_source, uint32_t host_cpus);
+
+  absl::optional<CpuTimes> getCpuTimes() override;
+
+private:
+  std::unique_ptr<Common::CgroupStatsReader> cgroup_;
+  TimeSource& time_source_;
+  const uint32_t host_cpus_;
+  absl::optional<MonotonicTime> last_read_time_;
+  double total_time_{};
+};
+
+/**
+ * Reports the fraction of the available CPU time which was used since the previous update.
+ */
+class CpuUtilizationMonitor : public Server::ResourceMonitor {
+public:
+  CpuUtilizationMonitor(CpuStatsReaderPtr reader);
+
+  void updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) override;
+
+private:
+  CpuStatsReaderPtr reader_;
+  absl::optional<CpuTimes> previous_times_;
+  double utilization_{};
+};
+
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -20,7 +20,8 @@ ActiveUdpListenerBase::ActiveUdpListenerBase(uint32_t worker_index, uint32_t con
       udp_listener_(std::move(listener)),
       udp_stats_({ALL_UDP_LISTENER_STATS(POOL_COUNTER_PREFIX(config->listenerScope(), "udp"))}),
       udp_listener_worker_router_(config_->udpListenerConfig()->listenerWorkerRouter(
-          *listen_socket.connectionInfoProvider().localAddress())) {
+          *listen_socket.connectionInfoProvider().localAddress())),
+      posted_datagrams_(std::make_shared<PostedDatagrams>()) {
   ASSERT(worker_index_ < concurrency_);
   udp_listener_worker_router_.registerWorkerForListener(*this);
 }
@@ -33,19 +34,36 @@ void ActiveUdpListenerBase::post(Network::UdpRecvData&& data) {
   ASSERT(!udp_listener_->dispatcher().isThreadSafe(),
          "Shouldn't be posting if thread safe; use onWorkerData() instead.");
 
-  // It is not possible to capture a unique_ptr because the post() API copies the lambda, so we must
-  // bundle the socket inside a shared_ptr that can be captured.
-  // TODO(mattklein123): It may be possible to change the post() API such that the lambda is only
-  // moved, but this is non-trivial and needs investigation.
-  auto data_to_post = std::make_shared<Network::UdpRecvData>();
-  *data_to_post = std::move(data);
+  // Datagrams forwarded from other workers are queued, and only the first datagram of a batch
+  // posts a callback to this worker's dispatcher. Packets misrouted by the kernel typically arrive
+  // in bursts from a single recvmmsg() call on the source worker, so this replaces a dispatcher
+  // post (and event loop wakeup) per datagram with one per burst.
+  bool schedule_drain;
+  {
+    absl::MutexLock lock(&posted_datagrams_->mutex_);
+    schedule_drain = posted_datagrams_->datagrams_.empty();
+    posted_datagrams_->datagrams_.push_back(std::move(data));
+  }
+  if (!schedule_drain) {
+    return;
+  }
 
+  // The queue is captured through a shared_ptr so that datagrams posted right before this listener
+  // is destroyed are dropped instead of being delivered to a dangling listener.
   auto address = listen_socket_.connectionInfoProvider().localAddress();
-  udp_listener_->dispatcher().post([data_to_post, tag = config_->listenerTag(), &parent = parent_,
-                                    address]() {
+  udp_listener_->dispatcher().post([posted_datagrams = posted_datagrams_,
+                                    tag = config_->listenerTag(), &parent = parent_, address]() {
+    std::vector<Network::UdpRecvData> datagrams;
+    {
+      absl::MutexLock lock(&posted_datagrams->mutex_);
+      datagrams.swap(posted_datagrams->datagrams_);
+    }
     Network::UdpListenerCallbacksOptRef listener = parent.getUdpListenerCallbacks(tag, *address);
-    if (listener.has_value()) {
-      listener->get().onDataWorker(std::move(*data_to_post));
+    if (!listener.has_value()) {
+      return;
+    }
+    for (Network::UdpRecvData& data : datagrams) {
+      listener->get().onDataWorker(std::move(data));
     }
   });
 }
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "envoy/network/connection_handler.h"
 #include "envoy/network/filter.h"
@@ -12,6 +13,8 @@
 #include "source/common/network/utility.h"
 #include "source/server/active_listener_base.h"
 
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -56,6 +59,16 @@ protected:
   Network::UdpListenerPtr udp_listener_;
   UdpListenerStats udp_stats_;
   Network::UdpListenerWorkerRouter& udp_listener_worker_router_;
+
+private:
+  // Datagrams posted to this worker by other workers, waiting to be drained by a single callback
+  // on this worker's dispatcher.
+  struct PostedDatagrams {
+    absl::Mutex mutex_;
+    std::vector<Network::UdpRecvData> datagrams_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  const std::shared_ptr<PostedDatagrams> posted_datagrams_;
 };
 
 /**
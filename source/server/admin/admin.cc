@@ -182,6 +182,10 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server,
                 "Drains all inbound listeners. traffic_direction field in "
                 "envoy_v3_api_msg_config.listener.v3.Listener is used to determine whether a "
                 "listener is inbound or outbound."}}),
+          makeHandler("/event_loops",
+                      "dump event loop stats and slowest callbacks (if dispatcher stats are "
+                      "enabled)",
+                      MAKE_ADMIN_HANDLER(stats_handler_.handlerEventLoops), false, false),
           makeHandler("/server_info", "print server version/status information",
                       MAKE_ADMIN_HANDLER(server_info_handler_.handlerServerInfo), false, false),
           makeHandler("/ready", "print server state, return 200 if LIVE, otherwise return 503",
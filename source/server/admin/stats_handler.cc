@@ -3,11 +3,13 @@
 #include <functional>
 #include <vector>
 
+#include "envoy/admin/v3/event_loops.pb.h"
 #include "envoy/admin/v3/mutex_stats.pb.h"
 #include "envoy/server/admin.h"
 
 #include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/empty_string.h"
+#include "source/common/event/dispatcher_instrumentation.h"
 #include "source/common/http/headers.h"
 #include "source/common/http/utility.h"
 #include "source/server/admin/prometheus_stats.h"
@@ -170,6 +172,44 @@ Http::Code StatsHandler::handlerContention(Http::ResponseHeaderMap& response_hea
   return Http::Code::OK;
 }
 
+Http::Code StatsHandler::handlerEventLoops(Http::ResponseHeaderMap& response_headers,
+                                           Buffer::Instance& response, AdminStream&) {
+  const std::vector<Event::DispatcherInstrumentation::Snapshot> snapshots =
+      Event::DispatcherInstrumentation::snapshotAll();
+  if (snapshots.empty()) {
+    response.add("Event loop instrumentation is not enabled. To enable, set "
+                 "enable_dispatcher_stats in the bootstrap.");
+    return Http::Code::OK;
+  }
+
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
+  envoy::admin::v3::EventLoops event_loops;
+  for (const Event::DispatcherInstrumentation::Snapshot& snapshot : snapshots) {
+    envoy::admin::v3::EventLoop& event_loop = *event_loops.add_event_loops();
+    event_loop.set_name(snapshot.name_);
+    event_loop.set_utilization(snapshot.utilization_);
+    for (size_t i = 0; i < Event::NumCallbackTypes; ++i) {
+      auto& callback_time = *event_loop.add_callback_times();
+      callback_time.set_type(std::string(Event::DispatcherInstrumentation::callbackTypeName(
+          static_cast<Event::CallbackType>(i))));
+      callback_time.set_count(snapshot.callback_times_[i].count_);
+      *callback_time.mutable_total_time() = Protobuf::util::TimeUtil::MicrosecondsToDuration(
+          snapshot.callback_times_[i].total_time_.count());
+    }
+    for (const Event::DispatcherInstrumentation::SlowCallback& slow :
+         snapshot.slowest_callbacks_) {
+      auto& slow_callback = *event_loop.add_slowest_callbacks();
+      slow_callback.set_type(
+          std::string(Event::DispatcherInstrumentation::callbackTypeName(slow.type_)));
+      slow_callback.set_source(Event::DispatcherInstrumentation::sourceName(slow.source_));
+      *slow_callback.mutable_duration() =
+          Protobuf::util::TimeUtil::MicrosecondsToDuration(slow.duration_.count());
+    }
+  }
+  response.add(MessageUtil::getJsonStringFromMessageOrError(event_loops, true, true));
+  return Http::Code::OK;
+}
+
 Admin::UrlHandler StatsHandler::statsHandler(bool active_mode) {
   const Admin::ParamDescriptorVec common_params{
       {Admin::ParamDescriptor::Type::String, "filter",
@@ -72,6 +72,9 @@ public:
   Http::Code handlerContention(Http::ResponseHeaderMap& response_headers,
                                Buffer::Instance& response, AdminStream&);
 
+  Http::Code handlerEventLoops(Http::ResponseHeaderMap& response_headers,
+                               Buffer::Instance& response, AdminStream&);
+
   /**
    * When stats are rendered in HTML mode, we want users to be able to tweak
    * parameters after the stats page is rendered, such as tweaking the filter or
@@ -141,6 +141,10 @@ HotRestartImpl::mergeParentStatsIfAny(Stats::StoreRoot& stats_store) {
   return response;
 }
 
+std::vector<HotRestart::HostHealthFromParent> HotRestartImpl::parentHostHealth() {
+  return as_child_.getParentHostHealth();
+}
+
 void HotRestartImpl::shutdown() { as_parent_.shutdown(); }
 
 uint32_t HotRestartImpl::baseId() { return base_id_; }
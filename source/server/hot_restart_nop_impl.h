@@ -24,6 +24,7 @@ public:
   }
   void sendParentTerminateRequest() override {}
   ServerStatsFromParent mergeParentStatsIfAny(Stats::StoreRoot&) override { return {}; }
+  std::vector<HostHealthFromParent> parentHostHealth() override { return {}; }
   void shutdown() override {}
   uint32_t baseId() override { return 0; }
   std::string version() override { return "disabled"; }
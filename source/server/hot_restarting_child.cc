@@ -51,6 +51,30 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   return wrapped_reply;
 }
 
+std::vector<HotRestart::HostHealthFromParent> HotRestartingChild::getParentHostHealth() {
+  std::vector<HotRestart::HostHealthFromParent> host_health;
+  if (restart_epoch_ == 0 || parent_terminated_) {
+    return host_health;
+  }
+
+  HotRestartMessage wrapped_request;
+  wrapped_request.mutable_request()->mutable_host_health();
+  sendHotRestartMessage(parent_address_, wrapped_request);
+
+  std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
+  // A parent of an older version doesn't know the request, in which case the hosts of the new
+  // process start out as they would without a parent.
+  if (!replyIsExpectedType(wrapped_reply.get(), HotRestartMessage::Reply::kHostHealth)) {
+    return host_health;
+  }
+  host_health.reserve(wrapped_reply->reply().host_health().hosts_size());
+  for (const auto& host : wrapped_reply->reply().host_health().hosts()) {
+    host_health.push_back({host.cluster_name(), host.address(), host.failed_active_health_check(),
+                           host.degraded_active_health_check(), host.failed_outlier_check()});
+  }
+  return host_health;
+}
+
 void HotRestartingChild::drainParentListeners() {
   if (restart_epoch_ == 0 || parent_terminated_) {
     return;
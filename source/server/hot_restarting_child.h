@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "source/common/stats/stat_merger.h"
 #include "source/server/hot_restarting_base.h"
 
@@ -16,6 +18,7 @@ public:
 
   int duplicateParentListenSocket(const std::string& address, uint32_t worker_index);
   std::unique_ptr<envoy::HotRestartMessage> getParentStats();
+  std::vector<HotRestart::HostHealthFromParent> getParentHostHealth();
   void drainParentListeners();
   absl::optional<HotRestart::AdminShutdownResponse> sendParentAdminShutdownRequest();
   void sendParentTerminateRequest();
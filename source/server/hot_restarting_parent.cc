@@ -1,6 +1,8 @@
 #include "source/server/hot_restarting_parent.h"
 
 #include "envoy/server/instance.h"
+#include "envoy/upstream/cluster_manager.h"
+#include "envoy/upstream/upstream.h"
 
 #include "source/common/memory/stats.h"
 #include "source/common/network/utility.h"
@@ -60,6 +62,13 @@ void HotRestartingParent::onSocketEvent() {
       break;
     }
 
+    case HotRestartMessage::Request::kHostHealth: {
+      HotRestartMessage wrapped_reply;
+      internal_->exportHostHealthToChild(wrapped_reply.mutable_reply()->mutable_host_health());
+      sendHotRestartMessage(child_address_, wrapped_reply);
+      break;
+    }
+
     case HotRestartMessage::Request::kDrainListeners: {
       internal_->drainListeners();
       break;
@@ -184,6 +193,27 @@ void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Sta
   }
 }
 
+void HotRestartingParent::Internal::exportHostHealthToChild(
+    HotRestartMessage::Reply::HostHealth* host_health) {
+  // Only active clusters are exported, as the hosts of warming clusters haven't been checked yet.
+  const Upstream::ClusterManager::ClusterInfoMaps clusters = server_->clusterManager().clusters();
+  for (const auto& [cluster_name, cluster] : clusters.active_clusters_) {
+    for (const auto& host_set : cluster.get().prioritySet().hostSetsPerPriority()) {
+      for (const Upstream::HostSharedPtr& host : host_set->hosts()) {
+        HotRestartMessage::Reply::HostHealth::Host* host_proto = host_health->add_hosts();
+        host_proto->set_cluster_name(cluster_name);
+        host_proto->set_address(host->address()->asString());
+        host_proto->set_failed_active_health_check(
+            host->healthFlagGet(Upstream::Host::HealthFlag::FAILED_ACTIVE_HC));
+        host_proto->set_degraded_active_health_check(
+            host->healthFlagGet(Upstream::Host::HealthFlag::DEGRADED_ACTIVE_HC));
+        host_proto->set_failed_outlier_check(
+            host->healthFlagGet(Upstream::Host::HealthFlag::FAILED_OUTLIER_CHECK));
+      }
+    }
+  }
+}
+
 void HotRestartingParent::Internal::drainListeners() { server_->drainListeners(); }
 
 } // namespace Server
@@ -32,6 +32,9 @@ public:
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
+    // 'host_health' is a field in the reply protobuf to be sent to the child, which we should
+    // populate.
+    void exportHostHealthToChild(envoy::HotRestartMessage::Reply::HostHealth* host_health);
     void drainListeners();
 
   private:
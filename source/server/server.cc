@@ -46,6 +46,7 @@
 #include "source/common/network/tcp_listener_impl.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/router/rds_impl.h"
+#include "source/common/runtime/runtime_features.h"
 #include "source/common/runtime/runtime_impl.h"
 #include "source/common/signal/fatal_error_handler.h"
 #include "source/common/singleton/manager_impl.h"
@@ -700,6 +701,11 @@ void InstanceImpl::initialize(Network::Address::InstanceConstSharedPtr local_add
   // Once we have runtime we can initialize the SSL context manager.
   ssl_context_manager_ = createContextManager("ssl_context_manager", time_source_);
 
+  // The hosts created while the clusters initialize start out with the health the parent last saw.
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.hot_restart_host_health")) {
+    loadParentHostHealth();
+  }
+
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       serverFactoryContext(), admin(), runtime(), stats_store_, thread_local_,
       [this]() -> Network::DnsResolverSharedPtr { return this->getOrCreateDnsResolver(); },
@@ -803,7 +809,27 @@ void InstanceImpl::onRuntimeReady() {
   }
 }
 
+void InstanceImpl::loadParentHostHealth() {
+  const std::vector<HotRestart::HostHealthFromParent> parent_host_health =
+      restarter_.parentHostHealth();
+  if (parent_host_health.empty()) {
+    return;
+  }
+  auto inherited_host_health = std::make_unique<Upstream::InheritedHostHealth>();
+  for (const HotRestart::HostHealthFromParent& host : parent_host_health) {
+    inherited_host_health->add(host.cluster_name_, host.address_,
+                               {host.failed_active_health_check_,
+                                host.degraded_active_health_check_, host.failed_outlier_check_});
+  }
+  ENVOY_LOG(info, "inheriting the health of {} upstream hosts from the parent",
+            parent_host_health.size());
+  inherited_host_health_ =
+      std::make_unique<Upstream::ScopedInheritedHostHealth>(std::move(inherited_host_health));
+}
+
 void InstanceImpl::startWorkers() {
+  // The clusters are initialized, so the health inherited from the parent isn't needed anymore.
+  inherited_host_health_.reset();
   // The callback will be called after workers are started.
   listener_manager_->startWorkers(*worker_guard_dog_, [this]() {
     if (isShutdown()) {
@@ -39,6 +39,7 @@
 #include "source/common/runtime/runtime_impl.h"
 #include "source/common/secret/secret_manager_impl.h"
 #include "source/common/upstream/health_discovery_service.h"
+#include "source/common/upstream/inherited_host_health.h"
 
 #ifdef ENVOY_ADMIN_FUNCTIONALITY
 #include "source/server/admin/admin.h"
@@ -315,6 +316,7 @@ private:
   void initialize(Network::Address::InstanceConstSharedPtr local_address,
                   ComponentFactory& component_factory);
   void loadServerFlags(const absl::optional<std::string>& flags_path);
+  void loadParentHostHealth();
   void startWorkers();
   void terminate();
   void notifyCallbacksForStage(
@@ -367,6 +369,7 @@ private:
   Network::ConnectionHandlerPtr handler_;
   std::unique_ptr<Runtime::ScopedLoaderSingleton> runtime_singleton_;
   std::unique_ptr<Runtime::Loader> runtime_;
+  std::unique_ptr<Upstream::ScopedInheritedHostHealth> inherited_host_health_;
   ProdWorkerFactory worker_factory_;
   std::unique_ptr<ListenerManager> listener_manager_;
   absl::node_hash_map<Stage, LifecycleNotifierCallbacks> stage_callbacks_;
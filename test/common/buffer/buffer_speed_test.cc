@@ -2,6 +2,7 @@
 #include "envoy/http/stream_reset_handler.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/buffer/slice_allocator.h"
 #include "source/common/buffer/watermark_buffer.h"
 #include "source/common/common/assert.h"
 
@@ -558,4 +559,56 @@ BENCHMARK(bufferAddVsAddFragments)
     ->Args({1, 1, 64, 5})
     ->Args({1, 1, 4096, 5});
 
+// Test alloc/free heavy workloads: buffers of mixed payload sizes are filled, moved and drained, so
+// that every iteration allocates and frees slices of several size classes.
+static void bufferMixedSizeChurn(benchmark::State& state) {
+  const std::vector<std::string> payloads = {std::string(100, 'a'), std::string(3000, 'b'),
+                                             std::string(9000, 'c'), std::string(20000, 'd'),
+                                             std::string(50000, 'e')};
+  const uint64_t num_buffers = state.range(0);
+  uint64_t length = 0;
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    std::vector<Buffer::OwnedImpl> buffers(num_buffers);
+    for (uint64_t i = 0; i < num_buffers; ++i) {
+      buffers[i].add(payloads[i % payloads.size()]);
+    }
+    Buffer::OwnedImpl sink;
+    for (Buffer::OwnedImpl& buffer : buffers) {
+      // Reserving for a read allocates the storage of the next read, and frees what is not used.
+      Buffer::Reservation reservation = buffer.reserveForRead();
+      reservation.commit(1000);
+      sink.move(buffer);
+      length += sink.length();
+      sink.drain(sink.length());
+    }
+  }
+  benchmark::DoNotOptimize(length);
+}
+BENCHMARK(bufferMixedSizeChurn)->Arg(1)->Arg(16)->Arg(256);
+
+// Test the cost of allocating and freeing slice storage of mixed sizes through the SliceAllocator,
+// compared to allocating it with new and delete. Arg 0 selects new and delete, arg 1 the allocator.
+static void sliceStorageAllocFree(benchmark::State& state) {
+  const bool use_allocator = state.range(0) != 0;
+  const std::vector<uint64_t> sizes = {4096, 16384, 8192, 65536, 4096, 32768, 16384, 12288};
+  std::vector<uint8_t*> storage(sizes.size());
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      storage[i] = use_allocator ? Buffer::SliceAllocator::allocate(sizes[i])
+                                 : new uint8_t[sizes[i]];
+      benchmark::DoNotOptimize(storage[i]);
+    }
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      if (use_allocator) {
+        Buffer::SliceAllocator::free(storage[i], sizes[i]);
+      } else {
+        delete[] storage[i];
+      }
+    }
+  }
+}
+BENCHMARK(sliceStorageAllocFree)->Arg(0)->Arg(1);
+
 } // namespace Envoy
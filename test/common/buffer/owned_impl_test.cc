@@ -854,8 +854,10 @@ TEST_F(OwnedImplTest, ReserveSingleOverCommit) {
       "length <= slice_.len_. Details: commit() length must be <= size of the Reservation");
 }
 
-// Test functionality of the `freelist` (a performance optimization).
+// Test that slice storage is reused through the thread local cache of the SliceAllocator (a
+// performance optimization), most recently freed storage first.
 TEST_F(OwnedImplTest, SliceFreeList) {
+  Buffer::SliceAllocator::releaseCachedForTest();
   Buffer::OwnedImpl b1, b2;
   std::vector<void*> slices;
   {
@@ -874,19 +876,21 @@ TEST_F(OwnedImplTest, SliceFreeList) {
     EXPECT_EQ(slices[1], b2.getRawSlices()[0].mem_);
   }
 
+  // The storage of drained slices is cached as well.
   b1.drain(1);
   EXPECT_EQ(0, b1.getRawSlices().size());
   {
     auto r = b2.reserveForRead();
     // slices()[0] is the partially used slice that is already part of this buffer.
-    EXPECT_EQ(slices[2], r.slices()[1].mem_);
+    EXPECT_EQ(slices[0], r.slices()[1].mem_);
+    EXPECT_EQ(slices[2], r.slices()[2].mem_);
   }
   {
     auto r = b1.reserveForRead();
-    EXPECT_EQ(slices[2], r.slices()[0].mem_);
+    EXPECT_EQ(slices[0], r.slices()[0].mem_);
   }
   {
-    // This causes an underflow in the `freelist` on creation, and overflows it on deletion.
+    // This empties the cache on creation, and overflows it on deletion.
     auto r1 = b1.reserveForRead();
     auto r2 = b2.reserveForRead();
     for (auto& r1_slice : absl::MakeSpan(r1.slices(), r1.numSlices())) {
@@ -898,6 +902,11 @@ TEST_F(OwnedImplTest, SliceFreeList) {
       }
     }
   }
+  // Full magazines of the thread local cache move to the depot.
+  EXPECT_EQ(7 * Buffer::Slice::default_slice_size_,
+            Buffer::SliceAllocator::threadCachedBytesForTest());
+  EXPECT_EQ(8 * Buffer::Slice::default_slice_size_,
+            Buffer::SliceAllocator::depotCachedBytesForTest());
 }
 
 TEST_F(OwnedImplTest, Search) {
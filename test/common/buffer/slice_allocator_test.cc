@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "source/common/buffer/slice_allocator.h"
+
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class SliceAllocatorTest : public testing::Test {
+protected:
+  SliceAllocatorTest() {
+    scoped_runtime_.mergeValues({{"envoy.reloadable_features.buffer_slice_magazines", "true"}});
+    SliceAllocator::releaseCachedForTest();
+  }
+  ~SliceAllocatorTest() override { SliceAllocator::releaseCachedForTest(); }
+
+  TestScopedRuntime scoped_runtime_;
+};
+
+// Nothing is cached while the runtime guard is disabled.
+TEST_F(SliceAllocatorTest, NotCachedWhenDisabled) {
+  scoped_runtime_.mergeValues({{"envoy.reloadable_features.buffer_slice_magazines", "false"}});
+  SliceAllocator::free(SliceAllocator::allocate(4096), 4096);
+  EXPECT_EQ(0, SliceAllocator::threadCachedBytesForTest());
+  EXPECT_EQ(0, SliceAllocator::depotCachedBytesForTest());
+}
+
+// A thread caches at most MaxThreadCachedBytes, even when none of its magazines is full.
+TEST_F(SliceAllocatorTest, ThreadCacheBounded) {
+  std::vector<std::pair<uint8_t*, uint64_t>> storage;
+  for (uint64_t size = SliceAllocator::PageSize; size <= SliceAllocator::MaxCachedSize;
+       size += SliceAllocator::PageSize) {
+    // Enough storage to fill the magazine of the size class, but not to move it to the depot.
+    for (uint64_t i = 0; i < std::max<uint64_t>(2, 128 * 1024 / size); ++i) {
+      storage.emplace_back(SliceAllocator::allocate(size), size);
+    }
+  }
+  for (const auto& [s, size] : storage) {
+    SliceAllocator::free(s, size);
+  }
+  EXPECT_LE(SliceAllocator::threadCachedBytesForTest(), SliceAllocator::MaxThreadCachedBytes);
+  EXPECT_GT(SliceAllocator::threadCachedBytesForTest(),
+            SliceAllocator::MaxThreadCachedBytes - SliceAllocator::MaxCachedSize);
+  EXPECT_EQ(0, SliceAllocator::depotCachedBytesForTest());
+}
+
+// Freed storage is handed out again by the next allocation of the same size, most recently freed
+// first.
+TEST_F(SliceAllocatorTest, ReusesStorageOfSameSize) {
+  uint8_t* a = SliceAllocator::allocate(4096);
+  uint8_t* b = SliceAllocator::allocate(4096);
+  uint8_t* c = SliceAllocator::allocate(8192);
+  SliceAllocator::free(a, 4096);
+  SliceAllocator::free(b, 4096);
+  SliceAllocator::free(c, 8192);
+  EXPECT_EQ(4096 + 4096 + 8192, SliceAllocator::threadCachedBytesForTest());
+
+  EXPECT_EQ(b, SliceAllocator::allocate(4096));
+  EXPECT_EQ(a, SliceAllocator::allocate(4096));
+  EXPECT_EQ(c, SliceAllocator::allocate(8192));
+  EXPECT_EQ(0, SliceAllocator::threadCachedBytesForTest());
+  SliceAllocator::free(a, 4096);
+  SliceAllocator::free(b, 4096);
+  SliceAllocator::free(c, 8192);
+}
+
+// Storage above the largest size class is never cached.
+TEST_F(SliceAllocatorTest, LargeStorageNotCached) {
+  const uint64_t size = SliceAllocator::MaxCachedSize + SliceAllocator::PageSize;
+  SliceAllocator::free(SliceAllocator::allocate(size), size);
+  SliceAllocator::free(SliceAllocator::allocate(0), 0);
+  EXPECT_EQ(0, SliceAllocator::threadCachedBytesForTest());
+  EXPECT_EQ(0, SliceAllocator::depotCachedBytesForTest());
+}
+
+// Full magazines move to the depot, and empty magazines refill from it.
+TEST_F(SliceAllocatorTest, MagazinesMoveThroughDepot) {
+  const uint64_t size = SliceAllocator::MaxCachedSize;
+  std::vector<uint8_t*> storage;
+  for (int i = 0; i < 5; ++i) {
+    storage.push_back(SliceAllocator::allocate(size));
+  }
+  for (uint8_t* s : storage) {
+    SliceAllocator::free(s, size);
+  }
+  // The magazine of the largest size class holds two pieces of storage.
+  EXPECT_EQ(size, SliceAllocator::threadCachedBytesForTest());
+  EXPECT_EQ(4 * size, SliceAllocator::depotCachedBytesForTest());
+
+  for (int i = 0; i < 5; ++i) {
+    SliceAllocator::allocate(size);
+  }
+  EXPECT_EQ(0, SliceAllocator::threadCachedBytesForTest());
+  EXPECT_EQ(0, SliceAllocator::depotCachedBytesForTest());
+  for (uint8_t* s : storage) {
+    SliceAllocator::free(s, size);
+  }
+}
+
+// Storage freed by another thread returns to the allocating thread through the depot.
+TEST_F(SliceAllocatorTest, CrossThreadReturn) {
+  const uint64_t size = SliceAllocator::MaxCachedSize;
+  std::vector<uint8_t*> storage;
+  for (int i = 0; i < 4; ++i) {
+    storage.push_back(SliceAllocator::allocate(size));
+  }
+
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread([&storage, size]() {
+    for (uint8_t* s : storage) {
+      SliceAllocator::free(s, size);
+    }
+    EXPECT_EQ(2 * size, SliceAllocator::threadCachedBytesForTest());
+  });
+  thread->join();
+  // The magazine left on the thread returns to the depot when the thread exits.
+  EXPECT_EQ(4 * size, SliceAllocator::depotCachedBytesForTest());
+
+  std::vector<uint8_t*> reused;
+  for (int i = 0; i < 4; ++i) {
+    reused.push_back(SliceAllocator::allocate(size));
+  }
+  EXPECT_EQ(0, SliceAllocator::depotCachedBytesForTest());
+  EXPECT_TRUE(std::is_permutation(storage.begin(), storage.end(), reused.begin()));
+  for (uint8_t* s : reused) {
+    SliceAllocator::free(s, size);
+  }
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
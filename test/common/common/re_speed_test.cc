@@ -1,9 +1,12 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from
 // a quiescent system with disabled cstate power management.
 
+#include <memory>
 #include <regex>
+#include <vector>
 
 #include "source/common/common/assert.h"
+#include "source/common/common/regex.h"
 
 #include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
@@ -126,3 +129,64 @@ static void BM_RE2_AltPattern(benchmark::State& state) {
   RELEASE_ASSERT(passes > 0, "");
 }
 BENCHMARK(BM_RE2_AltPattern);
+
+// Regexes as commonly found in route and header matchers, most of which only compare the value
+// with literals.
+static const char* RouteRegexes[] = {
+    "/api/v1/users",    "^/static/.*",       ".*\\.(css|js)$",       ".*\\.png",
+    "/health(z)?",      "GET|HEAD|OPTIONS",  "/api/v[0-9]+/orders/.*", ".*/admin/.*",
+    "(?:gzip|br)",      "/login",            "/users/[0-9]+",         "^/v2/.*$",
+};
+
+static const char* RouteInputs[] = {
+    "/api/v1/users",
+    "/static/js/app.3f2a91.js",
+    "/images/logo.png",
+    "/api/v2/orders/12345/items",
+    "/internal/admin/settings",
+    "/users/42",
+    "/v2/catalog/products?page=3",
+    "/a/much/longer/path/that/does/not/match/any/of/the/configured/routes/at/all",
+    "GET",
+    "br",
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RE2_RouteRegexes(benchmark::State& state) {
+  std::vector<std::unique_ptr<re2::RE2>> regexes;
+  for (const char* regex : RouteRegexes) {
+    regexes.push_back(std::make_unique<re2::RE2>(regex));
+  }
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const char* route_input : RouteInputs) {
+      for (const auto& regex : regexes) {
+        if (re2::RE2::FullMatch(route_input, *regex)) {
+          ++passes;
+        }
+      }
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_RE2_RouteRegexes);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CompiledGoogleReMatcher_RouteRegexes(benchmark::State& state) {
+  std::vector<std::unique_ptr<Envoy::Regex::CompiledGoogleReMatcher>> matchers;
+  for (const char* regex : RouteRegexes) {
+    matchers.push_back(std::make_unique<Envoy::Regex::CompiledGoogleReMatcher>(regex, false));
+  }
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const char* route_input : RouteInputs) {
+      for (const auto& matcher : matchers) {
+        if (matcher->match(route_input)) {
+          ++passes;
+        }
+      }
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_CompiledGoogleReMatcher_RouteRegexes);
@@ -154,6 +154,77 @@ TEST(Utility, ParseRegex) {
   }
 }
 
+// Regexes which only compare the value with literals are matched without RE2, with the same
+// results.
+TEST(CompiledGoogleReMatcher, LiteralFastPath) {
+  const std::vector<std::string> regexes = {"",
+                                            "^$",
+                                            "/foo",
+                                            "^/foo$",
+                                            "/foo\\.bar",
+                                            "/foo\\$",
+                                            "/foo\\\\$",
+                                            "/foo/.*",
+                                            ".*\\.css",
+                                            ".*/admin/.*",
+                                            ".*",
+                                            "GET|POST",
+                                            "^(GET|HEAD)$",
+                                            "(?:a\\|b|c)",
+                                            "a||b",
+                                            "/foo\\.*",
+                                            "/foo.+",
+                                            "/foo.*?",
+                                            "(a)|(b)",
+                                            "(?i)get",
+                                            "/status/200(/.*)?$",
+                                            "/api/v[0-9]+/.*",
+                                            "caf\xc3\xa9/.*"};
+  const std::vector<std::string> values = {"",
+                                           "/foo",
+                                           "/foo.bar",
+                                           "/fooxbar",
+                                           "/foo$",
+                                           "/foo\\",
+                                           "/foo/",
+                                           "/foo/bar/baz",
+                                           "/foo/bar\nbaz",
+                                           "/foo/caf\xc3\xa9",
+                                           "/foo/\xff",
+                                           "/foo...",
+                                           "style.css",
+                                           "style.css\n",
+                                           "/x/admin/y",
+                                           "/admin",
+                                           "GET",
+                                           "HEAD",
+                                           "POST",
+                                           "get",
+                                           "a|b",
+                                           "a",
+                                           "c",
+                                           "/status/200/x",
+                                           "/api/v2/users",
+                                           "caf\xc3\xa9/menu"};
+  for (const std::string& regex : regexes) {
+    const CompiledGoogleReMatcher matcher(regex, false);
+    const re2::RE2 re2(regex);
+    ASSERT_TRUE(re2.ok()) << regex;
+    for (const std::string& value : values) {
+      EXPECT_EQ(re2::RE2::FullMatch(value, re2), matcher.match(value))
+          << "regex: '" << regex << "', value: '" << value << "'";
+    }
+  }
+}
+
+TEST(CompiledGoogleReMatcher, LiteralFastPathDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.regex_literal_fast_path", "false"}});
+  EXPECT_TRUE(CompiledGoogleReMatcher("/foo/.*", false).match("/foo/bar"));
+  EXPECT_FALSE(CompiledGoogleReMatcher("/foo/.*", false).match("/foo/bar\nbaz"));
+  EXPECT_TRUE(CompiledGoogleReMatcher("GET|POST", false).match("POST"));
+}
+
 } // namespace
 } // namespace Regex
 } // namespace Envoy
@@ -0,0 +1,141 @@
+#include <random>
+
+#include "envoy/type/matcher/v3/string.pb.h"
+
+#include "source/common/common/matchers.h"
+#include "source/common/common/string_matcher_set.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Matchers {
+namespace {
+
+using MatchType = StringMatcherSet::MatchType;
+
+TEST(StringMatcherSetTest, ToPattern) {
+  envoy::type::matcher::v3::StringMatcher matcher;
+  matcher.set_prefix("foo");
+  matcher.set_ignore_case(true);
+  auto pattern = StringMatcherSet::toPattern(matcher);
+  ASSERT_TRUE(pattern.has_value());
+  EXPECT_EQ(MatchType::Prefix, pattern->type_);
+  EXPECT_EQ("foo", pattern->value_);
+  EXPECT_TRUE(pattern->ignore_case_);
+
+  matcher.mutable_safe_regex()->set_regex("foo");
+  EXPECT_FALSE(StringMatcherSet::toPattern(matcher).has_value());
+}
+
+TEST(StringMatcherSetTest, Empty) {
+  const StringMatcherSet set(std::vector<StringMatcherSet::Pattern>{});
+  EXPECT_FALSE(set.matchAny(""));
+  EXPECT_FALSE(set.matchAny("foo"));
+}
+
+TEST(StringMatcherSetTest, EmptyPatterns) {
+  EXPECT_TRUE(StringMatcherSet({{MatchType::Exact, "", false}}).matchAny(""));
+  EXPECT_FALSE(StringMatcherSet({{MatchType::Exact, "", false}}).matchAny("foo"));
+  EXPECT_TRUE(StringMatcherSet({{MatchType::Prefix, "", false}}).matchAny("foo"));
+  EXPECT_TRUE(StringMatcherSet({{MatchType::Suffix, "", true}}).matchAny("foo"));
+  EXPECT_TRUE(StringMatcherSet({{MatchType::Contains, "", false}}).matchAny(""));
+}
+
+TEST(StringMatcherSetTest, MatchTypes) {
+  const StringMatcherSet set({{MatchType::Exact, "exact", false},
+                              {MatchType::Prefix, "prefix", false},
+                              {MatchType::Suffix, "suffix", false},
+                              {MatchType::Contains, "contains", false}});
+
+  EXPECT_TRUE(set.matchAny("exact"));
+  EXPECT_FALSE(set.matchAny("exactly"));
+  EXPECT_FALSE(set.matchAny("inexact"));
+  EXPECT_TRUE(set.matchAny("prefix-value"));
+  EXPECT_FALSE(set.matchAny("value-prefix"));
+  EXPECT_TRUE(set.matchAny("value-suffix"));
+  EXPECT_FALSE(set.matchAny("suffix-value"));
+  EXPECT_TRUE(set.matchAny("value-contains-value"));
+  EXPECT_FALSE(set.matchAny("value-contain-value"));
+  EXPECT_FALSE(set.matchAny("EXACT"));
+  EXPECT_FALSE(set.matchAny(""));
+}
+
+TEST(StringMatcherSetTest, IgnoreCase) {
+  const StringMatcherSet set({{MatchType::Exact, "Exact", true},
+                              {MatchType::Prefix, "prefix", false},
+                              {MatchType::Contains, "CoNtAiNs", true}});
+
+  EXPECT_TRUE(set.matchAny("eXACT"));
+  EXPECT_TRUE(set.matchAny("prefix"));
+  EXPECT_FALSE(set.matchAny("PREFIX"));
+  EXPECT_TRUE(set.matchAny("value-CONTAINS"));
+}
+
+// Patterns which are suffixes of other patterns are found through the failure transitions of the
+// automaton.
+TEST(StringMatcherSetTest, OverlappingPatterns) {
+  const StringMatcherSet set({{MatchType::Contains, "abcd", false},
+                              {MatchType::Suffix, "bc", false},
+                              {MatchType::Exact, "cab", false}});
+
+  EXPECT_TRUE(set.matchAny("xabcdx"));
+  EXPECT_TRUE(set.matchAny("aabc"));
+  EXPECT_FALSE(set.matchAny("abca"));
+  EXPECT_TRUE(set.matchAny("cab"));
+  EXPECT_FALSE(set.matchAny("ccab"));
+}
+
+// Compares StringMatcherSet with StringMatcherImpl on random patterns and values over a small
+// alphabet, so that patterns overlap often.
+TEST(StringMatcherSetTest, MatchesLikeStringMatchers) {
+  std::mt19937 random(0);
+  const auto random_string = [&random](size_t max_length) {
+    constexpr absl::string_view alphabet = "abAB\xff";
+    std::string value(random() % (max_length + 1), 'a');
+    for (char& c : value) {
+      c = alphabet[random() % alphabet.size()];
+    }
+    return value;
+  };
+
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<StringMatcherSet::Pattern> patterns;
+    std::vector<StringMatcherImpl<envoy::type::matcher::v3::StringMatcher>> matchers;
+    const size_t num_patterns = 1 + random() % 5;
+    for (size_t j = 0; j < num_patterns; ++j) {
+      envoy::type::matcher::v3::StringMatcher matcher;
+      const std::string pattern = random_string(4);
+      switch (random() % 4) {
+      case 0:
+        matcher.set_exact(pattern);
+        break;
+      case 1:
+        matcher.set_prefix(pattern);
+        break;
+      case 2:
+        matcher.set_suffix(pattern);
+        break;
+      default:
+        matcher.set_contains(pattern);
+        break;
+      }
+      matcher.set_ignore_case(random() % 2);
+      patterns.push_back(*StringMatcherSet::toPattern(matcher));
+      matchers.emplace_back(matcher);
+    }
+
+    const StringMatcherSet set(patterns);
+    for (int j = 0; j < 20; ++j) {
+      const std::string value = random_string(8);
+      bool expected = false;
+      for (const auto& matcher : matchers) {
+        expected = expected || matcher.match(value);
+      }
+      EXPECT_EQ(expected, set.matchAny(value)) << value;
+    }
+  }
+}
+
+} // namespace
+} // namespace Matchers
+} // namespace Envoy
@@ -8,6 +8,7 @@
 
 #include "source/common/common/empty_string.h"
 #include "source/common/config/api_version.h"
+#include "source/common/config/decoded_resource_impl.h"
 #include "source/common/config/grpc_mux_impl.h"
 #include "source/common/config/protobuf_link_hacks.h"
 #include "source/common/config/utility.h"
@@ -25,6 +26,7 @@
 #include "test/test_common/logging.h"
 #include "test/test_common/resources.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
@@ -590,6 +592,109 @@ TEST_F(GrpcMuxImplTest, WildcardWatch) {
   }
 }
 
+// Decodes ClusterLoadAssignment resources, counting the decoded resources.
+class CountingResourceDecoder : public TestUtility::TestOpaqueResourceDecoderImpl<
+                                    envoy::config::endpoint::v3::ClusterLoadAssignment> {
+public:
+  CountingResourceDecoder() : TestOpaqueResourceDecoderImpl("cluster_name") {}
+
+  ProtobufTypes::MessagePtr decodeResource(const ProtobufWkt::Any& resource) override {
+    decoded_++;
+    return TestOpaqueResourceDecoderImpl::decodeResource(resource);
+  }
+
+  uint32_t decoded_{};
+};
+
+// Validate that resources which are resent unchanged are not decoded again.
+TEST_F(GrpcMuxImplTest, UnchangedResourcesAreNotDecodedAgain) {
+  setup();
+
+  InSequence s;
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  auto resource_decoder = std::make_shared<CountingResourceDecoder>();
+  auto foo_sub = grpc_mux_->addWatch(type_url, {}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {}, "", true);
+  grpc_mux_->start();
+
+  envoy::config::endpoint::v3::ClusterLoadAssignment x;
+  x.set_cluster_name("x");
+  envoy::config::endpoint::v3::ClusterLoadAssignment y;
+  y.set_cluster_name("y");
+  using LoadAssignments = std::vector<envoy::config::endpoint::v3::ClusterLoadAssignment>;
+  const auto send_response = [&](const std::string& version,
+                                 const LoadAssignments& load_assignments) {
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url);
+    response->set_version_info(version);
+    for (const auto& load_assignment : load_assignments) {
+      response->add_resources()->PackFrom(load_assignment);
+    }
+    EXPECT_CALL(callbacks_, onConfigUpdate(_, version))
+        .WillOnce(Invoke([&load_assignments, &version](
+                             const std::vector<DecodedResourceRef>& resources,
+                             const std::string&) {
+          ASSERT_EQ(load_assignments.size(), resources.size());
+          for (size_t i = 0; i < resources.size(); i++) {
+            EXPECT_EQ(load_assignments[i].cluster_name(), resources[i].get().name());
+            EXPECT_EQ(version, resources[i].get().version());
+            EXPECT_TRUE(
+                TestUtility::protoEqual(load_assignments[i], resources[i].get().resource()));
+            ProtobufWkt::Any serialized;
+            serialized.PackFrom(load_assignments[i]);
+            EXPECT_EQ(DecodedResourceImpl::computeWireHash(serialized),
+                      resources[i].get().wireHash());
+          }
+        }));
+    expectSendMessage(type_url, {}, version);
+    grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+  };
+
+  send_response("1", {x});
+  EXPECT_EQ(1, resource_decoder->decoded_);
+  // Only the added resource is decoded.
+  send_response("2", {x, y});
+  EXPECT_EQ(2, resource_decoder->decoded_);
+  // A changed resource is decoded again.
+  y.mutable_policy()->set_overprovisioning_factor(200);
+  send_response("3", {x, y});
+  EXPECT_EQ(3, resource_decoder->decoded_);
+  // Resources removed by an update are not kept around for reuse.
+  send_response("4", {y});
+  send_response("5", {x, y});
+  EXPECT_EQ(4, resource_decoder->decoded_);
+}
+
+// Validate that every resource is decoded when reuse is disabled.
+TEST_F(GrpcMuxImplTest, UnchangedResourcesAreDecodedAgainWithoutReuse) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.xds_reuse_unchanged_resources", "false"}});
+  setup();
+
+  InSequence s;
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  auto resource_decoder = std::make_shared<CountingResourceDecoder>();
+  auto foo_sub = grpc_mux_->addWatch(type_url, {}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {}, "", true);
+  grpc_mux_->start();
+
+  envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  for (const std::string version : {"1", "2"}) {
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url);
+    response->set_version_info(version);
+    response->add_resources()->PackFrom(load_assignment);
+    EXPECT_CALL(callbacks_, onConfigUpdate(_, version));
+    expectSendMessage(type_url, {}, version);
+    grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+  }
+  EXPECT_EQ(2, resource_decoder->decoded_);
+}
+
 // Validate behavior when watches specify resources (potentially overlapping).
 TEST_F(GrpcMuxImplTest, WatchDemux) {
   setup();
@@ -386,6 +386,15 @@ protected:
 // TODO(mergeconflict): We also need integration testing to validate that the expected histograms
 // are written when `enable_dispatcher_stats` is true. See issue #6582.
 TEST_F(DispatcherImplTest, InitializeStats) {
+  EXPECT_CALL(store_, counter("test.dispatcher.deferred_delete_time_us"));
+  EXPECT_CALL(store_, counter("test.dispatcher.file_event_time_us"));
+  EXPECT_CALL(store_, counter("test.dispatcher.post_time_us"));
+  EXPECT_CALL(store_, counter("test.dispatcher.schedulable_callback_time_us"));
+  EXPECT_CALL(store_, counter("test.dispatcher.timer_time_us"));
+  EXPECT_CALL(store_,
+              gauge("test.dispatcher.utilization_percent", Stats::Gauge::ImportMode::NeverImport));
+  EXPECT_CALL(store_,
+              histogram("test.dispatcher.callbacks_per_loop", Stats::Histogram::Unit::Unspecified));
   EXPECT_CALL(store_,
               histogram("test.dispatcher.loop_duration_us", Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(store_,
@@ -0,0 +1,159 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "source/common/event/dispatcher_instrumentation.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+class DispatcherInstrumentationTest : public testing::Test {
+protected:
+  DispatcherInstrumentationTest()
+      : stats_{ALL_DISPATCHER_STATS(POOL_COUNTER_PREFIX(*store_.rootScope(), "test."),
+                                    POOL_GAUGE_PREFIX(*store_.rootScope(), "test."),
+                                    POOL_HISTOGRAM_PREFIX(*store_.rootScope(), "test."))},
+        instrumentation_("test_thread", stats_, time_system_) {}
+
+  void runCallback(CallbackType type, microseconds duration,
+                   const std::type_info* source = nullptr) {
+    DispatcherInstrumentation::ScopedCallback scoped_callback(&instrumentation_, type, source);
+    time_system_.advanceTimeWait(duration);
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  SimulatedTimeSystem time_system_;
+  DispatcherStats stats_;
+  DispatcherInstrumentation instrumentation_;
+};
+
+// Utilization and callback times are published once per interval of loop time.
+TEST_F(DispatcherInstrumentationTest, PublishesOncePerInterval) {
+  runCallback(CallbackType::Timer, microseconds(300));
+  runCallback(CallbackType::FileEvent, microseconds(200));
+  instrumentation_.onLoopBusy(microseconds(500));
+  instrumentation_.onLoopIdle(milliseconds(400));
+
+  EXPECT_EQ(0, stats_.timer_time_us_.value());
+  EXPECT_EQ(0, instrumentation_.snapshot().callback_times_[0].count_);
+
+  runCallback(CallbackType::Post, microseconds(100));
+  instrumentation_.onLoopBusy(microseconds(599500));
+
+  EXPECT_EQ(60, stats_.utilization_percent_.value());
+  EXPECT_EQ(300, stats_.timer_time_us_.value());
+  EXPECT_EQ(200, stats_.file_event_time_us_.value());
+  EXPECT_EQ(100, stats_.post_time_us_.value());
+  EXPECT_EQ(0, stats_.deferred_delete_time_us_.value());
+
+  const DispatcherInstrumentation::Snapshot snapshot = instrumentation_.snapshot();
+  EXPECT_EQ("test_thread", snapshot.name_);
+  EXPECT_DOUBLE_EQ(0.6, snapshot.utilization_);
+  const auto& timer = snapshot.callback_times_[static_cast<size_t>(CallbackType::Timer)];
+  EXPECT_EQ(1, timer.count_);
+  EXPECT_EQ(microseconds(300), timer.total_time_);
+  EXPECT_EQ(3, snapshot.slowest_callbacks_.size());
+
+  // The next interval starts from scratch, while the callback times keep accumulating.
+  runCallback(CallbackType::Timer, microseconds(50));
+  instrumentation_.onLoopIdle(milliseconds(900));
+  instrumentation_.onLoopBusy(milliseconds(100));
+  EXPECT_EQ(10, stats_.utilization_percent_.value());
+  EXPECT_EQ(350, stats_.timer_time_us_.value());
+  EXPECT_EQ(2, instrumentation_.snapshot()
+                   .callback_times_[static_cast<size_t>(CallbackType::Timer)]
+                   .count_);
+}
+
+// A callback running within another one is accounted to the outer one only.
+TEST_F(DispatcherInstrumentationTest, NestedCallbacksCountedOnce) {
+  {
+    DispatcherInstrumentation::ScopedCallback outer(&instrumentation_, CallbackType::Timer);
+    time_system_.advanceTimeWait(microseconds(100));
+    runCallback(CallbackType::DeferredDelete, microseconds(50));
+  }
+  instrumentation_.onLoopBusy(DispatcherInstrumentation::PublishInterval);
+
+  EXPECT_EQ(150, stats_.timer_time_us_.value());
+  EXPECT_EQ(0, stats_.deferred_delete_time_us_.value());
+  const DispatcherInstrumentation::Snapshot snapshot = instrumentation_.snapshot();
+  EXPECT_EQ(0,
+            snapshot.callback_times_[static_cast<size_t>(CallbackType::DeferredDelete)].count_);
+  ASSERT_EQ(1, snapshot.slowest_callbacks_.size());
+  EXPECT_EQ(CallbackType::Timer, snapshot.slowest_callbacks_[0].type_);
+}
+
+TEST_F(DispatcherInstrumentationTest, KeepsSlowestCallbacks) {
+  for (int i = 1; i <= 15; ++i) {
+    runCallback(CallbackType::SchedulableCallback, microseconds(i),
+                i == 15 ? &typeid(int) : nullptr);
+  }
+  instrumentation_.onLoopBusy(DispatcherInstrumentation::PublishInterval);
+
+  const std::vector<DispatcherInstrumentation::SlowCallback> slowest =
+      instrumentation_.snapshot().slowest_callbacks_;
+  ASSERT_EQ(DispatcherInstrumentation::MaxSlowCallbacks, slowest.size());
+  for (size_t i = 0; i < slowest.size(); ++i) {
+    EXPECT_EQ(microseconds(15 - i), slowest[i].duration_);
+  }
+  EXPECT_EQ("int", DispatcherInstrumentation::sourceName(slowest[0].source_));
+  EXPECT_EQ("", DispatcherInstrumentation::sourceName(slowest[1].source_));
+}
+
+// The slowest callbacks start from scratch every interval, so that a slow callback doesn't hide the
+// callbacks of later intervals.
+TEST_F(DispatcherInstrumentationTest, SlowestCallbacksPerInterval) {
+  runCallback(CallbackType::Timer, milliseconds(100));
+  instrumentation_.onLoopBusy(DispatcherInstrumentation::PublishInterval);
+  ASSERT_EQ(1, instrumentation_.snapshot().slowest_callbacks_.size());
+
+  runCallback(CallbackType::Post, microseconds(10));
+  instrumentation_.onLoopBusy(DispatcherInstrumentation::PublishInterval);
+  std::vector<DispatcherInstrumentation::SlowCallback> slowest =
+      instrumentation_.snapshot().slowest_callbacks_;
+  ASSERT_EQ(1, slowest.size());
+  EXPECT_EQ(CallbackType::Post, slowest[0].type_);
+  EXPECT_EQ(microseconds(10), slowest[0].duration_);
+
+  instrumentation_.onLoopBusy(DispatcherInstrumentation::PublishInterval);
+  EXPECT_TRUE(instrumentation_.snapshot().slowest_callbacks_.empty());
+}
+
+TEST_F(DispatcherInstrumentationTest, SnapshotAll) {
+  auto names = [] {
+    std::vector<std::string> names;
+    for (const auto& snapshot : DispatcherInstrumentation::snapshotAll()) {
+      names.push_back(snapshot.name_);
+    }
+    return names;
+  };
+  {
+    DispatcherInstrumentation other("another_thread", stats_, time_system_);
+    EXPECT_THAT(names(), testing::ElementsAre("another_thread", "test_thread"));
+  }
+  EXPECT_THAT(names(), testing::ElementsAre("test_thread"));
+}
+
+TEST_F(DispatcherInstrumentationTest, CallbackTypeName) {
+  EXPECT_EQ("file_event", DispatcherInstrumentation::callbackTypeName(CallbackType::FileEvent));
+  EXPECT_EQ("timer", DispatcherInstrumentation::callbackTypeName(CallbackType::Timer));
+  EXPECT_EQ("schedulable_callback",
+            DispatcherInstrumentation::callbackTypeName(CallbackType::SchedulableCallback));
+  EXPECT_EQ("post", DispatcherInstrumentation::callbackTypeName(CallbackType::Post));
+  EXPECT_EQ("deferred_delete",
+            DispatcherInstrumentation::callbackTypeName(CallbackType::DeferredDelete));
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
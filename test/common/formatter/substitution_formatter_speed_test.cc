@@ -1,6 +1,8 @@
 #include "source/common/formatter/substitution_formatter.h"
 #include "source/common/network/address_impl.h"
+#include "source/common/protobuf/utility.h"
 
+#include "test/common/stats/stat_test_utility.h"
 #include "test/common/stream_info/test_util.h"
 #include "test/mocks/http/mocks.h"
 
@@ -10,6 +12,25 @@ namespace Envoy {
 
 namespace {
 
+// Reports the heap bytes held per formatted line, by the output and any intermediate
+// representation returned by format_line, as the heap_bytes_per_line counter. This is measured
+// outside of the timed loop, and only where Memory::Stats is available, e.g. with tcmalloc.
+template <class FormatLine>
+void reportHeapBytesPerLine(benchmark::State& state, FormatLine format_line) {
+  if (Stats::TestUtil::MemoryTest::mode() == Stats::TestUtil::MemoryTest::Mode::Disabled) {
+    return;
+  }
+  constexpr size_t Lines = 100;
+  std::vector<decltype(format_line())> lines;
+  lines.reserve(Lines);
+  Stats::TestUtil::MemoryTest memory_test;
+  for (size_t i = 0; i < Lines; ++i) {
+    lines.push_back(format_line());
+  }
+  state.counters["heap_bytes_per_line"] =
+      static_cast<double>(memory_test.consumedBytes()) / Lines;
+}
+
 std::unique_ptr<Envoy::Formatter::JsonFormatterImpl> makeJsonFormatter(bool typed) {
   ProtobufWkt::Struct JsonLogFormat;
   const std::string format_yaml = R"EOF(
@@ -90,11 +111,14 @@ static void BM_AccessLogFormatter(benchmark::State& state) {
   Http::TestResponseHeaderMapImpl response_headers;
   Http::TestResponseTrailerMapImpl response_trailers;
   std::string body;
+  const auto format_line = [&]() {
+    return formatter->format(request_headers, response_headers, response_trailers, *stream_info,
+                             body);
+  };
   for (auto _ : state) { // NOLINT: Silences warning about dead store
-    output_bytes +=
-        formatter->format(request_headers, response_headers, response_trailers, *stream_info, body)
-            .length();
+    output_bytes += format_line().length();
   }
+  reportHeapBytesPerLine(state, format_line);
   benchmark::DoNotOptimize(output_bytes);
 }
 BENCHMARK(BM_AccessLogFormatter);
@@ -153,16 +177,47 @@ static void BM_JsonAccessLogFormatter(benchmark::State& state) {
   Http::TestResponseHeaderMapImpl response_headers;
   Http::TestResponseTrailerMapImpl response_trailers;
   std::string body;
+  const auto format_line = [&]() {
+    return json_formatter->format(request_headers, response_headers, response_trailers,
+                                  *stream_info, body);
+  };
   for (auto _ : state) { // NOLINT: Silences warning about dead store
-    output_bytes +=
-        json_formatter
-            ->format(request_headers, response_headers, response_trailers, *stream_info, body)
-            .length();
+    output_bytes += format_line().length();
   }
+  reportHeapBytesPerLine(state, format_line);
   benchmark::DoNotOptimize(output_bytes);
 }
 BENCHMARK(BM_JsonAccessLogFormatter);
 
+// Serializes the output of StructFormatter to JSON, as JsonFormatterImpl does when
+// envoy.reloadable_features.json_access_log_direct_serialization is disabled.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_JsonAccessLogFormatterViaStruct(benchmark::State& state) {
+  MockTimeSystem time_system;
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo(time_system);
+  std::unique_ptr<Envoy::Formatter::StructFormatter> struct_formatter = makeStructFormatter(false);
+
+  size_t output_bytes = 0;
+  Http::TestRequestHeaderMapImpl request_headers;
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  std::string body;
+  // The intermediate Struct is returned along with the line, so that its heap usage is reported.
+  const auto format_line = [&]() {
+    ProtobufWkt::Struct log_struct = struct_formatter->format(
+        request_headers, response_headers, response_trailers, *stream_info, body);
+    std::string line =
+        absl::StrCat(MessageUtil::getJsonStringFromMessageOrError(log_struct, false, true), "\n");
+    return std::make_pair(std::move(log_struct), std::move(line));
+  };
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes += format_line().second.length();
+  }
+  reportHeapBytesPerLine(state, format_line);
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_JsonAccessLogFormatterViaStruct);
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void BM_TypedJsonAccessLogFormatter(benchmark::State& state) {
   MockTimeSystem time_system;
@@ -175,12 +230,14 @@ static void BM_TypedJsonAccessLogFormatter(benchmark::State& state) {
   Http::TestResponseHeaderMapImpl response_headers;
   Http::TestResponseTrailerMapImpl response_trailers;
   std::string body;
+  const auto format_line = [&]() {
+    return typed_json_formatter->format(request_headers, response_headers, response_trailers,
+                                        *stream_info, body);
+  };
   for (auto _ : state) { // NOLINT: Silences warning about dead store
-    output_bytes +=
-        typed_json_formatter
-            ->format(request_headers, response_headers, response_trailers, *stream_info, body)
-            .length();
+    output_bytes += format_line().length();
   }
+  reportHeapBytesPerLine(state, format_line);
   benchmark::DoNotOptimize(output_bytes);
 }
 BENCHMARK(BM_TypedJsonAccessLogFormatter);
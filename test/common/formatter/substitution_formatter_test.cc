@@ -1,5 +1,6 @@
 #include <chrono>
 #include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -3660,6 +3661,166 @@ TEST(SubstitutionFormatterTest, JsonFormatterTest) {
   EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
 }
 
+// Serializing JSON directly produces the same output as serializing the Struct built by
+// StructFormatter.
+TEST(SubstitutionFormatterTest, JsonFormatterDirectSerialization) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{":method", "GET"},
+                                                {"quoted", "say \"hi\"\\\t\x01"}};
+  Http::TestResponseHeaderMapImpl response_header{{":status", "200"}};
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body = "local reply";
+
+  envoy::config::core::v3::Metadata metadata;
+  populateMetadataTestData(metadata);
+  EXPECT_CALL(stream_info, dynamicMetadata()).WillRepeatedly(ReturnRef(metadata));
+  EXPECT_CALL(Const(stream_info), dynamicMetadata()).WillRepeatedly(ReturnRef(metadata));
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    method: '%REQ(:METHOD)%'
+    quoted: '%REQ(QUOTED)%'
+    missing: '%REQ(MISSING)%'
+    truncated: '%REQ(:METHOD):2%'
+    composite: '%PROTOCOL% %REQ(MISSING)% %LOCAL_REPLY_BODY%'
+    number: 5.5
+    metadata: '%DYNAMIC_METADATA(com.test)%'
+    nested:
+      status: '%RESP(:STATUS)%'
+      empty:
+        missing: '%RESP(MISSING)%'
+    list:
+      - '%REQ(:METHOD)%'
+      - '%REQ(MISSING)%'
+      - plain
+  )EOF",
+                            key_mapping);
+
+  for (const bool preserve_types : {false, true}) {
+    for (const bool omit_empty_values : {false, true}) {
+      JsonFormatterImpl formatter(key_mapping, preserve_types, omit_empty_values);
+
+      std::string struct_json;
+      {
+        TestScopedRuntime scoped_runtime;
+        scoped_runtime.mergeValues(
+            {{"envoy.reloadable_features.json_access_log_direct_serialization", "false"}});
+        struct_json =
+            formatter.format(request_header, response_header, response_trailer, stream_info, body);
+      }
+      const std::string direct_json =
+          formatter.format(request_header, response_header, response_trailer, stream_info, body);
+
+      EXPECT_EQ('\n', direct_json.back());
+      EXPECT_TRUE(TestUtility::jsonStringEqual(direct_json, struct_json))
+          << "preserve_types=" << preserve_types << " omit_empty_values=" << omit_empty_values
+          << "\ndirect: " << direct_json << "struct: " << struct_json;
+    }
+  }
+}
+
+TEST(SubstitutionFormatterTest, JsonFormatterDirectSerializationAllValuesOmitted) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header;
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    missing: '%REQ(MISSING)%'
+    nested:
+      missing: '%RESP(MISSING)%'
+  )EOF",
+                            key_mapping);
+  JsonFormatterImpl formatter(key_mapping, false, true);
+
+  EXPECT_EQ("{}\n",
+            formatter.format(request_header, response_header, response_trailer, stream_info, body));
+}
+
+// Formats the value of the com.test:value dynamic metadata into a single property JSON line, with
+// or without serializing JSON directly.
+class JsonFormatterValueTest : public testing::Test {
+protected:
+  JsonFormatterValueTest() {
+    EXPECT_CALL(stream_info_, dynamicMetadata()).WillRepeatedly(ReturnRef(metadata_));
+    EXPECT_CALL(Const(stream_info_), dynamicMetadata()).WillRepeatedly(ReturnRef(metadata_));
+    TestUtility::loadFromYaml("value: '%DYNAMIC_METADATA(com.test:value)%'", key_mapping_);
+  }
+
+  std::string format(const ProtobufWkt::Value& value, bool direct) {
+    (*(*metadata_.mutable_filter_metadata())["com.test"].mutable_fields())["value"] = value;
+    TestScopedRuntime scoped_runtime;
+    scoped_runtime.mergeValues({{"envoy.reloadable_features.json_access_log_direct_serialization",
+                                 direct ? "true" : "false"}});
+    JsonFormatterImpl formatter(key_mapping_, true, false);
+    return formatter.format(request_header_, response_header_, response_trailer_, stream_info_,
+                            "");
+  }
+
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  envoy::config::core::v3::Metadata metadata_;
+  Http::TestRequestHeaderMapImpl request_header_;
+  Http::TestResponseHeaderMapImpl response_header_;
+  Http::TestResponseTrailerMapImpl response_trailer_;
+  ProtobufWkt::Struct key_mapping_;
+};
+
+// Numbers are written with the same digits as by the protobuf JSON printer.
+TEST_F(JsonFormatterValueTest, Numbers) {
+  for (const double number :
+       {0.0, -0.0, 200.0, -1.5, 0.1, 1.0 / 3, 123456.789, 1e15, 1e16, 1e21, 1.5e-7,
+        9007199254740993.0, std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::min()}) {
+    const ProtobufWkt::Value value = ValueUtil::numberValue(number);
+    EXPECT_EQ(format(value, false), format(value, true)) << "number=" << number;
+  }
+}
+
+TEST_F(JsonFormatterValueTest, Utf8Strings) {
+  for (const std::string str : {"caf\xc3\xa9", "\xe2\x82\xac 5", "\xf0\x9f\x98\x80",
+                                "\xe2\x80\xa8", "\x7f\x1f"}) {
+    const ProtobufWkt::Value value = ValueUtil::stringValue(str);
+    const std::string direct_json = format(value, true);
+    EXPECT_TRUE(TestUtility::jsonStringEqual(direct_json, format(value, false)))
+        << "direct: " << direct_json;
+  }
+}
+
+// Strings are escaped exactly as by the protobuf JSON printer, including '<', '>' and the
+// Unicode format characters, so that the serialized bytes are unchanged.
+TEST_F(JsonFormatterValueTest, EscapedStrings) {
+  for (const std::string str :
+       {"<script>alert(1)</script>", "say \"hi\"\\\b\f\n\r\t\x01\x1f\x7f", "\xc2\x80\xc2\x9f",
+        "soft\xc2\xadhyphen", "\xe2\x80\x8b\xe2\x80\xa8\xe2\x80\xa9\xe2\x80\xae", "\xef\xbb\xbf",
+        "\xef\xbf\xb9\xef\xbf\xbb", "\xd8\x80\xdb\x9d\xdc\x8f", "\xf0\x9d\x85\xb3",
+        "\xf3\xa0\x80\x81\xf3\xa0\x81\xbf", "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80"}) {
+    const ProtobufWkt::Value value = ValueUtil::stringValue(str);
+    EXPECT_EQ(format(value, false), format(value, true));
+  }
+}
+
+// Invalid UTF-8 is replaced as MessageUtil::sanitizeUtf8String() does, so that the line is valid
+// JSON.
+TEST_F(JsonFormatterValueTest, InvalidUtf8Strings) {
+  for (const std::string str : {"a\xff"
+                                "b",
+                                "\xc3", "\xc3\x28 \xe2\x82", "\xf8\x88\x80\x80\x80",
+                                "caf\xc3\xa9\x80"}) {
+    const std::string direct_json = format(ValueUtil::stringValue(str), true);
+    EXPECT_NO_THROW(Json::Factory::loadFromString(direct_json)) << direct_json;
+    EXPECT_TRUE(TestUtility::jsonStringEqual(
+        direct_json, format(ValueUtil::stringValue(MessageUtil::sanitizeUtf8String(str)), false)))
+        << "direct: " << direct_json;
+  }
+  EXPECT_EQ("{\"value\":\"a!b\"}\n", format(ValueUtil::stringValue("a\xff"
+                                                                     "b"),
+                                                true));
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
   Http::TestResponseHeaderMapImpl response_header{{"second", "PUT"}, {"test", "test"}};
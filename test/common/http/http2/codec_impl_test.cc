@@ -591,6 +591,58 @@ TEST_P(Http2CodecImplTest, SimpleRequestResponse) {
   }
 }
 
+TEST_P(Http2CodecImplTest, TrackHpackEncoding) {
+  client_http2_options_.set_track_hpack_encoding(true);
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_headers.addCopy("x-custom-header", "a-value-sent-with-every-request");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+  driveToCompletion();
+  const uint64_t fields = client_stats_store_.counter("http2.tx_hpack_fields").value();
+  EXPECT_LE(request_headers.size(), fields);
+  EXPECT_EQ(request_headers.byteSize(),
+            client_stats_store_.counter("http2.tx_hpack_uncompressed_bytes").value());
+
+  // The second request finds the fields of the first one in the dynamic table.
+  RequestEncoder* request_encoder2 = &client_->newStream(response_decoder_);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_TRUE(request_encoder2->encodeHeaders(request_headers, true).ok());
+  driveToCompletion();
+  EXPECT_EQ(2 * fields, client_stats_store_.counter("http2.tx_hpack_fields").value());
+  EXPECT_LE(2, client_stats_store_.counter("http2.tx_hpack_dynamic_table_hits").value());
+  EXPECT_LT(client_stats_store_.counter("http2.tx_hpack_encoded_bytes").value(),
+            client_stats_store_.counter("http2.tx_hpack_uncompressed_bytes").value());
+}
+
+// Verify that the headers of a stream reset before they were sent are not counted.
+TEST_P(Http2CodecImplTest, TrackHpackEncodingIgnoresHeadersOfResetStreams) {
+  server_http2_options_.set_track_hpack_encoding(true);
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false)).WillOnce(InvokeWithoutArgs([&]() {
+    // The response headers are submitted from the call stack of decodeHeaders, so they are only
+    // sent at the end of dispatch, by which time the reset discarded them.
+    TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+    response_encoder_->encodeHeaders(response_headers, false);
+    EXPECT_CALL(server_stream_callbacks_, onResetStream(StreamResetReason::LocalReset, _));
+    response_encoder_->getStream().resetStream(StreamResetReason::LocalReset);
+  }));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+
+  MockStreamCallbacks client_stream_callbacks;
+  request_encoder_->getStream().addCallbacks(client_stream_callbacks);
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, _)).Times(0);
+  EXPECT_CALL(client_stream_callbacks, onResetStream(StreamResetReason::RemoteReset, _));
+  driveToCompletion();
+  EXPECT_EQ(0, server_stats_store_.counter("http2.tx_hpack_uncompressed_bytes").value());
+  EXPECT_EQ(0, server_stats_store_.counter("http2.tx_hpack_fields").value());
+}
+
 TEST_P(Http2CodecImplTest, ShutdownNotice) {
   initialize();
   EXPECT_EQ(absl::nullopt, request_encoder_->http1StreamEncoderOptions());
@@ -2240,6 +2292,99 @@ TEST_P(Http2CodecImplFlowControlTest, LargeServerBodyFlushTimeoutAfterGoaway) {
   EXPECT_EQ(0, server_stats_store_.counter("http2.tx_flush_timeout").value());
 }
 
+// Verify that window autotuning grows the windows of a client that receives a response as fast as
+// its windows allow, and that the server sends into the grown windows.
+TEST_P(Http2CodecImplFlowControlTest, WindowAutotuningGrowsWindows) {
+  client_http2_options_.mutable_window_autotuning();
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+  driveToCompletion();
+
+  const uint32_t initial_window = getStreamReceiveWindowLimit(client_, 1);
+  ASSERT_EQ(65535, initial_window);
+
+  // The server fills the windows. The first DATA frame received by the client starts a sample,
+  // which counts the rest of the response body.
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(response_decoder_, decodeData(_, false)).Times(AnyNumber());
+  TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+  response_encoder_->encodeHeaders(response_headers, false);
+  Buffer::OwnedImpl body(std::string(initial_window, 'a'));
+  response_encoder_->encodeData(body, false);
+  driveClient();
+
+  // The PING is acknowledged a round trip later.
+  client_connection_.dispatcher_.globalTimeSystem().advanceTimeAsyncImpl(
+      std::chrono::milliseconds(50));
+  driveToCompletion();
+  EXPECT_EQ(1, client_stats_store_.counter("http2.stream_window_grown").value());
+  EXPECT_EQ(1, client_stats_store_.counter("http2.connection_window_grown").value());
+  EXPECT_EQ(0, client_stats_store_.counter("http2.stream_window_shrunk").value());
+
+  // The sample was the body less its first frame, and the windows were grown to twice that. With
+  // the body consumed, the server can send that much without waiting for window updates.
+  const uint32_t grown_window = 2 * (initial_window - 16 * 1024);
+  EXPECT_EQ(grown_window, getStreamReceiveWindowLimit(client_, 1));
+  EXPECT_EQ(grown_window, getStreamSendWindowSize(server_, 1));
+  EXPECT_EQ(grown_window, getSendWindowSize(server_));
+
+  EXPECT_CALL(response_decoder_, decodeData(_, true));
+  response_encoder_->encodeData(body, true);
+  driveToCompletion();
+}
+
+// Verify that a PING ACK that arrives late grows the windows no further than their configured
+// maximums, and leaves the buffer limits of existing and new streams at the initial window size.
+TEST_P(Http2CodecImplFlowControlTest, WindowAutotuningSlowPingAckKeepsLimits) {
+  const uint32_t max_window = 80000;
+  client_http2_options_.mutable_window_autotuning()->mutable_max_stream_window_size()->set_value(
+      max_window);
+  client_http2_options_.mutable_window_autotuning()
+      ->mutable_max_connection_window_size()
+      ->set_value(max_window);
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+  driveToCompletion();
+
+  const uint32_t initial_window = getStreamReceiveWindowLimit(client_, 1);
+  ASSERT_EQ(65535, initial_window);
+  EXPECT_EQ(initial_window, client_->getStream(1)->bufferLimit());
+
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(response_decoder_, decodeData(_, false)).Times(AnyNumber());
+  TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+  response_encoder_->encodeHeaders(response_headers, false);
+  Buffer::OwnedImpl body(std::string(initial_window, 'a'));
+  response_encoder_->encodeData(body, false);
+  driveClient();
+
+  // The PING is acknowledged seconds later. The sample would grow the windows past the maximum.
+  client_connection_.dispatcher_.globalTimeSystem().advanceTimeAsyncImpl(std::chrono::seconds(5));
+  driveToCompletion();
+  EXPECT_EQ(1, client_stats_store_.counter("http2.stream_window_grown").value());
+  EXPECT_LT(max_window, 2 * (initial_window - 16 * 1024));
+  EXPECT_EQ(max_window, getStreamReceiveWindowLimit(client_, 1));
+  EXPECT_EQ(max_window, getStreamSendWindowSize(server_, 1));
+  EXPECT_EQ(max_window, getSendWindowSize(server_));
+
+  // Only the receive windows grew: the buffer limits stay at the initial window size.
+  EXPECT_EQ(initial_window, client_->getStream(1)->bufferLimit());
+  MockResponseDecoder response_decoder2;
+  EXPECT_EQ(initial_window, client_->newStream(response_decoder2).getStream().bufferLimit());
+
+  EXPECT_CALL(response_decoder_, decodeData(_, true));
+  response_encoder_->encodeData(body, true);
+  driveToCompletion();
+}
+
 // Verify detection of downstream outbound frame queue by the WINDOW_UPDATE frames
 // sent when codec resumes reading.
 TEST_P(Http2CodecImplFlowControlTest, WindowUpdateOnReadResumingFlood) {
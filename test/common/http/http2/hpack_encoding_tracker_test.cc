@@ -0,0 +1,164 @@
+#include <sstream>
+#include <string>
+
+#include "source/common/http/http2/hpack_encoding_tracker.h"
+
+#include "test/common/stats/stat_test_utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+constexpr uint8_t DataFrame = 0x0;
+constexpr uint8_t HeadersFrame = 0x1;
+constexpr uint8_t SettingsFrame = 0x4;
+constexpr uint8_t ContinuationFrame = 0x9;
+constexpr uint8_t EndHeaders = 0x4;
+constexpr uint8_t Padded = 0x8;
+constexpr uint8_t Priority = 0x20;
+
+// Indexed :method GET and :path /, a literal foo: bar with incremental indexing, and the dynamic
+// table's first entry.
+const std::string HeaderBlock("\x82\x84\x40\x03"
+                              "foo\x03"
+                              "bar\xbe",
+                              12);
+
+std::string frame(uint8_t type, uint8_t flags, const std::string& payload) {
+  std::string frame;
+  frame.push_back(static_cast<char>(payload.size() >> 16));
+  frame.push_back(static_cast<char>(payload.size() >> 8));
+  frame.push_back(static_cast<char>(payload.size()));
+  frame.push_back(static_cast<char>(type));
+  frame.push_back(static_cast<char>(flags));
+  frame.append("\x00\x00\x00\x01", 4);
+  return frame + payload;
+}
+
+class HpackEncodingTrackerTest : public ::testing::Test {
+protected:
+  HpackEncodingTrackerTest() : stats_(CodecStats::atomicGet(stats_ptr_, *store_.rootScope())) {}
+
+  uint64_t counter(const std::string& name) { return store_.counter("http2." + name).value(); }
+
+  Stats::TestUtil::TestStore store_;
+  CodecStats::AtomicPtr stats_ptr_;
+  CodecStats& stats_;
+};
+
+TEST_F(HpackEncodingTrackerTest, CountsTableHits) {
+  HpackEncodingTracker tracker(stats_, false);
+  tracker.onHeaderListSent(30);
+  tracker.onBytesSent(frame(HeadersFrame, EndHeaders, HeaderBlock));
+
+  const HpackEncodingTracker::Counts& counts = tracker.counts();
+  EXPECT_EQ(counts.header_blocks_, 1);
+  EXPECT_EQ(counts.fields_, 4);
+  EXPECT_EQ(counts.static_table_hits_, 2);
+  EXPECT_EQ(counts.dynamic_table_hits_, 1);
+  EXPECT_EQ(counts.uncompressed_bytes_, 30);
+  EXPECT_EQ(counts.encoded_bytes_, HeaderBlock.size());
+
+  EXPECT_EQ(counter("tx_hpack_fields"), 4);
+  EXPECT_EQ(counter("tx_hpack_static_table_hits"), 2);
+  EXPECT_EQ(counter("tx_hpack_dynamic_table_hits"), 1);
+  EXPECT_EQ(counter("tx_hpack_uncompressed_bytes"), 30);
+  EXPECT_EQ(counter("tx_hpack_encoded_bytes"), HeaderBlock.size());
+}
+
+TEST_F(HpackEncodingTrackerTest, ParsesAllRepresentations) {
+  HpackEncodingTracker tracker(stats_, false);
+  // A table size update to 4096, a literal with an indexed name without indexing, and a literal
+  // never indexed with a Huffman encoded value.
+  const std::string block("\x3f\xe1\x1f"
+                          "\x04\x02/a"
+                          "\x10\x03"
+                          "abc\x81\x1f",
+                          14);
+  tracker.onBytesSent(frame(HeadersFrame, EndHeaders, block));
+  EXPECT_EQ(tracker.counts().header_blocks_, 1);
+  EXPECT_EQ(tracker.counts().fields_, 2);
+  EXPECT_EQ(tracker.counts().static_table_hits_, 0);
+  EXPECT_EQ(tracker.counts().dynamic_table_hits_, 0);
+}
+
+TEST_F(HpackEncodingTrackerTest, IgnoresOtherFrames) {
+  HpackEncodingTracker tracker(stats_, false);
+  tracker.onBytesSent(frame(SettingsFrame, 0, std::string(12, '\x82')) +
+                      frame(DataFrame, 0, std::string(100, '\xbe')) +
+                      frame(HeadersFrame, EndHeaders, HeaderBlock));
+  EXPECT_EQ(tracker.counts().header_blocks_, 1);
+  EXPECT_EQ(tracker.counts().fields_, 4);
+  EXPECT_EQ(tracker.counts().encoded_bytes_, HeaderBlock.size());
+}
+
+TEST_F(HpackEncodingTrackerTest, FramesSplitAcrossWrites) {
+  HpackEncodingTracker tracker(stats_, false);
+  const std::string frames =
+      frame(SettingsFrame, 0, "") + frame(HeadersFrame, EndHeaders, HeaderBlock);
+  for (char c : frames) {
+    tracker.onBytesSent(absl::string_view(&c, 1));
+  }
+  EXPECT_EQ(tracker.counts().header_blocks_, 1);
+  EXPECT_EQ(tracker.counts().fields_, 4);
+  EXPECT_EQ(tracker.counts().dynamic_table_hits_, 1);
+}
+
+TEST_F(HpackEncodingTrackerTest, HeaderBlockSplitAcrossContinuationFrames) {
+  HpackEncodingTracker tracker(stats_, false);
+  // The block is split in the middle of the literal.
+  tracker.onBytesSent(frame(HeadersFrame, 0, HeaderBlock.substr(0, 5)));
+  EXPECT_EQ(tracker.counts().header_blocks_, 0);
+  tracker.onBytesSent(frame(ContinuationFrame, 0, HeaderBlock.substr(5, 4)) +
+                      frame(ContinuationFrame, EndHeaders, HeaderBlock.substr(9)));
+  EXPECT_EQ(tracker.counts().header_blocks_, 1);
+  EXPECT_EQ(tracker.counts().fields_, 4);
+  EXPECT_EQ(tracker.counts().encoded_bytes_, HeaderBlock.size());
+}
+
+TEST_F(HpackEncodingTrackerTest, SkipsPaddingAndPriority) {
+  HpackEncodingTracker tracker(stats_, false);
+  const std::string payload =
+      std::string("\x03", 1) + std::string(5, '\x00') + HeaderBlock + std::string(3, '\x00');
+  tracker.onBytesSent(frame(HeadersFrame, EndHeaders | Padded | Priority, payload));
+  EXPECT_EQ(tracker.counts().header_blocks_, 1);
+  EXPECT_EQ(tracker.counts().fields_, 4);
+  EXPECT_EQ(tracker.counts().encoded_bytes_, HeaderBlock.size());
+}
+
+TEST_F(HpackEncodingTrackerTest, SkipsClientPreface) {
+  const std::string preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+  ASSERT_EQ(preface.size(), HpackEncodingTracker::ClientPrefaceSize);
+
+  HpackEncodingTracker tracker(stats_, true);
+  tracker.onBytesSent(preface.substr(0, 10));
+  tracker.onBytesSent(preface.substr(10) + frame(SettingsFrame, 0, "") +
+                      frame(HeadersFrame, EndHeaders, HeaderBlock));
+  EXPECT_EQ(tracker.counts().header_blocks_, 1);
+  EXPECT_EQ(tracker.counts().fields_, 4);
+}
+
+TEST_F(HpackEncodingTrackerTest, StopsAtMalformedHeaderBlock) {
+  HpackEncodingTracker tracker(stats_, false);
+  // The literal's name is longer than the rest of the block.
+  tracker.onBytesSent(frame(HeadersFrame, EndHeaders, std::string("\x82\x40\x05"
+                                                                  "ab",
+                                                                  5)));
+  tracker.onBytesSent(frame(HeadersFrame, EndHeaders, HeaderBlock));
+  EXPECT_EQ(tracker.counts().header_blocks_, 0);
+  EXPECT_EQ(tracker.counts().fields_, 0);
+  EXPECT_EQ(counter("tx_hpack_fields"), 0);
+
+  std::stringstream out;
+  tracker.dumpState(out, 0);
+  EXPECT_THAT(out.str(), testing::HasSubstr("failed_: 1"));
+}
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <chrono>
+
+#include "source/common/http/http2/window_autotuner.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+constexpr uint32_t InitialWindow = 65535;
+constexpr uint32_t MaxWindow = 16 * 1024 * 1024;
+constexpr uint64_t FrameSize = 16 * 1024;
+
+// Simulates a peer sending to a WindowAutotuner's connection over a link with a fixed round trip
+// time, as fast as the link and the flow-control windows allow.
+class WindowAutotunerTest : public ::testing::Test {
+protected:
+  // Runs `round_trips` round trips of a link that carries `link_bdp` bytes per round trip, and
+  // returns the number of bytes received in the last one.
+  uint64_t runRoundTrips(WindowAutotuner& tuner, uint64_t link_bdp, int round_trips) {
+    uint64_t received = 0;
+    for (int i = 0; i < round_trips; i++) {
+      // A single stream is limited by both windows.
+      received = std::min<uint64_t>({link_bdp, tuner.streamWindow(), tuner.connectionWindow()});
+      const MonotonicTime start = now_;
+      now_ += rtt_;
+      // The first frame of the round trip starts a sample if one is due. It is acknowledged after
+      // the rest of the round trip's data has been received.
+      if (tuner.onDataReceived(FrameSize, start)) {
+        tuner.onPingSent(++payload_, start);
+        tuner.onDataReceived(received, start + rtt_ / 2);
+        EXPECT_TRUE(tuner.onPingAck(payload_, now_));
+        EXPECT_EQ(tuner.lastSample(), received);
+        EXPECT_EQ(tuner.lastRoundTripTime(), rtt_);
+        samples_++;
+      }
+    }
+    return received;
+  }
+
+  const std::chrono::microseconds rtt_{std::chrono::milliseconds(50)};
+  MonotonicTime now_{};
+  uint64_t payload_{};
+  int samples_{};
+};
+
+// Over a link with a BDP of ~600KiB, such as 100Mbps with 50ms of delay, a 64KiB window caps
+// throughput at a tenth of the link, while autotuning reaches the link's throughput within a few
+// round trips and without growing the windows to more than twice the BDP.
+TEST_F(WindowAutotunerTest, ReachesThroughputOfDelayedLink) {
+  constexpr uint64_t LinkBdp = 100 * 1000 * 1000 / 8 / 20;
+
+  WindowAutotuner tuner(InitialWindow, MaxWindow, InitialWindow, MaxWindow);
+  EXPECT_EQ(runRoundTrips(tuner, LinkBdp, 1), InitialWindow);
+  EXPECT_EQ(runRoundTrips(tuner, LinkBdp, 5), LinkBdp);
+  EXPECT_GE(tuner.streamWindow(), LinkBdp);
+  EXPECT_LE(tuner.streamWindow(), 2 * LinkBdp);
+  EXPECT_GE(tuner.connectionWindow(), LinkBdp);
+  EXPECT_LE(tuner.connectionWindow(), 2 * LinkBdp);
+
+  // Windows without room to grow keep the throughput where it started.
+  WindowAutotuner static_windows(InitialWindow, InitialWindow, InitialWindow, InitialWindow);
+  EXPECT_EQ(runRoundTrips(static_windows, LinkBdp, 6), InitialWindow);
+}
+
+TEST_F(WindowAutotunerTest, WindowsDoNotGrowPastMax) {
+  WindowAutotuner tuner(InitialWindow, 200000, InitialWindow, 300000);
+  EXPECT_EQ(runRoundTrips(tuner, MaxWindow, 10), 200000);
+  EXPECT_EQ(tuner.streamWindow(), 200000);
+  EXPECT_EQ(tuner.connectionWindow(), 300000);
+}
+
+TEST_F(WindowAutotunerTest, WindowsDoNotGrowWhenNotLimitingThePeer) {
+  WindowAutotuner tuner(InitialWindow, MaxWindow, InitialWindow, MaxWindow);
+  runRoundTrips(tuner, InitialWindow / 2, 10);
+  EXPECT_EQ(tuner.streamWindow(), InitialWindow);
+  EXPECT_EQ(tuner.connectionWindow(), InitialWindow);
+}
+
+TEST_F(WindowAutotunerTest, OnlyStreamWindowShrinksWhenBdpDrops) {
+  WindowAutotuner tuner(InitialWindow, MaxWindow, InitialWindow, MaxWindow);
+  runRoundTrips(tuner, 1024 * 1024, 10);
+  const uint32_t grown_stream_window = tuner.streamWindow();
+  const uint32_t grown_connection_window = tuner.connectionWindow();
+  EXPECT_GE(grown_stream_window, 1024 * 1024);
+
+  // Two samples below a quarter of the window don't shrink it yet.
+  samples_ = 0;
+  while (samples_ < 2) {
+    runRoundTrips(tuner, 1000, 1);
+  }
+  EXPECT_EQ(tuner.streamWindow(), grown_stream_window);
+  while (samples_ < 3) {
+    runRoundTrips(tuner, 1000, 1);
+  }
+  EXPECT_EQ(tuner.streamWindow(), grown_stream_window / 2);
+
+  // It keeps halving, down to the initial window.
+  runRoundTrips(tuner, 1000, 1000);
+  EXPECT_EQ(tuner.streamWindow(), InitialWindow);
+  EXPECT_EQ(tuner.connectionWindow(), grown_connection_window);
+}
+
+TEST_F(WindowAutotunerTest, SamplesBackOffWhileWindowsAreStable) {
+  WindowAutotuner tuner(InitialWindow, MaxWindow, InitialWindow, MaxWindow);
+  // Every round trip is sampled while the windows grow.
+  runRoundTrips(tuner, 1024 * 1024, 6);
+  EXPECT_EQ(samples_, 6);
+
+  // Once they are stable, samples are at most MaxSampleInterval apart, about 20 round trips.
+  samples_ = 0;
+  runRoundTrips(tuner, 1024 * 1024, 200);
+  EXPECT_GE(samples_, 200 / 21);
+  EXPECT_LE(samples_, 20);
+}
+
+TEST_F(WindowAutotunerTest, AcksOfOtherPingsAreIgnored) {
+  WindowAutotuner tuner(InitialWindow, MaxWindow, InitialWindow, MaxWindow);
+  EXPECT_FALSE(tuner.onPingAck(1, now_));
+
+  ASSERT_TRUE(tuner.onDataReceived(FrameSize, now_));
+  tuner.onPingSent(2, now_);
+  // No new sample is started while one is outstanding.
+  EXPECT_FALSE(tuner.onDataReceived(InitialWindow, now_));
+  EXPECT_FALSE(tuner.onPingAck(1, now_ + rtt_));
+  EXPECT_EQ(tuner.streamWindow(), InitialWindow);
+
+  EXPECT_TRUE(tuner.onPingAck(2, now_ + rtt_));
+  EXPECT_EQ(tuner.streamWindow(), 2 * InitialWindow);
+  EXPECT_EQ(tuner.connectionWindow(), 2 * InitialWindow);
+  // A duplicate ACK does nothing.
+  EXPECT_FALSE(tuner.onPingAck(2, now_ + rtt_));
+}
+
+TEST_F(WindowAutotunerTest, MaxWindowsDefaultToMultipleOfInitialWindows) {
+  envoy::config::core::v3::Http2ProtocolOptions options;
+  options.mutable_initial_stream_window_size()->set_value(InitialWindow);
+  options.mutable_initial_connection_window_size()->set_value(2 * InitialWindow);
+  options.mutable_window_autotuning();
+  WindowAutotuner tuner(options);
+  runRoundTrips(tuner, MaxWindow * 4ULL, 20);
+  EXPECT_EQ(tuner.streamWindow(), WindowAutotuner::DefaultMaxWindowSizeMultiplier * InitialWindow);
+  EXPECT_EQ(tuner.connectionWindow(),
+            WindowAutotuner::DefaultMaxWindowSizeMultiplier * 2 * InitialWindow);
+
+  options.mutable_window_autotuning()->mutable_max_stream_window_size()->set_value(100000);
+  options.mutable_window_autotuning()->mutable_max_connection_window_size()->set_value(200000);
+  WindowAutotuner configured(options);
+  runRoundTrips(configured, MaxWindow, 20);
+  EXPECT_EQ(configured.streamWindow(), 100000);
+  EXPECT_EQ(configured.connectionWindow(), 200000);
+
+  // The defaults never exceed an absolute cap, however large the initial windows are.
+  options.mutable_window_autotuning()->Clear();
+  options.mutable_initial_stream_window_size()->set_value(4 * 1024 * 1024);
+  options.mutable_initial_connection_window_size()->set_value(8 * 1024 * 1024);
+  WindowAutotuner large(options);
+  runRoundTrips(large, 64ULL * MaxWindow, 20);
+  EXPECT_EQ(large.streamWindow(), WindowAutotuner::DefaultMaxWindowSize);
+  EXPECT_EQ(large.connectionWindow(), WindowAutotuner::DefaultMaxWindowSize);
+}
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
@@ -547,6 +547,43 @@ initial_connection_window_size: 65535
   }
 }
 
+TEST(HttpUtility, ValidateHttp2WindowAutotuning) {
+  {
+    const std::string yaml = R"EOF(
+initial_stream_window_size: 65535
+initial_connection_window_size: 65535
+window_autotuning:
+  max_stream_window_size: 1048576
+  max_connection_window_size: 65535
+    )EOF";
+    auto http2_options = parseHttp2OptionsFromV3Yaml(yaml);
+    EXPECT_EQ(1048576U, http2_options.window_autotuning().max_stream_window_size().value());
+    EXPECT_EQ(65535U, http2_options.window_autotuning().max_connection_window_size().value());
+  }
+
+  {
+    const std::string yaml = R"EOF(
+initial_stream_window_size: 1048576
+window_autotuning:
+  max_stream_window_size: 65535
+    )EOF";
+    EXPECT_THROW_WITH_MESSAGE(parseHttp2OptionsFromV3Yaml(yaml), EnvoyException,
+                              "window_autotuning.max_stream_window_size must not be smaller than "
+                              "initial_stream_window_size");
+  }
+
+  {
+    // The default initial connection window is larger than this maximum.
+    const std::string yaml = R"EOF(
+window_autotuning:
+  max_connection_window_size: 1048576
+    )EOF";
+    EXPECT_THROW_WITH_MESSAGE(parseHttp2OptionsFromV3Yaml(yaml), EnvoyException,
+                              "window_autotuning.max_connection_window_size must not be smaller "
+                              "than initial_connection_window_size");
+  }
+}
+
 TEST(HttpUtility, ValidateStreamErrors) {
   // Both false, the result should be false.
   envoy::config::core::v3::Http2ProtocolOptions http2_options;
@@ -67,6 +67,19 @@ INSTANTIATE_TEST_SUITE_P(InvalidPrepareMethodParamsTest, IoUringImplParamTest,
                              },
                              [](IoUring& uring, os_fd_t fd) -> IoUringResult {
                                return uring.prepareClose(fd, nullptr);
+                             },
+                             [](IoUring& uring, os_fd_t fd) -> IoUringResult {
+                               return uring.prepareOpenat(fd, "", O_RDONLY, 0, nullptr);
+                             },
+                             [](IoUring& uring, os_fd_t fd) -> IoUringResult {
+                               return uring.prepareStatx(fd, "", AT_EMPTY_PATH, STATX_BASIC_STATS,
+                                                         nullptr, nullptr);
+                             },
+                             [](IoUring& uring, os_fd_t fd) -> IoUringResult {
+                               return uring.prepareUnlinkat(fd, "", 0, nullptr);
+                             },
+                             [](IoUring& uring, os_fd_t fd) -> IoUringResult {
+                               return uring.prepareLinkat(fd, "", fd, "", 0, nullptr);
                              }));
 
 TEST_P(IoUringImplParamTest, InvalidParams) {
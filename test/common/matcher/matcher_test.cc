@@ -353,6 +353,78 @@ matcher_tree:
   EXPECT_NE(result.on_match_->action_cb_, nullptr);
 }
 
+// String matchers of OR-ed predicates on the same input are evaluated together, and must match
+// the same values as when evaluated one by one.
+TEST_F(MatcherTest, TestOrMatcherWithStringMatchersOnSameInput) {
+  const std::string yaml = R"EOF(
+matcher_list:
+  matchers:
+  - on_match:
+      action:
+        name: test_action
+        typed_config:
+          "@type": type.googleapis.com/google.protobuf.StringValue
+          value: match!!
+    predicate:
+      or_matcher:
+        predicate:
+        - single_predicate:
+            input:
+              name: inner_input
+              typed_config:
+                "@type": type.googleapis.com/google.protobuf.BoolValue
+            value_match:
+              exact: bar
+        - single_predicate:
+            input:
+              name: other_input
+              typed_config:
+                "@type": type.googleapis.com/google.protobuf.StringValue
+            value_match:
+              exact: fob
+        - single_predicate:
+            input:
+              name: inner_input
+              typed_config:
+                "@type": type.googleapis.com/google.protobuf.BoolValue
+            value_match:
+              suffix: OO
+              ignore_case: true
+        - single_predicate:
+            input:
+              name: inner_input
+              typed_config:
+                "@type": type.googleapis.com/google.protobuf.BoolValue
+            value_match:
+              safe_regex:
+                regex: "b[0-9]"
+  )EOF";
+
+  envoy::config::common::matcher::v3::Matcher matcher;
+  MessageUtil::loadFromYaml(yaml, matcher, ProtobufMessage::getStrictValidationVisitor());
+
+  TestUtility::validate(matcher);
+
+  auto other_factory = TestDataInputStringFactory("other");
+  const std::vector<std::pair<std::string, bool>> values{
+      {"bar", true}, {"foo", true}, {"FoO", true}, {"b7", true}, {"fob", false}, {"", false}};
+  for (const auto& [value, expected] : values) {
+    SCOPED_TRACE(value);
+    auto inner_factory = TestDataInputBoolFactory(value);
+
+    EXPECT_CALL(validation_visitor_,
+                performDataInputValidation(_, "type.googleapis.com/google.protobuf.StringValue"));
+    EXPECT_CALL(validation_visitor_,
+                performDataInputValidation(_, "type.googleapis.com/google.protobuf.BoolValue"))
+        .Times(3);
+    auto match_tree = factory_.create(matcher);
+
+    const auto result = match_tree()->match(TestData());
+    EXPECT_EQ(result.match_state_, MatchState::MatchComplete);
+    EXPECT_EQ(result.on_match_.has_value(), expected);
+  }
+}
+
 TEST_F(MatcherTest, TestNotMatcher) {
   const std::string yaml = R"EOF(
 matcher_list:
@@ -14,6 +14,7 @@
 #include "gtest/gtest.h"
 #include "quiche/quic/core/crypto/null_encrypter.h"
 #include "quiche/quic/core/deterministic_connection_id_generator.h"
+#include "quiche/quic/test_tools/quic_flow_controller_peer.h"
 
 namespace Envoy {
 namespace Quic {
@@ -247,6 +248,41 @@ TEST_F(EnvoyQuicClientStreamTest, PostRequestAndResponse) {
   quic_stream_->OnStreamFrame(frame);
 }
 
+// Tests that response body data spread across many DATA frames, more than the regions read by a
+// single GetReadableRegions() call, is delivered in a single decodeData() call with all the bytes
+// in order.
+TEST_F(EnvoyQuicClientStreamTest, ReadBodyFromMultipleRegions) {
+  EXPECT_TRUE(quic_stream_->encodeHeaders(request_headers_, /*end_stream=*/true).ok());
+  size_t offset = receiveResponseHeaders(false);
+
+  // Buffer the body in the sequencer while reading is disabled. It is larger than the initial
+  // flow-control windows.
+  quic::test::QuicFlowControllerPeer::SetReceiveWindowOffset(quic_stream_->flow_controller(),
+                                                             1024 * 1024);
+  quic::test::QuicFlowControllerPeer::SetReceiveWindowOffset(quic_session_.flow_controller(),
+                                                             1024 * 1024);
+  quic_stream_->readDisable(true);
+  std::string expected_body;
+  for (int i = 0; i < 40; ++i) {
+    std::string chunk(1000, 'a' + i % 26);
+    expected_body += chunk;
+    std::string data = bodyToHttp3StreamPayload(chunk);
+    quic::QuicStreamFrame frame(stream_id_, /*fin=*/i == 39, offset, data);
+    quic_stream_->OnStreamFrame(frame);
+    offset += data.length();
+  }
+  EXPECT_TRUE(quic_stream_->HasBytesToRead());
+
+  EXPECT_CALL(stream_decoder_, decodeData(_, _))
+      .WillOnce(Invoke([&expected_body](Buffer::Instance& buffer, bool finished_reading) {
+        EXPECT_EQ(expected_body, buffer.toString());
+        EXPECT_TRUE(finished_reading);
+      }));
+  quic_stream_->readDisable(false);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_FALSE(quic_stream_->HasBytesToRead());
+}
+
 TEST_F(EnvoyQuicClientStreamTest, PostRequestAndResponseWithAccounting) {
   EXPECT_EQ(absl::nullopt, quic_stream_->http1StreamEncoderOptions());
   EXPECT_EQ(0, quic_stream_->bytesMeter()->wireBytesSent());
@@ -23,6 +23,7 @@
 #include "quiche/quic/core/crypto/null_encrypter.h"
 #include "quiche/quic/core/deterministic_connection_id_generator.h"
 #include "quiche/quic/test_tools/quic_connection_peer.h"
+#include "quiche/quic/test_tools/quic_flow_controller_peer.h"
 #include "quiche/quic/test_tools/quic_session_peer.h"
 
 namespace Envoy {
@@ -475,6 +476,42 @@ TEST_F(EnvoyQuicServerStreamTest, ReadDisableUponLargePost) {
   EXPECT_CALL(stream_callbacks_, onResetStream(_, _));
 }
 
+// Tests that body data spread across many DATA frames, more than the regions read by a single
+// GetReadableRegions() call, is delivered in a single decodeData() call with all the bytes in
+// order.
+TEST_F(EnvoyQuicServerStreamTest, ReadBodyFromMultipleRegions) {
+  size_t payload_offset = receiveRequestHeaders(false);
+  // Buffer the body in the sequencer while reading is disabled. It is larger than the initial
+  // flow-control windows.
+  quic::test::QuicFlowControllerPeer::SetReceiveWindowOffset(quic_stream_->flow_controller(),
+                                                             1024 * 1024);
+  quic::test::QuicFlowControllerPeer::SetReceiveWindowOffset(quic_session_.flow_controller(),
+                                                             1024 * 1024);
+  quic_stream_->readDisable(true);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  std::string expected_body;
+  for (char c = 'a'; c < 'a' + 24; ++c) {
+    std::string chunk(1000, c);
+    expected_body += chunk;
+    std::string data = bodyToHttp3StreamPayload(chunk);
+    quic::QuicStreamFrame frame(stream_id_, false, payload_offset, data);
+    quic_stream_->OnStreamFrame(frame);
+    payload_offset += data.length();
+  }
+  EXPECT_TRUE(quic_stream_->HasBytesToRead());
+
+  EXPECT_CALL(stream_decoder_, decodeData(_, _))
+      .WillOnce(Invoke([&expected_body](Buffer::Instance& buffer, bool finished_reading) {
+        EXPECT_EQ(expected_body, buffer.toString());
+        EXPECT_FALSE(finished_reading);
+      }));
+  quic_stream_->readDisable(false);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_FALSE(quic_stream_->HasBytesToRead());
+
+  EXPECT_CALL(stream_callbacks_, onResetStream(_, _));
+}
+
 // Tests that readDisable() doesn't cause re-entry of OnBodyAvailable().
 TEST_F(EnvoyQuicServerStreamTest, ReadDisableAndReEnableImmediately) {
   std::string payload(1024, 'a');
@@ -0,0 +1,190 @@
+// Measures the throughput of the HTTP/3 stream receive path, from QUIC STREAM frames carrying
+// DATA frames to Http::StreamDecoder::decodeData(), for the body read by
+// EnvoyQuicStream::readBodyIntoBuffer(). Packets are handed to the stream in process, without
+// sockets or encryption, so that the cost measured is that of the stream and its sequencer.
+
+#include <memory>
+#include <string>
+
+#include "source/common/quic/envoy_quic_alarm_factory.h"
+#include "source/common/quic/envoy_quic_connection_helper.h"
+#include "source/common/quic/envoy_quic_server_connection.h"
+#include "source/common/quic/envoy_quic_server_session.h"
+#include "source/common/quic/envoy_quic_server_stream.h"
+#include "source/server/active_listener_base.h"
+
+#include "test/common/quic/test_utils.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/http/stream_decoder.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+#include "quiche/quic/test_tools/quic_connection_peer.h"
+#include "quiche/quic/test_tools/quic_flow_controller_peer.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Quic {
+namespace {
+
+// Counts the body bytes decoded, without the overhead of a mocked decodeData().
+class CountingRequestDecoder : public NiceMock<Http::MockRequestDecoder> {
+public:
+  void decodeData(Buffer::Instance& data, bool) override {
+    received_ += data.length();
+    decode_calls_++;
+    data.drain(data.length());
+  }
+
+  uint64_t received_{};
+  uint64_t decode_calls_{};
+};
+
+class StreamReceiveBenchmark {
+public:
+  StreamReceiveBenchmark()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        connection_helper_(*dispatcher_),
+        alarm_factory_(*dispatcher_, *connection_helper_.GetClock()),
+        quic_version_(quic::CurrentSupportedHttp3Versions()[0]),
+        listener_stats_({ALL_LISTENER_STATS(POOL_COUNTER(listener_config_.listenerScope()),
+                                            POOL_GAUGE(listener_config_.listenerScope()),
+                                            POOL_HISTOGRAM(listener_config_.listenerScope()))}),
+        quic_connection_(connection_helper_, alarm_factory_, writer_,
+                         quic::ParsedQuicVersionVector{quic_version_}, *listener_config_.socket_,
+                         connection_id_generator_),
+        quic_session_(quic_config_, {quic_version_}, &quic_connection_, *dispatcher_,
+                      quic_config_.GetInitialStreamFlowControlWindowToSend() * 2),
+        stats_(
+            {ALL_HTTP3_CODEC_STATS(POOL_COUNTER_PREFIX(listener_config_.listenerScope(), "http3."),
+                                   POOL_GAUGE_PREFIX(listener_config_.listenerScope(), "http3."))}),
+        quic_stream_(new EnvoyQuicServerStream(
+            kStreamId, &quic_session_, quic::BIDIRECTIONAL, stats_, http3_options_,
+            envoy::config::core::v3::HttpProtocolOptions::ALLOW)) {
+    quic_stream_->setRequestDecoder(decoder_);
+    quic::test::QuicConnectionPeer::SetAddressValidated(&quic_connection_);
+    quic_session_.ActivateStream(std::unique_ptr<EnvoyQuicServerStream>(quic_stream_));
+    ON_CALL(quic_session_, ShouldYield(_)).WillByDefault(Return(false));
+    ON_CALL(quic_session_, WritevData(_, _, _, _, _, _))
+        .WillByDefault(
+            Invoke([](quic::QuicStreamId, size_t write_length, quic::QuicStreamOffset,
+                      quic::StreamSendingState state, bool, absl::optional<quic::EncryptionLevel>) {
+              return quic::QuicConsumedData{write_length, state != quic::NO_FIN};
+            }));
+    ON_CALL(writer_, WritePacket(_, _, _, _, _))
+        .WillByDefault(Invoke([](const char*, size_t buf_len, const quic::QuicIpAddress&,
+                                 const quic::QuicSocketAddress&, quic::PerPacketOptions*) {
+          return quic::WriteResult{quic::WRITE_STATUS_OK, static_cast<int>(buf_len)};
+        }));
+
+    quic_session_.Initialize();
+    setQuicConfigWithDefaultValues(quic_session_.config());
+    quic_connection_.SetEncrypter(
+        quic::ENCRYPTION_FORWARD_SECURE,
+        std::make_unique<quic::test::TaggingEncrypter>(quic::ENCRYPTION_FORWARD_SECURE));
+    quic_connection_.SetDefaultEncryptionLevel(quic::ENCRYPTION_FORWARD_SECURE);
+    quic_session_.OnConfigNegotiated();
+    quic::SettingsFrame settings;
+    settings.values[quic::SETTINGS_H3_DATAGRAM] = 1;
+    quic_session_.OnSettingsFrame(settings);
+
+    // The body of the benchmark's single request is unbounded, so don't let flow control get in
+    // the way.
+    constexpr quic::QuicStreamOffset UnlimitedWindow = uint64_t(1) << 50;
+    quic::test::QuicFlowControllerPeer::SetReceiveWindowOffset(quic_stream_->flow_controller(),
+                                                               UnlimitedWindow);
+    quic::test::QuicFlowControllerPeer::SetReceiveWindowOffset(quic_session_.flow_controller(),
+                                                               UnlimitedWindow);
+
+    spdy::Http2HeaderBlock request_headers;
+    request_headers[":authority"] = "www.abc.com";
+    request_headers[":method"] = "POST";
+    request_headers[":path"] = "/";
+    request_headers[":scheme"] = "https";
+    receive(spdyHeaderToHttp3StreamPayload(request_headers));
+  }
+
+  ~StreamReceiveBenchmark() { quic_session_.close(Network::ConnectionCloseType::NoFlush); }
+
+  // Receives `frames` DATA frames of `frame_size` bytes of body each, in a STREAM frame each.
+  // If `buffered`, the stream's reading is disabled while they are received, so that they are
+  // read at once, as when a filter is above its buffer limit.
+  void receiveBody(uint32_t frames, uint32_t frame_size, bool buffered) {
+    if (data_frame_.size() != frame_size) {
+      data_frame_ = bodyToHttp3StreamPayload(std::string(frame_size, 'a'));
+    }
+    if (buffered) {
+      quic_stream_->readDisable(true);
+    }
+    for (uint32_t i = 0; i < frames; i++) {
+      receive(data_frame_);
+    }
+    if (buffered) {
+      quic_stream_->readDisable(false);
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  const CountingRequestDecoder& decoder() const { return decoder_; }
+
+private:
+  static constexpr quic::QuicStreamId kStreamId = 4u;
+
+  void receive(absl::string_view data) {
+    quic::QuicStreamFrame frame(kStreamId, false, offset_, data);
+    quic_stream_->OnStreamFrame(frame);
+    offset_ += data.length();
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  EnvoyQuicConnectionHelper connection_helper_;
+  EnvoyQuicAlarmFactory alarm_factory_;
+  NiceMock<quic::test::MockPacketWriter> writer_;
+  quic::ParsedQuicVersion quic_version_;
+  quic::QuicConfig quic_config_;
+  NiceMock<Network::MockListenerConfig> listener_config_;
+  CountingRequestDecoder decoder_;
+  Server::ListenerStats listener_stats_;
+  quic::DeterministicConnectionIdGenerator connection_id_generator_{
+      quic::kQuicDefaultConnectionIdLength};
+  NiceMock<MockEnvoyQuicServerConnection> quic_connection_;
+  NiceMock<MockEnvoyQuicSession> quic_session_;
+  Http::Http3::CodecStats stats_;
+  envoy::config::core::v3::Http3ProtocolOptions http3_options_;
+  EnvoyQuicServerStream* quic_stream_;
+  quic::QuicStreamOffset offset_{};
+  std::string data_frame_;
+};
+
+// Receives 64 DATA frames per iteration. The first argument is the size of a frame's body, and
+// the second is whether the frames are buffered in the sequencer and read at once, which reads
+// several frames per GetReadableRegions() call, or read as each one arrives.
+void bmReceiveBody(benchmark::State& state) {
+  constexpr uint32_t FramesPerIteration = 64;
+  const uint32_t frame_size = state.range(0);
+  const bool buffered = state.range(1) != 0;
+  StreamReceiveBenchmark bench;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    bench.receiveBody(FramesPerIteration, frame_size, buffered);
+  }
+
+  state.SetBytesProcessed(bench.decoder().received_);
+  state.counters["decode_calls_per_iteration"] =
+      benchmark::Counter(bench.decoder().decode_calls_, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(bmReceiveBody)
+    ->ArgsProduct({{1024, 4096, 16384}, {0, 1}})
+    ->ArgNames({"frame_size", "buffered"})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Quic
+} // namespace Envoy
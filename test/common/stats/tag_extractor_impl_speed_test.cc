@@ -46,6 +46,7 @@
 #include "source/common/config/well_known_names.h"
 #include "source/common/stats/tag_producer_impl.h"
 
+#include "absl/strings/str_cat.h"
 #include "benchmark/benchmark.h"
 
 namespace Envoy {
@@ -106,6 +107,47 @@ void BM_ExtractTags(benchmark::State& state) {
 }
 BENCHMARK(BM_ExtractTags)->DenseRange(0, 26, 1);
 
+// Measures the rate at which the stats of new clusters are tag-extracted, in the presence of the
+// given number of custom tag regexes on top of the default ones, as happens when CDS pushes
+// thousands of clusters. The second argument is whether the custom regexes can be prefiltered by
+// the regex set: otherwise they end with a \s*, which RE2 doesn't match as std::regex does, so
+// that they are evaluated for every name.
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ExtractTagsCustomRegexes(benchmark::State& state) {
+  envoy::config::metrics::v3::StatsConfig config;
+  const uint32_t num_custom_regexes = state.range(0);
+  const bool prefiltered = state.range(1) != 0;
+  for (uint32_t i = 0; i < num_custom_regexes; ++i) {
+    auto& specifier = *config.mutable_stats_tags()->Add();
+    specifier.set_tag_name(absl::StrCat("custom_tag_", i));
+    specifier.set_regex(
+        absl::StrCat("\\.(custom_tag_", i, "=(\\w+);)", prefiltered ? "" : "\\s*"));
+  }
+  TagProducerImpl tag_extractors{config};
+
+  constexpr uint32_t NumClusters = 1000;
+  std::vector<std::string> names;
+  names.reserve(NumClusters * 3);
+  for (uint32_t i = 0; i < NumClusters; ++i) {
+    names.push_back(absl::StrCat("cluster.cluster_", i, ".upstream_rq_200"));
+    names.push_back(absl::StrCat("cluster.cluster_", i, ".upstream_cx_total"));
+    names.push_back(absl::StrCat("cluster.cluster_", i, ".custom_tag_", i % 64, "=value;total"));
+  }
+
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (const std::string& name : names) {
+      TagVector tags;
+      tag_extractors.produceTags(name, tags);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_ExtractTagsCustomRegexes)
+    ->ArgsProduct({{0, 16, 64}, {0, 1}})
+    ->ArgNames({"regexes", "prefiltered"})
+    ->Unit(benchmark::kMillisecond);
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
@@ -119,6 +119,81 @@ TEST_F(TagProducerTest, DuplicateConfigCliTagBehavior) {
   }
 }
 
+// Configured extractors use std::regex. Those RE2 can match are prefiltered by a regex set, and
+// those using constructs unsupported by RE2 are evaluated for every stat name.
+TEST_F(TagProducerTest, StdRegexExtractorsWithoutPrefix) {
+  stats_config_.mutable_use_all_default_tags()->set_value(false);
+  addSpecifier("color", "\\.(color=(\\w+);)");
+  addSpecifier("shape", "\\.(shape=(\\w+);)");
+  // Lookaheads are supported by std::regex only.
+  addSpecifier("size", "(size=(\\d+);)(?=\\w)");
+  // Back-references are supported by std::regex only.
+  addSpecifier("twice", "\\.(twice=(\\w)\\2;)");
+  TagProducerImpl producer{stats_config_};
+
+  {
+    TagVector tags;
+    EXPECT_EQ("foo.bar", producer.produceTags("foo.color=red;bar", tags));
+    checkTags(TagVector{{"color", "red"}}, tags);
+  }
+  {
+    TagVector tags;
+    EXPECT_EQ("foo.bar", producer.produceTags("foo.shape=square;size=12;bar", tags));
+    checkTags(TagVector{{"shape", "square"}, {"size", "12"}}, tags);
+  }
+  {
+    TagVector tags;
+    EXPECT_EQ("foo.bar", producer.produceTags("foo.twice=aa;bar", tags));
+    checkTags(TagVector{{"twice", "a"}}, tags);
+  }
+  {
+    TagVector tags;
+    EXPECT_EQ("foo.color=;shape=12;bar", producer.produceTags("foo.color=;shape=12;bar", tags));
+    EXPECT_TRUE(tags.empty());
+  }
+}
+
+// std::regex extractors for which RE2 may match fewer strings aren't prefiltered, e.g. as RE2's \s
+// doesn't match \v, while the default RE2 extractors still are.
+TEST_F(TagProducerTest, RegexSetSkipsStdRegexesRe2MatchesLessOf) {
+  addSpecifier("space", "\\.(space=(\\w+)\\s)");
+  TagProducerImpl producer{stats_config_};
+
+  {
+    TagVector tags;
+    EXPECT_EQ("foo.bar", producer.produceTags("foo.space=a\vbar", tags));
+    checkTags(TagVector{{"space", "a"}}, tags);
+  }
+  {
+    TagVector tags;
+    EXPECT_EQ("foo.upstream_rq", producer.produceTags("foo.upstream_rq_200", tags));
+    checkTags(TagVector{{tag_name_values_.RESPONSE_CODE, "200"}}, tags);
+  }
+}
+
+// The order in which tags are extracted is the configuration order, whether or not extractors
+// are prefiltered by the regex set, and only the matched extractors of the set are evaluated.
+TEST_F(TagProducerTest, RegexSetPreservesOrder) {
+  stats_config_.mutable_use_all_default_tags()->set_value(false);
+  addSpecifier("first", "\\.(a=(\\w+);)");
+  // Lookaheads are supported by std::regex only, so this one is evaluated for every stat name.
+  addSpecifier("second", "\\.(b=(\\w+);)(?=\\w)");
+  addSpecifier("third", "\\.(c=(\\w+);)");
+  addSpecifier("fourth", "\\.(d=(\\w+);)");
+  TagProducerImpl producer{stats_config_};
+
+  {
+    TagVector tags;
+    EXPECT_EQ("x.y.z.w.", producer.produceTags("x.d=4;y.c=3;z.b=2;w.a=1;", tags));
+    checkTags(TagVector{{"first", "1"}, {"second", "2"}, {"third", "3"}, {"fourth", "4"}}, tags);
+  }
+  {
+    TagVector tags;
+    EXPECT_EQ("x.d=;y.", producer.produceTags("x.d=;y.c=3;", tags));
+    checkTags(TagVector{{"third", "3"}}, tags);
+  }
+}
+
 TEST_F(TagProducerTest, Fixed) {
   const TagVector tag_config{{"my-tag", "fixed"}};
   TagProducerImpl producer{stats_config_, tag_config};
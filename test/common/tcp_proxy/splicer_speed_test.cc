@@ -0,0 +1,177 @@
+// Measures the throughput of proxying bytes between two loopback socket pairs, either by splicing
+// them with the Splicer or by copying them through a buffer, as connections do without splicing.
+
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/tcp_proxy/splicer.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+constexpr uint64_t BytesPerIteration = 16 * 1024 * 1024;
+// The default per connection buffer limit, which also sizes the splice pipes.
+constexpr uint32_t BufferLimit = 1024 * 1024;
+
+class NoopSplicerCallbacks : public Splicer::Callbacks {
+public:
+  void onDownstreamBytesSpliced(uint64_t) override {}
+  void onUpstreamBytesSpliced(uint64_t) override {}
+};
+
+// Two socket pairs. The proxy owns one socket of each pair, which stand for the sockets of the
+// downstream and the upstream connection. The client writes to the other socket of the downstream
+// pair, and the server reads from the other socket of the upstream pair.
+class Loopback {
+public:
+  Loopback()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {
+    downstream_handle_ = createPair(client_fd_);
+    upstream_handle_ = createPair(server_fd_);
+  }
+
+  ~Loopback() {
+    os_sys_calls_.close(client_fd_);
+    os_sys_calls_.close(server_fd_);
+  }
+
+  // Sends bytes from the client to the server, in writes of chunk_size bytes, and runs the
+  // dispatcher until the server received all of them.
+  void transfer(uint64_t chunk_size) {
+    uint64_t to_send = BytesPerIteration;
+    uint64_t received = 0;
+    while (received < BytesPerIteration) {
+      if (to_send > 0) {
+        const Api::SysCallSizeResult result = os_sys_calls_.send(
+            client_fd_, chunk_.data(), std::min<uint64_t>(chunk_size, to_send), 0);
+        if (result.return_value_ > 0) {
+          to_send -= result.return_value_;
+        }
+      }
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      while (true) {
+        const Api::SysCallSizeResult result =
+            os_sys_calls_.recv(server_fd_, chunk_.data(), chunk_.size(), 0);
+        if (result.return_value_ <= 0) {
+          break;
+        }
+        received += result.return_value_;
+      }
+    }
+  }
+
+  Api::OsSysCalls& os_sys_calls_{Api::OsSysCallsSingleton::get()};
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  std::unique_ptr<Network::IoSocketHandleImpl> downstream_handle_;
+  std::unique_ptr<Network::IoSocketHandleImpl> upstream_handle_;
+  os_fd_t client_fd_{};
+  os_fd_t server_fd_{};
+  std::vector<char> chunk_ = std::vector<char>(BufferLimit, 'a');
+
+private:
+  std::unique_ptr<Network::IoSocketHandleImpl> createPair(os_fd_t& peer) {
+    os_fd_t fds[2];
+    RELEASE_ASSERT(os_sys_calls_
+                           .socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds)
+                           .return_value_ == 0,
+                   "");
+    peer = fds[1];
+    return std::make_unique<Network::IoSocketHandleImpl>(fds[0]);
+  }
+};
+
+// Copies the bytes read from the downstream socket to the upstream socket through a buffer, with
+// the same reads and writes as a connection using the raw buffer transport socket.
+class BufferedCopy {
+public:
+  BufferedCopy(Loopback& loopback) : loopback_(loopback) {
+    for (auto* handle : {loopback.downstream_handle_.get(), loopback.upstream_handle_.get()}) {
+      file_events_.push_back(loopback.dispatcher_->createFileEvent(
+          handle->fdDoNotUse(), [this](uint32_t) { copy(); }, Event::PlatformDefaultTriggerType,
+          Event::FileReadyType::Read | Event::FileReadyType::Write));
+    }
+  }
+
+private:
+  void copy() {
+    bool progress = true;
+    while (progress) {
+      progress = false;
+      if (buffer_.length() < BufferLimit) {
+        const Api::IoCallUint64Result result =
+            loopback_.downstream_handle_->read(buffer_, BufferLimit - buffer_.length());
+        progress |= result.ok() && result.return_value_ > 0;
+      }
+      if (buffer_.length() > 0) {
+        const Api::IoCallUint64Result result = loopback_.upstream_handle_->write(buffer_);
+        progress |= result.ok() && result.return_value_ > 0;
+      }
+    }
+  }
+
+  Loopback& loopback_;
+  Buffer::OwnedImpl buffer_;
+  std::vector<Event::FileEventPtr> file_events_;
+};
+
+void setupConnection(NiceMock<Network::MockConnection>& connection,
+                     Network::IoSocketHandleImpl& handle, Event::Dispatcher& dispatcher) {
+  ON_CALL(connection, rawIoHandle())
+      .WillByDefault(Return(Network::Connection::RawIoHandle{
+          Network::Connection::RawIoHandle::Status::Available, handle}));
+  ON_CALL(connection, dispatcher()).WillByDefault(ReturnRef(dispatcher));
+  ON_CALL(connection, bufferLimit()).WillByDefault(Return(BufferLimit));
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ProxyBufferedCopy(benchmark::State& state) {
+  Loopback loopback;
+  BufferedCopy copy(loopback);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    loopback.transfer(state.range(0));
+  }
+  state.SetBytesProcessed(state.iterations() * BytesPerIteration);
+}
+BENCHMARK(BM_ProxyBufferedCopy)->Arg(4096)->Arg(65536)->Arg(BufferLimit);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BM_ProxySplice(benchmark::State& state) {
+  Loopback loopback;
+  NiceMock<Network::MockConnection> downstream;
+  NiceMock<Network::MockConnection> upstream;
+  setupConnection(downstream, *loopback.downstream_handle_, *loopback.dispatcher_);
+  setupConnection(upstream, *loopback.upstream_handle_, *loopback.dispatcher_);
+  NoopSplicerCallbacks callbacks;
+  Splicer::CreateResult result = Splicer::create(downstream, upstream, callbacks);
+  if (result.status_ != Splicer::CreateStatus::Started) {
+    state.SkipWithError("splicing is not supported");
+    return;
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    loopback.transfer(state.range(0));
+  }
+  state.SetBytesProcessed(state.iterations() * BytesPerIteration);
+}
+BENCHMARK(BM_ProxySplice)->Arg(4096)->Arg(65536)->Arg(BufferLimit);
+
+} // namespace
+} // namespace TcpProxy
+} // namespace Envoy
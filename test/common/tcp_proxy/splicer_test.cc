@@ -0,0 +1,243 @@
+#include <sys/socket.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/common/tcp_proxy/splicer.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace TcpProxy {
+namespace {
+
+using RawIoHandleStatus = Network::Connection::RawIoHandle::Status;
+
+#if defined(__linux__)
+
+class TestSplicerCallbacks : public Splicer::Callbacks {
+public:
+  void onDownstreamBytesSpliced(uint64_t bytes) override { downstream_bytes_ += bytes; }
+  void onUpstreamBytesSpliced(uint64_t bytes) override { upstream_bytes_ += bytes; }
+
+  uint64_t downstream_bytes_{};
+  uint64_t upstream_bytes_{};
+};
+
+// Splices between two socket pairs. One socket of each pair stands in for the socket of a
+// connection, the other one for the peer at the other end of the connection.
+class SplicerTest : public testing::Test {
+protected:
+  SplicerTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {
+    setupConnection(downstream_, downstream_handle_, downstream_peer_, downstream_events_);
+    setupConnection(upstream_, upstream_handle_, upstream_peer_, upstream_events_);
+  }
+
+  ~SplicerTest() override {
+    splicer_.reset();
+    for (os_fd_t peer : {downstream_peer_, upstream_peer_}) {
+      if (peer != -1) {
+        os_sys_calls_.close(peer);
+      }
+    }
+  }
+
+  void setupConnection(NiceMock<Network::MockConnection>& connection,
+                       std::unique_ptr<Network::IoSocketHandleImpl>& handle, os_fd_t& peer,
+                       uint32_t& events) {
+    os_fd_t fds[2];
+    ASSERT_EQ(0, os_sys_calls_
+                     .socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds)
+                     .return_value_);
+    handle = std::make_unique<Network::IoSocketHandleImpl>(fds[0]);
+    peer = fds[1];
+    // The file event of the connection itself, which only sees the reads handed back to it.
+    handle->initializeFileEvent(
+        *dispatcher_, [&events](uint32_t ready) { events |= ready; },
+        Event::PlatformDefaultTriggerType, Event::FileReadyType::Write);
+    ON_CALL(connection, rawIoHandle())
+        .WillByDefault(
+            Return(Network::Connection::RawIoHandle{RawIoHandleStatus::Available, *handle}));
+    ON_CALL(connection, dispatcher()).WillByDefault(ReturnRef(*dispatcher_));
+    ON_CALL(connection, bufferLimit()).WillByDefault(Return(16384));
+  }
+
+  void startSplicing() {
+    EXPECT_CALL(downstream_, readDisable(true));
+    EXPECT_CALL(upstream_, readDisable(true));
+    Splicer::CreateResult result = Splicer::create(downstream_, upstream_, callbacks_);
+    ASSERT_EQ(Splicer::CreateStatus::Started, result.status_);
+    splicer_ = std::move(result.splicer_);
+    ASSERT_NE(nullptr, splicer_);
+  }
+
+  void send(os_fd_t fd, std::string data) {
+    while (!data.empty()) {
+      const Api::SysCallSizeResult result = os_sys_calls_.send(fd, data.data(), data.size(), 0);
+      if (result.return_value_ > 0) {
+        data.erase(0, result.return_value_);
+      }
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  // Runs the dispatcher until the peer received the given number of bytes, or gives up.
+  std::string receive(os_fd_t fd, uint64_t length) {
+    std::string received;
+    char buffer[16384];
+    for (int i = 0; i < 10000 && received.size() < length; ++i) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      const Api::SysCallSizeResult result = os_sys_calls_.recv(
+          fd, buffer, std::min<uint64_t>(sizeof(buffer), length - received.size()), 0);
+      if (result.return_value_ > 0) {
+        received.append(buffer, result.return_value_);
+      }
+    }
+    return received;
+  }
+
+  void runUntil(const std::function<bool()>& condition) {
+    for (int i = 0; i < 10000 && !condition(); ++i) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  Api::OsSysCalls& os_sys_calls_{Api::OsSysCallsSingleton::get()};
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  NiceMock<Network::MockConnection> downstream_;
+  NiceMock<Network::MockConnection> upstream_;
+  std::unique_ptr<Network::IoSocketHandleImpl> downstream_handle_;
+  std::unique_ptr<Network::IoSocketHandleImpl> upstream_handle_;
+  os_fd_t downstream_peer_{-1};
+  os_fd_t upstream_peer_{-1};
+  uint32_t downstream_events_{};
+  uint32_t upstream_events_{};
+  TestSplicerCallbacks callbacks_;
+  SplicerPtr splicer_;
+};
+
+// Connections which can't be bypassed are left alone, and the caller is told whether it is worth
+// trying again later.
+TEST_F(SplicerTest, NoRawIoHandle) {
+  EXPECT_CALL(downstream_, readDisable(_)).Times(0);
+  EXPECT_CALL(upstream_, readDisable(_)).Times(0);
+
+  EXPECT_CALL(upstream_, rawIoHandle())
+      .WillOnce(Return(Network::Connection::RawIoHandle{RawIoHandleStatus::NotYet, {}}));
+  Splicer::CreateResult result = Splicer::create(downstream_, upstream_, callbacks_);
+  EXPECT_EQ(Splicer::CreateStatus::RetryLater, result.status_);
+  EXPECT_EQ(nullptr, result.splicer_);
+
+  // A connection which can never be bypassed wins over one which can't be bypassed yet.
+  EXPECT_CALL(downstream_, rawIoHandle())
+      .WillOnce(Return(Network::Connection::RawIoHandle{RawIoHandleStatus::NotYet, {}}));
+  EXPECT_CALL(upstream_, rawIoHandle())
+      .WillOnce(Return(Network::Connection::RawIoHandle{RawIoHandleStatus::Never, {}}));
+  result = Splicer::create(downstream_, upstream_, callbacks_);
+  EXPECT_EQ(Splicer::CreateStatus::Never, result.status_);
+  EXPECT_EQ(nullptr, result.splicer_);
+}
+
+TEST_F(SplicerTest, BothDirections) {
+  startSplicing();
+
+  send(downstream_peer_, "hello");
+  EXPECT_EQ("hello", receive(upstream_peer_, 5));
+  send(upstream_peer_, "world!");
+  EXPECT_EQ("world!", receive(downstream_peer_, 6));
+
+  EXPECT_EQ(5, callbacks_.downstream_bytes_);
+  EXPECT_EQ(6, callbacks_.upstream_bytes_);
+  EXPECT_TRUE(splicer_->active());
+  // The connections never read themselves.
+  EXPECT_EQ(0, downstream_events_ & Event::FileReadyType::Read);
+  EXPECT_EQ(0, upstream_events_ & Event::FileReadyType::Read);
+}
+
+// Moves more bytes than the pipes hold, while the peers only read some of them at a time.
+TEST_F(SplicerTest, LargeTransfer) {
+  startSplicing();
+
+  const std::string data(1024 * 1024, 'a');
+  std::string received;
+  for (size_t offset = 0; offset < data.size(); offset += 64 * 1024) {
+    send(downstream_peer_, data.substr(offset, 64 * 1024));
+    received += receive(upstream_peer_, 64 * 1024);
+  }
+  EXPECT_EQ(data.size(), received.size());
+  EXPECT_EQ(data, received);
+  EXPECT_EQ(data.size(), callbacks_.downstream_bytes_);
+}
+
+// The end of stream of a source is left for the connection to read, once the bytes before it have
+// been spliced. The other direction keeps splicing.
+TEST_F(SplicerTest, EndOfStreamHandedBack) {
+  startSplicing();
+
+  send(downstream_peer_, "hello");
+  ASSERT_EQ(0, os_sys_calls_.shutdown(downstream_peer_, SHUT_WR).return_value_);
+  EXPECT_CALL(downstream_, readDisable(false));
+  EXPECT_EQ("hello", receive(upstream_peer_, 5));
+  runUntil([this]() { return (downstream_events_ & Event::FileReadyType::Read) != 0; });
+  EXPECT_NE(0, downstream_events_ & Event::FileReadyType::Read);
+  EXPECT_TRUE(splicer_->active());
+
+  send(upstream_peer_, "world");
+  EXPECT_EQ("world", receive(downstream_peer_, 5));
+
+  ASSERT_EQ(0, os_sys_calls_.shutdown(upstream_peer_, SHUT_WR).return_value_);
+  EXPECT_CALL(upstream_, readDisable(false));
+  runUntil([this]() { return (upstream_events_ & Event::FileReadyType::Read) != 0; });
+  EXPECT_NE(0, upstream_events_ & Event::FileReadyType::Read);
+  EXPECT_FALSE(splicer_->active());
+}
+
+// A connection closes its socket before the splicer is destroyed from the close event. The splicer
+// works on a duplicate of the socket, so its file events stay valid until it is destroyed, which
+// fully closes the socket.
+TEST_F(SplicerTest, ConnectionClosedBeforeSplicerDestroyed) {
+  startSplicing();
+
+  ASSERT_TRUE(downstream_handle_->close().ok());
+  send(upstream_peer_, "world");
+  EXPECT_EQ("world", receive(downstream_peer_, 5));
+
+  char buffer[16];
+  EXPECT_EQ(-1, os_sys_calls_.recv(downstream_peer_, buffer, sizeof(buffer), 0).return_value_);
+  splicer_.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(0, os_sys_calls_.recv(downstream_peer_, buffer, sizeof(buffer), 0).return_value_);
+}
+
+// Both connections are handed back when splicing fails, so that they see the error themselves.
+TEST_F(SplicerTest, ErrorHandsBackBothConnections) {
+  startSplicing();
+
+  os_sys_calls_.close(upstream_peer_);
+  upstream_peer_ = -1;
+  EXPECT_CALL(downstream_, readDisable(false));
+  EXPECT_CALL(upstream_, readDisable(false));
+  send(downstream_peer_, "hello");
+  runUntil([this]() { return !splicer_->active(); });
+  EXPECT_FALSE(splicer_->active());
+}
+
+#endif
+
+} // namespace
+} // namespace TcpProxy
+} // namespace Envoy
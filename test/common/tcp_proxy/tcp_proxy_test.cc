@@ -190,6 +190,67 @@ TEST_F(TcpProxyTest, HalfCloseProxy) {
   upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
 }
 
+// Tests that connections which can never be spliced keep proxying through the buffers, without
+// retrying to splice them.
+TEST_F(TcpProxyTest, SpliceNotPossible) {
+  envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy config = defaultConfig();
+  config.set_use_splice(true);
+  setup(1, config);
+
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(0, filter_callbacks_.connection_.bytes_sent_callbacks_.size());
+  EXPECT_EQ(0, upstream_connections_.at(0)->bytes_sent_callbacks_.size());
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+
+  Buffer::OwnedImpl response("world");
+  EXPECT_CALL(filter_callbacks_.connection_, write(BufferEqual(&response), _));
+  upstream_callbacks_->onUpstreamData(response, false);
+
+  EXPECT_EQ(0, config_->stats().downstream_cx_splice_total_.value());
+
+  EXPECT_CALL(filter_callbacks_.connection_, close(_));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+}
+
+#if defined(__linux__)
+// Tests that splicing is retried whenever bytes have been written while either connection can't
+// be spliced yet, and that it stops being retried once either connection can never be spliced.
+TEST_F(TcpProxyTest, SpliceRetriedUntilNeverPossible) {
+  envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy config = defaultConfig();
+  config.set_use_splice(true);
+  setup(1, config);
+
+  using RawIoHandle = Network::Connection::RawIoHandle;
+  EXPECT_CALL(filter_callbacks_.connection_, rawIoHandle())
+      .WillOnce(Return(RawIoHandle{RawIoHandle::Status::NotYet, {}}))
+      .WillOnce(Return(RawIoHandle{RawIoHandle::Status::NotYet, {}}))
+      .WillOnce(Return(RawIoHandle{RawIoHandle::Status::Never, {}}));
+  EXPECT_CALL(*upstream_connections_.at(0), rawIoHandle())
+      .Times(3)
+      .WillRepeatedly(Return(RawIoHandle{RawIoHandle::Status::NotYet, {}}));
+
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(1, filter_callbacks_.connection_.bytes_sent_callbacks_.size());
+  EXPECT_EQ(1, upstream_connections_.at(0)->bytes_sent_callbacks_.size());
+
+  // Still not possible, so the callback is kept.
+  upstream_connections_.at(0)->raiseBytesSentCallbacks(5);
+  EXPECT_EQ(1, upstream_connections_.at(0)->bytes_sent_callbacks_.size());
+
+  // Never possible, so the callback is removed.
+  filter_callbacks_.connection_.raiseBytesSentCallbacks(5);
+  EXPECT_EQ(0, filter_callbacks_.connection_.bytes_sent_callbacks_.size());
+
+  EXPECT_EQ(0, config_->stats().downstream_cx_splice_total_.value());
+
+  EXPECT_CALL(filter_callbacks_.connection_, close(_));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+}
+#endif
+
 // Test with an explicitly configured upstream.
 TEST_F(TcpProxyTest, ExplicitFactory) {
   // Explicitly configure an HTTP upstream, to test factory creation.
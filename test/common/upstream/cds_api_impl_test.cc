@@ -7,6 +7,7 @@
 #include "envoy/config/core/v3/config_source.pb.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
+#include "source/common/config/decoded_resource_impl.h"
 #include "source/common/config/utility.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/upstream/cds_api_impl.h"
@@ -16,6 +17,7 @@
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/cluster_priority_set.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -313,7 +315,7 @@ resources:
       TestUtility::parseYaml<envoy::service::discovery::v3::DiscoveryResponse>(response2_yaml);
 
   EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({"cluster1", "cluster2"})));
-  expectAdd("cluster1", "1");
+  // cluster1 is unchanged, and is not handed to the cluster manager again.
   expectAdd("cluster3", "1");
   EXPECT_CALL(cm_, removeCluster("cluster2"));
   const auto decoded_resources_2 =
@@ -321,6 +323,133 @@ resources:
   cds_callbacks_->onConfigUpdate(decoded_resources_2.refvec_, response2.version_info());
 
   EXPECT_EQ("1", cds_->versionInfo());
+  EXPECT_EQ(3, TestUtility::findCounter(store_, "cluster_manager.cds.cluster_applied")->value());
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "cluster_manager.cds.cluster_skipped")->value());
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "cluster_manager.cds.cluster_skipped_by_wire_hash")
+                   ->value());
+}
+
+// Validate that clusters resent unchanged are skipped before being compared by the cluster manager,
+// and that changed or re-added clusters are not.
+TEST_F(CdsApiImplTest, SkipClustersWithUnchangedWireHash) {
+  InSequence s;
+
+  setup();
+
+  envoy::config::cluster::v3::Cluster cluster;
+  cluster.set_name("cluster1");
+  const auto send_update = [&](const std::string& version) {
+    envoy::service::discovery::v3::DiscoveryResponse response;
+    response.set_version_info(version);
+    response.add_resources()->PackFrom(cluster);
+    const auto decoded_resources =
+        TestUtility::decodeResources<envoy::config::cluster::v3::Cluster>(response);
+    cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, version);
+  };
+
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+  expectAdd("cluster1", "0");
+  EXPECT_CALL(initialized_, ready());
+  send_update("0");
+
+  // Resending the same cluster doesn't update it, nor the version.
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({"cluster1"})));
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _)).Times(0);
+  send_update("1");
+  EXPECT_EQ("0", cds_->versionInfo());
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "cluster_manager.cds.cluster_skipped_by_wire_hash")
+                   ->value());
+
+  // A changed cluster is handed to the cluster manager.
+  cluster.mutable_connect_timeout()->set_seconds(1);
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({"cluster1"})));
+  expectAdd("cluster1", "2");
+  send_update("2");
+  EXPECT_EQ("2", cds_->versionInfo());
+
+  // A cluster which was removed is added again, even if it is the same as before its removal.
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({"cluster1"})));
+  EXPECT_CALL(cm_, removeCluster("cluster1")).WillOnce(Return(true));
+  const auto no_resources = TestUtility::decodeResources<envoy::config::cluster::v3::Cluster>(
+      envoy::service::discovery::v3::DiscoveryResponse());
+  cds_callbacks_->onConfigUpdate(no_resources.refvec_, "3");
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+  expectAdd("cluster1", "4");
+  send_update("4");
+
+  EXPECT_EQ(3, TestUtility::findCounter(store_, "cluster_manager.cds.cluster_applied")->value());
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "cluster_manager.cds.cluster_skipped")->value());
+}
+
+// Validate that a changed cluster resent with a colliding wire hash is still handed to the cluster
+// manager.
+TEST_F(CdsApiImplTest, SkipClustersWithUnchangedWireHashCollision) {
+  InSequence s;
+
+  setup();
+
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::cluster::v3::Cluster> resource_decoder(
+      "name");
+  envoy::config::cluster::v3::Cluster cluster;
+  cluster.set_name("cluster1");
+  const auto send_update = [&](const std::string& version) {
+    ProtobufWkt::Any resource;
+    resource.PackFrom(cluster);
+    // All resources have the same wire hash.
+    const auto decoded_resource =
+        Config::DecodedResourceImpl::fromResource(resource_decoder, resource, version, 42);
+    cds_callbacks_->onConfigUpdate({*decoded_resource}, version);
+  };
+
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+  expectAdd("cluster1", "0");
+  EXPECT_CALL(initialized_, ready());
+  send_update("0");
+
+  cluster.mutable_connect_timeout()->set_seconds(1);
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({"cluster1"})));
+  expectAdd("cluster1", "1");
+  send_update("1");
+  EXPECT_EQ("1", cds_->versionInfo());
+
+  // The same cluster is still skipped.
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({"cluster1"})));
+  EXPECT_CALL(cm_, addOrUpdateCluster(_, _)).Times(0);
+  send_update("2");
+  EXPECT_EQ("1", cds_->versionInfo());
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "cluster_manager.cds.cluster_skipped_by_wire_hash")
+                   ->value());
+}
+
+// Validate that unchanged clusters are handed to the cluster manager when skipping them by their
+// wire hash is disabled.
+TEST_F(CdsApiImplTest, SkipClustersWithUnchangedWireHashDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.cds_skip_clusters_with_unchanged_wire_hash", "false"}});
+  InSequence s;
+
+  setup();
+
+  envoy::service::discovery::v3::DiscoveryResponse response;
+  envoy::config::cluster::v3::Cluster cluster;
+  cluster.set_name("cluster1");
+  response.add_resources()->PackFrom(cluster);
+  const auto decoded_resources =
+      TestUtility::decodeResources<envoy::config::cluster::v3::Cluster>(response);
+
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+  expectAdd("cluster1", "0");
+  EXPECT_CALL(initialized_, ready());
+  cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "0");
+
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({"cluster1"})));
+  EXPECT_CALL(cm_, addOrUpdateCluster(WithName("cluster1"), _)).WillOnce(Return(false));
+  cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "1");
+  EXPECT_EQ("0", cds_->versionInfo());
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "cluster_manager.cds.cluster_skipped")->value());
+  EXPECT_EQ(0, TestUtility::findCounter(store_, "cluster_manager.cds.cluster_skipped_by_wire_hash")
+                   ->value());
 }
 
 // Validate behavior when the config is delivered but it fails PGV validation.
@@ -0,0 +1,88 @@
+#include "source/common/upstream/inherited_host_health.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/common.h"
+#include "test/mocks/upstream/cluster.h"
+#include "test/mocks/upstream/health_checker.h"
+#include "test/mocks/upstream/host.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class InheritedHostHealthTest : public testing::Test {
+public:
+  InheritedHostHealthTest() { cluster_.info_->name_ = "cluster_0"; }
+
+  HostSharedPtr makeHost(const std::string& url) {
+    return makeTestHost(cluster_.info_, url, time_source_);
+  }
+
+  NiceMock<MockCluster> cluster_;
+  NiceMock<MockTimeSystem> time_source_;
+  NiceMock<MockHealthChecker> health_checker_;
+  NiceMock<Outlier::MockDetector> outlier_detector_;
+};
+
+// Without a parent, hosts start out as usual.
+TEST_F(InheritedHostHealthTest, NoParent) {
+  EXPECT_CALL(cluster_, healthChecker()).Times(0);
+  HostSharedPtr host = makeHost("tcp://10.0.0.1:80");
+  EXPECT_FALSE(InheritedHostHealth::apply(cluster_, *host));
+  EXPECT_EQ(Host::Health::Healthy, host->coarseHealth());
+}
+
+// Hosts inherit the health flags of the host of the same cluster and address, once.
+TEST_F(InheritedHostHealthTest, Apply) {
+  ON_CALL(cluster_, healthChecker()).WillByDefault(Return(&health_checker_));
+  ON_CALL(cluster_, outlierDetector()).WillByDefault(Return(&outlier_detector_));
+  ScopedInheritedHostHealth inherited(std::make_unique<InheritedHostHealth>());
+  inherited.instance().add("cluster_0", "10.0.0.1:80", {});
+  inherited.instance().add("cluster_0", "10.0.0.2:80", {true, false, false});
+  inherited.instance().add("cluster_0", "10.0.0.3:80", {false, true, true});
+  inherited.instance().add("cluster_1", "10.0.0.4:80", {});
+
+  HostSharedPtr healthy = makeHost("tcp://10.0.0.1:80");
+  EXPECT_TRUE(InheritedHostHealth::apply(cluster_, *healthy));
+  EXPECT_EQ(Host::Health::Healthy, healthy->coarseHealth());
+
+  HostSharedPtr failed = makeHost("tcp://10.0.0.2:80");
+  EXPECT_TRUE(InheritedHostHealth::apply(cluster_, *failed));
+  EXPECT_TRUE(failed->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC));
+  EXPECT_FALSE(failed->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+
+  HostSharedPtr ejected = makeHost("tcp://10.0.0.3:80");
+  EXPECT_TRUE(InheritedHostHealth::apply(cluster_, *ejected));
+  EXPECT_FALSE(ejected->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC));
+  EXPECT_TRUE(ejected->healthFlagGet(Host::HealthFlag::DEGRADED_ACTIVE_HC));
+  EXPECT_TRUE(ejected->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+
+  // The host of another cluster doesn't match.
+  EXPECT_FALSE(InheritedHostHealth::apply(cluster_, *makeHost("tcp://10.0.0.4:80")));
+  EXPECT_EQ(1, inherited.instance().size());
+
+  // The health of a host is only inherited the first time it's created.
+  EXPECT_FALSE(InheritedHostHealth::apply(cluster_, *makeHost("tcp://10.0.0.2:80")));
+}
+
+// Active health checking flags are only inherited with a health checker, and ejections only with
+// an outlier detector.
+TEST_F(InheritedHostHealthTest, NoHealthCheckerOrOutlierDetector) {
+  ScopedInheritedHostHealth inherited(std::make_unique<InheritedHostHealth>());
+  inherited.instance().add("cluster_0", "10.0.0.1:80", {true, false, true});
+
+  HostSharedPtr host = makeHost("tcp://10.0.0.1:80");
+  EXPECT_FALSE(InheritedHostHealth::apply(cluster_, *host));
+  EXPECT_EQ(Host::Health::Healthy, host->coarseHealth());
+  EXPECT_EQ(0, inherited.instance().size());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
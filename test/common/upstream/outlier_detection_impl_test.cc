@@ -282,6 +282,41 @@ TEST_F(OutlierDetectorImplTest, DestroyHostInUse) {
   loadRq(hosts_[0], 5, 500);
 }
 
+// A host ejected by the parent process during a hot restart is already ejected when it's added,
+// and is unejected after a base ejection time.
+TEST_F(OutlierDetectorImplTest, InheritedEjection) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({"tcp://127.0.0.1:80"});
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(cluster_, empty_outlier_detection_,
+                                                              dispatcher_, runtime_, time_system_,
+                                                              event_logger_, random_));
+  detector->addChangedStateCb([&](HostSharedPtr host) -> void { checker_.check(host); });
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(0));
+  addHosts({"tcp://127.0.0.1:81"});
+  hosts_[1]->healthFlagSet(Host::HealthFlag::FAILED_OUTLIER_CHECK);
+  cluster_.prioritySet().getMockHostSet(0)->runCallbacks({hosts_[1]}, {});
+  EXPECT_EQ(1UL, outlier_detection_ejections_active_.value());
+  EXPECT_EQ(1UL, hosts_[1]->outlierDetector().numEjections());
+
+  // Interval that doesn't bring the host back in.
+  time_system_.setMonotonicTime(std::chrono::milliseconds(29999));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_TRUE(hosts_[1]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+
+  // Interval that does bring the host back in.
+  time_system_.setMonotonicTime(std::chrono::milliseconds(30000));
+  EXPECT_CALL(checker_, check(hosts_[1]));
+  EXPECT_CALL(*event_logger_,
+              logUneject(std::static_pointer_cast<const HostDescription>(hosts_[1])));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_FALSE(hosts_[1]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(0UL, outlier_detection_ejections_active_.value());
+}
+
 /*
  Tests scenario when connect errors are reported by Non-http codes and success is reported by
  http codes. (this happens in http router).
@@ -22,6 +22,7 @@
 #include "source/common/network/transport_socket_options_impl.h"
 #include "source/common/network/utility.h"
 #include "source/common/singleton/manager_impl.h"
+#include "source/common/upstream/inherited_host_health.h"
 #include "source/extensions/clusters/static/static_cluster.h"
 #include "source/extensions/clusters/strict_dns/strict_dns_cluster.h"
 #include "source/server/transport_socket_config_impl.h"
@@ -2221,6 +2222,128 @@ TEST_F(StaticClusterImplTest, HealthyStat) {
   EXPECT_EQ(0UL, cluster.info()->endpointStats().membership_degraded_.value());
 }
 
+// During a hot restart, hosts start out with the health the parent last saw, and hosts which were
+// healthy there don't hold up initialization.
+TEST_F(StaticClusterImplTest, InheritedHostHealth) {
+  const std::string yaml = R"EOF(
+    name: addressportconfig
+    connect_timeout: 0.25s
+    type: static
+    lb_policy: random
+    load_assignment:
+        endpoints:
+          - lb_endpoints:
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 10.0.0.1
+                    port_value: 11001
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 10.0.0.1
+                    port_value: 11002
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 10.0.0.1
+                    port_value: 11003
+  )EOF";
+
+  ScopedInheritedHostHealth inherited_host_health(std::make_unique<InheritedHostHealth>());
+  inherited_host_health.instance().add("addressportconfig", "10.0.0.1:11001", {});
+  inherited_host_health.instance().add("addressportconfig", "10.0.0.1:11002",
+                                       {false, false, true});
+
+  envoy::config::cluster::v3::Cluster cluster_config = parseClusterFromV3Yaml(yaml);
+
+  Envoy::Upstream::ClusterFactoryContextImpl factory_context(
+      server_context_, server_context_.cluster_manager_, stats_, nullptr, ssl_context_manager_,
+      nullptr, false, validation_visitor_);
+  StaticClusterImpl cluster(server_context_, cluster_config, factory_context, runtime_, false);
+
+  Outlier::MockDetector* outlier_detector = new NiceMock<Outlier::MockDetector>();
+  cluster.setOutlierDetector(Outlier::DetectorSharedPtr{outlier_detector});
+
+  std::shared_ptr<MockHealthChecker> health_checker(new NiceMock<MockHealthChecker>());
+  cluster.setHealthChecker(health_checker);
+
+  ReadyWatcher initialized;
+  cluster.initialize([&initialized] { initialized.ready(); });
+
+  const HostVector hosts = cluster.prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(3UL, hosts.size());
+  EXPECT_EQ(Host::Health::Healthy, hosts[0]->coarseHealth());
+  EXPECT_FALSE(hosts[1]->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC));
+  EXPECT_TRUE(hosts[1]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_TRUE(hosts[2]->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC));
+  EXPECT_EQ(0UL, inherited_host_health.instance().size());
+
+  // Only the host the parent didn't know holds up initialization.
+  hosts[2]->healthFlagClear(Host::HealthFlag::FAILED_ACTIVE_HC);
+  EXPECT_CALL(initialized, ready());
+  health_checker->runCallbacks(hosts[2], HealthTransition::Changed);
+  EXPECT_EQ(2UL, cluster.prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+  EXPECT_EQ(2UL, cluster.info()->endpointStats().membership_healthy_.value());
+}
+
+// Health checks of hosts which inherited their health don't complete the initialization held up by
+// the other hosts, and neither do repeated checks of a host holding it up.
+TEST_F(StaticClusterImplTest, InheritedHostHealthChecksDontCompleteInitialization) {
+  const std::string yaml = R"EOF(
+    name: addressportconfig
+    connect_timeout: 0.25s
+    type: static
+    lb_policy: random
+    load_assignment:
+        endpoints:
+          - lb_endpoints:
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 10.0.0.1
+                    port_value: 11001
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 10.0.0.1
+                    port_value: 11002
+            - endpoint:
+                address:
+                  socket_address:
+                    address: 10.0.0.1
+                    port_value: 11003
+  )EOF";
+
+  ScopedInheritedHostHealth inherited_host_health(std::make_unique<InheritedHostHealth>());
+  inherited_host_health.instance().add("addressportconfig", "10.0.0.1:11001", {});
+
+  envoy::config::cluster::v3::Cluster cluster_config = parseClusterFromV3Yaml(yaml);
+
+  Envoy::Upstream::ClusterFactoryContextImpl factory_context(
+      server_context_, server_context_.cluster_manager_, stats_, nullptr, ssl_context_manager_,
+      nullptr, false, validation_visitor_);
+  StaticClusterImpl cluster(server_context_, cluster_config, factory_context, runtime_, false);
+
+  std::shared_ptr<MockHealthChecker> health_checker(new NiceMock<MockHealthChecker>());
+  cluster.setHealthChecker(health_checker);
+
+  ReadyWatcher initialized;
+  cluster.initialize([&initialized] { initialized.ready(); });
+
+  const HostVector hosts = cluster.prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(3UL, hosts.size());
+  EXPECT_CALL(initialized, ready()).Times(0);
+  health_checker->runCallbacks(hosts[0], HealthTransition::Unchanged);
+  health_checker->runCallbacks(hosts[0], HealthTransition::Unchanged);
+  health_checker->runCallbacks(hosts[1], HealthTransition::Unchanged);
+  health_checker->runCallbacks(hosts[1], HealthTransition::Unchanged);
+  testing::Mock::VerifyAndClearExpectations(&initialized);
+
+  EXPECT_CALL(initialized, ready());
+  health_checker->runCallbacks(hosts[2], HealthTransition::Unchanged);
+}
+
 TEST_F(StaticClusterImplTest, InitialHostsDisableHC) {
   const std::string yaml = R"EOF(
     name: staticcluster
@@ -223,6 +223,29 @@ static void duplicateUpdate(State& state) {
 
 BENCHMARK(duplicateUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
 
+// Same as duplicateUpdate with the legacy mux, but decoding the resent resource again, for
+// comparison.
+static void duplicateUpdateWithoutResourceReuse(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  Envoy::TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.xds_reuse_unchanged_resources", "false"}});
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Envoy::Upstream::EdsSpeedTest speed_test(state, false);
+    uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(0);
+
+    speed_test.priorityAndLocalityWeightedHelper(true, endpoints, true);
+    speed_test.priorityAndLocalityWeightedHelper(true, endpoints, true);
+  }
+}
+
+BENCHMARK(duplicateUpdateWithoutResourceReuse)
+    ->Range(1, 100000)
+    ->Unit(benchmark::kMillisecond);
+
 static void healthOnlyUpdate(State& state) {
   Envoy::Thread::MutexBasicLockable lock;
   Envoy::Logger::Context logging_state(spdlog::level::warn,
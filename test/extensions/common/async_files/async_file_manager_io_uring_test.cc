@@ -0,0 +1,266 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <climits>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+#include "source/extensions/common/async_files/async_file_manager_factory.h"
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/status_utility.h"
+#include "test/test_common/utility.h"
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+using StatusHelpers::IsOkAndHolds;
+
+class AsyncFileManagerIoUringTest : public testing::Test {
+public:
+  void SetUp() override {
+    if (!Io::isIoUringSupported() || !AsyncFileManagerIoUring::requiredOperationsSupported()) {
+      GTEST_SKIP() << "io_uring is not supported";
+    }
+    singleton_manager_ = std::make_unique<Singleton::ManagerImpl>(Thread::threadFactoryForTest());
+    factory_ = AsyncFileManagerFactory::singleton(singleton_manager_.get());
+    envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+    config.mutable_io_uring()->set_ring_size(4);
+    manager_ = factory_->getAsyncFileManager(config);
+  }
+
+  void close(AsyncFileHandle& handle) {
+    std::promise<absl::Status> close_result;
+    EXPECT_OK(handle->close([&](absl::Status status) { close_result.set_value(status); }));
+    EXPECT_OK(close_result.get_future().get());
+  }
+  AsyncFileHandle createAnonymousFile() {
+    std::promise<AsyncFileHandle> create_result;
+    manager_->createAnonymousFile(tmpdir_, [&](absl::StatusOr<AsyncFileHandle> result) {
+      create_result.set_value(result.value());
+    });
+    return create_result.get_future().get();
+  }
+  std::string writeTmpFile(absl::string_view name, absl::string_view contents) {
+    return TestEnvironment::writeStringToFileForTest(std::string(name), std::string(contents));
+  }
+
+  const char* test_tmpdir = std::getenv("TEST_TMPDIR");
+  std::string tmpdir_ = test_tmpdir ? test_tmpdir : "/tmp";
+  std::unique_ptr<Singleton::ManagerImpl> singleton_manager_;
+  std::shared_ptr<AsyncFileManagerFactory> factory_;
+  std::shared_ptr<AsyncFileManager> manager_;
+};
+
+TEST_F(AsyncFileManagerIoUringTest, Describe) {
+  EXPECT_EQ("io_uring ring_size = 4", manager_->describe());
+}
+
+TEST_F(AsyncFileManagerIoUringTest, WriteReadClose) {
+  auto handle = createAnonymousFile();
+  absl::StatusOr<size_t> write_status, second_write_status;
+  absl::StatusOr<Buffer::InstancePtr> read_status, second_read_status;
+  Buffer::OwnedImpl hello("hello");
+  std::promise<absl::Status> close_status;
+  EXPECT_OK(handle->write(hello, 0, [&](absl::StatusOr<size_t> status) {
+    write_status = std::move(status);
+    Buffer::OwnedImpl two_chars("p!");
+    EXPECT_OK(handle->write(two_chars, 3, [&](absl::StatusOr<size_t> status) {
+      second_write_status = std::move(status);
+      EXPECT_OK(handle->read(0, 5, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+        read_status = std::move(status);
+        // Reading past the end of the file returns what there is.
+        EXPECT_OK(handle->read(2, 10, [&](absl::StatusOr<Buffer::InstancePtr> status) {
+          second_read_status = std::move(status);
+          EXPECT_OK(handle->close(
+              [&](absl::Status status) { close_status.set_value(std::move(status)); }));
+        }));
+      }));
+    }));
+  }));
+  ASSERT_OK(close_status.get_future().get());
+  EXPECT_THAT(write_status, IsOkAndHolds(5U));
+  EXPECT_THAT(second_write_status, IsOkAndHolds(2U));
+  ASSERT_OK(read_status);
+  EXPECT_THAT(*read_status.value(), BufferStringEqual("help!"));
+  ASSERT_OK(second_read_status);
+  EXPECT_THAT(*second_read_status.value(), BufferStringEqual("lp!"));
+}
+
+// A buffer with more slices than one writev takes is written with several operations.
+TEST_F(AsyncFileManagerIoUringTest, WriteOfManySlices) {
+  auto handle = createAnonymousFile();
+  Buffer::OwnedImpl contents;
+  std::string expected;
+  for (int i = 0; i < IOV_MAX + 10; i++) {
+    const std::string slice = absl::StrCat(i % 10);
+    contents.appendSliceForTest(slice);
+    expected += slice;
+  }
+  std::promise<absl::StatusOr<size_t>> write_status;
+  EXPECT_OK(handle->write(contents, 0, [&](absl::StatusOr<size_t> status) {
+    write_status.set_value(std::move(status));
+  }));
+  EXPECT_THAT(write_status.get_future().get(), IsOkAndHolds(expected.size()));
+  std::promise<absl::StatusOr<Buffer::InstancePtr>> read_status;
+  EXPECT_OK(handle->read(0, expected.size(), [&](absl::StatusOr<Buffer::InstancePtr> status) {
+    read_status.set_value(std::move(status));
+  }));
+  auto read = read_status.get_future().get();
+  ASSERT_OK(read);
+  EXPECT_EQ(expected, read.value()->toString());
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, OpenStatAndUnlinkExistingFile) {
+  const std::string filename = writeTmpFile("io_uring_existing", "hello");
+  std::promise<absl::StatusOr<struct stat>> stat_status;
+  manager_->stat(filename,
+                 [&](absl::StatusOr<struct stat> status) { stat_status.set_value(status); });
+  auto stat_result = stat_status.get_future().get();
+  ASSERT_OK(stat_result);
+  EXPECT_EQ(5, stat_result.value().st_size);
+  EXPECT_TRUE(S_ISREG(stat_result.value().st_mode));
+
+  std::promise<AsyncFileHandle> open_result;
+  manager_->openExistingFile(filename, AsyncFileManager::Mode::ReadOnly,
+                             [&](absl::StatusOr<AsyncFileHandle> result) {
+                               open_result.set_value(result.value());
+                             });
+  AsyncFileHandle handle = open_result.get_future().get();
+  std::promise<absl::StatusOr<struct stat>> handle_stat_status;
+  EXPECT_OK(handle->stat(
+      [&](absl::StatusOr<struct stat> status) { handle_stat_status.set_value(status); }));
+  auto handle_stat = handle_stat_status.get_future().get();
+  ASSERT_OK(handle_stat);
+  EXPECT_EQ(stat_result.value().st_ino, handle_stat.value().st_ino);
+  EXPECT_EQ(stat_result.value().st_dev, handle_stat.value().st_dev);
+  close(handle);
+
+  std::promise<absl::Status> unlink_status;
+  manager_->unlink(filename, [&](absl::Status status) { unlink_status.set_value(status); });
+  EXPECT_OK(unlink_status.get_future().get());
+  EXPECT_EQ(-1, ::access(filename.c_str(), F_OK));
+}
+
+TEST_F(AsyncFileManagerIoUringTest, OpenMissingFileFails) {
+  std::promise<absl::Status> open_status;
+  manager_->openExistingFile(absl::StrCat(tmpdir_, "/io_uring_missing_file"),
+                             AsyncFileManager::Mode::ReadOnly,
+                             [&](absl::StatusOr<AsyncFileHandle> result) {
+                               open_status.set_value(result.status());
+                             });
+  EXPECT_EQ(absl::StatusCode::kNotFound, open_status.get_future().get().code());
+}
+
+// Operations waiting for room in the ring when the manager is destroyed still complete and call
+// their callbacks.
+TEST_F(AsyncFileManagerIoUringTest, DestructionCompletesWaitingOperations) {
+  envoy::extensions::common::async_files::v3::AsyncFileManagerConfig config;
+  config.mutable_io_uring()->set_ring_size(1);
+  std::atomic<int> completed{0};
+  {
+    AsyncFileManagerIoUring manager(config, Api::OsSysCallsSingleton::get());
+    for (int i = 0; i < 16; ++i) {
+      manager.stat(tmpdir_, [&completed](absl::StatusOr<struct stat> result) {
+        EXPECT_OK(result.status());
+        ++completed;
+      });
+    }
+  }
+  EXPECT_EQ(16, completed);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, LinkCreatesNamedFile) {
+  auto handle = createAnonymousFile();
+  Buffer::OwnedImpl data("hello");
+  std::promise<absl::StatusOr<size_t>> write_status;
+  EXPECT_OK(handle->write(
+      data, 0, [&](absl::StatusOr<size_t> status) { write_status.set_value(status); }));
+  ASSERT_THAT(write_status.get_future().get(), IsOkAndHolds(5U));
+  const std::string filename = absl::StrCat(tmpdir_, "/io_uring_link_test");
+  ::unlink(filename.c_str());
+  std::promise<absl::Status> link_status;
+  EXPECT_OK(handle->createHardLink(filename,
+                                   [&](absl::Status status) { link_status.set_value(status); }));
+  ASSERT_OK(link_status.get_future().get());
+  EXPECT_EQ("hello", TestEnvironment::readFileToStringForTest(filename));
+  ::unlink(filename.c_str());
+  close(handle);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, DuplicateCreatesIndependentHandle) {
+  auto handle = createAnonymousFile();
+  std::promise<absl::StatusOr<AsyncFileHandle>> duplicate_status_promise;
+  EXPECT_OK(handle->duplicate(
+      [&](absl::StatusOr<AsyncFileHandle> status) { duplicate_status_promise.set_value(status); }));
+  auto duplicate_status = duplicate_status_promise.get_future().get();
+  ASSERT_OK(duplicate_status);
+  AsyncFileHandle dup_file = std::move(duplicate_status.value());
+  close(handle);
+  std::promise<absl::StatusOr<size_t>> write_status;
+  Buffer::OwnedImpl buf("hello");
+  EXPECT_OK(dup_file->write(
+      buf, 0, [&](absl::StatusOr<size_t> result) { write_status.set_value(result); }));
+  EXPECT_THAT(write_status.get_future().get(), IsOkAndHolds(5U));
+  close(dup_file);
+}
+
+TEST_F(AsyncFileManagerIoUringTest, WhenReadyCallsBack) {
+  std::promise<absl::Status> ready;
+  manager_->whenReady([&](absl::Status status) { ready.set_value(status); });
+  EXPECT_OK(ready.get_future().get());
+}
+
+// Operations beyond the ring size wait for earlier ones to complete.
+TEST_F(AsyncFileManagerIoUringTest, MoreOperationsThanRingSize) {
+  const std::string filename = writeTmpFile("io_uring_many_stats", "hello");
+  constexpr int operations = 50;
+  std::vector<std::promise<absl::StatusOr<struct stat>>> results(operations);
+  for (auto& result : results) {
+    manager_->stat(filename,
+                   [&result](absl::StatusOr<struct stat> status) { result.set_value(status); });
+  }
+  for (auto& result : results) {
+    auto stat_result = result.get_future().get();
+    ASSERT_OK(stat_result);
+    EXPECT_EQ(5, stat_result.value().st_size);
+  }
+}
+
+TEST_F(AsyncFileManagerIoUringTest, CancelledOpenClosesFile) {
+  const std::string filename = writeTmpFile("io_uring_cancel", "hello");
+  // Cancelling right away races with the operation; either way the callback is not called and
+  // no file is left open, which the destructor of the handle would assert.
+  CancelFunction cancel = manager_->openExistingFile(
+      filename, AsyncFileManager::Mode::ReadOnly,
+      [](absl::StatusOr<AsyncFileHandle>) { FAIL() << "callback called after cancel"; });
+  cancel();
+  std::promise<absl::Status> ready;
+  manager_->whenReady([&](absl::Status status) { ready.set_value(status); });
+  EXPECT_OK(ready.get_future().get());
+}
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,108 @@
+// Compares the AsyncFileManager backends by writing, reading back and closing anonymous files,
+// with the given number of files in flight at once.
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "envoy/extensions/common/async_files/v3/async_file_manager.pb.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/singleton/manager_impl.h"
+#include "source/extensions/common/async_files/async_file_handle.h"
+#include "source/extensions/common/async_files/async_file_manager.h"
+#include "source/extensions/common/async_files/async_file_manager_factory.h"
+#include "source/extensions/common/async_files/async_file_manager_io_uring.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace AsyncFiles {
+
+namespace {
+
+using AsyncFileManagerConfig = envoy::extensions::common::async_files::v3::AsyncFileManagerConfig;
+
+constexpr size_t FileSize = 16 * 1024;
+
+// Writes, reads back and closes one anonymous file, by chaining the actions from the callbacks.
+void writeReadClose(AsyncFileManager& manager, const std::string& path,
+                    std::function<void()> on_done) {
+  manager.createAnonymousFile(path, [on_done](absl::StatusOr<AsyncFileHandle> opened) {
+    RELEASE_ASSERT(opened.ok(), opened.status().ToString());
+    AsyncFileHandle handle = opened.value();
+    Buffer::OwnedImpl contents(std::string(FileSize, 'a'));
+    handle
+        ->write(contents, 0,
+                [handle, on_done](absl::StatusOr<size_t> written) {
+                  RELEASE_ASSERT(written.ok() && written.value() == FileSize, "write failed");
+                  handle
+                      ->read(0, FileSize,
+                             [handle, on_done](absl::StatusOr<Buffer::InstancePtr> read) {
+                               RELEASE_ASSERT(read.ok(), "read failed");
+                               handle
+                                   ->close([on_done](absl::Status closed) {
+                                     RELEASE_ASSERT(closed.ok(), closed.ToString());
+                                     on_done();
+                                   })
+                                   .IgnoreError();
+                             })
+                      .IgnoreError();
+                })
+        .IgnoreError();
+  });
+}
+
+void runBenchmark(benchmark::State& state, const AsyncFileManagerConfig& config) {
+  Singleton::ManagerImpl singleton_manager(Thread::threadFactoryForTest());
+  std::shared_ptr<AsyncFileManager> manager =
+      AsyncFileManagerFactory::singleton(&singleton_manager)->getAsyncFileManager(config);
+  const std::string path = TestEnvironment::temporaryDirectory();
+  const int64_t files_in_flight = state.range(0);
+  for (auto _ : state) { // NOLINT
+    std::atomic<int64_t> remaining{files_in_flight};
+    std::promise<void> done;
+    for (int64_t i = 0; i < files_in_flight; i++) {
+      writeReadClose(*manager, path, [&remaining, &done]() {
+        if (--remaining == 0) {
+          done.set_value();
+        }
+      });
+    }
+    done.get_future().wait();
+  }
+  state.SetItemsProcessed(state.iterations() * files_in_flight);
+  state.SetBytesProcessed(state.iterations() * files_in_flight * FileSize * 2);
+}
+
+} // namespace
+
+static void threadPool(benchmark::State& state) {
+  AsyncFileManagerConfig config;
+  config.mutable_thread_pool()->set_thread_count(4);
+  runBenchmark(state, config);
+}
+BENCHMARK(threadPool)->Arg(1)->Arg(16)->Arg(128)->UseRealTime();
+
+static void ioUring(benchmark::State& state) {
+  if (!Io::isIoUringSupported() || !AsyncFileManagerIoUring::requiredOperationsSupported()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  AsyncFileManagerConfig config;
+  config.mutable_io_uring()->set_ring_size(256);
+  runBenchmark(state, config);
+}
+BENCHMARK(ioUring)->Arg(1)->Arg(16)->Arg(128)->UseRealTime();
+
+} // namespace AsyncFiles
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
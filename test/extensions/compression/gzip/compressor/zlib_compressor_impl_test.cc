@@ -3,6 +3,7 @@
 #include "source/extensions/compression/gzip/compressor/config.h"
 #include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
 
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "absl/container/fixed_array.h"
@@ -150,8 +151,9 @@ TEST_P(ZlibCompressorImplFactoryTest, CreateCompressorTest) {
                        strategy, compression_level);
   }
   TestUtility::loadFromJson(json, gzip);
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
   Envoy::Compression::Compressor::CompressorPtr compressor =
-      GzipCompressorFactory(gzip).createCompressor();
+      GzipCompressorFactory(gzip, tls).createCompressor();
   // Check the created compressor produces valid output.
   TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
   compressor->compress(buffer, Envoy::Compression::Compressor::State::Flush);
@@ -159,6 +161,44 @@ TEST_P(ZlibCompressorImplFactoryTest, CreateCompressorTest) {
   drainBuffer(buffer);
 }
 
+// Verifies that pooled streams are reset and reused by subsequent compressors, and that the
+// number of idle streams kept per thread is bounded.
+TEST_F(ZlibCompressorImplTest, PooledStreams) {
+  envoy::extensions::compression::gzip::compressor::v3::Gzip gzip;
+  TestUtility::loadFromJson(R"EOF({"max_pooled_contexts": 2})EOF", gzip);
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  GzipCompressorFactory factory(gzip, tls);
+  ASSERT_NE(nullptr, factory.contextPool());
+
+  for (uint32_t i = 0; i < 3; i++) {
+    Buffer::OwnedImpl buffer;
+    Envoy::Compression::Compressor::CompressorPtr compressor = factory.createCompressor();
+    TestUtility::feedBufferWithRandomCharacters(buffer, 4096, i);
+    compressor->compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    expectValidFinishedBuffer(buffer, 4096);
+  }
+  EXPECT_EQ(1U, factory.contextPool()->created());
+  EXPECT_EQ(2U, factory.contextPool()->reused());
+  EXPECT_EQ(1U, factory.contextPool()->idle());
+
+  {
+    std::vector<Envoy::Compression::Compressor::CompressorPtr> compressors;
+    for (uint32_t i = 0; i < 3; i++) {
+      compressors.push_back(factory.createCompressor());
+    }
+  }
+  EXPECT_EQ(3U, factory.contextPool()->created());
+  EXPECT_EQ(2U, factory.contextPool()->idle());
+}
+
+// Verifies that pooling is disabled by default.
+TEST_F(ZlibCompressorImplTest, PooledStreamsDisabledByDefault) {
+  envoy::extensions::compression::gzip::compressor::v3::Gzip gzip;
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  GzipCompressorFactory factory(gzip, tls);
+  EXPECT_EQ(nullptr, factory.contextPool());
+}
+
 // Exercises death by passing bad initialization params or by calling
 // compress before init.
 TEST_F(ZlibCompressorImplDeathTest, CompressorDeathTest) {
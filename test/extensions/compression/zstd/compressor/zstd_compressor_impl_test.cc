@@ -105,6 +105,34 @@ TEST_F(ZstdCompressorImplTest, CompressWitHugeBuffer) {
   verifyWithDecompressor(std::move(compressor));
 }
 
+// Verifies that compression contexts released by finished streams are reset and reused.
+TEST_F(ZstdCompressorImplTest, PooledContexts) {
+  envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
+  Zstd::Compressor::ZstdCompressorLibraryFactory lib_factory;
+  NiceMock<Server::Configuration::MockFactoryContext> mock_context;
+  TestUtility::loadFromJson(R"EOF({"compression_level": 19, "max_pooled_contexts": 1})EOF",
+                            zstd);
+  Envoy::Compression::Compressor::CompressorFactoryPtr factory =
+      lib_factory.createCompressorFactoryFromProto(zstd, mock_context);
+  const ZstdCCtxPool* pool = dynamic_cast<ZstdCompressorFactory&>(*factory).contextPool();
+  ASSERT_NE(nullptr, pool);
+
+  for (uint32_t i = 0; i < 3; i++) {
+    verifyWithDecompressor(factory->createCompressor());
+  }
+  EXPECT_EQ(1U, pool->created());
+  EXPECT_EQ(2U, pool->reused());
+  EXPECT_EQ(1U, pool->idle());
+
+  // A stream abandoned mid-frame leaves no state behind for the next owner of the context.
+  Buffer::OwnedImpl buffer;
+  TestUtility::feedBufferWithRandomCharacters(buffer, default_input_size_);
+  factory->createCompressor()->compress(buffer, Envoy::Compression::Compressor::State::Flush);
+  verifyWithDecompressor(factory->createCompressor());
+  EXPECT_EQ(1U, pool->created());
+  EXPECT_EQ(4U, pool->reused());
+}
+
 TEST_F(ZstdCompressorImplTest, IllegalConfig) {
   envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
   Zstd::Compressor::ZstdCompressorLibraryFactory lib_factory;
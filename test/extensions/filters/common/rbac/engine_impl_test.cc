@@ -18,6 +18,7 @@
 #include "gtest/gtest.h"
 
 using testing::Const;
+using testing::Return;
 using testing::ReturnPointee;
 using testing::ReturnRef;
 
@@ -246,6 +247,190 @@ TEST(RoleBasedAccessControlEngineImpl, DeniedDenylist) {
   checkEngine(engine, true, LogResult::Undecided, info, conn, headers);
 }
 
+// Principals are looked up in an index for IP ranges and exact header values, and shared between
+// the policies using the same ones. The first matching policy in name order must still be found.
+TEST(RoleBasedAccessControlEngineImpl, CompiledPrincipals) {
+  const std::string yaml = R"EOF(
+action: ALLOW
+policies:
+  a-ip:
+    permissions:
+    - destination_port: 123
+    principals:
+    - direct_remote_ip:
+        address_prefix: 10.0.0.0
+        prefix_len: 8
+    - remote_ip:
+        address_prefix: 192.168.1.0
+        prefix_len: 24
+  b-header:
+    permissions:
+    - any: true
+    principals:
+    - header:
+        name: X-User
+        string_match:
+          exact: alice
+    - header:
+        name: x-user
+        string_match:
+          exact: bob
+  c-shared:
+    permissions:
+    - destination_port: 456
+    principals:
+    - header:
+        name: x-team
+        string_match:
+          prefix: ops
+  d-shared:
+    permissions:
+    - destination_port: 789
+    principals:
+    - header:
+        name: x-team
+        string_match:
+          prefix: ops
+  )EOF";
+
+  envoy::config::rbac::v3::RBAC rbac;
+  TestUtility::loadFromYaml(yaml, rbac);
+  RBAC::RoleBasedAccessControlEngineImpl engine(rbac,
+                                                ProtobufMessage::getStrictValidationVisitor());
+
+  const auto check = [&engine](uint32_t port, const std::string& direct_remote,
+                               const std::string& remote,
+                               const Envoy::Http::TestRequestHeaderMapImpl& headers,
+                               const std::string& expected_policy) {
+    Envoy::Network::MockConnection conn;
+    NiceMock<StreamInfo::MockStreamInfo> info;
+    info.downstream_connection_info_provider_->setLocalAddress(
+        Envoy::Network::Utility::parseInternetAddress("1.2.3.4", port, false));
+    info.downstream_connection_info_provider_->setDirectRemoteAddressForTest(
+        Envoy::Network::Utility::parseInternetAddress(direct_remote, 1234, false));
+    info.downstream_connection_info_provider_->setRemoteAddress(
+        Envoy::Network::Utility::parseInternetAddress(remote, 1234, false));
+    std::string policy_id;
+    EXPECT_EQ(!expected_policy.empty(), engine.handleAction(conn, headers, info, &policy_id));
+    EXPECT_EQ(expected_policy, policy_id);
+  };
+
+  check(123, "10.1.2.3", "1.1.1.1", {}, "a-ip");
+  check(123, "1.1.1.1", "192.168.1.7", {}, "a-ip");
+  check(123, "1.1.1.1", "192.168.2.7", {}, "");
+  check(123, "1.1.1.1", "1.1.1.1", {{"x-user", "bob"}}, "b-header");
+  check(123, "10.1.2.3", "1.1.1.1", {{"x-user", "bob"}}, "a-ip");
+  check(123, "1.1.1.1", "1.1.1.1", {{"x-user", "carol"}}, "");
+  check(123, "1.1.1.1", "1.1.1.1", {{"x-user", "alice"}, {"x-user", "bob"}}, "");
+  check(456, "1.1.1.1", "1.1.1.1", {{"x-team", "ops-1"}}, "c-shared");
+  check(789, "1.1.1.1", "1.1.1.1", {{"x-team", "ops-1"}}, "d-shared");
+  check(789, "1.1.1.1", "1.1.1.1", {{"x-team", "dev"}}, "");
+}
+
+TEST(RoleBasedAccessControlEngineImpl, CacheConnectionPrincipals) {
+  const std::string yaml = R"EOF(
+action: ALLOW
+policies:
+  foo:
+    permissions:
+    - header:
+        name: x-allowed
+        string_match:
+          exact: "true"
+    principals:
+    - authenticated: {}
+  )EOF";
+
+  envoy::config::rbac::v3::RBAC rbac;
+  TestUtility::loadFromYaml(yaml, rbac);
+  Envoy::Network::MockConnection conn;
+  auto ssl = std::make_shared<Ssl::MockConnectionInfo>();
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  const Envoy::Http::TestRequestHeaderMapImpl allowed{{"x-allowed", "true"}};
+  const Envoy::Http::TestRequestHeaderMapImpl denied{{"x-allowed", "false"}};
+
+  {
+    // Without caching, the principals are evaluated for each request.
+    RBAC::RoleBasedAccessControlEngineImpl engine(rbac,
+                                                  ProtobufMessage::getStrictValidationVisitor());
+    EXPECT_CALL(Const(conn), ssl()).Times(2).WillRepeatedly(Return(ssl));
+    checkEngine(engine, true, LogResult::Undecided, info, conn, allowed);
+    checkEngine(engine, true, LogResult::Undecided, info, conn, allowed);
+  }
+
+  rbac.set_cache_connection_principals(true);
+  RBAC::RoleBasedAccessControlEngineImpl engine(rbac,
+                                                ProtobufMessage::getStrictValidationVisitor());
+  EXPECT_CALL(Const(conn), ssl()).WillOnce(Return(ssl));
+  checkEngine(engine, true, LogResult::Undecided, info, conn, allowed);
+  checkEngine(engine, true, LogResult::Undecided, info, conn, allowed);
+  // Permissions are still evaluated for each request.
+  checkEngine(engine, false, LogResult::Undecided, info, conn, denied);
+
+  // The results are cached per engine.
+  RBAC::RoleBasedAccessControlEngineImpl other_engine(
+      rbac, ProtobufMessage::getStrictValidationVisitor());
+  EXPECT_CALL(Const(conn), ssl()).WillOnce(Return(nullptr));
+  checkEngine(other_engine, false, LogResult::Undecided, info, conn, allowed);
+  checkEngine(other_engine, false, LogResult::Undecided, info, conn, allowed);
+  checkEngine(engine, true, LogResult::Undecided, info, conn, allowed);
+
+  // Another connection evaluates the principals again.
+  NiceMock<StreamInfo::MockStreamInfo> other_info;
+  EXPECT_CALL(Const(conn), ssl()).WillOnce(Return(nullptr));
+  checkEngine(engine, false, LogResult::Undecided, other_info, conn, allowed);
+}
+
+// The results of all of the engines in use on a connection are kept, and those of destroyed engines
+// are dropped.
+TEST(RoleBasedAccessControlEngineImpl, CacheConnectionPrincipalsOfLiveEngines) {
+  const std::string yaml = R"EOF(
+action: ALLOW
+cache_connection_principals: true
+policies:
+  foo:
+    permissions:
+    - any: true
+    principals:
+    - authenticated: {}
+  )EOF";
+
+  envoy::config::rbac::v3::RBAC rbac;
+  TestUtility::loadFromYaml(yaml, rbac);
+  Envoy::Network::MockConnection conn;
+  auto ssl = std::make_shared<Ssl::MockConnectionInfo>();
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  const Envoy::Http::TestRequestHeaderMapImpl headers;
+
+  std::vector<std::unique_ptr<RBAC::RoleBasedAccessControlEngineImpl>> engines;
+  for (size_t i = 0; i < 8; i++) {
+    engines.push_back(std::make_unique<RBAC::RoleBasedAccessControlEngineImpl>(
+        rbac, ProtobufMessage::getStrictValidationVisitor()));
+  }
+  EXPECT_CALL(Const(conn), ssl()).Times(engines.size()).WillRepeatedly(Return(ssl));
+  for (const auto& engine : engines) {
+    checkEngine(*engine, true, LogResult::Undecided, info, conn, headers);
+  }
+  // The results of every engine are still cached.
+  for (const auto& engine : engines) {
+    checkEngine(*engine, true, LogResult::Undecided, info, conn, headers);
+  }
+  const auto* connection_results =
+      info.filterState()->getDataReadOnly<RBAC::ConnectionPrincipalResults>(
+          RBAC::ConnectionPrincipalResults::key());
+  ASSERT_NE(nullptr, connection_results);
+  EXPECT_EQ(engines.size(), connection_results->numEnginesForTest());
+
+  // Those of destroyed engines are dropped when another engine's are added.
+  engines.resize(2);
+  RBAC::RoleBasedAccessControlEngineImpl new_engine(rbac,
+                                                    ProtobufMessage::getStrictValidationVisitor());
+  EXPECT_CALL(Const(conn), ssl()).WillOnce(Return(ssl));
+  checkEngine(new_engine, true, LogResult::Undecided, info, conn, headers);
+  EXPECT_EQ(3, connection_results->numEnginesForTest());
+  checkEngine(*engines.front(), true, LogResult::Undecided, info, conn, headers);
+}
+
 TEST(RoleBasedAccessControlEngineImpl, BasicCondition) {
   envoy::config::rbac::v3::Policy policy;
   policy.add_permissions()->set_any(true);
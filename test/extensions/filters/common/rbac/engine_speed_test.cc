@@ -0,0 +1,104 @@
+// Measures the cost of evaluating RBAC configs with many policies, as the engine does and as done
+// by evaluating every policy one by one.
+
+#include "envoy/config/rbac/v3/rbac.pb.h"
+
+#include "source/common/network/utility.h"
+#include "source/extensions/filters/common/rbac/engine_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Filters {
+namespace Common {
+namespace RBAC {
+namespace {
+
+// Creates policies allowing a path prefix per service, either to clients of an IP range or to
+// clients identified by a header. Only the last policy matches the request built by
+// lastPolicyRequest().
+envoy::config::rbac::v3::RBAC makeRbac(uint32_t num_policies) {
+  envoy::config::rbac::v3::RBAC rbac;
+  rbac.set_action(envoy::config::rbac::v3::RBAC::ALLOW);
+  for (uint32_t i = 0; i < num_policies; ++i) {
+    envoy::config::rbac::v3::Policy policy;
+    auto* permission = policy.add_permissions()->mutable_header();
+    permission->set_name(":path");
+    permission->mutable_string_match()->set_prefix(absl::StrCat("/service-", i, "/"));
+    auto* principal = policy.add_principals();
+    if (i % 2 == 0) {
+      auto* range = principal->mutable_direct_remote_ip();
+      range->set_address_prefix(absl::StrCat("10.", i / 256, ".", i % 256, ".0"));
+      range->mutable_prefix_len()->set_value(24);
+    } else {
+      principal->mutable_header()->set_name("x-client");
+      principal->mutable_header()->mutable_string_match()->set_exact(absl::StrCat("client-", i));
+    }
+    (*rbac.mutable_policies())[absl::StrCat("policy-", absl::Dec(i, absl::kZeroPad4))] = policy;
+  }
+  return rbac;
+}
+
+Http::TestRequestHeaderMapImpl lastPolicyRequest(uint32_t num_policies) {
+  const uint32_t last = num_policies - 1;
+  return {{":path", absl::StrCat("/service-", last, "/method")},
+          {"x-client", absl::StrCat("client-", last)}};
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_EngineManyPolicies(benchmark::State& state) {
+  const uint32_t num_policies = state.range(0);
+  RoleBasedAccessControlEngineImpl engine(makeRbac(num_policies),
+                                          ProtobufMessage::getNullValidationVisitor());
+  Network::MockConnection connection;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  info.downstream_connection_info_provider_->setDirectRemoteAddressForTest(
+      Network::Utility::parseInternetAddress("10.0.0.1", 1234, false));
+  const auto headers = lastPolicyRequest(num_policies);
+
+  for (auto _ : state) { // NOLINT
+    RELEASE_ASSERT(engine.handleAction(connection, headers, info, nullptr), "");
+  }
+}
+BENCHMARK(BM_EngineManyPolicies)->Arg(10)->Arg(100)->Arg(800);
+
+// Evaluates the same policies one by one, as the engine did before compiling the principals.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_PolicyWalkManyPolicies(benchmark::State& state) {
+  const uint32_t num_policies = state.range(0);
+  const envoy::config::rbac::v3::RBAC rbac = makeRbac(num_policies);
+  std::map<std::string, std::unique_ptr<PolicyMatcher>> policies;
+  for (const auto& [name, policy] : rbac.policies()) {
+    policies.emplace(name, std::make_unique<PolicyMatcher>(
+                               policy, nullptr, ProtobufMessage::getNullValidationVisitor()));
+  }
+  Network::MockConnection connection;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  info.downstream_connection_info_provider_->setDirectRemoteAddressForTest(
+      Network::Utility::parseInternetAddress("10.0.0.1", 1234, false));
+  const auto headers = lastPolicyRequest(num_policies);
+
+  for (auto _ : state) { // NOLINT
+    bool matched = false;
+    for (const auto& [name, policy] : policies) {
+      if (policy->matches(connection, headers, info)) {
+        matched = true;
+        break;
+      }
+    }
+    RELEASE_ASSERT(matched, "");
+  }
+}
+BENCHMARK(BM_PolicyWalkManyPolicies)->Arg(10)->Arg(100)->Arg(800);
+
+} // namespace
+} // namespace RBAC
+} // namespace Common
+} // namespace Filters
+} // namespace Extensions
+} // namespace Envoy
@@ -12,6 +12,7 @@
 
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/ssl/mocks.h"
+#include "test/test_common/test_runtime.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -182,6 +183,73 @@ TEST(HeaderMatcher, HeaderMatcher) {
   checkMatcher(matcher, false);
 }
 
+TEST(HeaderStringSetMatcher, HeaderStringSetMatcher) {
+  RBAC::HeaderStringSetMatcher matcher(
+      "foo", {{Matchers::StringMatcherSet::MatchType::Exact, "bar", false},
+              {Matchers::StringMatcherSet::MatchType::Prefix, "admin-", false},
+              {Matchers::StringMatcherSet::MatchType::Contains, "root", true}});
+
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"foo", "bar"}});
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"foo", "admin-alice"}});
+  checkMatcher(matcher, true, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"foo", "is-ROOT-user"}});
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"foo", "barbaz"}});
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"foo", "ADMIN-alice"}});
+  // Multiple values of the header are matched once joined, as with HeaderMatcher.
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"foo", "bar"}, {"foo", "baz"}});
+  checkMatcher(matcher, false, Envoy::Network::MockConnection(),
+               Envoy::Http::TestRequestHeaderMapImpl{{"other", "bar"}});
+  checkMatcher(matcher, false);
+}
+
+// Header rules using string matchers on the same header are merged into a HeaderStringSetMatcher,
+// which must match the same requests as the individual rules.
+TEST(OrMatcher, Permission_SetWithHeaderStringMatchers) {
+  envoy::config::rbac::v3::Permission::Set set;
+  const auto add_header_rule = [&set](const std::string& name) {
+    envoy::config::route::v3::HeaderMatcher* header = set.add_rules()->mutable_header();
+    header->set_name(name);
+    return header;
+  };
+  add_header_rule("X-Role")->mutable_string_match()->set_exact("admin");
+  add_header_rule("x-role")->mutable_string_match()->set_prefix("ops-");
+  add_header_rule("x-other")->mutable_string_match()->set_exact("admin");
+  auto* missing_as_empty = add_header_rule("x-role");
+  missing_as_empty->mutable_string_match()->set_exact("");
+  missing_as_empty->set_treat_missing_header_as_empty(true);
+  auto* suffix = add_header_rule("x-role");
+  suffix->mutable_string_match()->set_suffix("-OWNER");
+  suffix->mutable_string_match()->set_ignore_case(true);
+  add_header_rule("x-role")->mutable_string_match()->mutable_safe_regex()->set_regex("dev-[0-9]+");
+  add_header_rule("x-missing")->mutable_string_match()->set_prefix("");
+
+  for (const std::string merge : {"true", "false"}) {
+    TestScopedRuntime scoped_runtime;
+    scoped_runtime.mergeValues({{"envoy.reloadable_features.merge_or_string_matchers", merge}});
+    RBAC::OrMatcher matcher(set, ProtobufMessage::getStrictValidationVisitor());
+
+    for (const std::string value : {"admin", "ops-alice", "team-owner", "dev-42"}) {
+      checkMatcher(matcher, true, Envoy::Network::MockConnection(),
+                   Envoy::Http::TestRequestHeaderMapImpl{{"x-role", value}});
+    }
+    checkMatcher(matcher, false, Envoy::Network::MockConnection(),
+                 Envoy::Http::TestRequestHeaderMapImpl{{"x-role", "anyone"}});
+    checkMatcher(matcher, false, Envoy::Network::MockConnection(),
+                 Envoy::Http::TestRequestHeaderMapImpl{{"x-role", "anyone"}, {"x-other", "ops"}});
+    checkMatcher(matcher, true, Envoy::Network::MockConnection(),
+                 Envoy::Http::TestRequestHeaderMapImpl{{"x-role", "anyone"}, {"x-other", "admin"}});
+    checkMatcher(matcher, true, Envoy::Network::MockConnection(),
+                 Envoy::Http::TestRequestHeaderMapImpl{{"x-role", "anyone"}, {"x-missing", "x"}});
+    // The rule treating a missing header as empty matches requests without the header.
+    checkMatcher(matcher, true);
+  }
+}
+
 TEST(IPMatcher, IPMatcher) {
   NiceMock<Envoy::Network::MockConnection> conn;
   Envoy::Http::TestRequestHeaderMapImpl headers;
@@ -458,6 +526,31 @@ TEST(PolicyMatcher, PolicyMatcher) {
   checkMatcher(matcher, false, conn, headers, info);
 }
 
+// The principals of the policy are neither compiled nor evaluated.
+TEST(PolicyPermissionsMatcher, PolicyPermissionsMatcher) {
+  envoy::config::rbac::v3::Policy policy;
+  policy.add_permissions()->set_destination_port(123);
+  policy.add_permissions()->set_destination_port(456);
+  policy.add_principals()->mutable_authenticated()->mutable_principal_name()->set_exact("foo");
+  Expr::BuilderPtr builder = Expr::createBuilder(nullptr);
+
+  RBAC::PolicyPermissionsMatcher matcher(policy, builder.get(),
+                                         ProtobufMessage::getStrictValidationVisitor());
+
+  Envoy::Network::MockConnection conn;
+  Envoy::Http::TestRequestHeaderMapImpl headers;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  EXPECT_CALL(Const(conn), ssl()).Times(0);
+
+  info.downstream_connection_info_provider_->setLocalAddress(
+      Envoy::Network::Utility::parseInternetAddress("1.2.3.4", 456, false));
+  checkMatcher(matcher, true, conn, headers, info);
+
+  info.downstream_connection_info_provider_->setLocalAddress(
+      Envoy::Network::Utility::parseInternetAddress("1.2.3.4", 789, false));
+  checkMatcher(matcher, false, conn, headers, info);
+}
+
 TEST(RequestedServerNameMatcher, ValidRequestedServerName) {
   Envoy::Network::MockConnection conn;
   EXPECT_CALL(conn, requestedServerName())
@@ -1,6 +1,7 @@
 #include "envoy/event/dispatcher.h"
 
 #include "source/common/http/headers.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/filters/http/cache/cache_filter.h"
 #include "source/extensions/filters/http/cache/cache_filter_logging_info.h"
 #include "source/extensions/http/cache/simple_http_cache/simple_http_cache.h"
@@ -29,7 +30,7 @@ protected:
   // cache callbacks.
   CacheFilterSharedPtr makeFilter(OptRef<HttpCache> cache) {
     auto filter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
-                                                context_.timeSource(), cache);
+                                                context_.timeSource(), cache, request_collapser_);
     filter_state_ = std::make_shared<StreamInfo::FilterStateImpl>(
         StreamInfo::FilterState::LifeSpan::FilterChain);
     filter->setDecoderFilterCallbacks(decoder_callbacks_);
@@ -151,8 +152,33 @@ protected:
 
   void waitBeforeSecondRequest() { time_source_.advanceTimeWait(delay_); }
 
+  void enableRequestCollapsing() {
+    request_collapser_ =
+        std::make_shared<RequestCollapser>(collapse_max_wait_, *stats_store_.rootScope(), "");
+  }
+
+  uint64_t collapsingCounter(const std::string& name) {
+    const auto counter =
+        TestUtility::findCounter(stats_store_, "cache.request_collapsing." + name);
+    return counter != nullptr ? counter->value() : 0;
+  }
+
+  // Starts a request for which the cache lookup finds the same as the in-flight request before it,
+  // and checks that it waits for that request.
+  void testDecodeRequestCollapsed(CacheFilterSharedPtr filter) {
+    EXPECT_CALL(decoder_callbacks_, encodeHeaders_).Times(0);
+    EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+    EXPECT_EQ(filter->decodeHeaders(request_headers_, true),
+              Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+  }
+
   SimpleHttpCache simple_cache_;
   envoy::extensions::filters::http::cache::v3::CacheConfig config_;
+  Stats::IsolatedStoreImpl stats_store_;
+  const std::chrono::milliseconds collapse_max_wait_{5000};
+  RequestCollapserSharedPtr request_collapser_;
   std::shared_ptr<StreamInfo::FilterState> filter_state_ =
       std::make_shared<StreamInfo::FilterStateImpl>(StreamInfo::FilterState::LifeSpan::FilterChain);
   NiceMock<Server::Configuration::MockFactoryContext> context_;
@@ -722,6 +748,110 @@ TEST_F(CacheFilterTest, GetRequestWithBodyAndTrailers) {
 // was deleted (e.g. connection dropped with the client) before the posted callback was executed. In
 // this case the CacheFilter should not be accessed after it was deleted, which is ensured by using
 // a weak_ptr to the CacheFilter in the posted callback.
+TEST_F(CacheFilterTest, CollapsedRequestIsServedFromTheLeadersInsert) {
+  request_headers_.setHost("CollapsedRequestIsServedFromTheLeadersInsert");
+  enableRequestCollapsing();
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_);
+  testDecodeRequestMiss(leader);
+  CacheFilterSharedPtr follower = makeFilter(simple_cache_);
+  testDecodeRequestCollapsed(follower);
+  EXPECT_EQ(collapsingCounter("collapsed"), 1);
+
+  // Once the leader's response is inserted, the follower is served from the cache without going
+  // upstream.
+  EXPECT_CALL(decoder_callbacks_, encodeHeaders_(IsSupersetOfHeaders(response_headers_), true));
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+  EXPECT_EQ(collapsingCounter("collapsed_hit"), 1);
+
+  follower->onStreamComplete();
+  EXPECT_THAT(lookupStatus(), IsOkAndHolds(LookupStatus::CacheHit));
+  leader->onDestroy();
+  follower->onDestroy();
+}
+
+TEST_F(CacheFilterTest, CollapsedRequestGoesUpstreamIfLeadersResponseIsNotCacheable) {
+  request_headers_.setHost("CollapsedRequestGoesUpstreamIfLeadersResponseIsNotCacheable");
+  enableRequestCollapsing();
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_);
+  testDecodeRequestMiss(leader);
+  CacheFilterSharedPtr follower = makeFilter(simple_cache_);
+  testDecodeRequestCollapsed(follower);
+
+  EXPECT_CALL(decoder_callbacks_, encodeHeaders_).Times(0);
+  EXPECT_CALL(decoder_callbacks_, continueDecoding);
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "no-store");
+  EXPECT_EQ(leader->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+  EXPECT_EQ(collapsingCounter("released"), 1);
+  EXPECT_EQ(collapsingCounter("collapsed_hit"), 0);
+
+  leader->onDestroy();
+  follower->onDestroy();
+}
+
+TEST_F(CacheFilterTest, CollapsedRequestGoesUpstreamAfterMaxWait) {
+  request_headers_.setHost("CollapsedRequestGoesUpstreamAfterMaxWait");
+  enableRequestCollapsing();
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_);
+  testDecodeRequestMiss(leader);
+  CacheFilterSharedPtr follower = makeFilter(simple_cache_);
+  testDecodeRequestCollapsed(follower);
+
+  EXPECT_CALL(decoder_callbacks_, continueDecoding);
+  time_source_.advanceTimeAndRun(collapse_max_wait_, *dispatcher_,
+                                 Event::Dispatcher::RunType::NonBlock);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+  EXPECT_EQ(collapsingCounter("timed_out"), 1);
+
+  // The leader being done no longer affects the follower.
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_CALL(decoder_callbacks_, encodeHeaders_).Times(0);
+  leader->onDestroy();
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+  EXPECT_EQ(collapsingCounter("released"), 0);
+  follower->onDestroy();
+}
+
+TEST_F(CacheFilterTest, StaleResponseIsServedWhileLeaderRevalidates) {
+  request_headers_.setHost("StaleResponseIsServedWhileLeaderRevalidates");
+  enableRequestCollapsing();
+  response_headers_.setCopy(Http::CustomHeaders::get().CacheControl,
+                            "public, max-age=10, stale-while-revalidate=60");
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().Etag, "abc123");
+  {
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestMiss(filter);
+    EXPECT_EQ(filter->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+    filter->onDestroy();
+  }
+  // The cached response is stale, but within its stale-while-revalidate window.
+  time_source_.advanceTimeWait(Seconds(20));
+
+  // The first request to find it stale validates it.
+  CacheFilterSharedPtr leader = makeFilter(simple_cache_);
+  testDecodeRequestMiss(leader);
+
+  // Others are served the stale response in the meantime.
+  CacheFilterSharedPtr other = makeFilter(simple_cache_);
+  EXPECT_CALL(decoder_callbacks_,
+              encodeHeaders_(HeaderHasValueRef(Http::CustomHeaders::get().Age, "20"), true));
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_EQ(other->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+  EXPECT_EQ(collapsingCounter("served_stale"), 1);
+  EXPECT_EQ(collapsingCounter("collapsed"), 0);
+
+  leader->onDestroy();
+  other->onDestroy();
+}
+
 // This test may mistakenly pass (false positive) even if the CacheFilter is accessed after
 // being deleted, as filter_state_ may be accessed and read as "FilterState::Destroyed" which will
 // result in a correct behavior. However, running the test with ASAN sanitizer enabled should
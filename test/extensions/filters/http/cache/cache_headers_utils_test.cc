@@ -300,6 +300,16 @@ TEST_P(ResponseCacheControlTest, ResponseCacheControlTest) {
   EXPECT_EQ(expected_response_cache_control, ResponseCacheControl(cache_control_header));
 }
 
+TEST(ResponseCacheControlStaleWhileRevalidateTest, ParsesStaleWhileRevalidate) {
+  EXPECT_EQ(ResponseCacheControl("max-age=10, stale-while-revalidate=30").stale_while_revalidate_,
+            Seconds(30));
+  EXPECT_EQ(ResponseCacheControl("stale-while-revalidate=\"5\"").stale_while_revalidate_,
+            Seconds(5));
+  EXPECT_EQ(ResponseCacheControl("max-age=10").stale_while_revalidate_, absl::nullopt);
+  EXPECT_EQ(ResponseCacheControl("stale-while-revalidate=soon").stale_while_revalidate_,
+            absl::nullopt);
+}
+
 class HttpTimeTest : public testing::TestWithParam<std::string> {
 public:
   static const std::vector<std::string>& getOkTestCases() {
@@ -0,0 +1,113 @@
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/filters/http/cache/request_collapser.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+class RequestCollapserTest : public ::testing::Test {
+protected:
+  uint64_t counter(const std::string& name) {
+    const auto counter = TestUtility::findCounter(stats_, "cache.request_collapsing." + name);
+    return counter != nullptr ? counter->value() : 0;
+  }
+
+  uint64_t waiting() {
+    const auto gauge = TestUtility::findGauge(stats_, "cache.request_collapsing.waiting");
+    return gauge != nullptr ? gauge->value() : 0;
+  }
+
+  RequestCollapser::WakeCallback recordWake(std::vector<bool>& woken) {
+    return [&woken](bool cache_filled) { woken.push_back(cache_filled); };
+  }
+
+  void runPosted() { dispatcher_->run(Event::Dispatcher::RunType::NonBlock); }
+
+  Stats::IsolatedStoreImpl stats_;
+  RequestCollapser collapser_{std::chrono::milliseconds(100), *stats_.rootScope(), ""};
+  Api::ApiPtr api_ = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher_ = api_->allocateDispatcher("test_thread");
+};
+
+TEST_F(RequestCollapserTest, FirstRequestLeadsAndOthersFollow) {
+  absl::optional<uint64_t> leader_id = collapser_.lead(1);
+  ASSERT_TRUE(leader_id.has_value());
+  EXPECT_FALSE(collapser_.lead(1).has_value());
+  // Other keys are independent.
+  EXPECT_TRUE(collapser_.lead(2).has_value());
+
+  std::vector<bool> woken;
+  EXPECT_TRUE(collapser_.follow(1, *dispatcher_, recordWake(woken)).has_value());
+  EXPECT_TRUE(collapser_.follow(1, *dispatcher_, recordWake(woken)).has_value());
+  EXPECT_EQ(counter("collapsed"), 2);
+  EXPECT_EQ(waiting(), 2);
+
+  collapser_.done(1, leader_id.value(), true);
+  EXPECT_EQ(waiting(), 0);
+  // Followers are woken on their dispatcher.
+  EXPECT_TRUE(woken.empty());
+  runPosted();
+  EXPECT_EQ(woken, std::vector<bool>({true, true}));
+  EXPECT_EQ(counter("released"), 0);
+
+  // The next request for the key leads.
+  EXPECT_TRUE(collapser_.lead(1).has_value());
+}
+
+TEST_F(RequestCollapserTest, FollowWithoutLeaderFails) {
+  std::vector<bool> woken;
+  EXPECT_FALSE(collapser_.follow(1, *dispatcher_, recordWake(woken)).has_value());
+  EXPECT_EQ(counter("collapsed"), 0);
+}
+
+TEST_F(RequestCollapserTest, FollowersAreReleasedIfCacheNotFilled) {
+  uint64_t leader_id = collapser_.lead(1).value();
+  std::vector<bool> woken;
+  collapser_.follow(1, *dispatcher_, recordWake(woken));
+  collapser_.done(1, leader_id, false);
+  runPosted();
+  EXPECT_EQ(woken, std::vector<bool>({false}));
+  EXPECT_EQ(counter("released"), 1);
+}
+
+TEST_F(RequestCollapserTest, FollowerThatLeftIsNotWoken) {
+  uint64_t leader_id = collapser_.lead(1).value();
+  std::vector<bool> woken;
+  uint64_t follower_id = collapser_.follow(1, *dispatcher_, recordWake(woken)).value();
+  collapser_.leave(1, follower_id);
+  EXPECT_EQ(waiting(), 0);
+  // Leaving twice does nothing.
+  collapser_.leave(1, follower_id);
+  EXPECT_EQ(waiting(), 0);
+  collapser_.done(1, leader_id, true);
+  runPosted();
+  EXPECT_TRUE(woken.empty());
+}
+
+TEST_F(RequestCollapserTest, DoneOfAnEarlierLeaderIsIgnored) {
+  uint64_t first_leader_id = collapser_.lead(1).value();
+  collapser_.done(1, first_leader_id, false);
+  uint64_t second_leader_id = collapser_.lead(1).value();
+  std::vector<bool> woken;
+  collapser_.follow(1, *dispatcher_, recordWake(woken));
+  // A late callback of the first leader doesn't wake the second leader's followers.
+  collapser_.done(1, first_leader_id, true);
+  runPosted();
+  EXPECT_TRUE(woken.empty());
+  EXPECT_FALSE(collapser_.lead(1).has_value());
+  collapser_.done(1, second_leader_id, true);
+  runPosted();
+  EXPECT_EQ(woken, std::vector<bool>({true}));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
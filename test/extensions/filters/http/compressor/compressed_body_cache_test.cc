@@ -0,0 +1,67 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/extensions/filters/http/compressor/compressed_body_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Compressor {
+namespace {
+
+TEST(CompressedBodyCacheTest, Key) {
+  Buffer::OwnedImpl body1("body");
+  Buffer::OwnedImpl body2("body");
+  body2.add("2");
+  EXPECT_EQ(32, CompressedBodyCache::key(body1).size());
+  EXPECT_EQ(CompressedBodyCache::key(body1), CompressedBodyCache::key(Buffer::OwnedImpl("body")));
+  EXPECT_NE(CompressedBodyCache::key(body1), CompressedBodyCache::key(body2));
+}
+
+TEST(CompressedBodyCacheTest, LookupAndInsert) {
+  CompressedBodyCache cache(100);
+  EXPECT_EQ(nullptr, cache.lookup("a"));
+  cache.insert("a", "compressed");
+  ASSERT_NE(nullptr, cache.lookup("a"));
+  EXPECT_EQ("compressed", *cache.lookup("a"));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(10, cache.bytes());
+
+  // Existing entries are not replaced.
+  cache.insert("a", "other");
+  EXPECT_EQ("compressed", *cache.lookup("a"));
+  EXPECT_EQ(10, cache.bytes());
+}
+
+TEST(CompressedBodyCacheTest, EvictLeastRecentlyUsed) {
+  CompressedBodyCache cache(30);
+  cache.insert("a", std::string(10, 'a'));
+  cache.insert("b", std::string(10, 'b'));
+  cache.insert("c", std::string(10, 'c'));
+  EXPECT_EQ(30, cache.bytes());
+
+  // Looking up "a" makes "b" the least recently used entry.
+  EXPECT_NE(nullptr, cache.lookup("a"));
+  cache.insert("d", std::string(15, 'd'));
+  EXPECT_EQ(nullptr, cache.lookup("b"));
+  EXPECT_EQ(nullptr, cache.lookup("c"));
+  EXPECT_NE(nullptr, cache.lookup("a"));
+  EXPECT_NE(nullptr, cache.lookup("d"));
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(25, cache.bytes());
+}
+
+TEST(CompressedBodyCacheTest, BodyLargerThanCache) {
+  CompressedBodyCache cache(10);
+  cache.insert("a", std::string(5, 'a'));
+  cache.insert("b", std::string(11, 'b'));
+  EXPECT_EQ(nullptr, cache.lookup("b"));
+  EXPECT_NE(nullptr, cache.lookup("a"));
+  EXPECT_EQ(5, cache.bytes());
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -147,6 +147,95 @@ public:
             "@type": type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip
     )EOF"};
 
+  const std::string compressed_body_cache_config{R"EOF(
+      name: envoy.filters.http.compressor
+      typed_config:
+        "@type": type.googleapis.com/envoy.extensions.filters.http.compressor.v3.Compressor
+        response_direction_config:
+          compressed_body_cache:
+            max_body_bytes: 65536
+        compressor_library:
+          name: testlib
+          typed_config:
+            "@type": type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip
+    )EOF"};
+
+  // Routes requests for /direct to a direct response with the given body.
+  void addDirectResponseRoute(const std::string& body) {
+    config_helper_.addConfigModifier([body](ConfigHelper::HttpConnectionManager& cm) {
+      auto* vh = cm.mutable_route_config()->mutable_virtual_hosts(0);
+      auto* route = vh->add_routes();
+      route->mutable_match()->set_path("/direct");
+      route->mutable_direct_response()->set_status(200);
+      route->mutable_direct_response()->mutable_body()->set_inline_string(body);
+      // Match it before the default catch-all route.
+      vh->mutable_routes()->SwapElements(0, vh->routes_size() - 1);
+    });
+  }
+
+  // Sends a request for /direct and returns the compressed response body.
+  std::string doDirectResponseRequest() {
+    auto response = codec_client_->makeHeaderOnlyRequest(
+        Http::TestRequestHeaderMapImpl{{":method", "GET"},
+                                       {":path", "/direct"},
+                                       {":scheme", "http"},
+                                       {":authority", "host"},
+                                       {"accept-encoding", "gzip"}});
+    EXPECT_TRUE(response->waitForEndStream());
+    EXPECT_TRUE(response->complete());
+    EXPECT_EQ("gzip", response->headers()
+                          .get(Http::CustomHeaders::get().ContentEncoding)[0]
+                          ->value()
+                          .getStringView());
+    return response->body();
+  }
+
+  // Sends a request to the upstream, which responds with the given body in frames of
+  // `frame_size` bytes, and returns the compressed response body.
+  std::string doMultiFrameUpstreamRequest(const std::string& body, size_t frame_size) {
+    auto response = codec_client_->makeHeaderOnlyRequest(
+        Http::TestRequestHeaderMapImpl{{":method", "GET"},
+                                       {":path", "/test/long/url"},
+                                       {":scheme", "http"},
+                                       {":authority", "host"},
+                                       {"accept-encoding", "gzip"}});
+    waitForNextUpstreamRequest();
+    upstream_request_->encodeHeaders(
+        Http::TestResponseHeaderMapImpl{{":status", "200"},
+                                        {"content-length", absl::StrCat(body.size())},
+                                        {"content-type", "text/plain"}},
+        false);
+    for (size_t offset = 0; offset < body.size(); offset += frame_size) {
+      Buffer::OwnedImpl frame(body.substr(offset, frame_size));
+      upstream_request_->encodeData(frame, offset + frame_size >= body.size());
+    }
+    EXPECT_TRUE(response->waitForEndStream());
+    EXPECT_TRUE(response->complete());
+    EXPECT_EQ("gzip", response->headers()
+                          .get(Http::CustomHeaders::get().ContentEncoding)[0]
+                          ->value()
+                          .getStringView());
+    return response->body();
+  }
+
+  std::string decompress(const std::string& compressed_body) {
+    Extensions::Compression::Gzip::Decompressor::ZlibDecompressorImpl decompressor{
+        *stats_store_.rootScope(), "test", 4096, 100};
+    decompressor.init(window_bits);
+    Buffer::OwnedImpl decompressed;
+    decompressor.decompress(Buffer::OwnedImpl{compressed_body}, decompressed);
+    return decompressed.toString();
+  }
+
+  std::string compressibleBody() {
+    std::string body;
+    for (int i = 0; i < 100; i++) {
+      absl::StrAppend(&body, "line ", i, ": the same few words repeated over and over again\n");
+    }
+    return body;
+  }
+
+  const std::string cache_stats_prefix_{"http.config_test.compressor.testlib.gzip.response."};
   const uint64_t window_bits{15 | 16};
 
   Stats::IsolatedStoreImpl stats_store_;
@@ -474,4 +563,41 @@ TEST_P(CompressorIntegrationTest, PerRouteEnable) {
                                                           {"content-type", "text/xml"}});
 }
 
+// A direct response is encoded as a single frame with end_stream set. The body served from the
+// compressed body cache must be identical to the one compressed when it was inserted.
+TEST_P(CompressorIntegrationTest, CompressedBodyCacheDirectResponse) {
+  const std::string body = compressibleBody();
+  addDirectResponseRoute(body);
+  initializeFilter(compressed_body_cache_config);
+
+  const std::string uncached = doDirectResponseRequest();
+  test_server_->waitForCounterEq(cache_stats_prefix_ + "compressed_body_cache_miss", 1);
+  const std::string cached = doDirectResponseRequest();
+  test_server_->waitForCounterEq(cache_stats_prefix_ + "compressed_body_cache_hit", 1);
+
+  EXPECT_EQ(uncached, cached);
+  EXPECT_LT(uncached.size(), body.size());
+  EXPECT_EQ(body, decompress(uncached));
+}
+
+// An upstream response sent in several frames is buffered before it is compressed or looked up,
+// and the body served from the cache is identical to the one compressed when it was inserted,
+// whichever response inserted it.
+TEST_P(CompressorIntegrationTest, CompressedBodyCacheMultiFrameUpstreamResponse) {
+  const std::string body = compressibleBody();
+  addDirectResponseRoute(body);
+  initializeFilter(compressed_body_cache_config);
+
+  const std::string uncached = doMultiFrameUpstreamRequest(body, 1000);
+  test_server_->waitForCounterEq(cache_stats_prefix_ + "compressed_body_cache_miss", 1);
+  EXPECT_EQ(body, decompress(uncached));
+
+  // The same body is now served from the cache, whether it's split differently or comes from the
+  // direct response.
+  EXPECT_EQ(uncached, doMultiFrameUpstreamRequest(body, 333));
+  EXPECT_EQ(uncached, doDirectResponseRequest());
+  test_server_->waitForCounterEq(cache_stats_prefix_ + "compressed_body_cache_hit", 2);
+  EXPECT_EQ(1, test_server_->counter(cache_stats_prefix_ + "compressed_body_cache_miss")->value());
+}
+
 } // namespace Envoy
@@ -5,16 +5,21 @@
 #include "source/extensions/compression/brotli/compressor/config.h"
 #include "source/extensions/compression/gzip/compressor/config.h"
 #include "source/extensions/compression/gzip/compressor/zlib_compressor_impl.h"
+#include "source/extensions/compression/zstd/compressor/config.h"
 #include "source/extensions/compression/zstd/compressor/zstd_compressor_impl.h"
 #include "source/extensions/filters/http/compressor/compressor_filter.h"
 
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/server/factory_context.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 
 #include "benchmark/benchmark.h"
 #include "gmock/gmock.h"
 
+using testing::_;
+using testing::Invoke;
 using testing::Return;
 
 namespace Envoy {
@@ -106,6 +111,7 @@ struct CompressionParams {
 
 CompressorFilterConfigSharedPtr makeGzipConfig(Stats::IsolatedStoreImpl& stats,
                                                testing::NiceMock<Runtime::MockLoader>& runtime,
+                                               ThreadLocal::SlotAllocator& tls,
                                                const CompressionParams& params) {
 
   envoy::extensions::filters::http::compressor::v3::Compressor compressor;
@@ -121,13 +127,14 @@ CompressorFilterConfigSharedPtr makeGzipConfig(Stats::IsolatedStoreImpl& stats,
   Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
       std::make_unique<MockGzipCompressorFactory>(level, strategy, window_bits, memory_level);
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
-      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory));
+      compressor, "test.", *stats.rootScope(), runtime, tls, std::move(compressor_factory));
 
   return config;
 }
 
 CompressorFilterConfigSharedPtr makeZstdConfig(Stats::IsolatedStoreImpl& stats,
                                                testing::NiceMock<Runtime::MockLoader>& runtime,
+                                               ThreadLocal::SlotAllocator& tls,
                                                const CompressionParams& params) {
 
   envoy::extensions::filters::http::compressor::v3::Compressor compressor;
@@ -137,13 +144,14 @@ CompressorFilterConfigSharedPtr makeZstdConfig(Stats::IsolatedStoreImpl& stats,
   Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
       std::make_unique<MockZstdCompressorFactory>(level, strategy);
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
-      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory));
+      compressor, "test.", *stats.rootScope(), runtime, tls, std::move(compressor_factory));
 
   return config;
 }
 
 CompressorFilterConfigSharedPtr makeBrotliConfig(Stats::IsolatedStoreImpl& stats,
                                                  testing::NiceMock<Runtime::MockLoader>& runtime,
+                                                 ThreadLocal::SlotAllocator& tls,
                                                  const CompressionParams& params) {
 
   envoy::extensions::filters::http::compressor::v3::Compressor compressor;
@@ -152,7 +160,7 @@ CompressorFilterConfigSharedPtr makeBrotliConfig(Stats::IsolatedStoreImpl& stats
   Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory =
       std::make_unique<MockBrotliCompressorFactory>(quality);
   CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
-      compressor, "test.", *stats.rootScope(), runtime, std::move(compressor_factory));
+      compressor, "test.", *stats.rootScope(), runtime, tls, std::move(compressor_factory));
 
   return config;
 }
@@ -208,18 +216,19 @@ static Result compressWith(enum CompressorLibs lib, std::vector<Buffer::OwnedImp
   auto start = std::chrono::high_resolution_clock::now();
   Stats::IsolatedStoreImpl stats;
   testing::NiceMock<Runtime::MockLoader> runtime;
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
   CompressorFilterConfigSharedPtr config;
   std::string compressor = "";
   std::string encoding = "";
   if (lib == CompressorLibs::Brotli) {
-    config = makeBrotliConfig(stats, runtime, params);
+    config = makeBrotliConfig(stats, runtime, tls, params);
     encoding = "br";
     compressor = "brotli";
   } else if (lib == CompressorLibs::Gzip) {
-    config = makeGzipConfig(stats, runtime, params);
+    config = makeGzipConfig(stats, runtime, tls, params);
     encoding = compressor = "gzip";
   } else if (lib == CompressorLibs::Zstd) {
-    config = makeZstdConfig(stats, runtime, params);
+    config = makeZstdConfig(stats, runtime, tls, params);
     encoding = compressor = "zstd";
   }
 
@@ -688,6 +697,181 @@ BENCHMARK(compressChunks1024WithBrotli)
     ->UseManualTime()
     ->Unit(benchmark::kMillisecond);
 
+// Measures the per-response cost of compressing many small responses, where creating and
+// initializing the compression context dominates. The second argument toggles per-worker context
+// pooling. With pooling, the "contexts_per_response" and "pool_hits_per_response" counters report
+// how many contexts the pool had to create and how many it handed out again for each response.
+static void compressSmallResponses(CompressorLibs lib, uint32_t level, bool pooled,
+                                   benchmark::State& state) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  Stats::IsolatedStoreImpl stats;
+  testing::NiceMock<Runtime::MockLoader> runtime;
+  ON_CALL(runtime.snapshot_, featureEnabled("test.filter_enabled", 100))
+      .WillByDefault(Return(true));
+
+  const uint32_t max_pooled_contexts = pooled ? 1 : 0;
+  std::string encoding;
+  Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory;
+  std::function<uint64_t()> contexts_created;
+  std::function<uint64_t()> contexts_reused;
+  if (lib == CompressorLibs::Gzip) {
+    envoy::extensions::compression::gzip::compressor::v3::Gzip gzip;
+    gzip.set_compression_level(
+        static_cast<envoy::extensions::compression::gzip::compressor::v3::Gzip::CompressionLevel>(
+            level));
+    gzip.set_max_pooled_contexts(max_pooled_contexts);
+    auto factory = std::make_unique<Compression::Gzip::Compressor::GzipCompressorFactory>(
+        gzip, context.threadLocal());
+    const auto* pool = factory->contextPool();
+    contexts_created = [pool]() { return pool->created(); };
+    contexts_reused = [pool]() { return pool->reused(); };
+    compressor_factory = std::move(factory);
+    encoding = "gzip";
+  } else {
+    envoy::extensions::compression::zstd::compressor::v3::Zstd zstd;
+    zstd.mutable_compression_level()->set_value(level);
+    zstd.set_max_pooled_contexts(max_pooled_contexts);
+    auto factory = std::make_unique<Compression::Zstd::Compressor::ZstdCompressorFactory>(
+        zstd, context.mainThreadDispatcher(), context.api(), context.threadLocal());
+    const auto* pool = factory->contextPool();
+    contexts_created = [pool]() { return pool->created(); };
+    contexts_reused = [pool]() { return pool->reused(); };
+    compressor_factory = std::move(factory);
+    encoding = "zstd";
+  }
+
+  envoy::extensions::filters::http::compressor::v3::Compressor compressor;
+  CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
+      compressor, "test.", *stats.rootScope(), runtime, context.threadLocal(),
+      std::move(compressor_factory));
+
+  const std::string body = testData().toString().substr(0, 2048);
+  uint64_t responses = 0;
+  for (auto _ : state) { // NOLINT
+    auto filter = std::make_unique<CompressorFilter>(config);
+    filter->setDecoderFilterCallbacks(decoder_callbacks);
+    Http::TestRequestHeaderMapImpl headers = {{":method", "get"}, {"accept-encoding", encoding}};
+    filter->decodeHeaders(headers, false);
+    Http::TestResponseHeaderMapImpl response_headers = {
+        {":status", "200"},
+        {"content-length", absl::StrCat(body.size())},
+        {"content-type", "application/json;charset=utf-8"}};
+    filter->encodeHeaders(response_headers, false);
+    Buffer::OwnedImpl data(body);
+    filter->encodeData(data, true);
+    filter->onDestroy();
+    responses++;
+  }
+  if (pooled && responses > 0) {
+    state.counters["contexts_per_response"] =
+        benchmark::Counter(static_cast<double>(contexts_created()) / responses);
+    state.counters["pool_hits_per_response"] =
+        benchmark::Counter(static_cast<double>(contexts_reused()) / responses);
+  }
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressSmallResponsesWithGzip(benchmark::State& state) {
+  compressSmallResponses(CompressorLibs::Gzip, state.range(0), state.range(1) != 0, state);
+}
+BENCHMARK(compressSmallResponsesWithGzip)
+    ->ArgsProduct({{1, 6, 9}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressSmallResponsesWithZstd(benchmark::State& state) {
+  compressSmallResponses(CompressorLibs::Zstd, state.range(0), state.range(1) != 0, state);
+}
+BENCHMARK(compressSmallResponsesWithZstd)
+    ->ArgsProduct({{3, 12, 19}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Measures serving the same response body repeatedly, e.g. a static JS bundle, with and without
+// the compressed body cache. The second argument toggles the cache.
+static void compressRepeatedBody(CompressorLibs lib, uint32_t level, bool cached,
+                                 benchmark::State& state) {
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks;
+  ON_CALL(encoder_callbacks, addEncodedData(_, _))
+      .WillByDefault(Invoke([&encoder_callbacks](Buffer::Instance& data, bool) {
+        if (encoder_callbacks.buffer_ == nullptr) {
+          encoder_callbacks.buffer_ = std::make_unique<Buffer::OwnedImpl>();
+        }
+        encoder_callbacks.buffer_->move(data);
+      }));
+  ON_CALL(encoder_callbacks, modifyEncodingBuffer(_))
+      .WillByDefault(
+          Invoke([&encoder_callbacks](std::function<void(Buffer::Instance&)> callback) {
+            callback(*encoder_callbacks.buffer_);
+          }));
+  Stats::IsolatedStoreImpl stats;
+  testing::NiceMock<Runtime::MockLoader> runtime;
+  ON_CALL(runtime.snapshot_, featureEnabled("test.filter_enabled", 100))
+      .WillByDefault(Return(true));
+
+  std::string encoding;
+  Envoy::Compression::Compressor::CompressorFactoryPtr compressor_factory;
+  if (lib == CompressorLibs::Gzip) {
+    envoy::extensions::compression::gzip::compressor::v3::Gzip gzip;
+    gzip.set_compression_level(
+        static_cast<envoy::extensions::compression::gzip::compressor::v3::Gzip::CompressionLevel>(
+            level));
+    compressor_factory = std::make_unique<Compression::Gzip::Compressor::GzipCompressorFactory>(
+        gzip, context.threadLocal());
+    encoding = "gzip";
+  } else {
+    envoy::extensions::compression::brotli::compressor::v3::Brotli brotli;
+    brotli.mutable_quality()->set_value(level);
+    compressor_factory =
+        std::make_unique<Compression::Brotli::Compressor::BrotliCompressorFactory>(brotli);
+    encoding = "br";
+  }
+
+  envoy::extensions::filters::http::compressor::v3::Compressor compressor;
+  if (cached) {
+    compressor.mutable_response_direction_config()->mutable_compressed_body_cache();
+  }
+  CompressorFilterConfigSharedPtr config = std::make_shared<CompressorFilterConfig>(
+      compressor, "test.", *stats.rootScope(), runtime, context.threadLocal(),
+      std::move(compressor_factory));
+
+  const std::string body = testData().toString().substr(0, 65536);
+  for (auto _ : state) { // NOLINT
+    auto filter = std::make_unique<CompressorFilter>(config);
+    filter->setDecoderFilterCallbacks(decoder_callbacks);
+    filter->setEncoderFilterCallbacks(encoder_callbacks);
+    encoder_callbacks.buffer_.reset();
+    Http::TestRequestHeaderMapImpl headers = {{":method", "get"}, {"accept-encoding", encoding}};
+    filter->decodeHeaders(headers, false);
+    Http::TestResponseHeaderMapImpl response_headers = {
+        {":status", "200"},
+        {"content-length", absl::StrCat(body.size())},
+        {"content-type", "application/javascript"}};
+    filter->encodeHeaders(response_headers, false);
+    Buffer::OwnedImpl data(body);
+    filter->encodeData(data, true);
+    filter->onDestroy();
+  }
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressRepeatedBodyWithGzip(benchmark::State& state) {
+  compressRepeatedBody(CompressorLibs::Gzip, state.range(0), state.range(1) != 0, state);
+}
+BENCHMARK(compressRepeatedBodyWithGzip)
+    ->ArgsProduct({{1, 9}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void compressRepeatedBodyWithBrotli(benchmark::State& state) {
+  compressRepeatedBody(CompressorLibs::Brotli, state.range(0), state.range(1) != 0, state);
+}
+BENCHMARK(compressRepeatedBodyWithBrotli)
+    ->ArgsProduct({{3, 11}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
 } // namespace Compressor
 } // namespace HttpFilters
 } // namespace Extensions
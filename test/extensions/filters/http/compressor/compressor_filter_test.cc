@@ -4,6 +4,7 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
@@ -66,7 +67,8 @@ public:
     auto compressor_factory = std::make_unique<TestCompressorFactory>("test");
     compressor_factory_ = compressor_factory.get();
     config_ = std::make_shared<CompressorFilterConfig>(compressor, "test.", *stats_.rootScope(),
-                                                       runtime_, std::move(compressor_factory));
+                                                       runtime_, tls_,
+                                                       std::move(compressor_factory));
     filter_ = std::make_unique<CompressorFilter>(config_);
     filter_->setDecoderFilterCallbacks(decoder_callbacks_);
     filter_->setEncoderFilterCallbacks(encoder_callbacks_);
@@ -172,6 +174,7 @@ public:
     }
   }
 
+  NiceMock<ThreadLocal::MockInstance> tls_;
   TestCompressorFactory* compressor_factory_;
   std::shared_ptr<CompressorFilterConfig> config_;
   std::unique_ptr<CompressorFilter> filter_;
@@ -746,6 +749,151 @@ TEST_P(InsertVaryHeaderTest, Validate) {
   EXPECT_EQ(expected, headers.get_("vary"));
 }
 
+class CompressedBodyCacheFilterTest : public CompressorFilterTest {
+public:
+  void SetUp() override {
+    setUpFilter(R"EOF(
+{
+  "response_direction_config": {
+    "compressed_body_cache": {
+      "max_body_bytes": 1024
+    }
+  },
+  "compressor_library": {
+     "name": "test",
+     "typed_config": {
+       "@type": "type.googleapis.com/envoy.extensions.compression.gzip.compressor.v3.Gzip"
+     }
+  }
+}
+)EOF");
+    ON_CALL(encoder_callbacks_, addEncodedData(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) { bufferData(data); }));
+    ON_CALL(encoder_callbacks_, modifyEncodingBuffer(_))
+        .WillByDefault(Invoke([this](std::function<void(Buffer::Instance&)> callback) {
+          callback(*encoder_callbacks_.buffer_);
+        }));
+  }
+
+  void bufferData(Buffer::Instance& data) {
+    if (encoder_callbacks_.buffer_ == nullptr) {
+      encoder_callbacks_.buffer_ = std::make_unique<Buffer::OwnedImpl>();
+    }
+    encoder_callbacks_.buffer_->move(data);
+  }
+
+  // Passes on the buffered data the way the filter manager does when iteration continues.
+  void continueBufferedData(std::string& passed_on) {
+    if (encoder_callbacks_.buffer_ != nullptr) {
+      passed_on.append(encoder_callbacks_.buffer_->toString());
+      encoder_callbacks_.buffer_.reset();
+    }
+  }
+
+  // Sends a response through a new filter instance in chunks of chunk_size bytes and returns the
+  // body passed on to the next filter.
+  std::string doCachedResponse(const std::string& body, uint64_t content_length,
+                               uint64_t chunk_size, bool with_trailers = false) {
+    filter_ = std::make_unique<CompressorFilter>(config_);
+    filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+    filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+    encoder_callbacks_.buffer_.reset();
+
+    Http::TestRequestHeaderMapImpl request_headers{{":method", "get"},
+                                                   {"accept-encoding", "test"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, true));
+    Http::TestResponseHeaderMapImpl headers{{":status", "200"},
+                                            {"content-length", absl::StrCat(content_length)}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+    EXPECT_EQ("test", headers.get_("content-encoding"));
+
+    std::string passed_on;
+    for (uint64_t offset = 0; offset < body.size(); offset += chunk_size) {
+      Buffer::OwnedImpl data(body.substr(offset, chunk_size));
+      const bool end_stream = !with_trailers && offset + chunk_size >= body.size();
+      const Http::FilterDataStatus status = filter_->encodeData(data, end_stream);
+      if (status == Http::FilterDataStatus::StopIterationAndBuffer) {
+        EXPECT_FALSE(end_stream);
+        bufferData(data);
+      } else {
+        EXPECT_EQ(Http::FilterDataStatus::Continue, status);
+        continueBufferedData(passed_on);
+        passed_on.append(data.toString());
+      }
+    }
+    if (with_trailers) {
+      Http::TestResponseTrailerMapImpl trailers;
+      EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->encodeTrailers(trailers));
+      continueBufferedData(passed_on);
+    }
+    return passed_on;
+  }
+
+  uint64_t cacheHits() {
+    return stats_.counter("test.compressor.test.test.compressed_body_cache_hit").value();
+  }
+  uint64_t cacheMisses() {
+    return stats_.counter("test.compressor.test.test.compressed_body_cache_miss").value();
+  }
+};
+
+// Identical bodies are compressed once and served from the cache afterwards.
+TEST_F(CompressedBodyCacheFilterTest, IdenticalBodies) {
+  populateBuffer(512);
+  EXPECT_EQ(expected_str_, doCachedResponse(expected_str_, 512, 128));
+  EXPECT_EQ(0, cacheHits());
+  EXPECT_EQ(1, cacheMisses());
+
+  compressor_factory_->setExpectedCompressCalls(0);
+  EXPECT_EQ(expected_str_, doCachedResponse(expected_str_, 512, 100));
+  EXPECT_EQ(expected_str_, doCachedResponse(expected_str_, 512, 512));
+  EXPECT_EQ(2, cacheHits());
+  EXPECT_EQ(1, cacheMisses());
+  EXPECT_EQ(1, config_->compressedBodyCache()->size());
+  EXPECT_EQ(3 * 512, stats_.counter("test.compressor.test.test.response.total_compressed_bytes")
+                         .value());
+}
+
+TEST_F(CompressedBodyCacheFilterTest, DifferentBodies) {
+  populateBuffer(512);
+  const std::string body1 = expected_str_;
+  populateBuffer(512);
+  const std::string body2 = expected_str_;
+  EXPECT_EQ(body1, doCachedResponse(body1, 512, 512));
+  EXPECT_EQ(body2, doCachedResponse(body2, 512, 512));
+  EXPECT_EQ(0, cacheHits());
+  EXPECT_EQ(2, cacheMisses());
+  EXPECT_EQ(2, config_->compressedBodyCache()->size());
+}
+
+// The body is buffered until trailers arrive.
+TEST_F(CompressedBodyCacheFilterTest, Trailers) {
+  populateBuffer(512);
+  EXPECT_EQ(expected_str_, doCachedResponse(expected_str_, 512, 128, true));
+  EXPECT_EQ(1, cacheMisses());
+}
+
+// Responses announcing a body larger than the limit are streamed.
+TEST_F(CompressedBodyCacheFilterTest, ContentLengthTooLarge) {
+  compressor_factory_->setExpectedCompressCalls(2);
+  populateBuffer(2048);
+  EXPECT_EQ(expected_str_, doCachedResponse(expected_str_, 2048, 1024));
+  EXPECT_EQ(0, cacheHits());
+  EXPECT_EQ(0, cacheMisses());
+}
+
+// A body turning out to be larger than announced falls back to streaming compression.
+TEST_F(CompressedBodyCacheFilterTest, BodyLargerThanContentLength) {
+  // Once for the data buffered so far, then once for each remaining chunk.
+  compressor_factory_->setExpectedCompressCalls(3);
+  populateBuffer(2048);
+  EXPECT_EQ(expected_str_, doCachedResponse(expected_str_, 512, 512));
+  EXPECT_EQ(0, cacheHits());
+  EXPECT_EQ(0, cacheMisses());
+  EXPECT_EQ(2048, stats_.counter("test.compressor.test.test.response.total_uncompressed_bytes")
+                      .value());
+}
+
 class MultipleFiltersTest : public testing::Test {
 protected:
   void SetUp() override {
@@ -763,8 +911,9 @@ protected:
                               compressor);
     auto compressor_factory1 = std::make_unique<TestCompressorFactory>("test1");
     compressor_factory1->setExpectedCompressCalls(0);
-    auto config1 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test1.", *stats1_.rootScope(), runtime_, std::move(compressor_factory1));
+    auto config1 = std::make_shared<CompressorFilterConfig>(compressor, "test1.",
+                                                            *stats1_.rootScope(), runtime_, tls_,
+                                                            std::move(compressor_factory1));
     filter1_ = std::make_unique<CompressorFilter>(config1);
 
     TestUtility::loadFromJson(R"EOF(
@@ -780,12 +929,14 @@ protected:
                               compressor);
     auto compressor_factory2 = std::make_unique<TestCompressorFactory>("test2");
     compressor_factory2->setExpectedCompressCalls(0);
-    auto config2 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test2.", *stats2_.rootScope(), runtime_, std::move(compressor_factory2));
+    auto config2 = std::make_shared<CompressorFilterConfig>(compressor, "test2.",
+                                                            *stats2_.rootScope(), runtime_, tls_,
+                                                            std::move(compressor_factory2));
     filter2_ = std::make_unique<CompressorFilter>(config2);
   }
 
   NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
   Stats::TestUtil::TestStore stats1_;
   Stats::TestUtil::TestStore stats2_;
   std::unique_ptr<CompressorFilter> filter1_;
@@ -886,8 +1037,9 @@ protected:
                                           choose_first1),
                               compressor);
     auto compressor_factory1 = std::make_unique<TestCompressorFactory>("test1");
-    auto config1 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test1.", *stats1_.rootScope(), runtime_, std::move(compressor_factory1));
+    auto config1 = std::make_shared<CompressorFilterConfig>(compressor, "test1.",
+                                                            *stats1_.rootScope(), runtime_, tls_,
+                                                            std::move(compressor_factory1));
     filter1_ = std::make_unique<CompressorFilter>(config1);
 
     TestUtility::loadFromJson(fmt::format(R"EOF(
@@ -904,8 +1056,9 @@ protected:
                                           choose_first2),
                               compressor);
     auto compressor_factory2 = std::make_unique<TestCompressorFactory>("test2");
-    auto config2 = std::make_shared<CompressorFilterConfig>(
-        compressor, "test2.", *stats2_.rootScope(), runtime_, std::move(compressor_factory2));
+    auto config2 = std::make_shared<CompressorFilterConfig>(compressor, "test2.",
+                                                            *stats2_.rootScope(), runtime_, tls_,
+                                                            std::move(compressor_factory2));
     filter2_ = std::make_unique<CompressorFilter>(config2);
   }
 
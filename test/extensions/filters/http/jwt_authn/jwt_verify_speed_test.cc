@@ -0,0 +1,58 @@
+// Compares verifying an RS256 JWT on every request with looking it up in the per-worker JWT cache.
+
+#include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
+
+#include "source/extensions/filters/http/jwt_authn/jwt_cache.h"
+
+#include "test/extensions/filters/http/jwt_authn/test_common.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+#include "jwt_verify_lib/jwks.h"
+#include "jwt_verify_lib/verify.h"
+
+using ::google::jwt_verify::Jwks;
+using ::google::jwt_verify::Jwt;
+using ::google::jwt_verify::Status;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+// Parses and verifies the token, as done on a cache miss.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_VerifyWithoutCache(benchmark::State& state) {
+  const auto jwks = Jwks::createFrom(PublicKey, Jwks::JWKS);
+  RELEASE_ASSERT(jwks->getStatus() == Status::Ok, "");
+
+  for (auto _ : state) { // NOLINT
+    Jwt jwt;
+    RELEASE_ASSERT(jwt.parseFromString(GoodToken) == Status::Ok, "");
+    RELEASE_ASSERT(::google::jwt_verify::verifyJwt(jwt, *jwks) == Status::Ok, "");
+  }
+}
+BENCHMARK(BM_VerifyWithoutCache);
+
+// Looks up the token in a cache holding it, as done on a cache hit.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_VerifyWithCache(benchmark::State& state) {
+  Event::SimulatedTimeSystem time_system;
+  envoy::extensions::filters::http::jwt_authn::v3::JwtCacheConfig config;
+  auto cache = JwtCache::create(true, config, time_system);
+  auto jwt = std::make_unique<Jwt>();
+  RELEASE_ASSERT(jwt->parseFromString(GoodToken) == Status::Ok, "");
+  cache->insert(GoodToken, std::move(jwt));
+
+  for (auto _ : state) { // NOLINT
+    RELEASE_ASSERT(cache->lookup(GoodToken) != nullptr, "");
+  }
+}
+BENCHMARK(BM_VerifyWithCache);
+
+} // namespace
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,150 @@
+// Measures the operations of the in-memory index of the file system cache, with the given number
+// of entries in the index.
+
+#include <string>
+#include <vector>
+
+#include "source/extensions/http/cache/file_system_http_cache/cache_index.h"
+
+#include "test/benchmark/main.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+namespace {
+
+constexpr uint64_t FileSize = 16 * 1024;
+
+std::vector<std::string> makeNames(int64_t count, absl::string_view prefix = "cache-") {
+  std::vector<std::string> names;
+  names.reserve(count);
+  for (int64_t i = 0; i < count; i++) {
+    // Entry filenames are the prefix followed by a 64 bit hash.
+    names.push_back(absl::StrCat(prefix, 0x9e3779b97f4a7c15ULL * (i + 1)));
+  }
+  return names;
+}
+
+bool skipIfExpensive(::benchmark::State& state) {
+  if (Envoy::benchmark::skipExpensiveBenchmarks() && state.range(0) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return true;
+  }
+  return false;
+}
+
+void buildIndex(CacheIndex& index, const std::vector<std::string>& names) {
+  std::vector<CacheIndex::File> files;
+  files.reserve(names.size());
+  for (size_t i = 0; i < names.size(); i++) {
+    files.push_back(CacheIndex::File{names[i], FileSize, SystemTime{} + std::chrono::seconds(i)});
+  }
+  index.build(std::move(files));
+}
+
+} // namespace
+
+// A lookup of an entry in the index, which doesn't touch the file system for the headers if
+// they are kept.
+static void lookupPresent(::benchmark::State& state) {
+  if (skipIfExpensive(state)) {
+    return;
+  }
+  const std::vector<std::string> names = makeNames(state.range(0));
+  CacheIndex index(0);
+  buildIndex(index, names);
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT
+    ::benchmark::DoNotOptimize(index.lookup(names[i]));
+    if (++i == names.size()) {
+      i = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(lookupPresent)->Arg(1000)->Arg(1000000)->Unit(::benchmark::kNanosecond);
+
+// A lookup of an entry not in the index, which is a miss without touching the file system.
+static void lookupAbsent(::benchmark::State& state) {
+  if (skipIfExpensive(state)) {
+    return;
+  }
+  const std::vector<std::string> names = makeNames(state.range(0));
+  const std::vector<std::string> absent_names = makeNames(1000, "cache-absent-");
+  CacheIndex index(0);
+  buildIndex(index, names);
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT
+    ::benchmark::DoNotOptimize(index.lookup(absent_names[i]));
+    if (++i == absent_names.size()) {
+      i = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(lookupAbsent)->Arg(1000)->Arg(1000000)->Unit(::benchmark::kNanosecond);
+
+// Lookups from several threads at once, contending for the lock of the index.
+static void lookupPresentContended(::benchmark::State& state) {
+  if (skipIfExpensive(state)) {
+    return;
+  }
+  static CacheIndex* index;
+  static std::vector<std::string>* names;
+  if (state.thread_index() == 0) {
+    names = new std::vector<std::string>(makeNames(state.range(0)));
+    index = new CacheIndex(0);
+    buildIndex(*index, *names);
+  }
+  size_t i = state.thread_index();
+  for (auto _ : state) { // NOLINT
+    ::benchmark::DoNotOptimize(index->lookup((*names)[i]));
+    i = (i + state.threads()) % names->size();
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    delete index;
+    delete names;
+  }
+}
+BENCHMARK(lookupPresentContended)
+    ->Arg(1000)
+    ->Arg(1000000)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+// Adding an entry to a full cache, and taking the least recently used entry as the eviction
+// candidate, without reading the cache path.
+static void addAndEvict(::benchmark::State& state) {
+  if (skipIfExpensive(state)) {
+    return;
+  }
+  const std::vector<std::string> names = makeNames(state.range(0));
+  const std::vector<std::string> new_names = makeNames(state.range(0), "cache-new-");
+  CacheIndex index(0);
+  buildIndex(index, names);
+  size_t i = 0;
+  for (auto _ : state) { // NOLINT
+    index.add(new_names[i], FileSize);
+    ::benchmark::DoNotOptimize(index.removeLeastRecentlyUsed(FileSize, 1));
+    if (++i == new_names.size()) {
+      i = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(addAndEvict)->Arg(1000)->Arg(1000000)->Unit(::benchmark::kNanosecond);
+
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
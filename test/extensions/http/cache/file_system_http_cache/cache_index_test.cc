@@ -0,0 +1,200 @@
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "source/extensions/http/cache/file_system_http_cache/cache_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace FileSystemHttpCache {
+
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+class CacheIndexTest : public ::testing::Test {
+protected:
+  static SystemTime secondsSinceEpoch(int seconds) {
+    return SystemTime{} + std::chrono::seconds(seconds);
+  }
+
+  static CachedHeadersSharedPtr headersOfSize(size_t header_value_size) {
+    auto headers = std::make_shared<CachedHeaders>();
+    headers->file_ = CacheFileIdentity{1, 100, secondsSinceEpoch(1)};
+    auto header = headers->header_proto_.add_headers();
+    header->set_key("x");
+    header->set_value(std::string(header_value_size, 'a'));
+    return headers;
+  }
+
+  static uint64_t bytesOf(const CachedHeadersSharedPtr& headers) {
+    return headers->header_proto_.ByteSizeLong() + sizeof(CachedHeaders);
+  }
+};
+
+namespace {
+
+TEST_F(CacheIndexTest, LookupBeforeBuildMayBePresent) {
+  CacheIndex index(0);
+  EXPECT_FALSE(index.isBuilt());
+  EXPECT_TRUE(index.lookup("cache-a").maybe_present_);
+}
+
+TEST_F(CacheIndexTest, LookupAfterBuildIsOnlyPresentForIndexedFiles) {
+  CacheIndex index(0);
+  index.build({{"cache-a", 5, secondsSinceEpoch(1)}});
+  EXPECT_TRUE(index.isBuilt());
+  EXPECT_TRUE(index.lookup("cache-a").maybe_present_);
+  EXPECT_FALSE(index.lookup("cache-b").maybe_present_);
+  index.add("cache-b", 10);
+  EXPECT_TRUE(index.lookup("cache-b").maybe_present_);
+  EXPECT_EQ(index.remove("cache-a"), 5);
+  EXPECT_FALSE(index.lookup("cache-a").maybe_present_);
+  EXPECT_EQ(index.remove("cache-a"), absl::nullopt);
+  EXPECT_EQ(index.size(), 1);
+}
+
+TEST_F(CacheIndexTest, RemoveIfUnchangedKeepsEntriesAddedAgainSinceTheLookup) {
+  CacheIndex index(0);
+  index.build({{"cache-a", 5, secondsSinceEpoch(1)}});
+  const uint64_t generation = index.lookup("cache-a").generation_;
+  index.add("cache-a", 10);
+  EXPECT_EQ(index.removeIfUnchanged("cache-a", generation), absl::nullopt);
+  EXPECT_TRUE(index.lookup("cache-a").maybe_present_);
+  EXPECT_EQ(index.removeIfUnchanged("cache-a", index.lookup("cache-a").generation_), 10);
+  EXPECT_FALSE(index.lookup("cache-a").maybe_present_);
+  EXPECT_EQ(index.removeIfUnchanged("cache-a", generation), absl::nullopt);
+}
+
+TEST_F(CacheIndexTest, BuildOrdersFilesByLastTouchBehindEntriesAlreadyAdded) {
+  CacheIndex index(0);
+  index.add("cache-added-during-build", 1);
+  index.build({{"cache-young", 2, secondsSinceEpoch(3)},
+               {"cache-old", 3, secondsSinceEpoch(1)},
+               {"cache-middle", 4, secondsSinceEpoch(2)},
+               {"cache-added-during-build", 99, secondsSinceEpoch(0)}});
+  EXPECT_EQ(index.size(), 4);
+  EXPECT_THAT(index.removeLeastRecentlyUsed(0, 4),
+              ElementsAre(Pair("cache-old", 3), Pair("cache-middle", 4), Pair("cache-young", 2),
+                          Pair("cache-added-during-build", 1)));
+}
+
+TEST_F(CacheIndexTest, LookupAndAddMakeEntriesMostRecentlyUsed) {
+  CacheIndex index(0);
+  index.build({});
+  index.add("cache-a", 1);
+  index.add("cache-b", 1);
+  index.add("cache-c", 1);
+  index.lookup("cache-a");
+  index.add("cache-b", 2);
+  EXPECT_THAT(index.removeLeastRecentlyUsed(0, 3),
+              ElementsAre(Pair("cache-c", 1), Pair("cache-a", 1), Pair("cache-b", 2)));
+}
+
+TEST_F(CacheIndexTest, RemoveLeastRecentlyUsedRemovesUntilBothSizeAndCountAreReached) {
+  CacheIndex index(0);
+  index.build({});
+  index.add("cache-a", 10);
+  index.add("cache-b", 10);
+  index.add("cache-c", 10);
+  index.add("cache-d", 10);
+  EXPECT_THAT(index.removeLeastRecentlyUsed(15, 1),
+              ElementsAre(Pair("cache-a", 10), Pair("cache-b", 10)));
+  EXPECT_THAT(index.removeLeastRecentlyUsed(1, 2),
+              ElementsAre(Pair("cache-c", 10), Pair("cache-d", 10)));
+  EXPECT_THAT(index.removeLeastRecentlyUsed(100, 100), ElementsAre());
+}
+
+TEST_F(CacheIndexTest, HeadersAreNotKeptIfDisabled) {
+  CacheIndex index(0);
+  EXPECT_FALSE(index.cachesHeaders());
+  index.build({});
+  index.add("cache-a", 100);
+  index.setHeaders("cache-a", headersOfSize(10));
+  EXPECT_EQ(index.lookup("cache-a").headers_, nullptr);
+  EXPECT_EQ(index.cachedHeadersBytes(), 0);
+}
+
+TEST_F(CacheIndexTest, HeadersAreKeptUntilEntryIsReplacedOrRemoved) {
+  CacheIndex index(1024 * 1024);
+  index.build({});
+  // Headers of entries not in the index are not kept.
+  index.setHeaders("cache-a", headersOfSize(10));
+  EXPECT_EQ(index.cachedHeadersBytes(), 0);
+  index.add("cache-a", 100);
+  auto headers = headersOfSize(10);
+  index.setHeaders("cache-a", headers);
+  EXPECT_EQ(index.lookup("cache-a").headers_, headers);
+  EXPECT_EQ(index.cachedHeadersBytes(), bytesOf(headers));
+  index.add("cache-a", 200);
+  EXPECT_EQ(index.lookup("cache-a").headers_, nullptr);
+  EXPECT_EQ(index.cachedHeadersBytes(), 0);
+  index.setHeaders("cache-a", headers);
+  index.remove("cache-a");
+  EXPECT_EQ(index.cachedHeadersBytes(), 0);
+}
+
+TEST_F(CacheIndexTest, LeastRecentlyUsedHeadersAreDroppedOverTheLimit) {
+  auto headers_a = headersOfSize(100);
+  auto headers_b = headersOfSize(100);
+  auto headers_c = headersOfSize(100);
+  CacheIndex index(bytesOf(headers_a) * 2);
+  index.build({});
+  index.add("cache-a", 100);
+  index.add("cache-b", 100);
+  index.add("cache-c", 100);
+  index.setHeaders("cache-a", headers_a);
+  index.setHeaders("cache-b", headers_b);
+  // Using a makes b the least recently used headers.
+  index.lookup("cache-a");
+  index.setHeaders("cache-c", headers_c);
+  EXPECT_EQ(index.lookup("cache-a").headers_, headers_a);
+  EXPECT_EQ(index.lookup("cache-b").headers_, nullptr);
+  EXPECT_EQ(index.lookup("cache-c").headers_, headers_c);
+  EXPECT_EQ(index.cachedHeadersBytes(), bytesOf(headers_a) * 2);
+  // The entry itself is still in the index.
+  EXPECT_TRUE(index.lookup("cache-b").maybe_present_);
+}
+
+TEST_F(CacheIndexTest, HeadersLargerThanTheLimitAreNotKept) {
+  auto headers = headersOfSize(100);
+  CacheIndex index(bytesOf(headers) - 1);
+  index.build({});
+  index.add("cache-a", 100);
+  index.setHeaders("cache-a", headers);
+  EXPECT_EQ(index.lookup("cache-a").headers_, nullptr);
+  EXPECT_EQ(index.cachedHeadersBytes(), 0);
+}
+
+TEST_F(CacheIndexTest, FileIdentityComparesInodeSizeAndChangeTime) {
+  struct stat s = {};
+  s.st_ino = 123;
+  s.st_size = 456;
+  CacheFileIdentity identity = CacheFileIdentity::fromStat(s);
+  EXPECT_EQ(identity, CacheFileIdentity::fromStat(s));
+  struct stat other = s;
+  other.st_ino = 124;
+  EXPECT_NE(identity, CacheFileIdentity::fromStat(other));
+  other = s;
+  other.st_size = 457;
+  EXPECT_NE(identity, CacheFileIdentity::fromStat(other));
+  other = s;
+#ifdef _DARWIN_FEATURE_64_BIT_INODE
+  other.st_ctimespec.tv_nsec = 1;
+#else
+  other.st_ctim.tv_nsec = 1;
+#endif
+  EXPECT_NE(identity, CacheFileIdentity::fromStat(other));
+}
+
+} // namespace
+} // namespace FileSystemHttpCache
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -81,6 +81,9 @@ public:
     ConfigProto cfg;
     MessageUtil::unpackTo(cache_config.typed_config(), cfg);
     cfg.set_cache_path(cache_path_);
+    if (in_memory_index_) {
+      cfg.mutable_in_memory_index();
+    }
     return cfg;
   }
 
@@ -101,6 +104,7 @@ protected:
 
   ::Envoy::TestEnvironment env_;
   std::string cache_path_;
+  bool in_memory_index_ = false;
   NiceMock<Server::Configuration::MockFactoryContext> context_;
   std::shared_ptr<FileSystemHttpCache> cache_;
   LogLevelSetter log_level_ = LogLevelSetter(spdlog::level::debug);
@@ -189,6 +193,37 @@ TEST_F(FileSystemHttpCacheTestWithNoDefaultCache, EvictsOldestFilesUntilUnderSiz
   EXPECT_EQ(cache_->stats().eviction_runs_.value(), 1);
 }
 
+TEST_F(FileSystemHttpCacheTestWithNoDefaultCache, IndexEvictsLeastRecentlyUsedFiles) {
+  const std::string file_contents = "XXXXX";
+  const uint64_t max_count = 2;
+  in_memory_index_ = true;
+  ConfigProto cfg = testConfig();
+  cfg.mutable_max_cache_entry_count()->set_value(max_count);
+  env_.writeStringToFileForTest(absl::StrCat(cache_path_, "cache-a"), file_contents, true);
+  env_.writeStringToFileForTest(absl::StrCat(cache_path_, "cache-b"), file_contents, true);
+  cache_ = std::dynamic_pointer_cast<FileSystemHttpCache>(
+      http_cache_factory_->getCache(cacheConfig(cfg), context_));
+  waitForEvictionThreadIdle();
+  ASSERT_NE(cache_->index(), nullptr);
+  EXPECT_EQ(cache_->index()->size(), 2);
+  EXPECT_EQ(cache_->stats().size_count_.value(), 2);
+  EXPECT_FALSE(cache_->index()->lookup("cache-c").maybe_present_);
+  // Looking up a makes b the least recently used, regardless of file times.
+  EXPECT_TRUE(cache_->index()->lookup("cache-b").maybe_present_);
+  EXPECT_TRUE(cache_->index()->lookup("cache-a").maybe_present_);
+  env_.writeStringToFileForTest(absl::StrCat(cache_path_, "cache-c"), file_contents, true);
+  cache_->trackFileAdded("cache-c", file_contents.size());
+  waitForEvictionThreadIdle();
+  EXPECT_EQ(cache_->stats().size_bytes_.value(), file_contents.size() * 2);
+  EXPECT_EQ(cache_->stats().size_count_.value(), 2);
+  EXPECT_EQ(cache_->index()->size(), 2);
+  EXPECT_TRUE(Filesystem::fileSystemForTest().fileExists(absl::StrCat(cache_path_, "cache-a")));
+  EXPECT_FALSE(Filesystem::fileSystemForTest().fileExists(absl::StrCat(cache_path_, "cache-b")));
+  EXPECT_TRUE(Filesystem::fileSystemForTest().fileExists(absl::StrCat(cache_path_, "cache-c")));
+  EXPECT_FALSE(cache_->index()->lookup("cache-b").maybe_present_);
+  EXPECT_EQ(cache_->stats().eviction_runs_.value(), 1);
+}
+
 class FileSystemHttpCacheTest : public FileSystemCacheTestContext, public ::testing::Test {
   void SetUp() override { initCache(); }
 };
@@ -1274,6 +1309,65 @@ TEST_F(FileSystemHttpCacheTestWithMockFiles, UpdateHeadersAbortsEarlyIfCacheEntr
   EXPECT_OK(mock_async_file_handle_->close([](absl::Status) {}));
 }
 
+class FileSystemHttpCacheTestWithMockFilesAndIndex : public FileSystemHttpCacheTestWithMockFiles {
+public:
+  FileSystemHttpCacheTestWithMockFilesAndIndex() { in_memory_index_ = true; }
+
+  void SetUp() override {
+    initCache();
+    // The index is built from the (empty) cache path by the eviction thread.
+    waitForEvictionThreadIdle();
+  }
+};
+
+TEST_F(FileSystemHttpCacheTestWithMockFilesAndIndex, LookupOfEntryNotInIndexMissesWithoutOpening) {
+  auto lookup = testLookupContext();
+  absl::Cleanup destroy_lookup([&lookup]() { lookup->onDestroy(); });
+  EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _)).Times(0);
+  LookupResult result;
+  lookup->getHeaders([&](LookupResult&& r) { result = std::move(r); });
+  EXPECT_EQ(result.cache_entry_status_, CacheEntryStatus::Unusable);
+  EXPECT_EQ(cache_->stats().cache_miss_.value(), 1);
+  // The file handle didn't actually get used in this test, but is expected to be closed.
+  EXPECT_OK(mock_async_file_handle_->close([](absl::Status) {}));
+}
+
+TEST_F(FileSystemHttpCacheTestWithMockFilesAndIndex, LookupUsesKeptHeadersOnlyForTheSameFile) {
+  cache_->trackFileAdded(cache_->generateFilename(key_), 1234);
+  struct stat file_stat = {};
+  file_stat.st_size = 1234;
+  // The second lookup opens the same file as the first, the third a replacement of it.
+  for (ino_t inode : {5, 5, 6}) {
+    const bool expect_read = inode != file_stat.st_ino;
+    file_stat.st_ino = inode;
+    auto file_handle = std::make_shared<MockAsyncFileContext>(mock_async_file_manager_);
+    LookupResult result;
+    {
+      auto lookup = testLookupContext();
+      absl::Cleanup destroy_lookup([&lookup]() { lookup->onDestroy(); });
+      EXPECT_CALL(*mock_async_file_manager_, openExistingFile(_, _, _));
+      EXPECT_CALL(*file_handle, stat(_));
+      EXPECT_CALL(*file_handle, read(_, _, _)).Times(expect_read ? 2 : 0);
+      lookup->getHeaders([&](LookupResult&& r) { result = std::move(r); });
+      mock_async_file_manager_->nextActionCompletes(absl::StatusOr<AsyncFileHandle>(file_handle));
+      mock_async_file_manager_->nextActionCompletes(absl::StatusOr<struct stat>(file_stat));
+      if (expect_read) {
+        mock_async_file_manager_->nextActionCompletes(
+            absl::StatusOr<Buffer::InstancePtr>(testHeaderBlock(0)));
+        mock_async_file_manager_->nextActionCompletes(
+            absl::StatusOr<Buffer::InstancePtr>(testHeaderBuffer()));
+      }
+      EXPECT_EQ(result.cache_entry_status_, CacheEntryStatus::Ok);
+    }
+    // Consume the close from the queue that occurs when lookup context is destroyed.
+    mock_async_file_manager_->nextActionCompletes(absl::OkStatus());
+  }
+  EXPECT_EQ(cache_->stats().cache_hit_.value(), 3);
+  EXPECT_GT(cache_->index()->cachedHeadersBytes(), 0);
+  // The file handle didn't actually get used in this test, but is expected to be closed.
+  EXPECT_OK(mock_async_file_handle_->close([](absl::Status) {}));
+}
+
 // For the standard cache tests from http_cache_implementation_test_common.cc
 // These will be run with the real file system, and therefore only cover the
 // "no file errors" paths.
@@ -1292,6 +1386,26 @@ INSTANTIATE_TEST_SUITE_P(FileSystemHttpCacheTest, HttpCacheImplementationTest,
                            return "FileSystemHttpCache";
                          });
 
+// The standard cache tests again, with lookups and eviction going through the in-memory index.
+class FileSystemHttpCacheWithIndexTestDelegate : public HttpCacheTestDelegate,
+                                                 public FileSystemCacheTestContext {
+public:
+  FileSystemHttpCacheWithIndexTestDelegate() {
+    in_memory_index_ = true;
+    initCache();
+    waitForEvictionThreadIdle();
+  }
+  std::shared_ptr<HttpCache> cache() override { return cache_; }
+  bool validationEnabled() const override { return true; }
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    FileSystemHttpCacheWithIndexTest, HttpCacheImplementationTest,
+    testing::Values(std::make_unique<FileSystemHttpCacheWithIndexTestDelegate>),
+    [](const testing::TestParamInfo<HttpCacheImplementationTest::ParamType>&) {
+      return "FileSystemHttpCacheWithIndex";
+    });
+
 TEST(Registration, GetCacheFromFactory) {
   HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
       "envoy.extensions.http.cache.file_system_http_cache.v3.FileSystemHttpCacheConfig");
@@ -0,0 +1,138 @@
+#include <string>
+
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+
+#include "source/extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+#include "source/extensions/resource_monitors/common/cgroup_stats_reader.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+class ResourcePressure : public Server::ResourceUpdateCallbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+class CgroupMemoryMonitorTest : public testing::Test {
+protected:
+  CgroupMemoryMonitorTest()
+      : api_(Api::createApiForTest()), root_(TestEnvironment::temporaryPath("cgroup_memory")) {
+    TestEnvironment::removePath(root_);
+    TestEnvironment::createPath(root_);
+  }
+
+  ~CgroupMemoryMonitorTest() override { TestEnvironment::removePath(root_); }
+
+  void writeFile(const std::string& name, const std::string& contents) {
+    TestEnvironment::writeStringToFileForTest(absl::StrCat(root_, "/", name), contents, true);
+  }
+
+  void writeV2(const std::string& current, const std::string& max) {
+    writeFile("cgroup.controllers", "memory\n");
+    writeFile("memory.current", current);
+    writeFile("memory.max", max);
+  }
+
+  ResourcePressure update(uint64_t max_memory_bytes, bool use_pressure_stall_information) {
+    envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig config;
+    config.set_max_memory_bytes(max_memory_bytes);
+    config.set_use_pressure_stall_information(use_pressure_stall_information);
+    CgroupMemoryMonitor monitor(
+        config, std::make_unique<Common::CgroupStatsReader>(api_->fileSystem(), root_));
+    ResourcePressure resource;
+    monitor.updateResourceUsage(resource);
+    return resource;
+  }
+
+  Api::ApiPtr api_;
+  const std::string root_;
+};
+
+TEST_F(CgroupMemoryMonitorTest, UsesCgroupLimit) {
+  writeV2("300\n", "1000\n");
+  ResourcePressure resource = update(0, false);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.3, resource.pressure());
+}
+
+TEST_F(CgroupMemoryMonitorTest, UsesLowerOfConfiguredAndCgroupLimit) {
+  writeV2("300\n", "1000\n");
+  ResourcePressure resource = update(600, false);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.5, resource.pressure());
+
+  resource = update(2000, false);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.3, resource.pressure());
+}
+
+TEST_F(CgroupMemoryMonitorTest, UsesConfiguredLimitWithoutCgroupLimit) {
+  writeV2("300\n", "max\n");
+  ResourcePressure resource = update(600, false);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.5, resource.pressure());
+}
+
+TEST_F(CgroupMemoryMonitorTest, FailsWithoutLimit) {
+  writeV2("300\n", "max\n");
+  ResourcePressure resource = update(0, false);
+  EXPECT_FALSE(resource.hasPressure());
+  EXPECT_TRUE(resource.hasError());
+}
+
+TEST_F(CgroupMemoryMonitorTest, FailsWithoutUsage) {
+  writeFile("cgroup.controllers", "memory\n");
+  ResourcePressure resource = update(600, false);
+  EXPECT_FALSE(resource.hasPressure());
+  EXPECT_TRUE(resource.hasError());
+}
+
+TEST_F(CgroupMemoryMonitorTest, PressureStallInformation) {
+  writeV2("300\n", "1000\n");
+  writeFile("memory.pressure", "some avg10=75.00 avg60=10.00 avg300=1.00 total=1234\n"
+                               "full avg10=50.00 avg60=5.00 avg300=0.50 total=123\n");
+  ResourcePressure resource = update(0, true);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.75, resource.pressure());
+
+  writeFile("memory.pressure", "some avg10=10.00 avg60=10.00 avg300=1.00 total=1234\n");
+  resource = update(0, true);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.3, resource.pressure());
+}
+
+TEST_F(CgroupMemoryMonitorTest, FailsWithoutPressureStallInformation) {
+  writeV2("300\n", "1000\n");
+  ResourcePressure resource = update(0, true);
+  EXPECT_FALSE(resource.hasPressure());
+  EXPECT_TRUE(resource.hasError());
+}
+
+} // namespace
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,127 @@
+#include <string>
+
+#include "source/extensions/resource_monitors/common/cgroup_stats_reader.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace Common {
+namespace {
+
+class CgroupStatsReaderTest : public testing::Test {
+protected:
+  CgroupStatsReaderTest()
+      : api_(Api::createApiForTest()), root_(TestEnvironment::temporaryPath("cgroup")) {
+    TestEnvironment::removePath(root_);
+    TestEnvironment::createPath(root_);
+  }
+
+  ~CgroupStatsReaderTest() override { TestEnvironment::removePath(root_); }
+
+  void writeFile(const std::string& relative_path, const std::string& contents) {
+    const std::string path = absl::StrCat(root_, "/", relative_path);
+    TestEnvironment::createPath(path.substr(0, path.rfind('/')));
+    TestEnvironment::writeStringToFileForTest(path, contents, true);
+  }
+
+  CgroupStatsReader reader() { return CgroupStatsReader(api_->fileSystem(), root_); }
+
+  Api::ApiPtr api_;
+  const std::string root_;
+};
+
+TEST_F(CgroupStatsReaderTest, V2) {
+  writeFile("cgroup.controllers", "cpu io memory pids\n");
+  writeFile("cpu.stat", "usage_usec 123456\nuser_usec 100000\nsystem_usec 23456\n");
+  writeFile("cpu.max", "150000 100000\n");
+  writeFile("memory.current", "1048576\n");
+  writeFile("memory.stat", "anon 524288\nfile 524288\nactive_file 262144\ninactive_file 131072\n");
+  writeFile("memory.max", "4194304\n");
+  writeFile("memory.pressure", "some avg10=12.50 avg60=1.00 avg300=0.10 total=1234\n"
+                               "full avg10=2.00 avg60=0.50 avg300=0.05 total=123\n");
+
+  CgroupStatsReader cgroup = reader();
+  EXPECT_TRUE(cgroup.isV2());
+  EXPECT_EQ(123456, cgroup.cpuUsageMicros());
+  EXPECT_EQ(1.5, cgroup.cpuLimit());
+  // The inactive file cache is reclaimable, and not counted as used.
+  EXPECT_EQ(917504, cgroup.memoryUsageBytes());
+  EXPECT_EQ(4194304, cgroup.memoryLimitBytes());
+  EXPECT_EQ(0.125, cgroup.memoryPressure());
+}
+
+TEST_F(CgroupStatsReaderTest, V2WithoutLimits) {
+  writeFile("cgroup.controllers", "cpu memory\n");
+  writeFile("cpu.max", "max 100000\n");
+  writeFile("memory.max", "max\n");
+
+  CgroupStatsReader cgroup = reader();
+  EXPECT_FALSE(cgroup.cpuLimit().has_value());
+  EXPECT_FALSE(cgroup.memoryLimitBytes().has_value());
+  // Files which don't exist, e.g. memory.pressure without PSI support in the kernel.
+  EXPECT_FALSE(cgroup.cpuUsageMicros().has_value());
+  EXPECT_FALSE(cgroup.memoryUsageBytes().has_value());
+  EXPECT_FALSE(cgroup.memoryPressure().has_value());
+}
+
+TEST_F(CgroupStatsReaderTest, V1) {
+  writeFile("cpuacct/cpuacct.usage", "123456789\n");
+  writeFile("cpu/cpu.cfs_quota_us", "50000\n");
+  writeFile("cpu/cpu.cfs_period_us", "100000\n");
+  writeFile("memory/memory.usage_in_bytes", "1048576\n");
+  writeFile("memory/memory.stat", "inactive_file 4096\ntotal_inactive_file 131072\n");
+  writeFile("memory/memory.limit_in_bytes", "2097152\n");
+
+  CgroupStatsReader cgroup = reader();
+  EXPECT_FALSE(cgroup.isV2());
+  EXPECT_EQ(123456, cgroup.cpuUsageMicros());
+  EXPECT_EQ(0.5, cgroup.cpuLimit());
+  // The usage includes the memory of child cgroups, so their inactive file cache is left out too.
+  EXPECT_EQ(917504, cgroup.memoryUsageBytes());
+  EXPECT_EQ(2097152, cgroup.memoryLimitBytes());
+  // Pressure stall information is only available with cgroup v2.
+  EXPECT_FALSE(cgroup.memoryPressure().has_value());
+}
+
+TEST_F(CgroupStatsReaderTest, InactiveFileAboveUsage) {
+  writeFile("cgroup.controllers", "memory\n");
+  writeFile("memory.current", "4096\n");
+  writeFile("memory.stat", "inactive_file 8192\n");
+  EXPECT_EQ(0, reader().memoryUsageBytes());
+}
+
+TEST_F(CgroupStatsReaderTest, V1WithoutLimits) {
+  writeFile("cpu/cpu.cfs_quota_us", "-1\n");
+  writeFile("cpu/cpu.cfs_period_us", "100000\n");
+  writeFile("memory/memory.limit_in_bytes", "9223372036854771712\n");
+
+  CgroupStatsReader cgroup = reader();
+  EXPECT_FALSE(cgroup.cpuLimit().has_value());
+  EXPECT_FALSE(cgroup.memoryLimitBytes().has_value());
+}
+
+TEST_F(CgroupStatsReaderTest, Malformed) {
+  writeFile("cgroup.controllers", "");
+  writeFile("cpu.stat", "user_usec 100000\n");
+  writeFile("cpu.max", "100000\n");
+  writeFile("memory.current", "a lot\n");
+  writeFile("memory.pressure", "full avg10=2.00 avg60=0.50 avg300=0.05 total=123\n");
+
+  CgroupStatsReader cgroup = reader();
+  EXPECT_FALSE(cgroup.cpuUsageMicros().has_value());
+  EXPECT_FALSE(cgroup.cpuLimit().has_value());
+  EXPECT_FALSE(cgroup.memoryUsageBytes().has_value());
+  EXPECT_FALSE(cgroup.memoryPressure().has_value());
+}
+
+} // namespace
+} // namespace Common
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,52 @@
+#include "envoy/extensions/resource_monitors/cpu_utilization/v3/cpu_utilization.pb.h"
+#include "envoy/extensions/resource_monitors/cpu_utilization/v3/cpu_utilization.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/extensions/resource_monitors/cpu_utilization/config.h"
+#include "source/server/resource_monitor_config_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/options.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+namespace {
+
+class CpuUtilizationMonitorFactoryTest
+    : public testing::TestWithParam<
+          envoy::extensions::resource_monitors::cpu_utilization::v3::CpuUtilizationConfig::
+              UtilizationComputeStrategy> {};
+
+INSTANTIATE_TEST_SUITE_P(
+    Modes, CpuUtilizationMonitorFactoryTest,
+    testing::Values(
+        envoy::extensions::resource_monitors::cpu_utilization::v3::CpuUtilizationConfig::HOST,
+        envoy::extensions::resource_monitors::cpu_utilization::v3::CpuUtilizationConfig::
+            CONTAINER));
+
+TEST_P(CpuUtilizationMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.cpu_utilization");
+  EXPECT_NE(factory, nullptr);
+
+  envoy::extensions::resource_monitors::cpu_utilization::v3::CpuUtilizationConfig config;
+  config.set_mode(GetParam());
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  Server::MockOptions options;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor());
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+} // namespace
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
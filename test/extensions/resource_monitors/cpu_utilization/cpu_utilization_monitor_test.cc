@@ -0,0 +1,196 @@
+#include <string>
+
+#include "source/extensions/resource_monitors/common/cgroup_stats_reader.h"
+#include "source/extensions/resource_monitors/cpu_utilization/cpu_utilization_monitor.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuUtilizationMonitor {
+namespace {
+
+using testing::Return;
+
+class MockCpuStatsReader : public CpuStatsReader {
+public:
+  MOCK_METHOD(absl::optional<CpuTimes>, getCpuTimes, ());
+};
+
+class ResourcePressure : public Server::ResourceUpdateCallbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+    error_.reset();
+  }
+
+  void onFailure(const EnvoyException& error) override {
+    error_ = error;
+    pressure_.reset();
+  }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+TEST(CpuUtilizationMonitorTest, ComputesUtilizationSincePreviousUpdate) {
+  auto stats_reader = std::make_unique<MockCpuStatsReader>();
+  EXPECT_CALL(*stats_reader, getCpuTimes())
+      .WillOnce(Return(CpuTimes{100, 1000}))
+      .WillOnce(Return(CpuTimes{150, 1100}))
+      .WillOnce(Return(CpuTimes{250, 1200}))
+      // No time passed.
+      .WillOnce(Return(CpuTimes{250, 1200}))
+      .WillOnce(Return(absl::nullopt));
+  CpuUtilizationMonitor monitor(std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.5, resource.pressure());
+
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(1.0, resource.pressure());
+
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(1.0, resource.pressure());
+
+  monitor.updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasError());
+}
+
+TEST(CpuUtilizationMonitorTest, InitialReadFailure) {
+  auto stats_reader = std::make_unique<MockCpuStatsReader>();
+  EXPECT_CALL(*stats_reader, getCpuTimes())
+      .WillOnce(Return(absl::nullopt))
+      .WillOnce(Return(CpuTimes{100, 1000}))
+      .WillOnce(Return(CpuTimes{300, 2000}));
+  CpuUtilizationMonitor monitor(std::move(stats_reader));
+
+  // Nothing to compare the first successful read with.
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.0, resource.pressure());
+
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.2, resource.pressure());
+}
+
+class CpuStatsReaderTest : public testing::Test {
+protected:
+  CpuStatsReaderTest()
+      : api_(Api::createApiForTest()), root_(TestEnvironment::temporaryPath("cpu_stats")) {
+    TestEnvironment::removePath(root_);
+    TestEnvironment::createPath(root_);
+  }
+
+  ~CpuStatsReaderTest() override { TestEnvironment::removePath(root_); }
+
+  std::string writeFile(const std::string& relative_path, const std::string& contents) {
+    const std::string path = absl::StrCat(root_, "/", relative_path);
+    TestEnvironment::createPath(path.substr(0, path.rfind('/')));
+    return TestEnvironment::writeStringToFileForTest(path, contents, true);
+  }
+
+  Api::ApiPtr api_;
+  const std::string root_;
+  Event::SimulatedTimeSystem time_system_;
+};
+
+TEST_F(CpuStatsReaderTest, Host) {
+  const std::string path =
+      writeFile("stat", "cpu  100 20 30 800 50 5 10 2 40 0\ncpu0 50 10 15 400 25 2 5 1 20 0\n");
+  HostCpuStatsReader reader(path);
+  const absl::optional<CpuTimes> times = reader.getCpuTimes();
+  ASSERT_TRUE(times.has_value());
+  // The steal time is neither used nor available.
+  EXPECT_EQ(165, times->work_time_);
+  EXPECT_EQ(1015, times->total_time_);
+}
+
+// Reads the statistics of the host running the test, which are outside of the paths
+// Filesystem::Instance::fileReadToEnd() may read.
+TEST_F(CpuStatsReaderTest, HostProcStat) {
+  if (!api_->fileSystem().fileExists("/proc/stat")) {
+    GTEST_SKIP() << "/proc/stat is not available";
+  }
+  HostCpuStatsReader reader;
+  const absl::optional<CpuTimes> times = reader.getCpuTimes();
+  ASSERT_TRUE(times.has_value());
+  EXPECT_GT(times->total_time_, 0);
+  EXPECT_LE(times->work_time_, times->total_time_);
+}
+
+TEST_F(CpuStatsReaderTest, HostMalformed) {
+  HostCpuStatsReader missing(absl::StrCat(root_, "/missing"));
+  EXPECT_FALSE(missing.getCpuTimes().has_value());
+
+  HostCpuStatsReader truncated(writeFile("truncated", "cpu  100 20\n"));
+  EXPECT_FALSE(truncated.getCpuTimes().has_value());
+
+  HostCpuStatsReader garbage(writeFile("garbage", "cpu  a b c d e\n"));
+  EXPECT_FALSE(garbage.getCpuTimes().has_value());
+}
+
+TEST_F(CpuStatsReaderTest, ContainerWithLimit) {
+  writeFile("cgroup.controllers", "cpu\n");
+  writeFile("cpu.max", "200000 100000\n");
+  writeFile("cpu.stat", "usage_usec 1000000\n");
+  ContainerCpuStatsReader reader(
+      std::make_unique<Common::CgroupStatsReader>(api_->fileSystem(), root_), time_system_, 8);
+
+  absl::optional<CpuTimes> times = reader.getCpuTimes();
+  ASSERT_TRUE(times.has_value());
+  EXPECT_EQ(1000000, times->work_time_);
+  EXPECT_EQ(0, times->total_time_);
+
+  // Two CPUs are available for one second.
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  writeFile("cpu.stat", "usage_usec 2500000\n");
+  times = reader.getCpuTimes();
+  ASSERT_TRUE(times.has_value());
+  EXPECT_EQ(2500000, times->work_time_);
+  EXPECT_EQ(2000000, times->total_time_);
+}
+
+TEST_F(CpuStatsReaderTest, ContainerWithoutLimit) {
+  writeFile("cpu/cpu.cfs_quota_us", "-1\n");
+  writeFile("cpu/cpu.cfs_period_us", "100000\n");
+  writeFile("cpuacct/cpuacct.usage", "1000000000\n");
+  ContainerCpuStatsReader reader(
+      std::make_unique<Common::CgroupStatsReader>(api_->fileSystem(), root_), time_system_, 4);
+
+  ASSERT_TRUE(reader.getCpuTimes().has_value());
+  // All CPUs of the host are available.
+  time_system_.advanceTimeWait(std::chrono::milliseconds(500));
+  const absl::optional<CpuTimes> times = reader.getCpuTimes();
+  ASSERT_TRUE(times.has_value());
+  EXPECT_EQ(2000000, times->total_time_);
+
+  TestEnvironment::removePath(absl::StrCat(root_, "/cpuacct"));
+  EXPECT_FALSE(reader.getCpuTimes().has_value());
+}
+
+} // namespace
+} // namespace CpuUtilizationMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
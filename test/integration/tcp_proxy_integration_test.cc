@@ -44,6 +44,21 @@ void TcpProxyIntegrationTest::setupByteMeterAccessLog() {
                        "UPSTREAM_WIRE_BYTES_RECEIVED=%UPSTREAM_WIRE_BYTES_RECEIVED%");
 }
 
+void TcpProxyIntegrationTest::enableSplice() {
+  config_helper_.addConfigModifier([](envoy::config::bootstrap::v3::Bootstrap& bootstrap) -> void {
+    auto* listener = bootstrap.mutable_static_resources()->mutable_listeners(0);
+    auto* filter_chain = listener->mutable_filter_chains(0);
+    auto* config_blob = filter_chain->mutable_filters(0)->mutable_typed_config();
+
+    ASSERT_TRUE(config_blob->Is<envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy>());
+    auto tcp_proxy_config =
+        MessageUtil::anyConvert<envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy>(
+            *config_blob);
+    tcp_proxy_config.set_use_splice(true);
+    config_blob->PackFrom(tcp_proxy_config);
+  });
+}
+
 INSTANTIATE_TEST_SUITE_P(IpVersions, TcpProxyIntegrationTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
                          TestUtility::ipTestParamsToString);
@@ -678,6 +693,80 @@ TEST_P(TcpProxyIntegrationTest, TcpProxyBidirectionalBytesMeter) {
   }
 }
 
+// Test proxying in both directions, including half closes, while splicing.
+TEST_P(TcpProxyIntegrationTest, TcpProxySplice) {
+  setupByteMeterAccessLog();
+  enableSplice();
+  initialize();
+
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+#if defined(__linux__)
+  test_server_->waitForCounterEq("tcp.tcpproxy_stats.downstream_cx_splice_total", 1);
+#else
+  EXPECT_EQ(0, test_server_->counter("tcp.tcpproxy_stats.downstream_cx_splice_total")->value());
+#endif
+
+  ASSERT_TRUE(tcp_client->write("hello"));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(5));
+  ASSERT_TRUE(fake_upstream_connection->write("squack"));
+  tcp_client->waitForData("squack");
+
+  const std::string large_data(1024 * 1024, 'a');
+  ASSERT_TRUE(tcp_client->write(large_data));
+  ASSERT_TRUE(fake_upstream_connection->waitForData(5 + large_data.size()));
+
+  ASSERT_TRUE(tcp_client->write("", true));
+  ASSERT_TRUE(fake_upstream_connection->waitForHalfClose());
+  ASSERT_TRUE(fake_upstream_connection->write("bye", true));
+  tcp_client->waitForData("squackbye");
+  tcp_client->waitForHalfClose();
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+  tcp_client->waitForDisconnect();
+  test_server_->waitForCounterGe("tcp.tcpproxy_stats.downstream_cx_total", 1);
+  EXPECT_EQ(5 + large_data.size(),
+            test_server_->counter("tcp.tcpproxy_stats.downstream_cx_rx_bytes_total")->value());
+  test_server_.reset();
+
+  EXPECT_THAT(waitForAccessLog(listener_access_log_name_),
+              MatchesRegex(fmt::format(
+                  ".*DOWNSTREAM_WIRE_BYTES_SENT=9 DOWNSTREAM_WIRE_BYTES_RECEIVED={0} "
+                  "UPSTREAM_WIRE_BYTES_SENT={0} UPSTREAM_WIRE_BYTES_RECEIVED=9.*",
+                  5 + large_data.size())));
+}
+
+// Test that spliced bytes keep the idle timer from firing, and that it fires once they stop.
+TEST_P(TcpProxyIntegrationTest, TcpProxySpliceIdleTimeout) {
+  enableSplice();
+  config_helper_.addConfigModifier([&](envoy::config::bootstrap::v3::Bootstrap& bootstrap) -> void {
+    auto* listener = bootstrap.mutable_static_resources()->mutable_listeners(0);
+    auto* filter_chain = listener->mutable_filter_chains(0);
+    auto* config_blob = filter_chain->mutable_filters(0)->mutable_typed_config();
+
+    auto tcp_proxy_config =
+        MessageUtil::anyConvert<envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy>(
+            *config_blob);
+    tcp_proxy_config.mutable_idle_timeout()->set_seconds(1);
+    config_blob->PackFrom(tcp_proxy_config);
+  });
+  initialize();
+
+  IntegrationTcpClientPtr tcp_client = makeTcpConnection(lookupPort("tcp_proxy"));
+  FakeRawConnectionPtr fake_upstream_connection;
+  ASSERT_TRUE(fake_upstreams_[0]->waitForRawConnection(fake_upstream_connection));
+
+  for (int i = 0; i < 4; ++i) {
+    timeSystem().advanceTimeWait(std::chrono::milliseconds(500));
+    ASSERT_TRUE(tcp_client->write("hello"));
+    ASSERT_TRUE(fake_upstream_connection->waitForData(5 * (i + 1)));
+  }
+
+  ASSERT_TRUE(fake_upstream_connection->waitForDisconnect());
+  tcp_client->waitForDisconnect();
+  EXPECT_EQ(1, test_server_->counter("tcp.tcpproxy_stats.idle_timeout")->value());
+}
+
 // Test that the server shuts down without crashing when connections are open.
 TEST_P(TcpProxyIntegrationTest, ShutdownWithOpenConnections) {
   config_helper_.addConfigModifier([&](envoy::config::bootstrap::v3::Bootstrap& bootstrap) -> void {
@@ -25,6 +25,8 @@ public:
   void initialize() override;
   // Setup common byte metering parameters.
   void setupByteMeterAccessLog();
+  // Enable splicing between the downstream and upstream connections.
+  void enableSplice();
 };
 
 class TcpProxySslIntegrationTest : public TcpProxyIntegrationTest {
@@ -32,8 +32,14 @@ void MockConnectionBase::raiseEvent(Network::ConnectionEvent event) {
 }
 
 void MockConnectionBase::raiseBytesSentCallbacks(uint64_t num_bytes) {
-  for (Network::Connection::BytesSentCb& cb : bytes_sent_callbacks_) {
-    cb(num_bytes);
+  // Like the connection, remove the callbacks which return false.
+  auto it = bytes_sent_callbacks_.begin();
+  while (it != bytes_sent_callbacks_.end()) {
+    if ((*it)(num_bytes)) {
+      it++;
+    } else {
+      it = bytes_sent_callbacks_.erase(it);
+    }
   }
 }
 
@@ -0,0 +1,143 @@
+// Measures the throughput of datagrams forwarded between workers by the UDP listener worker router,
+// as happens for QUIC packets that the kernel delivers to the wrong worker.
+
+#include <atomic>
+#include <memory>
+
+#include "envoy/network/filter.h"
+#include "envoy/network/listener.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/listen_socket_impl.h"
+#include "source/common/network/socket_option_factory.h"
+#include "source/server/active_udp_listener.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/network_utility.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+class MockUdpConnectionHandler : public Network::UdpConnectionHandler,
+                                 public Network::MockConnectionHandler {
+public:
+  MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
+  MOCK_METHOD(Network::UdpListenerCallbacksOptRef, getUdpListenerCallbacks,
+              (uint64_t listener_tag, const Network::Address::Instance& address));
+};
+
+class ForwardingUdpListener : public ActiveRawUdpListener {
+public:
+  ForwardingUdpListener(uint32_t worker_index, uint32_t destination,
+                        Network::UdpConnectionHandler& parent,
+                        Network::SocketSharedPtr listen_socket_ptr,
+                        Event::Dispatcher& dispatcher, Network::ListenerConfig& config)
+      : ActiveRawUdpListener(worker_index, 2, parent, listen_socket_ptr, dispatcher, config),
+        destination_(destination) {}
+  uint32_t destination(const Network::UdpRecvData&) const override { return destination_; }
+
+private:
+  const uint32_t destination_;
+};
+
+class CountingFilter : public Network::UdpListenerReadFilter {
+public:
+  CountingFilter(Network::UdpReadFilterCallbacks& callbacks, std::atomic<uint64_t>& received)
+      : UdpListenerReadFilter(callbacks), received_(received) {}
+
+  Network::FilterStatus onData(Network::UdpRecvData&) override {
+    received_++;
+    return Network::FilterStatus::StopIteration;
+  }
+  Network::FilterStatus onReceiveError(Api::IoError::IoErrorCode) override {
+    return Network::FilterStatus::StopIteration;
+  }
+
+private:
+  std::atomic<uint64_t>& received_;
+};
+
+Network::SocketSharedPtr makeListenSocket() {
+  auto socket = std::make_shared<Network::UdpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(Network::Address::IpVersion::v4), nullptr,
+      /*bind*/ true);
+  socket->addOptions(Network::SocketOptionFactory::buildIpPacketInfoOptions());
+  RELEASE_ASSERT(Network::Socket::applyOptions(socket->options(), *socket,
+                                               envoy::config::core::v3::SocketOption::STATE_BOUND),
+                 "");
+  return socket;
+}
+
+// Datagrams are handed from worker 0, driven by the benchmark thread, to worker 1, whose
+// dispatcher runs on its own thread. The argument is the number of datagrams read by worker 0 in a
+// single event loop iteration, i.e. the size of a recvmmsg() batch.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmForwardMisroutedDatagrams(benchmark::State& state) {
+  const uint64_t batch_size = state.range(0);
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr source_dispatcher = api->allocateDispatcher("source_worker");
+  Event::DispatcherPtr destination_dispatcher = api->allocateDispatcher("destination_worker");
+
+  NiceMock<MockUdpConnectionHandler> conn_handler;
+  NiceMock<Network::MockUdpListenerConfig> udp_listener_config(2);
+  NiceMock<Network::MockUdpPacketWriterFactory> udp_packet_writer_factory;
+  NiceMock<Network::MockListenerConfig> listener_config;
+  ON_CALL(listener_config, udpListenerConfig())
+      .WillByDefault(Return(Network::UdpListenerConfigOptRef(udp_listener_config)));
+  ON_CALL(udp_listener_config, packetWriterFactory())
+      .WillByDefault(ReturnRef(udp_packet_writer_factory));
+
+  NiceMock<Network::MockUdpReadFilterCallbacks> read_callbacks;
+  std::atomic<uint64_t> received{0};
+  auto source = std::make_unique<ForwardingUdpListener>(
+      0, 1, conn_handler, makeListenSocket(), *source_dispatcher, listener_config);
+  auto destination = std::make_unique<ForwardingUdpListener>(
+      1, 1, conn_handler, makeListenSocket(), *destination_dispatcher, listener_config);
+  destination->addReadFilter(std::make_unique<CountingFilter>(read_callbacks, received));
+  ON_CALL(conn_handler, getUdpListenerCallbacks(_, _))
+      .WillByDefault(Invoke([&destination](uint64_t, const Network::Address::Instance&) {
+        return std::reference_wrapper<Network::UdpListenerCallbacks>(*destination);
+      }));
+
+  Thread::ThreadPtr destination_thread = api->threadFactory().createThread([&]() {
+    destination_dispatcher->run(Event::Dispatcher::RunType::RunUntilExit);
+  });
+  // Wait for the destination dispatcher to be running so that posts aren't considered to be made
+  // from its own thread.
+  absl::Notification running;
+  destination_dispatcher->post([&running]() { running.Notify(); });
+  running.WaitForNotification();
+
+  uint64_t sent = 0;
+  for (auto _ : state) { // NOLINT
+    for (uint64_t i = 0; i < batch_size; i++) {
+      Network::UdpRecvData data;
+      data.buffer_ = std::make_unique<Buffer::OwnedImpl>("datagram");
+      source->onData(std::move(data));
+    }
+    sent += batch_size;
+    while (received.load() < sent) {
+    }
+  }
+  state.SetItemsProcessed(sent);
+
+  destination_dispatcher->exit();
+  destination_thread->join();
+}
+BENCHMARK(bmForwardMisroutedDatagrams)->Arg(1)->Arg(16)->Arg(64)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
@@ -225,6 +225,67 @@ TEST_P(ActiveUdpListenerTest, UdpListenerWorkerRouterTest) {
   EXPECT_CALL(*another_udp_listener, onDestroy());
 }
 
+TEST_P(ActiveUdpListenerTest, UdpListenerWorkerRouterBatchesPostedDatagrams) {
+  uint32_t concurrency = 2;
+  setup(concurrency);
+
+  uint64_t listener_tag = 1;
+  EXPECT_CALL(listener_config_, listenerTag()).WillOnce(Return(listener_tag));
+  active_listener_->destination_ = 1;
+
+  EXPECT_CALL(listener_config_, filterChainFactory());
+  auto another_udp_listener = new NiceMock<Network::MockUdpListener>();
+  EXPECT_CALL(*another_udp_listener, dispatcher()).WillRepeatedly(ReturnRef(dispatcher_));
+  EXPECT_CALL(dispatcher_, createUdpListener_(_, _, _)).WillOnce(Return(another_udp_listener));
+#ifndef NDEBUG
+  EXPECT_CALL(dispatcher_, isThreadSafe()).WillRepeatedly(Return(false));
+#endif
+  auto another_active_listener = std::make_unique<TestActiveRawUdpListener>(
+      1, concurrency, conn_handler_, listen_socket_, dispatcher_, listener_config_);
+
+  auto* test_filter = new NiceMock<Network::MockUdpListenerReadFilter>(cb_);
+  another_active_listener->addReadFilter(Network::UdpListenerReadFilterPtr{test_filter});
+
+  // Only the first datagram posts a callback to the destination worker.
+  Event::PostCb drain_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(Invoke([&](Event::PostCb cb) {
+    drain_cb = std::move(cb);
+  }));
+  for (int64_t i = 0; i < 3; i++) {
+    Network::UdpRecvData data;
+    data.receive_time_ = MonotonicTime(std::chrono::microseconds(i));
+    active_listener_->onData(std::move(data));
+  }
+
+  EXPECT_CALL(conn_handler_, getUdpListenerCallbacks(listener_tag, _))
+      .WillOnce(Invoke([&](uint64_t, const Network::Address::Instance&) {
+        return std::reference_wrapper<Network::UdpListenerCallbacks>(*another_active_listener);
+      }));
+  std::vector<MonotonicTime> received;
+  EXPECT_CALL(*test_filter, onData(_))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](Network::UdpRecvData& data) -> Network::FilterStatus {
+        received.push_back(data.receive_time_);
+        return Network::FilterStatus::Continue;
+      }));
+  drain_cb();
+  EXPECT_EQ(
+      (std::vector<MonotonicTime>{MonotonicTime(std::chrono::microseconds(0)),
+                                  MonotonicTime(std::chrono::microseconds(1)),
+                                  MonotonicTime(std::chrono::microseconds(2))}),
+      received);
+
+  // Once the queue is drained, the next datagram starts a new batch.
+  EXPECT_CALL(listener_config_, listenerTag()).WillOnce(Return(listener_tag));
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(Invoke([](Event::PostCb cb) { cb(); }));
+  EXPECT_CALL(conn_handler_, getUdpListenerCallbacks(listener_tag, _))
+      .WillOnce(Return(Network::UdpListenerCallbacksOptRef()));
+  Network::UdpRecvData data;
+  active_listener_->onData(std::move(data));
+
+  EXPECT_CALL(*another_udp_listener, onDestroy());
+}
+
 } // namespace
 } // namespace Server
 } // namespace Envoy
@@ -145,6 +145,7 @@ TEST_P(AdminInstanceTest, Help) {
   /drain_listeners (POST): drain listeners
       graceful: When draining listeners, enter a graceful drain period prior to closing listeners. This behaviour and duration is configurable via server options or CLI
       inboundonly: Drains all inbound listeners. traffic_direction field in envoy_v3_api_msg_config.listener.v3.Listener is used to determine whether a listener is inbound or outbound.
+  /event_loops: dump event loop stats and slowest callbacks (if dispatcher stats are enabled)
   /healthcheck/fail (POST): cause the server to fail health checks
   /healthcheck/ok (POST): cause the server to pass health checks
   /heap_dump: dump current Envoy heap (if supported)
@@ -2,7 +2,9 @@
 #include <string>
 
 #include "source/common/common/regex.h"
+#include "source/common/event/dispatcher_instrumentation.h"
 #include "source/common/stats/custom_stat_namespaces_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/common/stats/thread_local_store.h"
 #include "source/server/admin/stats_handler.h"
 #include "source/server/admin/stats_request.h"
@@ -12,6 +14,7 @@
 #include "test/server/admin/admin_instance.h"
 #include "test/test_common/logging.h"
 #include "test/test_common/real_threads_test_helper.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 using testing::Combine;
@@ -1266,6 +1269,37 @@ TEST_P(AdminInstanceTest, RecentLookups) {
   EXPECT_THAT(body, HasSubstr("       1 gamma\n       2 beta\n       3 alpha\n"));
 }
 
+TEST_P(AdminInstanceTest, EventLoops) {
+  Http::TestResponseHeaderMapImpl response_headers;
+  std::string body;
+
+  // Event loops are only instrumented with dispatcher stats enabled.
+  EXPECT_EQ(Http::Code::OK, admin_.request("/event_loops", "GET", response_headers, body));
+  EXPECT_THAT(body, HasSubstr("Event loop instrumentation is not enabled"));
+
+  Stats::IsolatedStoreImpl store;
+  Event::SimulatedTimeSystem time_system;
+  Event::DispatcherStats stats{
+      ALL_DISPATCHER_STATS(POOL_COUNTER_PREFIX(*store.rootScope(), "test."),
+                           POOL_GAUGE_PREFIX(*store.rootScope(), "test."),
+                           POOL_HISTOGRAM_PREFIX(*store.rootScope(), "test."))};
+  Event::DispatcherInstrumentation instrumentation("worker_0", stats, time_system);
+  {
+    Event::DispatcherInstrumentation::ScopedCallback scoped_callback(&instrumentation,
+                                                                     Event::CallbackType::Timer);
+    time_system.advanceTimeWait(std::chrono::milliseconds(250));
+  }
+  instrumentation.onLoopIdle(std::chrono::milliseconds(750));
+  instrumentation.onLoopBusy(std::chrono::milliseconds(250));
+
+  EXPECT_EQ(Http::Code::OK, admin_.request("/event_loops", "GET", response_headers, body));
+  EXPECT_THAT(std::string(response_headers.getContentTypeValue()), HasSubstr("application/json"));
+  EXPECT_THAT(body, HasSubstr("\"name\": \"worker_0\""));
+  EXPECT_THAT(body, HasSubstr("\"utilization\": 0.25"));
+  EXPECT_THAT(body, HasSubstr("\"count\": \"1\""));
+  EXPECT_THAT(body, HasSubstr("\"duration\": \"0.250s\""));
+}
+
 class StatsHandlerPrometheusTest : public StatsHandlerTest {
 public:
   void createTestStats() {
@@ -4,9 +4,12 @@
 #include "source/server/hot_restarting_child.h"
 #include "source/server/hot_restarting_parent.h"
 
+#include "test/common/upstream/utility.h"
+#include "test/mocks/common.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/server/instance.h"
 #include "test/mocks/server/listener_manager.h"
+#include "test/mocks/upstream/cluster_priority_set.h"
 
 #include "gtest/gtest.h"
 
@@ -297,6 +300,46 @@ TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   }
 }
 
+TEST_F(HotRestartingParentTest, ExportHostHealthToChild) {
+  NiceMock<Upstream::MockClusterMockPrioritySet> cluster;
+  NiceMock<MockTimeSystem> time_system;
+  Upstream::HostSharedPtr healthy =
+      Upstream::makeTestHost(cluster.info_, "tcp://10.0.0.1:80", time_system);
+  Upstream::HostSharedPtr failed =
+      Upstream::makeTestHost(cluster.info_, "tcp://10.0.0.2:80", time_system);
+  failed->healthFlagSet(Upstream::Host::HealthFlag::FAILED_ACTIVE_HC);
+  Upstream::HostSharedPtr ejected =
+      Upstream::makeTestHost(cluster.info_, "tcp://10.0.0.3:80", time_system);
+  ejected->healthFlagSet(Upstream::Host::HealthFlag::DEGRADED_ACTIVE_HC);
+  ejected->healthFlagSet(Upstream::Host::HealthFlag::FAILED_OUTLIER_CHECK);
+  cluster.priority_set_.getMockHostSet(0)->hosts_ = {healthy, failed};
+  cluster.priority_set_.getMockHostSet(1)->hosts_ = {ejected};
+
+  Upstream::ClusterManager::ClusterInfoMaps clusters;
+  clusters.active_clusters_.emplace("cluster_0", cluster);
+  EXPECT_CALL(server_.cluster_manager_, clusters()).WillOnce(Return(clusters));
+
+  HotRestartMessage::Reply::HostHealth host_health;
+  hot_restarting_parent_.exportHostHealthToChild(&host_health);
+  ASSERT_EQ(3, host_health.hosts_size());
+  EXPECT_EQ("cluster_0", host_health.hosts(0).cluster_name());
+  EXPECT_EQ("10.0.0.1:80", host_health.hosts(0).address());
+  EXPECT_FALSE(host_health.hosts(0).failed_active_health_check());
+  EXPECT_FALSE(host_health.hosts(0).failed_outlier_check());
+  EXPECT_EQ("10.0.0.2:80", host_health.hosts(1).address());
+  EXPECT_TRUE(host_health.hosts(1).failed_active_health_check());
+  EXPECT_EQ("10.0.0.3:80", host_health.hosts(2).address());
+  EXPECT_FALSE(host_health.hosts(2).failed_active_health_check());
+  EXPECT_TRUE(host_health.hosts(2).degraded_active_health_check());
+  EXPECT_TRUE(host_health.hosts(2).failed_outlier_check());
+}
+
+// Without a parent, the child doesn't ask for the health of its hosts.
+TEST_F(HotRestartingParentTest, NoParentHostHealth) {
+  HotRestartingChild hot_restarting_child(0, 0, "@envoy_domain_socket", 0);
+  EXPECT_TRUE(hot_restarting_child.getParentHostHealth().empty());
+}
+
 TEST_F(HotRestartingParentTest, DrainListeners) {
   EXPECT_CALL(server_, drainListeners());
   hot_restarting_parent_.drainListeners();